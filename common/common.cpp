@@ -41,6 +41,7 @@
 #include <wx/stdpaths.h>
 
 #include <pgm_base.h>
+#include <ki_mutex.h>
 
 
 /**
@@ -263,9 +264,13 @@ int ProcessExecute( const wxString& aCommandLine, int aFlags, wxProcess *callbac
 
 time_t GetNewTimeStamp()
 {
+    // Time stamps are also created by the schematic loader threads.
+    static MUTEX  timestamp_mutex;
     static time_t oldTimeStamp;
     time_t newTimeStamp;
 
+    MUTLOCK lock( timestamp_mutex );
+
     newTimeStamp = time( NULL );
 
     if( newTimeStamp <= oldTimeStamp )
@@ -388,7 +393,6 @@ wxString GetKicadConfigPath()
 }
 
 
-#include <ki_mutex.h>
 const wxString ExpandEnvVarSubstitutions( const wxString& aString )
 {
     // wxGetenv( wchar_t* ) is not re-entrant on linux.
@@ -40,6 +40,7 @@
 #include <tool/tool_manager.h>
 
 #include <pcbstruct.h>  // display options definition
+#include <frame_profiler.h>
 
 #ifdef PROFILE
 #include <profile.h>
@@ -108,6 +109,7 @@ EDA_DRAW_PANEL_GAL::EDA_DRAW_PANEL_GAL( wxWindow* aParentWindow, wxWindowID aWin
     m_pendingRefresh = false;
     m_drawing = false;
     m_drawingEnabled = false;
+    m_profilerOverlay = false;
 
     // Set up timer that prevents too frequent redraw commands
     m_refreshTimer.SetOwner( this );
@@ -166,6 +168,7 @@ void EDA_DRAW_PANEL_GAL::onPaint( wxPaintEvent& WXUNUSED( aEvent ) )
 #endif /* PROFILE */
 
     m_drawing = true;
+    FRAME_PROFILER::Instance().BeginFrame();
     KIGFX::PCB_RENDER_SETTINGS* settings = static_cast<KIGFX::PCB_RENDER_SETTINGS*>( m_painter->GetSettings() );
 
 // Scrollbars broken in GAL on OSX
@@ -183,6 +186,10 @@ void EDA_DRAW_PANEL_GAL::onPaint( wxPaintEvent& WXUNUSED( aEvent ) )
         KIGFX::COLOR4D gridColor = settings->GetLayerColor( ITEM_GAL_LAYER( GRID_VISIBLE ) );
         m_gal->SetGridColor( gridColor );
 
+        // Statistics change with every frame
+        if( m_profilerOverlay )
+            m_view->MarkTargetDirty( KIGFX::TARGET_OVERLAY );
+
         if( m_view->IsDirty() )
         {
             m_view->ClearTargets();
@@ -192,6 +199,9 @@ void EDA_DRAW_PANEL_GAL::onPaint( wxPaintEvent& WXUNUSED( aEvent ) )
                 m_gal->DrawGrid();
 
             m_view->Redraw();
+
+            if( m_profilerOverlay )
+                drawProfilerOverlay();
         }
 
         m_gal->DrawCursor( m_viewControls->GetCursorPosition() );
@@ -217,6 +227,56 @@ void EDA_DRAW_PANEL_GAL::onPaint( wxPaintEvent& WXUNUSED( aEvent ) )
 
     m_lastRefresh = wxGetLocalTimeMillis();
     m_drawing = false;
+
+    FRAME_PROFILER::Instance().EndFrame();
+}
+
+
+void EDA_DRAW_PANEL_GAL::ShowProfilerOverlay( bool aShow )
+{
+    m_profilerOverlay = aShow;
+    FRAME_PROFILER::Instance().Enable( aShow );
+
+    // Remove the overlay from the screen
+    m_view->MarkTargetDirty( KIGFX::TARGET_OVERLAY );
+    Refresh();
+}
+
+
+void EDA_DRAW_PANEL_GAL::drawProfilerOverlay()
+{
+    FRAME_PROFILER::RECORD average;
+
+    if( !FRAME_PROFILER::Instance().GetAverage( average, PROFILER_AVERAGE_FRAMES ) )
+        return;
+
+    // Statistics are displayed in the top left corner, regardless of the zoom level
+    const double fontSize = 12.0;
+    VECTOR2D position = m_view->ToWorld( VECTOR2D( fontSize, fontSize ) );
+    double lineHeight = m_view->ToWorld( 1.5 * fontSize );
+
+    KIGFX::RENDER_TARGET target = m_gal->GetTarget();
+    m_gal->SetTarget( KIGFX::TARGET_OVERLAY );
+    m_gal->SetLayerDepth( m_gal->GetMinDepth() );
+    m_gal->SetIsFill( false );
+    m_gal->SetIsStroke( true );
+    m_gal->SetStrokeColor( KIGFX::COLOR4D( 1.0, 1.0, 0.0, 1.0 ) );
+    m_gal->SetLineWidth( m_view->ToWorld( 1.0 ) );
+    m_gal->SetGlyphSize( VECTOR2D( m_view->ToWorld( fontSize ), m_view->ToWorld( fontSize ) ) );
+    m_gal->SetHorizontalJustify( GR_TEXT_HJUSTIFY_LEFT );
+    m_gal->SetVerticalJustify( GR_TEXT_VJUSTIFY_TOP );
+
+    for( int i = 0; i < FRAME_PROFILER::SECTION_COUNT; ++i )
+    {
+        wxString line = wxString::Format( wxT( "%s: %.2f ms" ),
+                FRAME_PROFILER::GetSectionName( (FRAME_PROFILER::SECTION) i ),
+                average.m_time[i] );
+
+        m_gal->BitmapText( line, position, 0.0 );
+        position.y += lineHeight;
+    }
+
+    m_gal->SetTarget( target );
 }
 
 
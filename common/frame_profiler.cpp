@@ -0,0 +1,221 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <frame_profiler.h>
+
+#include <algorithm>
+#include <cstdio>
+
+#include <wx/filefn.h>
+
+std::atomic<bool> FRAME_PROFILER::s_enabled( false );
+
+const int FRAME_PROFILER::HISTORY_SIZE;
+
+
+FRAME_PROFILER::FRAME_PROFILER() :
+    m_next( 0 ), m_frameCounter( 0 ), m_frameStarted( false )
+{
+    for( int i = 0; i < SECTION_COUNT; ++i )
+    {
+        m_current[i] = 0;
+        m_currentCalls[i] = 0;
+    }
+
+    m_history.reserve( HISTORY_SIZE );
+}
+
+
+FRAME_PROFILER& FRAME_PROFILER::Instance()
+{
+    static FRAME_PROFILER profiler;
+
+    return profiler;
+}
+
+
+void FRAME_PROFILER::Enable( bool aEnable )
+{
+    // Make sure the first frame does not contain times collected before
+    for( int i = 0; i < SECTION_COUNT; ++i )
+    {
+        m_current[i] = 0;
+        m_currentCalls[i] = 0;
+    }
+
+    m_frameStarted = false;
+    s_enabled = aEnable;
+}
+
+
+void FRAME_PROFILER::AddSample( SECTION aSection, long long aNanoseconds )
+{
+    m_current[aSection].fetch_add( aNanoseconds, std::memory_order_relaxed );
+    m_currentCalls[aSection].fetch_add( 1, std::memory_order_relaxed );
+}
+
+
+void FRAME_PROFILER::BeginFrame()
+{
+    if( !IsEnabled() )
+        return;
+
+    m_frameStart = std::chrono::steady_clock::now();
+    m_frameStarted = true;
+}
+
+
+void FRAME_PROFILER::EndFrame()
+{
+    if( !IsEnabled() || !m_frameStarted )
+        return;
+
+    auto elapsed = std::chrono::steady_clock::now() - m_frameStart;
+    AddSample( FRAME, std::chrono::duration_cast<std::chrono::nanoseconds>( elapsed ).count() );
+    m_frameStarted = false;
+
+    RECORD record;
+    record.m_frame = m_frameCounter++;
+
+    for( int i = 0; i < SECTION_COUNT; ++i )
+    {
+        record.m_time[i] = m_current[i].exchange( 0 ) / 1e6;
+        record.m_calls[i] = m_currentCalls[i].exchange( 0 );
+    }
+
+    std::lock_guard<std::mutex> lock( m_lock );
+
+    if( (int) m_history.size() < HISTORY_SIZE )
+        m_history.push_back( record );
+    else
+        m_history[m_next] = record;
+
+    m_next = ( m_next + 1 ) % HISTORY_SIZE;
+}
+
+
+void FRAME_PROFILER::Clear()
+{
+    std::lock_guard<std::mutex> lock( m_lock );
+
+    m_history.clear();
+    m_next = 0;
+}
+
+
+std::vector<FRAME_PROFILER::RECORD> FRAME_PROFILER::GetRecords() const
+{
+    std::lock_guard<std::mutex> lock( m_lock );
+    std::vector<RECORD> records;
+
+    // Once the ring buffer is full, the oldest record is the one to be overwritten next
+    if( (int) m_history.size() < HISTORY_SIZE )
+    {
+        records = m_history;
+    }
+    else
+    {
+        records.insert( records.end(), m_history.begin() + m_next, m_history.end() );
+        records.insert( records.end(), m_history.begin(), m_history.begin() + m_next );
+    }
+
+    return records;
+}
+
+
+bool FRAME_PROFILER::GetAverage( RECORD& aAverage, int aFrameCount ) const
+{
+    std::vector<RECORD> records = GetRecords();
+    int count = std::min<int>( aFrameCount, records.size() );
+
+    if( count <= 0 )
+        return false;
+
+    aAverage.m_frame = records.back().m_frame;
+
+    for( int i = 0; i < SECTION_COUNT; ++i )
+    {
+        aAverage.m_time[i] = 0.0;
+        aAverage.m_calls[i] = 0;
+    }
+
+    for( auto it = records.end() - count; it != records.end(); ++it )
+    {
+        for( int i = 0; i < SECTION_COUNT; ++i )
+        {
+            aAverage.m_time[i] += it->m_time[i];
+            aAverage.m_calls[i] += it->m_calls[i];
+        }
+    }
+
+    for( int i = 0; i < SECTION_COUNT; ++i )
+        aAverage.m_time[i] /= count;
+
+    return true;
+}
+
+
+bool FRAME_PROFILER::Dump( const wxString& aFileName ) const
+{
+    FILE* file = wxFopen( aFileName, wxT( "wt" ) );
+
+    if( !file )
+        return false;
+
+    fprintf( file, "frame" );
+
+    for( int i = 0; i < SECTION_COUNT; ++i )
+        fprintf( file, ",%s_ms,%s_calls", GetSectionName( (SECTION) i ),
+                 GetSectionName( (SECTION) i ) );
+
+    fprintf( file, "\n" );
+
+    for( const RECORD& record : GetRecords() )
+    {
+        fprintf( file, "%lu", record.m_frame );
+
+        for( int i = 0; i < SECTION_COUNT; ++i )
+            fprintf( file, ",%.3f,%u", record.m_time[i], record.m_calls[i] );
+
+        fprintf( file, "\n" );
+    }
+
+    return fclose( file ) == 0;
+}
+
+
+const char* FRAME_PROFILER::GetSectionName( SECTION aSection )
+{
+    switch( aSection )
+    {
+    case FRAME:         return "frame";
+    case VIEW_UPDATE:   return "view_update";
+    case VIEW_REDRAW:   return "view_redraw";
+    case VIEW_QUERY:    return "view_query";
+    case PAINTER:       return "painter";
+    case GAL_COMPOSITE: return "gal_composite";
+    case RATSNEST:      return "ratsnest";
+    case ROUTER:        return "router";
+    default:            return "unknown";
+    }
+}
@@ -31,6 +31,9 @@
 #include <gal/cairo/cairo_compositor.h>
 #include <wx/log.h>
 
+#include <algorithm>
+#include <cmath>
+
 using namespace KIGFX;
 
 CAIRO_COMPOSITOR::CAIRO_COMPOSITOR( cairo_t** aMainContext ) :
@@ -40,6 +43,7 @@ CAIRO_COMPOSITOR::CAIRO_COMPOSITOR( cairo_t** aMainContext ) :
     cairo_matrix_init_identity( &m_matrix );
     m_stride = 0;
     m_bufferSize = 0;
+    m_tileCount = 0;
 }
 
 
@@ -67,6 +71,8 @@ void CAIRO_COMPOSITOR::Resize( unsigned int aWidth, unsigned int aHeight )
 
     m_stride     = cairo_format_stride_for_width( CAIRO_FORMAT_ARGB32, m_width );
     m_bufferSize = m_stride * m_height;
+
+    SetTileCount( m_tileCount );
 }
 
 
@@ -105,6 +111,86 @@ unsigned int CAIRO_COMPOSITOR::CreateBuffer()
 }
 
 
+void CAIRO_COMPOSITOR::SetTileCount( int aCount )
+{
+    destroyTiles();
+    m_tiles.clear();
+    m_tileCount = aCount;
+
+    if( aCount < 2 || m_width == 0 || m_height == 0 )
+        return;
+
+    // Make the tiles roughly square, so few items are shared by neighbouring tiles
+    int columns = std::lround( std::sqrt( (double) aCount * m_width / m_height ) );
+    columns = std::max( 1, std::min( columns, aCount ) );
+    int rows = ( aCount + columns - 1 ) / columns;
+
+    columns = std::min<int>( columns, std::max<int>( 1, m_width / MIN_TILE_SIZE ) );
+    rows = std::min<int>( rows, std::max<int>( 1, m_height / MIN_TILE_SIZE ) );
+
+    if( columns * rows < 2 )
+        return;
+
+    for( int row = 0; row < rows; ++row )
+    {
+        int top = m_height * row / rows;
+        int bottom = m_height * ( row + 1 ) / rows;
+
+        for( int col = 0; col < columns; ++col )
+        {
+            int left = m_width * col / columns;
+            int right = m_width * ( col + 1 ) / columns;
+
+            m_tiles.push_back( BOX2I( VECTOR2I( left, top ),
+                                      VECTOR2I( right - left, bottom - top ) ) );
+        }
+    }
+}
+
+
+cairo_t* CAIRO_COMPOSITOR::GetTileContext( int aTile )
+{
+    wxASSERT_MSG( aTile >= 0 && aTile < GetTileCount(), wxT( "Tried to use a not existing tile" ) );
+
+    CAIRO_BUFFER& buffer = m_buffers[m_current];
+
+    if( buffer.tileContexts.empty() )
+    {
+        for( const BOX2I& tile : m_tiles )
+        {
+            // The tile surface is a window into the buffer pixel storage
+            unsigned char* data = (unsigned char*) buffer.bitmap.get()
+                                  + tile.GetY() * m_stride + tile.GetX() * sizeof(int);
+            cairo_surface_t* surface = cairo_image_surface_create_for_data( data,
+                    CAIRO_FORMAT_ARGB32, tile.GetWidth(), tile.GetHeight(), m_stride );
+            cairo_t* context = cairo_create( surface );
+
+            // The context keeps a reference to the surface
+            cairo_surface_destroy( surface );
+
+            cairo_set_antialias( context, CAIRO_ANTIALIAS_NONE );
+            cairo_set_line_join( context, CAIRO_LINE_JOIN_ROUND );
+            cairo_set_line_cap( context, CAIRO_LINE_CAP_ROUND );
+
+            buffer.tileContexts.push_back( context );
+        }
+    }
+
+    // Use the current buffer transformation, shifted to the tile origin
+    cairo_matrix_t shift, matrix;
+    const BOX2I& tile = m_tiles[aTile];
+
+    cairo_get_matrix( *m_currentContext, &m_matrix );
+    cairo_matrix_init_translate( &shift, -tile.GetX(), -tile.GetY() );
+    cairo_matrix_multiply( &matrix, &m_matrix, &shift );
+
+    cairo_t* context = buffer.tileContexts[aTile];
+    cairo_set_matrix( context, &matrix );
+
+    return context;
+}
+
+
 void CAIRO_COMPOSITOR::SetBuffer( unsigned int aBufferHandle )
 {
     wxASSERT_MSG( aBufferHandle <= usedBuffers(), wxT( "Tried to use a not existing buffer" ) );
@@ -125,8 +211,52 @@ void CAIRO_COMPOSITOR::Begin()
 
 void CAIRO_COMPOSITOR::ClearBuffer()
 {
-    // Clear the pixel storage
-    memset( m_buffers[m_current].bitmap.get(), 0x00, m_bufferSize * sizeof(int) );
+    const BOX2I& clip = m_buffers[m_current].clipArea;
+
+    if( clip.GetWidth() <= 0 || clip.GetHeight() <= 0 )
+    {
+        // Clear the pixel storage
+        memset( m_buffers[m_current].bitmap.get(), 0x00, m_bufferSize * sizeof(int) );
+        return;
+    }
+
+    // Clear only the rows of the clip area
+    unsigned char* data = (unsigned char*) m_buffers[m_current].bitmap.get();
+
+    for( int y = clip.GetY(); y < clip.GetBottom(); ++y )
+    {
+        memset( data + y * m_stride + clip.GetX() * sizeof(int), 0x00,
+                clip.GetWidth() * sizeof(int) );
+    }
+}
+
+
+void CAIRO_COMPOSITOR::SetClipArea( const BOX2I& aArea )
+{
+    CAIRO_BUFFER& buffer = m_buffers[m_current];
+
+    // Keep the area within the buffer, so it can be cleared safely
+    VECTOR2I origin( std::max( aArea.GetX(), 0 ), std::max( aArea.GetY(), 0 ) );
+    VECTOR2I end( std::min<int>( aArea.GetRight(), m_width ),
+                  std::min<int>( aArea.GetBottom(), m_height ) );
+
+    if( end.x > origin.x && end.y > origin.y )
+        buffer.clipArea = BOX2I( origin, end - origin );
+    else
+        buffer.clipArea = BOX2I();
+
+    cairo_reset_clip( buffer.context );
+
+    if( buffer.clipArea.GetWidth() > 0 )
+    {
+        // The clip area is given in pixels, not in world coordinates
+        cairo_get_matrix( buffer.context, &m_matrix );
+        cairo_identity_matrix( buffer.context );
+        cairo_rectangle( buffer.context, origin.x, origin.y,
+                         buffer.clipArea.GetWidth(), buffer.clipArea.GetHeight() );
+        cairo_clip( buffer.context );
+        cairo_set_matrix( buffer.context, &m_matrix );
+    }
 }
 
 
@@ -139,6 +269,9 @@ void CAIRO_COMPOSITOR::DrawBuffer( unsigned int aBufferHandle )
     cairo_get_matrix( m_mainContext, &m_matrix );
     cairo_identity_matrix( m_mainContext );
 
+    // The buffer could have been modified through the tile surfaces
+    cairo_surface_mark_dirty( m_buffers[aBufferHandle - 1].surface );
+
     // Draw the selected buffer contents
     cairo_set_source_surface( m_mainContext, m_buffers[aBufferHandle - 1].surface, 0.0, 0.0 );
     cairo_paint( m_mainContext );
@@ -151,8 +284,22 @@ void CAIRO_COMPOSITOR::Present()
 {
 }
 
+void CAIRO_COMPOSITOR::destroyTiles()
+{
+    for( CAIRO_BUFFER& buffer : m_buffers )
+    {
+        for( cairo_t* context : buffer.tileContexts )
+            cairo_destroy( context );
+
+        buffer.tileContexts.clear();
+    }
+}
+
+
 void CAIRO_COMPOSITOR::clean()
 {
+    destroyTiles();
+
     CAIRO_BUFFERS::const_iterator it;
 
     for( it = m_buffers.begin(); it != m_buffers.end(); ++it )
@@ -33,6 +33,7 @@
 #include <gal/cairo/cairo_compositor.h>
 #include <gal/definitions.h>
 #include <geometry/shape_poly_set.h>
+#include <frame_profiler.h>
 
 #include <limits>
 
@@ -51,11 +52,7 @@ CAIRO_GAL::CAIRO_GAL( wxWindow* aParent, wxEvtHandler* aMouseListener,
     paintListener = aPaintListener;
 
     // Initialize the flags
-    isGrouping          = false;
-    isInitialized       = false;
     isDeleteSavedPixels = false;
-    validCompositor     = false;
-    groupCounter        = 0;
 
     // Connecting the event handlers
     Connect( wxEVT_PAINT,       wxPaintEventHandler( CAIRO_GAL::onPaint ) );
@@ -98,8 +95,6 @@ CAIRO_GAL::~CAIRO_GAL()
 
     delete cursorPixels;
     delete cursorPixelsSaved;
-
-    ClearCache();
 }
 
 
@@ -117,8 +112,11 @@ void CAIRO_GAL::BeginDrawing()
 
 void CAIRO_GAL::EndDrawing()
 {
+    FRAME_PROFILER_SCOPE profilerScope( FRAME_PROFILER::GAL_COMPOSITE );
+
     // Force remaining objects to be drawn
     Flush();
+    finishBuffers();
 
     // Merge buffers on the screen
     compositor->DrawBuffer( mainBuffer );
@@ -151,131 +149,6 @@ void CAIRO_GAL::EndDrawing()
 }
 
 
-void CAIRO_GAL::DrawLine( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint )
-{
-    cairo_move_to( currentContext, aStartPoint.x, aStartPoint.y );
-    cairo_line_to( currentContext, aEndPoint.x, aEndPoint.y );
-    flushPath();
-    isElementAdded = true;
-}
-
-
-void CAIRO_GAL::DrawSegment( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint,
-                             double aWidth )
-{
-    if( isFillEnabled )
-    {
-        // Filled tracks mode
-        SetLineWidth( aWidth );
-
-        cairo_move_to( currentContext, (double) aStartPoint.x, (double) aStartPoint.y );
-        cairo_line_to( currentContext, (double) aEndPoint.x, (double) aEndPoint.y );
-        cairo_set_source_rgba( currentContext, fillColor.r, fillColor.g, fillColor.b, fillColor.a );
-        cairo_stroke( currentContext );
-    }
-    else
-    {
-        // Outline mode for tracks
-        VECTOR2D startEndVector = aEndPoint - aStartPoint;
-        double   lineAngle      = atan2( startEndVector.y, startEndVector.x );
-        double   lineLength     = startEndVector.EuclideanNorm();
-
-        cairo_save( currentContext );
-
-        cairo_translate( currentContext, aStartPoint.x, aStartPoint.y );
-        cairo_rotate( currentContext, lineAngle );
-
-        cairo_arc( currentContext, 0.0,        0.0, aWidth / 2.0,  M_PI / 2.0, 3.0 * M_PI / 2.0 );
-        cairo_arc( currentContext, lineLength, 0.0, aWidth / 2.0, -M_PI / 2.0, M_PI / 2.0 );
-
-        cairo_move_to( currentContext, 0.0,        aWidth / 2.0 );
-        cairo_line_to( currentContext, lineLength, aWidth / 2.0 );
-
-        cairo_move_to( currentContext, 0.0,        -aWidth / 2.0 );
-        cairo_line_to( currentContext, lineLength, -aWidth / 2.0 );
-
-        cairo_restore( currentContext );
-        flushPath();
-    }
-
-    isElementAdded = true;
-}
-
-
-void CAIRO_GAL::DrawCircle( const VECTOR2D& aCenterPoint, double aRadius )
-{
-    cairo_new_sub_path( currentContext );
-    cairo_arc( currentContext, aCenterPoint.x, aCenterPoint.y, aRadius, 0.0, 2 * M_PI );
-    flushPath();
-    isElementAdded = true;
-}
-
-
-void CAIRO_GAL::DrawArc( const VECTOR2D& aCenterPoint, double aRadius, double aStartAngle,
-                         double aEndAngle )
-{
-    SWAP( aStartAngle, >, aEndAngle );
-
-    cairo_new_sub_path( currentContext );
-    cairo_arc( currentContext, aCenterPoint.x, aCenterPoint.y, aRadius, aStartAngle, aEndAngle );
-
-    if( isFillEnabled )
-    {
-        VECTOR2D startPoint( cos( aStartAngle ) * aRadius + aCenterPoint.x,
-                             sin( aStartAngle ) * aRadius + aCenterPoint.y );
-        VECTOR2D endPoint( cos( aEndAngle ) * aRadius + aCenterPoint.x,
-                           sin( aEndAngle ) * aRadius + aCenterPoint.y );
-
-        cairo_move_to( currentContext, aCenterPoint.x, aCenterPoint.y );
-        cairo_line_to( currentContext, startPoint.x, startPoint.y );
-        cairo_line_to( currentContext, endPoint.x, endPoint.y );
-        cairo_close_path( currentContext );
-    }
-
-    flushPath();
-
-    isElementAdded = true;
-}
-
-
-void CAIRO_GAL::DrawRectangle( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint )
-{
-    // Calculate the diagonal points
-    VECTOR2D diagonalPointA( aEndPoint.x,  aStartPoint.y );
-    VECTOR2D diagonalPointB( aStartPoint.x, aEndPoint.y );
-
-    // The path is composed from 4 segments
-    cairo_move_to( currentContext, aStartPoint.x, aStartPoint.y );
-    cairo_line_to( currentContext, diagonalPointA.x, diagonalPointA.y );
-    cairo_line_to( currentContext, aEndPoint.x, aEndPoint.y );
-    cairo_line_to( currentContext, diagonalPointB.x, diagonalPointB.y );
-    cairo_close_path( currentContext );
-    flushPath();
-
-    isElementAdded = true;
-}
-
-
-void CAIRO_GAL::DrawPolygon( const SHAPE_POLY_SET& aPolySet )
-{
-    for( int i = 0; i < aPolySet.OutlineCount(); ++i )
-        drawPoly( aPolySet.COutline( i ) );
-}
-
-
-void CAIRO_GAL::DrawCurve( const VECTOR2D& aStartPoint, const VECTOR2D& aControlPointA,
-                           const VECTOR2D& aControlPointB, const VECTOR2D& aEndPoint )
-{
-    cairo_move_to( currentContext, aStartPoint.x, aStartPoint.y );
-    cairo_curve_to( currentContext, aControlPointA.x, aControlPointA.y, aControlPointB.x,
-                    aControlPointB.y, aEndPoint.x, aEndPoint.y );
-    cairo_line_to( currentContext, aEndPoint.x, aEndPoint.y );
-
-    flushPath();
-    isElementAdded = true;
-}
-
-
 void CAIRO_GAL::ResizeScreen( int aWidth, int aHeight )
 {
     screenSize = VECTOR2I( aWidth, aHeight );
@@ -304,397 +177,6 @@ bool CAIRO_GAL::Show( bool aShow )
 }
 
 
-void CAIRO_GAL::Flush()
-{
-    storePath();
-}
-
-
-void CAIRO_GAL::ClearScreen( const COLOR4D& aColor )
-{
-    backgroundColor = aColor;
-    cairo_set_source_rgb( currentContext, aColor.r, aColor.g, aColor.b );
-    cairo_rectangle( currentContext, 0.0, 0.0, screenSize.x, screenSize.y );
-    cairo_fill( currentContext );
-}
-
-
-void CAIRO_GAL::SetIsFill( bool aIsFillEnabled )
-{
-    storePath();
-    isFillEnabled = aIsFillEnabled;
-
-    if( isGrouping )
-    {
-        GROUP_ELEMENT groupElement;
-        groupElement.command = CMD_SET_FILL;
-        groupElement.argument.boolArg = aIsFillEnabled;
-        currentGroup->push_back( groupElement );
-    }
-}
-
-
-void CAIRO_GAL::SetIsStroke( bool aIsStrokeEnabled )
-{
-    storePath();
-    isStrokeEnabled = aIsStrokeEnabled;
-
-    if( isGrouping )
-    {
-        GROUP_ELEMENT groupElement;
-        groupElement.command = CMD_SET_STROKE;
-        groupElement.argument.boolArg = aIsStrokeEnabled;
-        currentGroup->push_back( groupElement );
-    }
-}
-
-
-void CAIRO_GAL::SetStrokeColor( const COLOR4D& aColor )
-{
-    storePath();
-    strokeColor = aColor;
-
-    if( isGrouping )
-    {
-        GROUP_ELEMENT groupElement;
-        groupElement.command = CMD_SET_STROKECOLOR;
-        groupElement.argument.dblArg[0] = strokeColor.r;
-        groupElement.argument.dblArg[1] = strokeColor.g;
-        groupElement.argument.dblArg[2] = strokeColor.b;
-        groupElement.argument.dblArg[3] = strokeColor.a;
-        currentGroup->push_back( groupElement );
-    }
-}
-
-
-void CAIRO_GAL::SetFillColor( const COLOR4D& aColor )
-{
-    storePath();
-    fillColor = aColor;
-
-    if( isGrouping )
-    {
-        GROUP_ELEMENT groupElement;
-        groupElement.command = CMD_SET_FILLCOLOR;
-        groupElement.argument.dblArg[0] = fillColor.r;
-        groupElement.argument.dblArg[1] = fillColor.g;
-        groupElement.argument.dblArg[2] = fillColor.b;
-        groupElement.argument.dblArg[3] = fillColor.a;
-        currentGroup->push_back( groupElement );
-    }
-}
-
-
-void CAIRO_GAL::SetLineWidth( double aLineWidth )
-{
-    storePath();
-
-    lineWidth = aLineWidth;
-
-    if( isGrouping )
-    {
-        GROUP_ELEMENT groupElement;
-        groupElement.command = CMD_SET_LINE_WIDTH;
-        groupElement.argument.dblArg[0] = aLineWidth;
-        currentGroup->push_back( groupElement );
-    }
-    else
-    {
-        // Make lines appear at least 1 pixel wide, no matter of zoom
-        double x = 1.0, y = 1.0;
-        cairo_device_to_user_distance( currentContext, &x, &y );
-        double minWidth = std::min( fabs( x ), fabs( y ) );
-        cairo_set_line_width( currentContext, std::max( aLineWidth, minWidth ) );
-    }
-}
-
-
-void CAIRO_GAL::SetLayerDepth( double aLayerDepth )
-{
-    super::SetLayerDepth( aLayerDepth );
-
-    if( isInitialized )
-        storePath();
-}
-
-
-void CAIRO_GAL::Transform( const MATRIX3x3D& aTransformation )
-{
-    cairo_matrix_t cairoTransformation;
-
-    cairo_matrix_init( &cairoTransformation,
-                       aTransformation.m_data[0][0],
-                       aTransformation.m_data[1][0],
-                       aTransformation.m_data[0][1],
-                       aTransformation.m_data[1][1],
-                       aTransformation.m_data[0][2],
-                       aTransformation.m_data[1][2] );
-
-    cairo_transform( currentContext, &cairoTransformation );
-}
-
-
-void CAIRO_GAL::Rotate( double aAngle )
-{
-    storePath();
-
-    if( isGrouping )
-    {
-        GROUP_ELEMENT groupElement;
-        groupElement.command = CMD_ROTATE;
-        groupElement.argument.dblArg[0] = aAngle;
-        currentGroup->push_back( groupElement );
-    }
-    else
-    {
-        cairo_rotate( currentContext, aAngle );
-    }
-}
-
-
-void CAIRO_GAL::Translate( const VECTOR2D& aTranslation )
-{
-    storePath();
-
-    if( isGrouping )
-    {
-        GROUP_ELEMENT groupElement;
-        groupElement.command = CMD_TRANSLATE;
-        groupElement.argument.dblArg[0] = aTranslation.x;
-        groupElement.argument.dblArg[1] = aTranslation.y;
-        currentGroup->push_back( groupElement );
-    }
-    else
-    {
-        cairo_translate( currentContext, aTranslation.x, aTranslation.y );
-    }
-}
-
-
-void CAIRO_GAL::Scale( const VECTOR2D& aScale )
-{
-    storePath();
-
-    if( isGrouping )
-    {
-        GROUP_ELEMENT groupElement;
-        groupElement.command = CMD_SCALE;
-        groupElement.argument.dblArg[0] = aScale.x;
-        groupElement.argument.dblArg[1] = aScale.y;
-        currentGroup->push_back( groupElement );
-    }
-    else
-    {
-        cairo_scale( currentContext, aScale.x, aScale.y );
-    }
-}
-
-
-void CAIRO_GAL::Save()
-{
-    storePath();
-
-    if( isGrouping )
-    {
-        GROUP_ELEMENT groupElement;
-        groupElement.command = CMD_SAVE;
-        currentGroup->push_back( groupElement );
-    }
-    else
-    {
-        cairo_save( currentContext );
-    }
-}
-
-
-void CAIRO_GAL::Restore()
-{
-    storePath();
-
-    if( isGrouping )
-    {
-        GROUP_ELEMENT groupElement;
-        groupElement.command = CMD_RESTORE;
-        currentGroup->push_back( groupElement );
-    }
-    else
-    {
-        cairo_restore( currentContext );
-    }
-}
-
-
-int CAIRO_GAL::BeginGroup()
-{
-    initSurface();
-
-    // If the grouping is started: the actual path is stored in the group, when
-    // a attribute was changed or when grouping stops with the end group method.
-    storePath();
-
-    GROUP group;
-    int groupNumber = getNewGroupNumber();
-    groups.insert( std::make_pair( groupNumber, group ) );
-    currentGroup = &groups[groupNumber];
-    isGrouping   = true;
-
-    return groupNumber;
-}
-
-
-void CAIRO_GAL::EndGroup()
-{
-    storePath();
-    isGrouping = false;
-
-    deinitSurface();
-}
-
-
-void CAIRO_GAL::DrawGroup( int aGroupNumber )
-{
-    // This method implements a small Virtual Machine - all stored commands
-    // are executed; nested calling is also possible
-
-    storePath();
-
-    for( GROUP::iterator it = groups[aGroupNumber].begin();
-         it != groups[aGroupNumber].end(); ++it )
-    {
-        switch( it->command )
-        {
-        case CMD_SET_FILL:
-            isFillEnabled = it->argument.boolArg;
-            break;
-
-        case CMD_SET_STROKE:
-            isStrokeEnabled = it->argument.boolArg;
-            break;
-
-        case CMD_SET_FILLCOLOR:
-            fillColor = COLOR4D( it->argument.dblArg[0], it->argument.dblArg[1], it->argument.dblArg[2],
-                                 it->argument.dblArg[3] );
-            break;
-
-        case CMD_SET_STROKECOLOR:
-            strokeColor = COLOR4D( it->argument.dblArg[0], it->argument.dblArg[1], it->argument.dblArg[2],
-                                   it->argument.dblArg[3] );
-            break;
-
-        case CMD_SET_LINE_WIDTH:
-            {
-                // Make lines appear at least 1 pixel wide, no matter of zoom
-                double x = 1.0, y = 1.0;
-                cairo_device_to_user_distance( currentContext, &x, &y );
-                double minWidth = std::min( fabs( x ), fabs( y ) );
-                cairo_set_line_width( currentContext, std::max( it->argument.dblArg[0], minWidth ) );
-            }
-            break;
-
-
-        case CMD_STROKE_PATH:
-            cairo_set_source_rgb( currentContext, strokeColor.r, strokeColor.g, strokeColor.b );
-            cairo_append_path( currentContext, it->cairoPath );
-            cairo_stroke( currentContext );
-            break;
-
-        case CMD_FILL_PATH:
-            cairo_set_source_rgb( currentContext, fillColor.r, fillColor.g, fillColor.b );
-            cairo_append_path( currentContext, it->cairoPath );
-            cairo_fill( currentContext );
-            break;
-
-            /*
-        case CMD_TRANSFORM:
-            cairo_matrix_t matrix;
-            cairo_matrix_init( &matrix, it->argument.dblArg[0], it->argument.dblArg[1], it->argument.dblArg[2],
-                               it->argument.dblArg[3], it->argument.dblArg[4], it->argument.dblArg[5] );
-            cairo_transform( currentContext, &matrix );
-            break;
-            */
-
-        case CMD_ROTATE:
-            cairo_rotate( currentContext, it->argument.dblArg[0] );
-            break;
-
-        case CMD_TRANSLATE:
-            cairo_translate( currentContext, it->argument.dblArg[0], it->argument.dblArg[1] );
-            break;
-
-        case CMD_SCALE:
-            cairo_scale( currentContext, it->argument.dblArg[0], it->argument.dblArg[1] );
-            break;
-
-        case CMD_SAVE:
-            cairo_save( currentContext );
-            break;
-
-        case CMD_RESTORE:
-            cairo_restore( currentContext );
-            break;
-
-        case CMD_CALL_GROUP:
-            DrawGroup( it->argument.intArg );
-            break;
-        }
-    }
-}
-
-
-void CAIRO_GAL::ChangeGroupColor( int aGroupNumber, const COLOR4D& aNewColor )
-{
-    storePath();
-
-    for( GROUP::iterator it = groups[aGroupNumber].begin();
-         it != groups[aGroupNumber].end(); ++it )
-    {
-        if( it->command == CMD_SET_FILLCOLOR || it->command == CMD_SET_STROKECOLOR )
-        {
-            it->argument.dblArg[0] = aNewColor.r;
-            it->argument.dblArg[1] = aNewColor.g;
-            it->argument.dblArg[2] = aNewColor.b;
-            it->argument.dblArg[3] = aNewColor.a;
-        }
-    }
-}
-
-
-void CAIRO_GAL::ChangeGroupDepth( int aGroupNumber, int aDepth )
-{
-    // Cairo does not have any possibilities to change the depth coordinate of stored items,
-    // it depends only on the order of drawing
-}
-
-
-void CAIRO_GAL::DeleteGroup( int aGroupNumber )
-{
-    storePath();
-
-    // Delete the Cairo paths
-    std::deque<GROUP_ELEMENT>::iterator it, end;
-
-    for( it = groups[aGroupNumber].begin(), end = groups[aGroupNumber].end(); it != end; ++it )
-    {
-        if( it->command == CMD_FILL_PATH || it->command == CMD_STROKE_PATH )
-        {
-            cairo_path_destroy( it->cairoPath );
-        }
-    }
-
-    // Delete the group
-    groups.erase( aGroupNumber );
-}
-
-
-void CAIRO_GAL::ClearCache()
-{
-    for( int i = groups.size() - 1; i >= 0; --i )
-    {
-        DeleteGroup( i );
-    }
-}
-
-
 void CAIRO_GAL::SaveScreen()
 {
     // Copy the current bitmap to the backup buffer
@@ -726,66 +208,6 @@ void CAIRO_GAL::RestoreScreen()
 }
 
 
-void CAIRO_GAL::SetTarget( RENDER_TARGET aTarget )
-{
-    // If the compositor is not set, that means that there is a recaching process going on
-    // and we do not need the compositor now
-    if( !validCompositor )
-        return;
-
-    // Cairo grouping prevents display of overlapping items on the same layer in the lighter color
-    if( isInitialized )
-        storePath();
-
-    switch( aTarget )
-    {
-    default:
-    case TARGET_CACHED:
-    case TARGET_NONCACHED:
-        compositor->SetBuffer( mainBuffer );
-        break;
-
-    case TARGET_OVERLAY:
-        compositor->SetBuffer( overlayBuffer );
-        break;
-    }
-
-    currentTarget = aTarget;
-}
-
-
-RENDER_TARGET CAIRO_GAL::GetTarget() const
-{
-    return currentTarget;
-}
-
-
-void CAIRO_GAL::ClearTarget( RENDER_TARGET aTarget )
-{
-    // Save the current state
-    unsigned int currentBuffer = compositor->GetBuffer();
-
-    switch( aTarget )
-    {
-    // Cached and noncached items are rendered to the same buffer
-    default:
-    case TARGET_CACHED:
-    case TARGET_NONCACHED:
-        compositor->SetBuffer( mainBuffer );
-        break;
-
-    case TARGET_OVERLAY:
-        compositor->SetBuffer( overlayBuffer );
-        break;
-    }
-
-    compositor->ClearBuffer();
-
-    // Restore the previous state
-    compositor->SetBuffer( currentBuffer );
-}
-
-
 void CAIRO_GAL::SetCursorSize( unsigned int aCursorSize )
 {
     GAL::SetCursorSize( aCursorSize );
@@ -799,85 +221,6 @@ void CAIRO_GAL::DrawCursor( const VECTOR2D& aCursorPosition )
 }
 
 
-void CAIRO_GAL::drawGridLine( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint )
-{
-    cairo_move_to( currentContext, aStartPoint.x, aStartPoint.y );
-    cairo_line_to( currentContext, aEndPoint.x, aEndPoint.y );
-    cairo_set_source_rgba( currentContext, gridColor.r, gridColor.g, gridColor.b, strokeColor.a );
-    cairo_stroke( currentContext );
-}
-
-
-void CAIRO_GAL::flushPath()
-{
-        if( isFillEnabled )
-        {
-            cairo_set_source_rgba( currentContext,
-                    fillColor.r, fillColor.g, fillColor.b, fillColor.a );
-
-            if( isStrokeEnabled )
-                cairo_fill_preserve( currentContext );
-            else
-                cairo_fill( currentContext );
-        }
-
-        if( isStrokeEnabled )
-        {
-            cairo_set_source_rgba( currentContext,
-                    strokeColor.r, strokeColor.g, strokeColor.b, strokeColor.a );
-            cairo_stroke( currentContext );
-        }
-}
-
-
-void CAIRO_GAL::storePath()
-{
-    if( isElementAdded )
-    {
-        isElementAdded = false;
-
-        if( !isGrouping )
-        {
-            if( isFillEnabled )
-            {
-                cairo_set_source_rgb( currentContext, fillColor.r, fillColor.g, fillColor.b );
-                cairo_fill_preserve( currentContext );
-            }
-
-            if( isStrokeEnabled )
-            {
-                cairo_set_source_rgb( currentContext, strokeColor.r, strokeColor.g,
-                                      strokeColor.b );
-                cairo_stroke_preserve( currentContext );
-            }
-        }
-        else
-        {
-            // Copy the actual path, append it to the global path list
-            // then check, if the path needs to be stroked/filled and
-            // add this command to the group list;
-            if( isStrokeEnabled )
-            {
-                GROUP_ELEMENT groupElement;
-                groupElement.cairoPath = cairo_copy_path( currentContext );
-                groupElement.command   = CMD_STROKE_PATH;
-                currentGroup->push_back( groupElement );
-            }
-
-            if( isFillEnabled )
-            {
-                GROUP_ELEMENT groupElement;
-                groupElement.cairoPath = cairo_copy_path( currentContext );
-                groupElement.command   = CMD_FILL_PATH;
-                currentGroup->push_back( groupElement );
-            }
-        }
-
-        cairo_new_path( currentContext );
-    }
-}
-
-
 void CAIRO_GAL::onPaint( wxPaintEvent& WXUNUSED( aEvent ) )
 {
     PostPaint();
@@ -1009,83 +352,3 @@ void CAIRO_GAL::deinitSurface()
 
     isInitialized = false;
 }
-
-
-void CAIRO_GAL::setCompositor()
-{
-    // Recreate the compositor with the new Cairo context
-    compositor.reset( new CAIRO_COMPOSITOR( &currentContext ) );
-    compositor->Resize( screenSize.x, screenSize.y );
-
-    // Prepare buffers
-    mainBuffer = compositor->CreateBuffer();
-    overlayBuffer = compositor->CreateBuffer();
-
-    validCompositor = true;
-}
-
-
-void CAIRO_GAL::drawPoly( const std::deque<VECTOR2D>& aPointList )
-{
-    // Iterate over the point list and draw the segments
-    std::deque<VECTOR2D>::const_iterator it = aPointList.begin();
-
-    cairo_move_to( currentContext, it->x, it->y );
-
-    for( ++it; it != aPointList.end(); ++it )
-    {
-        cairo_line_to( currentContext, it->x, it->y );
-    }
-
-    flushPath();
-    isElementAdded = true;
-}
-
-
-void CAIRO_GAL::drawPoly( const VECTOR2D aPointList[], int aListSize )
-{
-    // Iterate over the point list and draw the segments
-    const VECTOR2D* ptr = aPointList;
-
-    cairo_move_to( currentContext, ptr->x, ptr->y );
-
-    for( int i = 0; i < aListSize; ++i )
-    {
-        ++ptr;
-        cairo_line_to( currentContext, ptr->x, ptr->y );
-    }
-
-    flushPath();
-    isElementAdded = true;
-}
-
-
-void CAIRO_GAL::drawPoly( const SHAPE_LINE_CHAIN& aLineChain )
-{
-    if( aLineChain.PointCount() < 2 )
-        return;
-
-    const VECTOR2I start = aLineChain.CPoint( 0 );
-    cairo_move_to( currentContext, start.x, start.y );
-
-    for( int i = 1; i < aLineChain.PointCount(); ++i )
-    {
-        const VECTOR2I& p = aLineChain.CPoint( i );
-        cairo_line_to( currentContext, p.x, p.y );
-    }
-
-    flushPath();
-    isElementAdded = true;
-}
-
-
-unsigned int CAIRO_GAL::getNewGroupNumber()
-{
-    wxASSERT_MSG( groups.size() < std::numeric_limits<unsigned int>::max(),
-                  wxT( "There are no free slots to store a group" ) );
-
-    while( groups.find( groupCounter ) != groups.end() )
-        groupCounter++;
-
-    return groupCounter++;
-}
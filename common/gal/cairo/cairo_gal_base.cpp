@@ -0,0 +1,932 @@
+/*
+ * This program source code file is part of KICAD, a free EDA CAD application.
+ *
+ * Copyright (C) 2012 Torsten Hueter, torstenhtr <at> gmx.de
+ * Copyright (C) 2012-2017 Kicad Developers, see change_log.txt for contributors.
+ * Copyright (C) 2017 CERN
+ * @author Maciej Suminski <maciej.suminski@cern.ch>
+ *
+ * Drawing part of the Cairo Graphics Abstraction Layer
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <wx/log.h>
+
+#include <gal/cairo/cairo_gal_base.h>
+#include <gal/cairo/cairo_compositor.h>
+#include <gal/definitions.h>
+#include <geometry/shape_poly_set.h>
+
+#include <limits>
+
+#ifdef USE_OPENMP
+#include <omp.h>
+#endif /* USE_OPENMP */
+
+using namespace KIGFX;
+
+
+CAIRO_GAL_BASE::CAIRO_GAL_BASE()
+{
+    // Initialize the flags
+    isGrouping          = false;
+    isElementAdded      = false;
+    isInitialized       = false;
+    groupCounter        = 0;
+    currentGroup        = NULL;
+    currentContext      = NULL;
+    validCompositor     = false;
+    buffersPreserved    = false;
+    isClipped           = false;
+    currentTarget       = TARGET_CACHED;
+}
+
+
+CAIRO_GAL_BASE::~CAIRO_GAL_BASE()
+{
+    ClearCache();
+}
+
+
+void CAIRO_GAL_BASE::SetContext( cairo_t* aContext )
+{
+    currentContext = aContext;
+    isInitialized = ( aContext != NULL );
+    isElementAdded = false;
+}
+
+
+void CAIRO_GAL_BASE::copyViewSettings( CAIRO_GAL_BASE& aTarget ) const
+{
+    aTarget.screenSize          = screenSize;
+    aTarget.worldUnitLength     = worldUnitLength;
+    aTarget.screenDPI           = screenDPI;
+    aTarget.lookAtPoint         = lookAtPoint;
+    aTarget.zoomFactor          = zoomFactor;
+    aTarget.worldScreenMatrix   = worldScreenMatrix;
+    aTarget.screenWorldMatrix   = screenWorldMatrix;
+    aTarget.worldScale          = worldScale;
+    aTarget.globalFlipX         = globalFlipX;
+    aTarget.globalFlipY         = globalFlipY;
+    aTarget.depthRange          = depthRange;
+    aTarget.backgroundColor     = backgroundColor;
+}
+
+
+void CAIRO_GAL_BASE::DrawLine( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint )
+{
+    cairo_move_to( currentContext, aStartPoint.x, aStartPoint.y );
+    cairo_line_to( currentContext, aEndPoint.x, aEndPoint.y );
+    flushPath();
+    isElementAdded = true;
+}
+
+
+void CAIRO_GAL_BASE::DrawSegment( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint,
+                             double aWidth )
+{
+    if( isFillEnabled )
+    {
+        // Filled tracks mode
+        SetLineWidth( aWidth );
+
+        cairo_move_to( currentContext, (double) aStartPoint.x, (double) aStartPoint.y );
+        cairo_line_to( currentContext, (double) aEndPoint.x, (double) aEndPoint.y );
+        cairo_set_source_rgba( currentContext, fillColor.r, fillColor.g, fillColor.b, fillColor.a );
+        cairo_stroke( currentContext );
+    }
+    else
+    {
+        // Outline mode for tracks
+        VECTOR2D startEndVector = aEndPoint - aStartPoint;
+        double   lineAngle      = atan2( startEndVector.y, startEndVector.x );
+        double   lineLength     = startEndVector.EuclideanNorm();
+
+        cairo_save( currentContext );
+
+        cairo_translate( currentContext, aStartPoint.x, aStartPoint.y );
+        cairo_rotate( currentContext, lineAngle );
+
+        cairo_arc( currentContext, 0.0,        0.0, aWidth / 2.0,  M_PI / 2.0, 3.0 * M_PI / 2.0 );
+        cairo_arc( currentContext, lineLength, 0.0, aWidth / 2.0, -M_PI / 2.0, M_PI / 2.0 );
+
+        cairo_move_to( currentContext, 0.0,        aWidth / 2.0 );
+        cairo_line_to( currentContext, lineLength, aWidth / 2.0 );
+
+        cairo_move_to( currentContext, 0.0,        -aWidth / 2.0 );
+        cairo_line_to( currentContext, lineLength, -aWidth / 2.0 );
+
+        cairo_restore( currentContext );
+        flushPath();
+    }
+
+    isElementAdded = true;
+}
+
+
+void CAIRO_GAL_BASE::DrawCircle( const VECTOR2D& aCenterPoint, double aRadius )
+{
+    cairo_new_sub_path( currentContext );
+    cairo_arc( currentContext, aCenterPoint.x, aCenterPoint.y, aRadius, 0.0, 2 * M_PI );
+    flushPath();
+    isElementAdded = true;
+}
+
+
+void CAIRO_GAL_BASE::DrawArc( const VECTOR2D& aCenterPoint, double aRadius, double aStartAngle,
+                         double aEndAngle )
+{
+    SWAP( aStartAngle, >, aEndAngle );
+
+    cairo_new_sub_path( currentContext );
+    cairo_arc( currentContext, aCenterPoint.x, aCenterPoint.y, aRadius, aStartAngle, aEndAngle );
+
+    if( isFillEnabled )
+    {
+        VECTOR2D startPoint( cos( aStartAngle ) * aRadius + aCenterPoint.x,
+                             sin( aStartAngle ) * aRadius + aCenterPoint.y );
+        VECTOR2D endPoint( cos( aEndAngle ) * aRadius + aCenterPoint.x,
+                           sin( aEndAngle ) * aRadius + aCenterPoint.y );
+
+        cairo_move_to( currentContext, aCenterPoint.x, aCenterPoint.y );
+        cairo_line_to( currentContext, startPoint.x, startPoint.y );
+        cairo_line_to( currentContext, endPoint.x, endPoint.y );
+        cairo_close_path( currentContext );
+    }
+
+    flushPath();
+
+    isElementAdded = true;
+}
+
+
+void CAIRO_GAL_BASE::DrawRectangle( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint )
+{
+    // Calculate the diagonal points
+    VECTOR2D diagonalPointA( aEndPoint.x,  aStartPoint.y );
+    VECTOR2D diagonalPointB( aStartPoint.x, aEndPoint.y );
+
+    // The path is composed from 4 segments
+    cairo_move_to( currentContext, aStartPoint.x, aStartPoint.y );
+    cairo_line_to( currentContext, diagonalPointA.x, diagonalPointA.y );
+    cairo_line_to( currentContext, aEndPoint.x, aEndPoint.y );
+    cairo_line_to( currentContext, diagonalPointB.x, diagonalPointB.y );
+    cairo_close_path( currentContext );
+    flushPath();
+
+    isElementAdded = true;
+}
+
+
+void CAIRO_GAL_BASE::DrawPolylines( const VECTOR2D aPoints[], const int aPolylineSizes[],
+                               int aPolylineCount )
+{
+    // Filling a path made of several subpaths differs from filling them one by one
+    if( isFillEnabled )
+    {
+        GAL::DrawPolylines( aPoints, aPolylineSizes, aPolylineCount );
+        return;
+    }
+
+    // Build a single path, so all polylines are stroked at once
+    const VECTOR2D* ptr = aPoints;
+
+    for( int i = 0; i < aPolylineCount; ++i )
+    {
+        if( aPolylineSizes[i] > 0 )
+        {
+            cairo_move_to( currentContext, ptr->x, ptr->y );
+
+            for( int j = 1; j < aPolylineSizes[i]; ++j )
+                cairo_line_to( currentContext, ptr[j].x, ptr[j].y );
+        }
+
+        ptr += aPolylineSizes[i];
+    }
+
+    flushPath();
+    isElementAdded = true;
+}
+
+
+void CAIRO_GAL_BASE::DrawPolygon( const SHAPE_POLY_SET& aPolySet )
+{
+    for( int i = 0; i < aPolySet.OutlineCount(); ++i )
+        drawPoly( aPolySet.COutline( i ) );
+}
+
+
+void CAIRO_GAL_BASE::DrawCurve( const VECTOR2D& aStartPoint, const VECTOR2D& aControlPointA,
+                           const VECTOR2D& aControlPointB, const VECTOR2D& aEndPoint )
+{
+    cairo_move_to( currentContext, aStartPoint.x, aStartPoint.y );
+    cairo_curve_to( currentContext, aControlPointA.x, aControlPointA.y, aControlPointB.x,
+                    aControlPointB.y, aEndPoint.x, aEndPoint.y );
+    cairo_line_to( currentContext, aEndPoint.x, aEndPoint.y );
+
+    flushPath();
+    isElementAdded = true;
+}
+
+
+void CAIRO_GAL_BASE::Flush()
+{
+    storePath();
+}
+
+
+void CAIRO_GAL_BASE::ClearScreen( const COLOR4D& aColor )
+{
+    backgroundColor = aColor;
+    cairo_set_source_rgb( currentContext, aColor.r, aColor.g, aColor.b );
+    cairo_rectangle( currentContext, 0.0, 0.0, screenSize.x, screenSize.y );
+    cairo_fill( currentContext );
+}
+
+
+void CAIRO_GAL_BASE::SetIsFill( bool aIsFillEnabled )
+{
+    storePath();
+    isFillEnabled = aIsFillEnabled;
+
+    if( isGrouping )
+    {
+        GROUP_ELEMENT groupElement;
+        groupElement.command = CMD_SET_FILL;
+        groupElement.argument.boolArg = aIsFillEnabled;
+        currentGroup->push_back( groupElement );
+    }
+}
+
+
+void CAIRO_GAL_BASE::SetIsStroke( bool aIsStrokeEnabled )
+{
+    storePath();
+    isStrokeEnabled = aIsStrokeEnabled;
+
+    if( isGrouping )
+    {
+        GROUP_ELEMENT groupElement;
+        groupElement.command = CMD_SET_STROKE;
+        groupElement.argument.boolArg = aIsStrokeEnabled;
+        currentGroup->push_back( groupElement );
+    }
+}
+
+
+void CAIRO_GAL_BASE::SetStrokeColor( const COLOR4D& aColor )
+{
+    storePath();
+    strokeColor = aColor;
+
+    if( isGrouping )
+    {
+        GROUP_ELEMENT groupElement;
+        groupElement.command = CMD_SET_STROKECOLOR;
+        groupElement.argument.dblArg[0] = strokeColor.r;
+        groupElement.argument.dblArg[1] = strokeColor.g;
+        groupElement.argument.dblArg[2] = strokeColor.b;
+        groupElement.argument.dblArg[3] = strokeColor.a;
+        currentGroup->push_back( groupElement );
+    }
+}
+
+
+void CAIRO_GAL_BASE::SetFillColor( const COLOR4D& aColor )
+{
+    storePath();
+    fillColor = aColor;
+
+    if( isGrouping )
+    {
+        GROUP_ELEMENT groupElement;
+        groupElement.command = CMD_SET_FILLCOLOR;
+        groupElement.argument.dblArg[0] = fillColor.r;
+        groupElement.argument.dblArg[1] = fillColor.g;
+        groupElement.argument.dblArg[2] = fillColor.b;
+        groupElement.argument.dblArg[3] = fillColor.a;
+        currentGroup->push_back( groupElement );
+    }
+}
+
+
+void CAIRO_GAL_BASE::SetLineWidth( double aLineWidth )
+{
+    storePath();
+
+    lineWidth = aLineWidth;
+
+    if( isGrouping )
+    {
+        GROUP_ELEMENT groupElement;
+        groupElement.command = CMD_SET_LINE_WIDTH;
+        groupElement.argument.dblArg[0] = aLineWidth;
+        currentGroup->push_back( groupElement );
+    }
+    else
+    {
+        // Make lines appear at least 1 pixel wide, no matter of zoom
+        double x = 1.0, y = 1.0;
+        cairo_device_to_user_distance( currentContext, &x, &y );
+        double minWidth = std::min( fabs( x ), fabs( y ) );
+        cairo_set_line_width( currentContext, std::max( aLineWidth, minWidth ) );
+    }
+}
+
+
+void CAIRO_GAL_BASE::SetLayerDepth( double aLayerDepth )
+{
+    super::SetLayerDepth( aLayerDepth );
+
+    if( isInitialized )
+        storePath();
+}
+
+
+void CAIRO_GAL_BASE::Transform( const MATRIX3x3D& aTransformation )
+{
+    cairo_matrix_t cairoTransformation;
+
+    cairo_matrix_init( &cairoTransformation,
+                       aTransformation.m_data[0][0],
+                       aTransformation.m_data[1][0],
+                       aTransformation.m_data[0][1],
+                       aTransformation.m_data[1][1],
+                       aTransformation.m_data[0][2],
+                       aTransformation.m_data[1][2] );
+
+    cairo_transform( currentContext, &cairoTransformation );
+}
+
+
+void CAIRO_GAL_BASE::Rotate( double aAngle )
+{
+    storePath();
+
+    if( isGrouping )
+    {
+        GROUP_ELEMENT groupElement;
+        groupElement.command = CMD_ROTATE;
+        groupElement.argument.dblArg[0] = aAngle;
+        currentGroup->push_back( groupElement );
+    }
+    else
+    {
+        cairo_rotate( currentContext, aAngle );
+    }
+}
+
+
+void CAIRO_GAL_BASE::Translate( const VECTOR2D& aTranslation )
+{
+    storePath();
+
+    if( isGrouping )
+    {
+        GROUP_ELEMENT groupElement;
+        groupElement.command = CMD_TRANSLATE;
+        groupElement.argument.dblArg[0] = aTranslation.x;
+        groupElement.argument.dblArg[1] = aTranslation.y;
+        currentGroup->push_back( groupElement );
+    }
+    else
+    {
+        cairo_translate( currentContext, aTranslation.x, aTranslation.y );
+    }
+}
+
+
+void CAIRO_GAL_BASE::Scale( const VECTOR2D& aScale )
+{
+    storePath();
+
+    if( isGrouping )
+    {
+        GROUP_ELEMENT groupElement;
+        groupElement.command = CMD_SCALE;
+        groupElement.argument.dblArg[0] = aScale.x;
+        groupElement.argument.dblArg[1] = aScale.y;
+        currentGroup->push_back( groupElement );
+    }
+    else
+    {
+        cairo_scale( currentContext, aScale.x, aScale.y );
+    }
+}
+
+
+void CAIRO_GAL_BASE::Save()
+{
+    storePath();
+
+    if( isGrouping )
+    {
+        GROUP_ELEMENT groupElement;
+        groupElement.command = CMD_SAVE;
+        currentGroup->push_back( groupElement );
+    }
+    else
+    {
+        cairo_save( currentContext );
+    }
+}
+
+
+void CAIRO_GAL_BASE::Restore()
+{
+    storePath();
+
+    if( isGrouping )
+    {
+        GROUP_ELEMENT groupElement;
+        groupElement.command = CMD_RESTORE;
+        currentGroup->push_back( groupElement );
+    }
+    else
+    {
+        cairo_restore( currentContext );
+    }
+}
+
+
+void CAIRO_GAL_BASE::SetTarget( RENDER_TARGET aTarget )
+{
+    // If the compositor is not set, that means that there is a recaching process going on
+    // and we do not need the compositor now
+    if( !validCompositor )
+        return;
+
+    // Cairo grouping prevents display of overlapping items on the same layer in the lighter color
+    if( isInitialized )
+        storePath();
+
+    switch( aTarget )
+    {
+    default:
+    case TARGET_CACHED:
+    case TARGET_NONCACHED:
+        compositor->SetBuffer( mainBuffer );
+        break;
+
+    case TARGET_OVERLAY:
+        compositor->SetBuffer( overlayBuffer );
+        break;
+    }
+
+    currentTarget = aTarget;
+}
+
+
+RENDER_TARGET CAIRO_GAL_BASE::GetTarget() const
+{
+    return currentTarget;
+}
+
+
+void CAIRO_GAL_BASE::ClearTarget( RENDER_TARGET aTarget )
+{
+    // Save the current state
+    unsigned int currentBuffer = compositor->GetBuffer();
+
+    switch( aTarget )
+    {
+    // Cached and noncached items are rendered to the same buffer
+    default:
+    case TARGET_CACHED:
+    case TARGET_NONCACHED:
+        compositor->SetBuffer( mainBuffer );
+        break;
+
+    case TARGET_OVERLAY:
+        compositor->SetBuffer( overlayBuffer );
+        break;
+    }
+
+    compositor->ClearBuffer();
+
+    // Restore the previous state
+    compositor->SetBuffer( currentBuffer );
+}
+
+
+int CAIRO_GAL_BASE::GetTileCount() const
+{
+    // If the compositor is not set, there is no target to be split
+    if( !validCompositor )
+        return 0;
+
+    return compositor->GetTileCount();
+}
+
+
+GAL* CAIRO_GAL_BASE::GetTile( int aIndex, BOX2I& aArea )
+{
+    wxASSERT( aIndex >= 0 && aIndex < GetTileCount() );
+
+    // Tiles draw to the same pixel storage, so the pending path has to go first
+    if( isInitialized )
+        storePath();
+
+    while( (int) tiles.size() <= aIndex )
+        tiles.emplace_back( new CAIRO_GAL_BASE );
+
+    CAIRO_GAL_BASE* tile = tiles[aIndex].get();
+
+    copyViewSettings( *tile );
+    tile->SetContext( compositor->GetTileContext( aIndex ) );
+    aArea = compositor->GetTileArea( aIndex );
+
+    return tile;
+}
+
+
+bool CAIRO_GAL_BASE::SetClipArea( const BOX2I& aArea )
+{
+    // Freshly created buffers do not contain anything to be preserved
+    if( !validCompositor || !buffersPreserved )
+        return false;
+
+    // The pending path has to be drawn without the new clip area
+    if( isInitialized )
+        storePath();
+
+    unsigned int currentBuffer = compositor->GetBuffer();
+    compositor->SetBuffer( mainBuffer );
+    compositor->SetClipArea( aArea );
+    compositor->SetBuffer( currentBuffer );
+    isClipped = true;
+
+    return true;
+}
+
+
+int CAIRO_GAL_BASE::BeginGroup()
+{
+    initSurface();
+
+    // If the grouping is started: the actual path is stored in the group, when
+    // a attribute was changed or when grouping stops with the end group method.
+    storePath();
+
+    GROUP group;
+    int groupNumber = getNewGroupNumber();
+    groups.insert( std::make_pair( groupNumber, group ) );
+    currentGroup = &groups[groupNumber];
+    isGrouping   = true;
+
+    return groupNumber;
+}
+
+
+void CAIRO_GAL_BASE::EndGroup()
+{
+    storePath();
+    isGrouping = false;
+
+    deinitSurface();
+}
+
+
+void CAIRO_GAL_BASE::DrawGroup( int aGroupNumber )
+{
+    // This method implements a small Virtual Machine - all stored commands
+    // are executed; nested calling is also possible
+
+    storePath();
+
+    for( GROUP::iterator it = groups[aGroupNumber].begin();
+         it != groups[aGroupNumber].end(); ++it )
+    {
+        switch( it->command )
+        {
+        case CMD_SET_FILL:
+            isFillEnabled = it->argument.boolArg;
+            break;
+
+        case CMD_SET_STROKE:
+            isStrokeEnabled = it->argument.boolArg;
+            break;
+
+        case CMD_SET_FILLCOLOR:
+            fillColor = COLOR4D( it->argument.dblArg[0], it->argument.dblArg[1], it->argument.dblArg[2],
+                                 it->argument.dblArg[3] );
+            break;
+
+        case CMD_SET_STROKECOLOR:
+            strokeColor = COLOR4D( it->argument.dblArg[0], it->argument.dblArg[1], it->argument.dblArg[2],
+                                   it->argument.dblArg[3] );
+            break;
+
+        case CMD_SET_LINE_WIDTH:
+            {
+                // Make lines appear at least 1 pixel wide, no matter of zoom
+                double x = 1.0, y = 1.0;
+                cairo_device_to_user_distance( currentContext, &x, &y );
+                double minWidth = std::min( fabs( x ), fabs( y ) );
+                cairo_set_line_width( currentContext, std::max( it->argument.dblArg[0], minWidth ) );
+            }
+            break;
+
+
+        case CMD_STROKE_PATH:
+            cairo_set_source_rgb( currentContext, strokeColor.r, strokeColor.g, strokeColor.b );
+            cairo_append_path( currentContext, it->cairoPath );
+            cairo_stroke( currentContext );
+            break;
+
+        case CMD_FILL_PATH:
+            cairo_set_source_rgb( currentContext, fillColor.r, fillColor.g, fillColor.b );
+            cairo_append_path( currentContext, it->cairoPath );
+            cairo_fill( currentContext );
+            break;
+
+            /*
+        case CMD_TRANSFORM:
+            cairo_matrix_t matrix;
+            cairo_matrix_init( &matrix, it->argument.dblArg[0], it->argument.dblArg[1], it->argument.dblArg[2],
+                               it->argument.dblArg[3], it->argument.dblArg[4], it->argument.dblArg[5] );
+            cairo_transform( currentContext, &matrix );
+            break;
+            */
+
+        case CMD_ROTATE:
+            cairo_rotate( currentContext, it->argument.dblArg[0] );
+            break;
+
+        case CMD_TRANSLATE:
+            cairo_translate( currentContext, it->argument.dblArg[0], it->argument.dblArg[1] );
+            break;
+
+        case CMD_SCALE:
+            cairo_scale( currentContext, it->argument.dblArg[0], it->argument.dblArg[1] );
+            break;
+
+        case CMD_SAVE:
+            cairo_save( currentContext );
+            break;
+
+        case CMD_RESTORE:
+            cairo_restore( currentContext );
+            break;
+
+        case CMD_CALL_GROUP:
+            DrawGroup( it->argument.intArg );
+            break;
+        }
+    }
+}
+
+
+void CAIRO_GAL_BASE::ChangeGroupColor( int aGroupNumber, const COLOR4D& aNewColor )
+{
+    storePath();
+
+    for( GROUP::iterator it = groups[aGroupNumber].begin();
+         it != groups[aGroupNumber].end(); ++it )
+    {
+        if( it->command == CMD_SET_FILLCOLOR || it->command == CMD_SET_STROKECOLOR )
+        {
+            it->argument.dblArg[0] = aNewColor.r;
+            it->argument.dblArg[1] = aNewColor.g;
+            it->argument.dblArg[2] = aNewColor.b;
+            it->argument.dblArg[3] = aNewColor.a;
+        }
+    }
+}
+
+
+void CAIRO_GAL_BASE::ChangeGroupDepth( int aGroupNumber, int aDepth )
+{
+    // Cairo does not have any possibilities to change the depth coordinate of stored items,
+    // it depends only on the order of drawing
+}
+
+
+void CAIRO_GAL_BASE::DeleteGroup( int aGroupNumber )
+{
+    storePath();
+
+    // Delete the Cairo paths
+    std::deque<GROUP_ELEMENT>::iterator it, end;
+
+    for( it = groups[aGroupNumber].begin(), end = groups[aGroupNumber].end(); it != end; ++it )
+    {
+        if( it->command == CMD_FILL_PATH || it->command == CMD_STROKE_PATH )
+        {
+            cairo_path_destroy( it->cairoPath );
+        }
+    }
+
+    // Delete the group
+    groups.erase( aGroupNumber );
+}
+
+
+void CAIRO_GAL_BASE::ClearCache()
+{
+    for( int i = groups.size() - 1; i >= 0; --i )
+    {
+        DeleteGroup( i );
+    }
+}
+
+
+void CAIRO_GAL_BASE::drawGridLine( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint )
+{
+    cairo_move_to( currentContext, aStartPoint.x, aStartPoint.y );
+    cairo_line_to( currentContext, aEndPoint.x, aEndPoint.y );
+    cairo_set_source_rgba( currentContext, gridColor.r, gridColor.g, gridColor.b, strokeColor.a );
+    cairo_stroke( currentContext );
+}
+
+
+void CAIRO_GAL_BASE::flushPath()
+{
+        if( isFillEnabled )
+        {
+            cairo_set_source_rgba( currentContext,
+                    fillColor.r, fillColor.g, fillColor.b, fillColor.a );
+
+            if( isStrokeEnabled )
+                cairo_fill_preserve( currentContext );
+            else
+                cairo_fill( currentContext );
+        }
+
+        if( isStrokeEnabled )
+        {
+            cairo_set_source_rgba( currentContext,
+                    strokeColor.r, strokeColor.g, strokeColor.b, strokeColor.a );
+            cairo_stroke( currentContext );
+        }
+}
+
+
+void CAIRO_GAL_BASE::storePath()
+{
+    if( isElementAdded )
+    {
+        isElementAdded = false;
+
+        if( !isGrouping )
+        {
+            if( isFillEnabled )
+            {
+                cairo_set_source_rgb( currentContext, fillColor.r, fillColor.g, fillColor.b );
+                cairo_fill_preserve( currentContext );
+            }
+
+            if( isStrokeEnabled )
+            {
+                cairo_set_source_rgb( currentContext, strokeColor.r, strokeColor.g,
+                                      strokeColor.b );
+                cairo_stroke_preserve( currentContext );
+            }
+        }
+        else
+        {
+            // Copy the actual path, append it to the global path list
+            // then check, if the path needs to be stroked/filled and
+            // add this command to the group list;
+            if( isStrokeEnabled )
+            {
+                GROUP_ELEMENT groupElement;
+                groupElement.cairoPath = cairo_copy_path( currentContext );
+                groupElement.command   = CMD_STROKE_PATH;
+                currentGroup->push_back( groupElement );
+            }
+
+            if( isFillEnabled )
+            {
+                GROUP_ELEMENT groupElement;
+                groupElement.cairoPath = cairo_copy_path( currentContext );
+                groupElement.command   = CMD_FILL_PATH;
+                currentGroup->push_back( groupElement );
+            }
+        }
+
+        cairo_new_path( currentContext );
+    }
+}
+
+
+void CAIRO_GAL_BASE::drawPoly( const std::deque<VECTOR2D>& aPointList )
+{
+    // Iterate over the point list and draw the segments
+    std::deque<VECTOR2D>::const_iterator it = aPointList.begin();
+
+    cairo_move_to( currentContext, it->x, it->y );
+
+    for( ++it; it != aPointList.end(); ++it )
+    {
+        cairo_line_to( currentContext, it->x, it->y );
+    }
+
+    flushPath();
+    isElementAdded = true;
+}
+
+
+void CAIRO_GAL_BASE::drawPoly( const VECTOR2D aPointList[], int aListSize )
+{
+    // Iterate over the point list and draw the segments
+    const VECTOR2D* ptr = aPointList;
+
+    cairo_move_to( currentContext, ptr->x, ptr->y );
+
+    for( int i = 1; i < aListSize; ++i )
+    {
+        ++ptr;
+        cairo_line_to( currentContext, ptr->x, ptr->y );
+    }
+
+    flushPath();
+    isElementAdded = true;
+}
+
+
+void CAIRO_GAL_BASE::drawPoly( const SHAPE_LINE_CHAIN& aLineChain )
+{
+    if( aLineChain.PointCount() < 2 )
+        return;
+
+    const VECTOR2I start = aLineChain.CPoint( 0 );
+    cairo_move_to( currentContext, start.x, start.y );
+
+    for( int i = 1; i < aLineChain.PointCount(); ++i )
+    {
+        const VECTOR2I& p = aLineChain.CPoint( i );
+        cairo_line_to( currentContext, p.x, p.y );
+    }
+
+    flushPath();
+    isElementAdded = true;
+}
+
+
+unsigned int CAIRO_GAL_BASE::getNewGroupNumber()
+{
+    wxASSERT_MSG( groups.size() < std::numeric_limits<unsigned int>::max(),
+                  wxT( "There are no free slots to store a group" ) );
+
+    while( groups.find( groupCounter ) != groups.end() )
+        groupCounter++;
+
+    return groupCounter++;
+}
+
+
+void CAIRO_GAL_BASE::setCompositor()
+{
+    // Recreate the compositor with the new Cairo context
+    compositor.reset( new CAIRO_COMPOSITOR( &currentContext ) );
+    compositor->Resize( screenSize.x, screenSize.y );
+
+    // Prepare buffers
+    mainBuffer = compositor->CreateBuffer();
+    overlayBuffer = compositor->CreateBuffer();
+
+    // Split the screen into tiles, so it may be rendered by all the available threads.
+    // Using more tiles than threads balances the load when some parts of the screen are
+    // more crowded than others.
+#ifdef USE_OPENMP
+    int threadCount = omp_get_max_threads();
+
+    if( threadCount > 1 )
+        compositor->SetTileCount( TILES_PER_THREAD * threadCount );
+#endif /* USE_OPENMP */
+
+    validCompositor = true;
+    buffersPreserved = false;
+    isClipped = false;
+}
+
+
+void CAIRO_GAL_BASE::finishBuffers()
+{
+    if( isClipped )
+    {
+        unsigned int currentBuffer = compositor->GetBuffer();
+        compositor->SetBuffer( mainBuffer );
+        compositor->SetClipArea( BOX2I() );
+        compositor->SetBuffer( currentBuffer );
+        isClipped = false;
+    }
+
+    buffersPreserved = true;
+}
@@ -0,0 +1,184 @@
+/*
+ * This program source code file is part of KICAD, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 CERN
+ * Copyright (C) 2017 Kicad Developers, see change_log.txt for contributors.
+ *
+ * Offscreen Cairo Graphics Abstraction Layer
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <wx/log.h>
+
+#include <gal/cairo/cairo_image_gal.h>
+#include <gal/cairo/cairo_compositor.h>
+#include <frame_profiler.h>
+
+using namespace KIGFX;
+
+
+CAIRO_IMAGE_GAL::CAIRO_IMAGE_GAL( int aWidth, int aHeight )
+{
+    context = NULL;
+    surface = NULL;
+    stride = 0;
+    tileCount = -1;
+
+    // Grid color settings are the same as in CAIRO_GAL
+    SetGridColor( COLOR4D( 0.1, 0.1, 0.1, 0.8 ) );
+
+    screenSize = VECTOR2I( aWidth, aHeight );
+    allocateBitmap();
+}
+
+
+CAIRO_IMAGE_GAL::~CAIRO_IMAGE_GAL()
+{
+    deinitSurface();
+}
+
+
+void CAIRO_IMAGE_GAL::BeginDrawing()
+{
+    initSurface();
+
+    if( !validCompositor )
+    {
+        setCompositor();
+
+        if( tileCount >= 0 )
+            compositor->SetTileCount( tileCount );
+    }
+
+    compositor->SetMainContext( context );
+    compositor->SetBuffer( mainBuffer );
+}
+
+
+void CAIRO_IMAGE_GAL::EndDrawing()
+{
+    FRAME_PROFILER_SCOPE profilerScope( FRAME_PROFILER::GAL_COMPOSITE );
+
+    // Force remaining objects to be drawn
+    Flush();
+    finishBuffers();
+
+    // Merge buffers into the image
+    compositor->DrawBuffer( mainBuffer );
+    compositor->DrawBuffer( overlayBuffer );
+
+    deinitSurface();
+}
+
+
+void CAIRO_IMAGE_GAL::ResizeScreen( int aWidth, int aHeight )
+{
+    deinitSurface();
+
+    screenSize = VECTOR2I( aWidth, aHeight );
+    allocateBitmap();
+
+    if( validCompositor )
+        compositor->Resize( aWidth, aHeight );
+
+    validCompositor = false;
+}
+
+
+void CAIRO_IMAGE_GAL::SetTileCount( int aCount )
+{
+    tileCount = aCount;
+    validCompositor = false;
+}
+
+
+bool CAIRO_IMAGE_GAL::SaveImage( const std::string& aFileName ) const
+{
+    cairo_surface_t* image = cairo_image_surface_create_for_data(
+            (unsigned char*) bitmapBuffer.data(), GAL_FORMAT,
+            screenSize.x, screenSize.y, stride );
+    cairo_status_t status = cairo_surface_write_to_png( image, aFileName.c_str() );
+    cairo_surface_destroy( image );
+
+    return status == CAIRO_STATUS_SUCCESS;
+}
+
+
+void CAIRO_IMAGE_GAL::allocateBitmap()
+{
+    stride = cairo_format_stride_for_width( GAL_FORMAT, screenSize.x );
+    bitmapBuffer.assign( stride * screenSize.y / sizeof( unsigned int ), 0 );
+}
+
+
+void CAIRO_IMAGE_GAL::initSurface()
+{
+    if( isInitialized )
+        return;
+
+    surface = cairo_image_surface_create_for_data( (unsigned char*) bitmapBuffer.data(),
+                                                   GAL_FORMAT, screenSize.x, screenSize.y,
+                                                   stride );
+    context = cairo_create( surface );
+#ifdef __WXDEBUG__
+    cairo_status_t status = cairo_status( context );
+    wxASSERT_MSG( status == CAIRO_STATUS_SUCCESS, wxT( "Cairo context creation error" ) );
+#endif /* __WXDEBUG__ */
+    currentContext = context;
+
+    cairo_set_antialias( context, CAIRO_ANTIALIAS_NONE );
+
+    // Clear the screen
+    ClearScreen( backgroundColor );
+
+    // Compute the world <-> screen transformations
+    ComputeWorldScreenMatrix();
+
+    cairo_matrix_init( &cairoWorldScreenMatrix, worldScreenMatrix.m_data[0][0],
+                       worldScreenMatrix.m_data[1][0], worldScreenMatrix.m_data[0][1],
+                       worldScreenMatrix.m_data[1][1], worldScreenMatrix.m_data[0][2],
+                       worldScreenMatrix.m_data[1][2] );
+
+    cairo_set_matrix( context, &cairoWorldScreenMatrix );
+
+    // Start drawing with a new path
+    cairo_new_path( context );
+    isElementAdded = true;
+
+    cairo_set_line_join( context, CAIRO_LINE_JOIN_ROUND );
+    cairo_set_line_cap( context, CAIRO_LINE_CAP_ROUND );
+
+    lineWidth = 0;
+
+    isInitialized = true;
+}
+
+
+void CAIRO_IMAGE_GAL::deinitSurface()
+{
+    if( !isInitialized )
+        return;
+
+    // Destroy Cairo objects
+    cairo_destroy( context );
+    cairo_surface_destroy( surface );
+
+    context = NULL;
+    surface = NULL;
+    isInitialized = false;
+}
@@ -36,23 +36,24 @@
 #include <gal/opengl/utils.h>
 
 #include <confirm.h>
-#include <list>
+#include <algorithm>
 #include <cassert>
+#include <cstring>
 
-#ifdef __WXDEBUG__
 #include <wx/log.h>
+
+#ifdef __WXDEBUG__
 #include <profile.h>
 #endif /* __WXDEBUG__ */
 
 using namespace KIGFX;
 
 CACHED_CONTAINER::CACHED_CONTAINER( unsigned int aSize ) :
-    VERTEX_CONTAINER( aSize ), m_item( NULL ),
-    m_chunkSize( 0 ), m_chunkOffset( 0 ), m_isMapped( false ),
-    m_isInitialized( false ), m_glBufferHandle( -1 )
+    VERTEX_CONTAINER( aSize ), m_allocator( aSize ), m_item( NULL ),
+    m_chunk( CHUNK_ALLOCATOR::NONE ), m_chunkSize( 0 ), m_chunkOffset( 0 ), m_isMapped( false ),
+    m_isInitialized( false ), m_glBufferHandle( -1 ), m_containerResizes( 0 ),
+    m_relocatedVertices( 0 ), m_compactedVertices( 0 )
 {
-    // In the beginning there is only free space
-    m_freeChunks.insert( std::make_pair( aSize, 0 ) );
 }
 
 
@@ -74,7 +75,8 @@ void CACHED_CONTAINER::SetItem( VERTEX_ITEM* aItem )
 
     unsigned int itemSize = aItem->GetSize();
     m_item      = aItem;
-    m_chunkSize = itemSize;
+    m_chunk     = itemSize > 0 ? aItem->m_chunk : CHUNK_ALLOCATOR::NONE;
+    m_chunkSize = itemSize > 0 ? m_allocator.GetSize( m_chunk ) : 0;
     m_useCopyBuffer = GLEW_ARB_copy_buffer;
 
     // Get the previously set offset if the item was stored previously
@@ -96,17 +98,12 @@ void CACHED_CONTAINER::FinishItem()
     if( itemSize < m_chunkSize )
     {
         // There is some not used but reserved memory left, so we should return it to the pool
-        int itemOffset = m_item->GetOffset();
-
-        // Add the not used memory back to the pool
-        addFreeChunk( itemOffset + itemSize, m_chunkSize - itemSize );
-        // mergeFreeChunks();   // veery slow and buggy
+        m_allocator.Resize( m_chunk, itemSize );
+        m_freeSpace = m_allocator.GetFreeSpace();
     }
 
-    if( itemSize > 0 )
-        m_items.insert( m_item );
-
     m_item = NULL;
+    m_chunk = CHUNK_ALLOCATOR::NONE;
     m_chunkSize = 0;
     m_chunkOffset = 0;
 
@@ -161,45 +158,30 @@ VERTEX* CACHED_CONTAINER::Allocate( unsigned int aSize )
 void CACHED_CONTAINER::Delete( VERTEX_ITEM* aItem )
 {
     assert( aItem != NULL );
-    assert( m_items.find( aItem ) != m_items.end() || aItem->GetSize() == 0 );
 
     int size = aItem->GetSize();
 
     if( size == 0 )
         return;     // Item is not stored here
 
-    int offset = aItem->GetOffset();
+    assert( m_allocator.GetData( aItem->m_chunk ) == aItem );
 
 #if CACHED_CONTAINER_TEST > 1
-    wxLogDebug( wxT( "Removing 0x%08lx (size %d offset %d)" ), (long) aItem, size, offset );
+    wxLogDebug( wxT( "Removing 0x%08lx (size %d offset %d)" ), (long) aItem, size,
+                aItem->GetOffset() );
 #endif
 
-    // Insert a free memory chunk entry in the place where item was stored
-    addFreeChunk( offset, size );
+    // Return the chunk to the pool, it is merged with the neighbouring free chunks
+    m_allocator.Free( aItem->m_chunk );
+    m_freeSpace = m_allocator.GetFreeSpace();
 
     // Indicate that the item is not stored in the container anymore
     aItem->setSize( 0 );
-
-    m_items.erase( aItem );
+    aItem->setChunk( CHUNK_ALLOCATOR::NONE );
 
 #if CACHED_CONTAINER_TEST > 0
     test();
 #endif
-
-    // This dynamic memory freeing optimize memory usage, but in fact can create
-    // out of memory issues because freeing and reallocation large chuncks of memory
-    // can create memory fragmentation and no room to reallocate large chuncks
-    // after many free/reallocate cycles during a session using the same complex board
-    // So it can be disable.
-    // Currently: it is disable to avoid "out of memory" issues
-#if 0
-    // Dynamic memory freeing, there is no point in holding
-    // a large amount of memory when there is no use for it
-    if( m_freeSpace > ( 0.75 * m_currentSize ) && m_currentSize > m_initialSize )
-    {
-        defragmentResize( 0.5 * m_currentSize );
-    }
-#endif
 }
 
 
@@ -210,16 +192,33 @@ void CACHED_CONTAINER::Clear()
 
     // Set the size of all the stored VERTEX_ITEMs to 0, so it is clear that they are not held
     // in the container anymore
-    for( ITEMS::iterator it = m_items.begin(); it != m_items.end(); ++it )
+    for( int chunk = m_allocator.FirstChunk(); chunk != CHUNK_ALLOCATOR::NONE;
+            chunk = m_allocator.NextChunk( chunk ) )
     {
-        ( *it )->setSize( 0 );
-    }
+        if( m_allocator.IsFree( chunk ) )
+            continue;
 
-    m_items.clear();
+        VERTEX_ITEM* item = static_cast<VERTEX_ITEM*>( m_allocator.GetData( chunk ) );
+        item->setSize( 0 );
+        item->setChunk( CHUNK_ALLOCATOR::NONE );
+    }
 
     // Now there is only free space left
-    m_freeChunks.clear();
-    m_freeChunks.insert( std::make_pair( m_freeSpace, 0 ) );
+    m_allocator.Reset( m_currentSize );
+}
+
+
+CACHED_CONTAINER::STATS CACHED_CONTAINER::GetStats() const
+{
+    STATS stats;
+
+    static_cast<CHUNK_ALLOCATOR::STATS&>( stats ) = m_allocator.GetStats();
+    stats.m_largestFreeChunk = m_allocator.GetLargestFree();
+    stats.m_containerResizes = m_containerResizes;
+    stats.m_relocatedVertices = m_relocatedVertices;
+    stats.m_compactedVertices = m_compactedVertices;
+
+    return stats;
 }
 
 
@@ -252,6 +251,16 @@ void CACHED_CONTAINER::Unmap()
 }
 
 
+void CACHED_CONTAINER::Compact()
+{
+    assert( IsMapped() );
+
+    // Move a limited number of vertices, so the update does not stall
+    if( !m_item && !m_failed )
+        compact( COMPACTION_BUDGET );
+}
+
+
 void CACHED_CONTAINER::init()
 {
     glGenBuffers( 1, &m_glBufferHandle );
@@ -275,36 +284,53 @@ bool CACHED_CONTAINER::reallocate( unsigned int aSize )
     wxLogDebug( wxT( "Resize %p from %d to %d" ), m_item, itemSize, aSize );
 #endif
 
-    // Find a free space chunk >= aSize
-    FREE_CHUNK_MAP::iterator newChunk = m_freeChunks.lower_bound( aSize );
+    // Items are usually built using many small allocations, so reserve more space than
+    // requested to avoid resizing the chunk every time. The excess is returned in FinishItem().
+    unsigned int reserve = std::max( aSize, 2 * m_chunkSize );
+
+    // Try to grow the chunk in place, so there is no need to copy the data
+    if( m_chunk != CHUNK_ALLOCATOR::NONE
+            && ( m_allocator.Resize( m_chunk, reserve ) || m_allocator.Resize( m_chunk, aSize ) ) )
+    {
+        m_chunkSize = m_allocator.GetSize( m_chunk );
+        m_freeSpace = m_allocator.GetFreeSpace();
+
+        return true;
+    }
+
+    int newChunk = m_allocator.Allocate( reserve );
+
+    if( newChunk == CHUNK_ALLOCATOR::NONE && reserve > aSize )
+        newChunk = m_allocator.Allocate( aSize );
 
     // Is there enough space to store vertices?
-    if( newChunk == m_freeChunks.end() )
+    if( newChunk == CHUNK_ALLOCATOR::NONE )
     {
-        bool result;
+        // Grow exponentially, but make sure the appended free space is able to hold the chunk
+        unsigned int newSize = m_currentSize * 2;
 
-        // Would it be enough to double the current space?
-        if( aSize < m_freeSpace + m_currentSize )
-        {
-            // Yes: exponential growing
-            result = defragmentResize( m_currentSize * 2 );
-        }
-        else
-        {
-            // No: grow to the nearest greater power of 2
-            result = defragmentResize( pow( 2, ceil( log2( m_currentSize * 2 + aSize ) ) ) );
-        }
+        while( newSize < m_currentSize + aSize )
+            newSize *= 2;
 
-        if( !result )
+        if( !resize( newSize ) )
             return false;
 
-        newChunk = m_freeChunks.lower_bound( aSize );
-        assert( newChunk != m_freeChunks.end() );
+        // The current chunk might have been the last one, then it can be simply extended
+        if( m_chunk != CHUNK_ALLOCATOR::NONE && m_allocator.Resize( m_chunk, aSize ) )
+        {
+            m_chunkSize = m_allocator.GetSize( m_chunk );
+            m_freeSpace = m_allocator.GetFreeSpace();
+
+            return true;
+        }
+
+        newChunk = m_allocator.Allocate( aSize );
+        assert( newChunk != CHUNK_ALLOCATOR::NONE );
     }
 
     // Parameters of the allocated chunk
-    unsigned int newChunkSize   = getChunkSize( *newChunk );
-    unsigned int newChunkOffset = getChunkOffset( *newChunk );
+    unsigned int newChunkSize   = m_allocator.GetSize( newChunk );
+    unsigned int newChunkOffset = m_allocator.GetOffset( newChunk );
 
     assert( newChunkSize >= aSize );
     assert( newChunkOffset < m_currentSize );
@@ -314,100 +340,38 @@ bool CACHED_CONTAINER::reallocate( unsigned int aSize )
     {
 #if CACHED_CONTAINER_TEST > 3
         wxLogDebug( wxT( "Moving 0x%08x from 0x%08x to 0x%08x" ),
-                    (int) m_item, oldChunkOffset, newChunkOffset );
+                    (int) m_item, m_chunkOffset, newChunkOffset );
 #endif
         // The item was reallocated, so we have to copy all the old data to the new place
         memcpy( &m_vertices[newChunkOffset], &m_vertices[m_chunkOffset], itemSize * VertexSize );
-
-        // Free the space used by the previous chunk
-        addFreeChunk( m_chunkOffset, m_chunkSize );
+        m_relocatedVertices += itemSize;
     }
 
-    // Remove the new allocated chunk from the free space pool
-    m_freeChunks.erase( newChunk );
-    m_freeSpace -= newChunkSize;
+    // Free the space used by the previous chunk
+    if( m_chunk != CHUNK_ALLOCATOR::NONE )
+        m_allocator.Free( m_chunk );
+
+    m_allocator.SetData( newChunk, m_item );
+    m_freeSpace = m_allocator.GetFreeSpace();
 
+    m_chunk = newChunk;
     m_chunkSize = newChunkSize;
     m_chunkOffset = newChunkOffset;
 
     m_item->setOffset( m_chunkOffset );
+    m_item->setChunk( m_chunk );
 
     return true;
 }
 
 
-void CACHED_CONTAINER::mergeFreeChunks()
+bool CACHED_CONTAINER::resize( unsigned int aNewSize )
 {
-    if( m_freeChunks.size() <= 1 ) // There are no chunks that can be merged
-        return;
-
-#ifdef __WXDEBUG__
-    PROF_COUNTER totalTime;
-#endif /* __WXDEBUG__ */
-
-    // Reversed free chunks map - this one stores chunk size with its offset as the key
-    std::list<CHUNK> freeChunks;
-
-    FREE_CHUNK_MAP::const_iterator it, it_end;
-
-    for( it = m_freeChunks.begin(), it_end = m_freeChunks.end(); it != it_end; ++it )
-    {
-        freeChunks.push_back( std::make_pair( it->second, it->first ) );
-    }
-
-    m_freeChunks.clear();
-    freeChunks.sort();
-
-    std::list<CHUNK>::const_iterator itf, itf_end;
-    unsigned int offset = freeChunks.front().first;
-    unsigned int size   = freeChunks.front().second;
-    freeChunks.pop_front();
-
-    for( itf = freeChunks.begin(), itf_end = freeChunks.end(); itf != itf_end; ++itf )
-    {
-        if( itf->first == offset + size )
-        {
-            // These chunks can be merged, so just increase the current chunk size and go on
-            size += itf->second;
-        }
-        else
-        {
-            // These chunks cannot be merged
-            // So store the previous one
-            m_freeChunks.insert( std::make_pair( size, offset ) );
-            // and let's check the next chunk
-            offset = itf->first;
-            size   = itf->second;
-
-        }
-    }
-
-    // Add the last one
-    m_freeChunks.insert( std::make_pair( size, offset ) );
-
-#ifdef __WXDEBUG__
-    totalTime.Stop();
-    wxLogDebug( "Merged free chunks / %.1f ms", totalTime.msecs() );
-#endif /* __WXDEBUG__ */
-#if CACHED_CONTAINER_TEST > 0
-    test();
-#endif
-}
-
-
-bool CACHED_CONTAINER::defragmentResize( unsigned int aNewSize )
-{
-    if( !m_useCopyBuffer )
-        return defragmentResizeMemcpy( aNewSize );
-
     assert( IsMapped() );
+    assert( aNewSize > m_currentSize );
 
     wxLogTrace( "GAL_CACHED_CONTAINER",
-            wxT( "Resizing & defragmenting container from %d to %d" ), m_currentSize, aNewSize );
-
-    // No shrinking if we cannot fit all the data
-    if( usedSpace() > aNewSize )
-        return false;
+            wxT( "Resizing container from %d to %d" ), m_currentSize, aNewSize );
 
 #ifdef __WXDEBUG__
     PROF_COUNTER totalTime;
@@ -415,9 +379,6 @@ bool CACHED_CONTAINER::defragmentResize( unsigned int aNewSize )
 
     GLuint newBuffer;
 
-    // glCopyBufferSubData requires a buffer to be unmapped
-    glUnmapBuffer( GL_ARRAY_BUFFER );
-
     // Create the destination buffer
     glGenBuffers( 1, &newBuffer );
 
@@ -430,38 +391,26 @@ bool CACHED_CONTAINER::defragmentResize( unsigned int aNewSize )
 #endif /* __WXDEBUG__ */
     glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, newBuffer );
     glBufferData( GL_ELEMENT_ARRAY_BUFFER, aNewSize * VertexSize, NULL, GL_DYNAMIC_DRAW );
-    checkGlError( "creating buffer during defragmentation" );
-
-    ITEMS::iterator it, it_end;
-    int newOffset = 0;
+    checkGlError( "creating buffer during resize" );
 
-    // Defragmentation
-    for( it = m_items.begin(), it_end = m_items.end(); it != it_end; ++it )
+    // Items keep their offsets, so the whole buffer is copied at once
+    if( m_useCopyBuffer )
     {
-        VERTEX_ITEM* item = *it;
-        int itemOffset    = item->GetOffset();
-        int itemSize      = item->GetSize();
-
-        // Move an item to the new container
+        // glCopyBufferSubData requires a buffer to be unmapped
+        glUnmapBuffer( GL_ARRAY_BUFFER );
         glCopyBufferSubData( GL_ARRAY_BUFFER, GL_ELEMENT_ARRAY_BUFFER,
-                itemOffset * VertexSize, newOffset * VertexSize, itemSize * VertexSize );
-
-        // Update new offset
-        item->setOffset( newOffset );
-
-        // Move to the next free space
-        newOffset += itemSize;
+                0, 0, m_currentSize * VertexSize );
     }
-
-    // Move the current item and place it at the end
-    if( m_item->GetSize() > 0 )
+    else
     {
-        glCopyBufferSubData( GL_ARRAY_BUFFER, GL_ELEMENT_ARRAY_BUFFER,
-                m_item->GetOffset() * VertexSize, newOffset * VertexSize,
-                m_item->GetSize() * VertexSize );
+        VERTEX* newBufferMem = static_cast<VERTEX*>( glMapBuffer( GL_ELEMENT_ARRAY_BUFFER,
+                                                                  GL_WRITE_ONLY ) );
+        checkGlError( "mapping buffer during resize" );
+
+        memcpy( newBufferMem, m_vertices, m_currentSize * VertexSize );
 
-        m_item->setOffset( newOffset );
-        m_chunkOffset = newOffset;
+        glUnmapBuffer( GL_ELEMENT_ARRAY_BUFFER );
+        glUnmapBuffer( GL_ARRAY_BUFFER );
     }
 
     // Cleanup
@@ -469,147 +418,111 @@ bool CACHED_CONTAINER::defragmentResize( unsigned int aNewSize )
     glBindBuffer( GL_ARRAY_BUFFER, 0 );
     // Previously we have unmapped the array buffer, now when it is also
     // unbound, it may be officially marked as unmapped
+    m_vertices = NULL;
     m_isMapped = false;
     glDeleteBuffers( 1, &m_glBufferHandle );
 
     // Switch to the new vertex buffer
     m_glBufferHandle = newBuffer;
     Map();
-    checkGlError( "switching buffers during defragmentation" );
+    checkGlError( "switching buffers during resize" );
 
 #ifdef __WXDEBUG__
     totalTime.Stop();
 
     wxLogTrace( "GAL_CACHED_CONTAINER",
-                "Defragmented container storing %d vertices / %.1f ms",
+                "Resized container storing %d vertices / %.1f ms",
                 m_currentSize - m_freeSpace, totalTime.msecs() );
 #endif /* __WXDEBUG__ */
 
-    m_freeSpace += ( aNewSize - m_currentSize );
+    m_allocator.Grow( aNewSize );
+    m_freeSpace = m_allocator.GetFreeSpace();
     m_currentSize = aNewSize;
-
-    // Now there is only one big chunk of free memory
-    m_freeChunks.clear();
-    m_freeChunks.insert( std::make_pair( m_freeSpace, m_currentSize - m_freeSpace ) );
+    ++m_containerResizes;
 
     return true;
 }
 
 
-bool CACHED_CONTAINER::defragmentResizeMemcpy( unsigned int aNewSize )
+void CACHED_CONTAINER::compact( unsigned int aMaxVertices )
 {
     assert( IsMapped() );
+    assert( !m_item );
 
-    wxLogTrace( "GAL_CACHED_CONTAINER",
-            wxT( "Resizing & defragmenting container (memcpy) from %d to %d" ),
-            m_currentSize, aNewSize );
+    // Nothing to do if the free space is not fragmented
+    if( m_allocator.GetStats().m_freeChunks <= 1 )
+        return;
 
-    // No shrinking if we cannot fit all the data
-    if( usedSpace() > aNewSize )
-        return false;
+    unsigned int moved = 0;
+    int chunk = m_allocator.LastChunk();
 
-#ifdef __WXDEBUG__
-    PROF_COUNTER totalTime;
-#endif /* __WXDEBUG__ */
+    // Move items from the end of the buffer to the holes before them
+    while( chunk != CHUNK_ALLOCATOR::NONE && moved < aMaxVertices )
+    {
+        if( m_allocator.IsFree( chunk ) )
+        {
+            chunk = m_allocator.PrevChunk( chunk );
+            continue;
+        }
 
-    GLuint newBuffer;
-    VERTEX* newBufferMem;
+        unsigned int size = m_allocator.GetSize( chunk );
+        unsigned int offset = m_allocator.GetOffset( chunk );
+        int target = m_allocator.Allocate( size );
 
-    // Create the destination buffer
-    glGenBuffers( 1, &newBuffer );
+        if( target == CHUNK_ALLOCATOR::NONE )
+            break;
 
-    // It would be best to use GL_COPY_WRITE_BUFFER here,
-    // but it is not available everywhere
-#ifdef __WXDEBUG__
-    GLint eaBuffer = -1;
-    glGetIntegerv( GL_ELEMENT_ARRAY_BUFFER_BINDING, &eaBuffer );
-    assert( eaBuffer == 0 );
-#endif /* __WXDEBUG__ */
-    glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, newBuffer );
-    glBufferData( GL_ELEMENT_ARRAY_BUFFER, aNewSize * VertexSize, NULL, GL_DYNAMIC_DRAW );
-    newBufferMem = static_cast<VERTEX*>( glMapBuffer( GL_ELEMENT_ARRAY_BUFFER, GL_WRITE_ONLY ) );
-    checkGlError( "creating buffer during defragmentation" );
-
-    // Defragmentation
-    ITEMS::iterator it, it_end;
-    int newOffset = 0;
+        unsigned int newOffset = m_allocator.GetOffset( target );
 
-    for( it = m_items.begin(), it_end = m_items.end(); it != it_end; ++it )
-    {
-        VERTEX_ITEM* item = *it;
-        int itemOffset    = item->GetOffset();
-        int itemSize      = item->GetSize();
+        if( newOffset > offset )
+        {
+            // There is no hole before the item that could store it
+            m_allocator.Free( target );
+            break;
+        }
 
-        // Move an item to the new container
-        memcpy( &newBufferMem[newOffset], &m_vertices[itemOffset], itemSize * VertexSize );
+        VERTEX_ITEM* item = static_cast<VERTEX_ITEM*>( m_allocator.GetData( chunk ) );
+        memcpy( &m_vertices[newOffset], &m_vertices[offset], size * VertexSize );
 
-        // Update new offset
+        m_allocator.SetData( target, item );
+        m_allocator.Free( chunk );
         item->setOffset( newOffset );
+        item->setChunk( target );
+        moved += size;
 
-        // Move to the next free space
-        newOffset += itemSize;
+        // The freed chunk has been merged, so start again from the end
+        chunk = m_allocator.LastChunk();
     }
 
-    // Move the current item and place it at the end
-    if( m_item->GetSize() > 0 )
+    if( moved > 0 )
     {
-        memcpy( &newBufferMem[newOffset], &m_vertices[m_item->GetOffset()],
-                m_item->GetSize() * VertexSize );
-        m_item->setOffset( newOffset );
-        m_chunkOffset = newOffset;
-    }
+        m_compactedVertices += moved;
+        m_dirty = true;
 
-    // Cleanup
-    glUnmapBuffer( GL_ELEMENT_ARRAY_BUFFER );
-    glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, 0 );
-    Unmap();
-    glDeleteBuffers( 1, &m_glBufferHandle );
-
-    // Switch to the new vertex buffer
-    m_glBufferHandle = newBuffer;
-    Map();
-    checkGlError( "switching buffers during defragmentation" );
-
-#ifdef __WXDEBUG__
-    totalTime.Stop();
-
-    wxLogTrace( "GAL_CACHED_CONTAINER",
-                "Defragmented container storing %d vertices / %.1f ms",
-                m_currentSize - m_freeSpace, totalTime.msecs() );
-#endif /* __WXDEBUG__ */
-
-    m_freeSpace += ( aNewSize - m_currentSize );
-    m_currentSize = aNewSize;
-
-    // Now there is only one big chunk of free memory
-    m_freeChunks.clear();
-    m_freeChunks.insert( std::make_pair( m_freeSpace, m_currentSize - m_freeSpace ) );
-
-    return true;
-}
-
-
-void CACHED_CONTAINER::addFreeChunk( unsigned int aOffset, unsigned int aSize )
-{
-    assert( aOffset + aSize <= m_currentSize );
-    assert( aSize > 0 );
+        wxLogTrace( "GAL_CACHED_CONTAINER",
+                    wxT( "Compacted %d vertices, %d free chunks left (largest %d)" ),
+                    moved, m_allocator.GetStats().m_freeChunks, m_allocator.GetLargestFree() );
+    }
 
-    m_freeChunks.insert( std::make_pair( aSize, aOffset ) );
-    m_freeSpace += aSize;
+#if CACHED_CONTAINER_TEST > 0
+    test();
+#endif
 }
 
 
 void CACHED_CONTAINER::showFreeChunks()
 {
 #ifdef __WXDEBUG__
-    FREE_CHUNK_MAP::iterator it;
-
     wxLogDebug( wxT( "Free chunks:" ) );
 
-    for( it = m_freeChunks.begin(); it != m_freeChunks.end(); ++it )
+    for( int chunk = m_allocator.FirstChunk(); chunk != CHUNK_ALLOCATOR::NONE;
+            chunk = m_allocator.NextChunk( chunk ) )
     {
-        unsigned int offset = getChunkOffset( *it );
-        unsigned int size   = getChunkSize( *it );
+        if( !m_allocator.IsFree( chunk ) )
+            continue;
+
+        unsigned int offset = m_allocator.GetOffset( chunk );
+        unsigned int size   = m_allocator.GetSize( chunk );
         assert( size > 0 );
 
         wxLogDebug( wxT( "[0x%08x-0x%08x] (size %d)" ),
@@ -622,15 +535,17 @@ void CACHED_CONTAINER::showFreeChunks()
 void CACHED_CONTAINER::showUsedChunks()
 {
 #ifdef __WXDEBUG__
-    ITEMS::iterator it;
-
     wxLogDebug( wxT( "Used chunks:" ) );
 
-    for( it = m_items.begin(); it != m_items.end(); ++it )
+    for( int chunk = m_allocator.FirstChunk(); chunk != CHUNK_ALLOCATOR::NONE;
+            chunk = m_allocator.NextChunk( chunk ) )
     {
-        VERTEX_ITEM* item   = *it;
-        unsigned int offset = item->GetOffset();
-        unsigned int size   = item->GetSize();
+        if( m_allocator.IsFree( chunk ) )
+            continue;
+
+        VERTEX_ITEM* item   = static_cast<VERTEX_ITEM*>( m_allocator.GetData( chunk ) );
+        unsigned int offset = m_allocator.GetOffset( chunk );
+        unsigned int size   = m_allocator.GetSize( chunk );
         assert( size > 0 );
 
         wxLogDebug( wxT( "[0x%08x-0x%08x] @ 0x%p (size %d)" ),
@@ -643,30 +558,32 @@ void CACHED_CONTAINER::showUsedChunks()
 void CACHED_CONTAINER::test()
 {
 #ifdef __WXDEBUG__
-    // Free space check
-    unsigned int freeSpace = 0;
-    FREE_CHUNK_MAP::iterator itf;
-
-    for( itf = m_freeChunks.begin(); itf != m_freeChunks.end(); ++itf )
-        freeSpace += getChunkSize( *itf );
-
-    assert( freeSpace == m_freeSpace );
+    // Allocator structures check (includes the overlapping check)
+    assert( m_allocator.Check() );
+    assert( m_allocator.GetFreeSpace() == m_freeSpace );
 
     // Used space check
     unsigned int usedSpace = 0;
-    ITEMS::iterator itr;
-    for( itr = m_items.begin(); itr != m_items.end(); ++itr )
-        usedSpace += ( *itr )->GetSize();
+
+    for( int chunk = m_allocator.FirstChunk(); chunk != CHUNK_ALLOCATOR::NONE;
+            chunk = m_allocator.NextChunk( chunk ) )
+    {
+        if( m_allocator.IsFree( chunk ) )
+            continue;
+
+        VERTEX_ITEM* item = static_cast<VERTEX_ITEM*>( m_allocator.GetData( chunk ) );
+
+        // Items own their chunks
+        assert( item->m_chunk == chunk );
+        assert( item->GetOffset() == m_allocator.GetOffset( chunk ) );
+
+        // Currently reserved chunk is counted with its whole size
+        usedSpace += ( item == m_item ) ? m_chunkSize : item->GetSize();
+    }
 
     // If we have a chunk assigned, then there must be an item edited
     assert( m_chunkSize == 0 || m_item );
 
-    // Currently reserved chunk is also counted as used
-    usedSpace += m_chunkSize;
-
     assert( ( m_freeSpace + usedSpace ) == m_currentSize );
-
-    // Overlapping check TODO
 #endif /* __WXDEBUG__ */
 }
-
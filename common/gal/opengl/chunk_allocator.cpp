@@ -0,0 +1,528 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 CERN
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file chunk_allocator.cpp
+ * @brief Segregated fit allocator managing chunks of a linear address space (e.g. a vertex
+ * buffer). It does not touch the managed memory, so it does not require an OpenGL context.
+ */
+
+#include <gal/opengl/chunk_allocator.h>
+
+#include <climits>
+#include <cstddef>
+#include <cassert>
+
+using namespace KIGFX;
+
+/// Index of the most significant set bit, aValue has to be greater than 0
+static inline int msb( uint32_t aValue )
+{
+#if defined( __GNUC__ )
+    return 31 - __builtin_clz( aValue );
+#else
+    int result = 0;
+
+    while( aValue >>= 1 )
+        ++result;
+
+    return result;
+#endif
+}
+
+
+/// Index of the least significant set bit, aValue has to be greater than 0
+static inline int lsb( uint32_t aValue )
+{
+#if defined( __GNUC__ )
+    return __builtin_ctz( aValue );
+#else
+    int result = 0;
+
+    while( !( aValue & 1 ) )
+    {
+        aValue >>= 1;
+        ++result;
+    }
+
+    return result;
+#endif
+}
+
+
+CHUNK_ALLOCATOR::CHUNK_ALLOCATOR( unsigned int aSize )
+{
+    m_stats.m_allocations = 0;
+    m_stats.m_releases = 0;
+    m_stats.m_resizes = 0;
+    m_stats.m_failures = 0;
+
+    Reset( aSize );
+}
+
+
+void CHUNK_ALLOCATOR::Reset( unsigned int aSize )
+{
+    m_chunks.clear();
+    m_unusedHandles.clear();
+    m_first = NONE;
+    m_last = NONE;
+    m_flBitmap = 0;
+
+    for( int fl = 0; fl < FL_COUNT; ++fl )
+    {
+        m_slBitmap[fl] = 0;
+
+        for( int sl = 0; sl < SL_COUNT; ++sl )
+            m_heads[fl][sl] = NONE;
+    }
+
+    m_stats.m_size = aSize;
+    m_stats.m_freeSpace = aSize;
+    m_stats.m_freeChunks = 0;
+    m_stats.m_usedChunks = 0;
+
+    // In the beginning there is only free space
+    if( aSize > 0 )
+        insertFree( createChunk( 0, aSize, NONE ) );
+}
+
+
+void CHUNK_ALLOCATOR::Grow( unsigned int aNewSize )
+{
+    assert( aNewSize >= m_stats.m_size );
+
+    unsigned int extra = aNewSize - m_stats.m_size;
+
+    if( extra == 0 )
+        return;
+
+    if( m_last != NONE && m_chunks[m_last].m_free )
+    {
+        // Extend the trailing free chunk
+        removeFree( m_last );
+        m_chunks[m_last].m_size += extra;
+        insertFree( m_last );
+    }
+    else
+    {
+        insertFree( createChunk( m_stats.m_size, extra, m_last ) );
+    }
+
+    m_stats.m_size = aNewSize;
+    m_stats.m_freeSpace += extra;
+}
+
+
+int CHUNK_ALLOCATOR::Allocate( unsigned int aSize )
+{
+    assert( aSize > 0 );
+
+    int chunk = findFree( aSize );
+
+    if( chunk == NONE )
+    {
+        ++m_stats.m_failures;
+        return NONE;
+    }
+
+    removeFree( chunk );
+
+    unsigned int remainder = m_chunks[chunk].m_size - aSize;
+
+    if( remainder > 0 )
+    {
+        // Split the chunk, the rest stays free
+        m_chunks[chunk].m_size = aSize;
+        insertFree( createChunk( m_chunks[chunk].m_offset + aSize, remainder, chunk ) );
+    }
+
+    CHUNK& c = m_chunks[chunk];
+    c.m_free = false;
+    c.m_data = NULL;
+
+    m_stats.m_freeSpace -= aSize;
+    ++m_stats.m_usedChunks;
+    ++m_stats.m_allocations;
+
+    return chunk;
+}
+
+
+void CHUNK_ALLOCATOR::Free( int aChunk )
+{
+    assert( aChunk >= 0 && aChunk < (int) m_chunks.size() );
+    assert( !m_chunks[aChunk].m_free );
+
+    m_stats.m_freeSpace += m_chunks[aChunk].m_size;
+    --m_stats.m_usedChunks;
+    ++m_stats.m_releases;
+
+    // Merge with the following chunk
+    int next = m_chunks[aChunk].m_next;
+
+    if( next != NONE && m_chunks[next].m_free )
+    {
+        removeFree( next );
+        m_chunks[aChunk].m_size += m_chunks[next].m_size;
+        destroyChunk( next );
+    }
+
+    // Merge with the preceding chunk
+    int prev = m_chunks[aChunk].m_prev;
+
+    if( prev != NONE && m_chunks[prev].m_free )
+    {
+        removeFree( prev );
+        m_chunks[prev].m_size += m_chunks[aChunk].m_size;
+        destroyChunk( aChunk );
+        aChunk = prev;
+    }
+
+    insertFree( aChunk );
+}
+
+
+bool CHUNK_ALLOCATOR::Resize( int aChunk, unsigned int aSize )
+{
+    assert( aChunk >= 0 && aChunk < (int) m_chunks.size() );
+    assert( !m_chunks[aChunk].m_free );
+    assert( aSize > 0 );
+
+    unsigned int size = m_chunks[aChunk].m_size;
+    int next = m_chunks[aChunk].m_next;
+
+    if( aSize == size )
+        return true;
+
+    if( aSize < size )
+    {
+        // Shrinking: return the tail to the pool
+        unsigned int tail = size - aSize;
+        m_chunks[aChunk].m_size = aSize;
+
+        if( next != NONE && m_chunks[next].m_free )
+        {
+            removeFree( next );
+            m_chunks[next].m_offset -= tail;
+            m_chunks[next].m_size += tail;
+            insertFree( next );
+        }
+        else
+        {
+            insertFree( createChunk( m_chunks[aChunk].m_offset + aSize, tail, aChunk ) );
+        }
+
+        m_stats.m_freeSpace += tail;
+    }
+    else
+    {
+        // Growing: possible only if there is enough free space right after the chunk
+        unsigned int extra = aSize - size;
+
+        if( next == NONE || !m_chunks[next].m_free || m_chunks[next].m_size < extra )
+            return false;
+
+        removeFree( next );
+        m_chunks[aChunk].m_size = aSize;
+
+        if( m_chunks[next].m_size == extra )
+        {
+            destroyChunk( next );
+        }
+        else
+        {
+            m_chunks[next].m_offset += extra;
+            m_chunks[next].m_size -= extra;
+            insertFree( next );
+        }
+
+        m_stats.m_freeSpace -= extra;
+    }
+
+    ++m_stats.m_resizes;
+
+    return true;
+}
+
+
+unsigned int CHUNK_ALLOCATOR::GetLargestFree() const
+{
+    if( !m_flBitmap )
+        return 0;
+
+    int fl = msb( m_flBitmap );
+    int sl = msb( m_slBitmap[fl] );
+    unsigned int largest = 0;
+
+    // Chunks in a single class differ in size, so the list has to be scanned
+    for( int chunk = m_heads[fl][sl]; chunk != NONE; chunk = m_chunks[chunk].m_nextFree )
+    {
+        if( m_chunks[chunk].m_size > largest )
+            largest = m_chunks[chunk].m_size;
+    }
+
+    return largest;
+}
+
+
+bool CHUNK_ALLOCATOR::Check() const
+{
+    unsigned int offset = 0;
+    unsigned int freeSpace = 0;
+    unsigned int freeChunks = 0;
+    unsigned int usedChunks = 0;
+    int prev = NONE;
+
+    // Chunks have to cover the whole space without gaps or overlaps
+    for( int chunk = m_first; chunk != NONE; chunk = m_chunks[chunk].m_next )
+    {
+        const CHUNK& c = m_chunks[chunk];
+
+        if( c.m_offset != offset || c.m_size == 0 || c.m_prev != prev )
+            return false;
+
+        if( c.m_free )
+        {
+            // Free chunks should have been merged
+            if( prev != NONE && m_chunks[prev].m_free )
+                return false;
+
+            freeSpace += c.m_size;
+            ++freeChunks;
+        }
+        else
+        {
+            ++usedChunks;
+        }
+
+        offset += c.m_size;
+        prev = chunk;
+    }
+
+    if( prev != m_last || offset != m_stats.m_size || freeSpace != m_stats.m_freeSpace
+            || freeChunks != m_stats.m_freeChunks || usedChunks != m_stats.m_usedChunks )
+        return false;
+
+    // Every free chunk has to be stored in the list matching its size
+    unsigned int listed = 0;
+
+    for( int fl = 0; fl < FL_COUNT; ++fl )
+    {
+        for( int sl = 0; sl < SL_COUNT; ++sl )
+        {
+            bool empty = ( m_heads[fl][sl] == NONE );
+
+            if( empty == bool( m_slBitmap[fl] & ( 1u << sl ) ) )
+                return false;
+
+            for( int chunk = m_heads[fl][sl]; chunk != NONE; chunk = m_chunks[chunk].m_nextFree )
+            {
+                int chunkFl, chunkSl;
+                mapping( m_chunks[chunk].m_size, chunkFl, chunkSl );
+
+                if( !m_chunks[chunk].m_free || chunkFl != fl || chunkSl != sl )
+                    return false;
+
+                ++listed;
+            }
+        }
+
+        if( bool( m_slBitmap[fl] ) != bool( m_flBitmap & ( 1u << fl ) ) )
+            return false;
+    }
+
+    return listed == freeChunks;
+}
+
+
+void CHUNK_ALLOCATOR::mapping( unsigned int aSize, int& aFl, int& aSl )
+{
+    assert( aSize > 0 );
+
+    if( aSize < (unsigned int) SL_COUNT )
+    {
+        aFl = 0;
+        aSl = aSize;
+    }
+    else
+    {
+        int bit = msb( aSize );
+        aFl = bit - SL_BITS + 1;
+        aSl = ( aSize >> ( bit - SL_BITS ) ) - SL_COUNT;
+    }
+}
+
+
+int CHUNK_ALLOCATOR::findFree( unsigned int aSize ) const
+{
+    // Round the size up to the next class, so any chunk found there is large enough
+    unsigned int rounded = aSize;
+
+    if( aSize >= (unsigned int) SL_COUNT )
+    {
+        unsigned int round = ( 1u << ( msb( aSize ) - SL_BITS ) ) - 1;
+        rounded = ( aSize > UINT_MAX - round ) ? UINT_MAX : aSize + round;
+    }
+
+    int fl, sl;
+    mapping( rounded, fl, sl );
+
+    uint32_t slMap = m_slBitmap[fl] & ( ~0u << sl );
+
+    if( !slMap )
+    {
+        uint32_t flMap = ( fl + 1 < FL_COUNT ) ? m_flBitmap & ( ~0u << ( fl + 1 ) ) : 0;
+
+        if( flMap )
+        {
+            fl = lsb( flMap );
+            slMap = m_slBitmap[fl];
+        }
+    }
+
+    if( slMap )
+        return m_heads[fl][lsb( slMap )];
+
+    // No class guarantees a fit, but there might be a large enough chunk in the class
+    // of the requested size
+    mapping( aSize, fl, sl );
+
+    for( int chunk = m_heads[fl][sl]; chunk != NONE; chunk = m_chunks[chunk].m_nextFree )
+    {
+        if( m_chunks[chunk].m_size >= aSize )
+            return chunk;
+    }
+
+    return NONE;
+}
+
+
+void CHUNK_ALLOCATOR::insertFree( int aChunk )
+{
+    CHUNK& c = m_chunks[aChunk];
+    int fl, sl;
+
+    mapping( c.m_size, fl, sl );
+
+    c.m_free = true;
+    c.m_data = NULL;
+    c.m_prevFree = NONE;
+    c.m_nextFree = m_heads[fl][sl];
+
+    if( c.m_nextFree != NONE )
+        m_chunks[c.m_nextFree].m_prevFree = aChunk;
+
+    m_heads[fl][sl] = aChunk;
+    m_slBitmap[fl] |= ( 1u << sl );
+    m_flBitmap |= ( 1u << fl );
+
+    ++m_stats.m_freeChunks;
+}
+
+
+void CHUNK_ALLOCATOR::removeFree( int aChunk )
+{
+    CHUNK& c = m_chunks[aChunk];
+    int fl, sl;
+
+    assert( c.m_free );
+    mapping( c.m_size, fl, sl );
+
+    if( c.m_prevFree != NONE )
+        m_chunks[c.m_prevFree].m_nextFree = c.m_nextFree;
+    else
+        m_heads[fl][sl] = c.m_nextFree;
+
+    if( c.m_nextFree != NONE )
+        m_chunks[c.m_nextFree].m_prevFree = c.m_prevFree;
+
+    if( m_heads[fl][sl] == NONE )
+    {
+        m_slBitmap[fl] &= ~( 1u << sl );
+
+        if( !m_slBitmap[fl] )
+            m_flBitmap &= ~( 1u << fl );
+    }
+
+    c.m_free = false;
+    --m_stats.m_freeChunks;
+}
+
+
+int CHUNK_ALLOCATOR::createChunk( unsigned int aOffset, unsigned int aSize, int aPrev )
+{
+    int handle;
+
+    if( m_unusedHandles.empty() )
+    {
+        handle = m_chunks.size();
+        m_chunks.push_back( CHUNK() );
+    }
+    else
+    {
+        handle = m_unusedHandles.back();
+        m_unusedHandles.pop_back();
+    }
+
+    CHUNK& c = m_chunks[handle];
+    c.m_offset = aOffset;
+    c.m_size = aSize;
+    c.m_prev = aPrev;
+    c.m_next = ( aPrev == NONE ) ? m_first : m_chunks[aPrev].m_next;
+    c.m_prevFree = NONE;
+    c.m_nextFree = NONE;
+    c.m_free = false;
+    c.m_data = NULL;
+
+    if( aPrev == NONE )
+        m_first = handle;
+    else
+        m_chunks[aPrev].m_next = handle;
+
+    if( c.m_next == NONE )
+        m_last = handle;
+    else
+        m_chunks[c.m_next].m_prev = handle;
+
+    return handle;
+}
+
+
+void CHUNK_ALLOCATOR::destroyChunk( int aChunk )
+{
+    CHUNK& c = m_chunks[aChunk];
+
+    if( c.m_prev == NONE )
+        m_first = c.m_next;
+    else
+        m_chunks[c.m_prev].m_next = c.m_next;
+
+    if( c.m_next == NONE )
+        m_last = c.m_prev;
+    else
+        m_chunks[c.m_next].m_prev = c.m_prev;
+
+    m_unusedHandles.push_back( aChunk );
+}
@@ -72,6 +72,7 @@ const float SHADER_FONT                 = 4.0;
 const float MIN_WIDTH = 1.0;
 
 attribute vec4 attrShaderParams;
+attribute vec2 attrInstanceOffset;      // translation of instanced groups
 varying vec4 shaderParams;
 varying vec2 circleCoords;
 
@@ -80,6 +81,8 @@ void main()
     // Pass attributes to the fragment shader
     shaderParams = attrShaderParams;
 
+    vec4 vertex = gl_Vertex + vec4( attrInstanceOffset, 0.0, 0.0 );
+
     if( shaderParams[0] == SHADER_LINE )
     {
         float lineWidth = shaderParams[3];
@@ -88,10 +91,10 @@ void main()
         // Make lines appear to be at least 1 pixel wide
         if( worldScale * lineWidth < MIN_WIDTH )
             gl_Position = gl_ModelViewProjectionMatrix *
-                ( gl_Vertex + vec4( shaderParams.yz * MIN_WIDTH / ( worldScale * lineWidth ), 0.0, 0.0 ) );
+                ( vertex + vec4( shaderParams.yz * MIN_WIDTH / ( worldScale * lineWidth ), 0.0, 0.0 ) );
         else
             gl_Position = gl_ModelViewProjectionMatrix *
-                ( gl_Vertex + vec4( shaderParams.yz, 0.0, 0.0 ) );
+                ( vertex + vec4( shaderParams.yz, 0.0, 0.0 ) );
     }
     else if( ( shaderParams[0] == SHADER_STROKED_CIRCLE ) ||
              ( shaderParams[0] == SHADER_FILLED_CIRCLE  ) )
@@ -120,12 +123,12 @@ void main()
         if( worldScale * lineWidth < MIN_WIDTH )
             shaderParams[3] = shaderParams[3] / ( worldScale * lineWidth );
 
-        gl_Position = ftransform();
+        gl_Position = gl_ModelViewProjectionMatrix * vertex;
     }
     else
     {
         // Pass through the coordinates like in the fixed pipeline
-        gl_Position = ftransform();
+        gl_Position = gl_ModelViewProjectionMatrix * vertex;
     }
 
     gl_FrontColor = gl_Color;
@@ -56,7 +56,8 @@ GPU_MANAGER* GPU_MANAGER::MakeManager( VERTEX_CONTAINER* aContainer )
 
 
 GPU_MANAGER::GPU_MANAGER( VERTEX_CONTAINER* aContainer ) :
-    m_isDrawing( false ), m_container( aContainer ), m_shader( NULL ), m_shaderAttrib( 0 )
+    m_isDrawing( false ), m_container( aContainer ), m_shader( NULL ), m_shaderAttrib( 0 ),
+    m_instanceAttrib( -1 )
 {
 }
 
@@ -75,13 +76,17 @@ void GPU_MANAGER::SetShader( SHADER& aShader )
     {
         DisplayError( NULL, wxT( "Could not get the shader attribute location" ) );
     }
+
+    // Optional, instances are translated using the transformation matrix if it is not available
+    m_instanceAttrib = m_shader->GetAttribute( "attrInstanceOffset" );
 }
 
 
 // Cached manager
 GPU_CACHED_MANAGER::GPU_CACHED_MANAGER( VERTEX_CONTAINER* aContainer ) :
     GPU_MANAGER( aContainer ), m_buffersInitialized( false ), m_indicesPtr( NULL ),
-    m_indicesBuffer( 0 ), m_indicesSize( 0 ), m_indicesCapacity( 0 )
+    m_indicesBuffer( 0 ), m_indicesSize( 0 ), m_indicesCapacity( 0 ), m_instancesSize( 0 ),
+    m_instanceBuffer( 0 ), m_useInstancedArrays( false )
 {
     // Allocate the biggest possible buffer for indices
     resizeIndices( aContainer->GetSize() );
@@ -94,6 +99,7 @@ GPU_CACHED_MANAGER::~GPU_CACHED_MANAGER()
     {
         glBindBuffer( GL_ARRAY_BUFFER, 0 );
         glDeleteBuffers( 1, &m_indicesBuffer );
+        glDeleteBuffers( 1, &m_instanceBuffer );
     }
 }
 
@@ -106,7 +112,11 @@ void GPU_CACHED_MANAGER::BeginDrawing()
     {
         glGenBuffers( 1, &m_indicesBuffer );
         checkGlError( "generating vertices buffer" );
+        glGenBuffers( 1, &m_instanceBuffer );
+        checkGlError( "generating instances buffer" );
         m_buffersInitialized = true;
+
+        m_useInstancedArrays = GLEW_ARB_instanced_arrays && GLEW_ARB_draw_instanced;
     }
 
     if( m_container->IsDirty() )
@@ -117,6 +127,8 @@ void GPU_CACHED_MANAGER::BeginDrawing()
     // Set the indices pointer to the beginning of the indices-to-draw buffer
     m_indicesPtr = m_indices.get();
 
+    m_instancesSize = 0;
+
     m_isDrawing = true;
 }
 
@@ -132,6 +144,19 @@ void GPU_CACHED_MANAGER::DrawIndices( unsigned int aOffset, unsigned int aSize )
 }
 
 
+void GPU_CACHED_MANAGER::DrawInstance( unsigned int aOffset, unsigned int aSize,
+                                       const VECTOR2D& aTranslation )
+{
+    wxASSERT( m_isDrawing );
+
+    std::vector<GLfloat>& translations = m_instances[std::make_pair( aOffset, aSize )];
+    translations.push_back( aTranslation.x );
+    translations.push_back( aTranslation.y );
+
+    ++m_instancesSize;
+}
+
+
 void GPU_CACHED_MANAGER::DrawAll()
 {
     wxASSERT( m_isDrawing );
@@ -155,7 +180,7 @@ void GPU_CACHED_MANAGER::EndDrawing()
     if( cached->IsMapped() )
         cached->Unmap();
 
-    if( m_indicesSize == 0 )
+    if( m_indicesSize == 0 && m_instancesSize == 0 )
     {
         m_isDrawing = false;
         return;
@@ -178,14 +203,21 @@ void GPU_CACHED_MANAGER::EndDrawing()
                                VertexSize, (GLvoid*) ShaderOffset );
     }
 
-    glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, m_indicesBuffer );
-    glBufferData( GL_ELEMENT_ARRAY_BUFFER, m_indicesSize * sizeof(int),
-            (GLvoid*) m_indices.get(), GL_DYNAMIC_DRAW );
+    if( m_indicesSize > 0 )
+    {
+        glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, m_indicesBuffer );
+        glBufferData( GL_ELEMENT_ARRAY_BUFFER, m_indicesSize * sizeof(int),
+                (GLvoid*) m_indices.get(), GL_DYNAMIC_DRAW );
+
+        glDrawElements( GL_TRIANGLES, m_indicesSize, GL_UNSIGNED_INT, 0 );
+    }
 
-    glDrawElements( GL_TRIANGLES, m_indicesSize, GL_UNSIGNED_INT, 0 );
+    if( m_instancesSize > 0 )
+        drawInstances();
 
 #ifdef __WXDEBUG__
-    wxLogTrace( "GAL_PROFILE", wxT( "Cached manager size: %d" ), m_indicesSize );
+    wxLogTrace( "GAL_PROFILE", wxT( "Cached manager size: %d, instances: %d" ),
+                m_indicesSize, m_instancesSize );
 #endif /* __WXDEBUG__ */
 
     glBindBuffer( GL_ARRAY_BUFFER, 0 );
@@ -211,6 +243,89 @@ void GPU_CACHED_MANAGER::EndDrawing()
 }
 
 
+void GPU_CACHED_MANAGER::drawInstances()
+{
+    if( m_useInstancedArrays && m_instanceAttrib >= 0 )
+    {
+        // Gather translations of all instances in a single buffer
+        std::vector<GLfloat> translations;
+        translations.reserve( 2 * m_instancesSize );
+
+        for( const INSTANCES::value_type& instance : m_instances )
+            translations.insert( translations.end(), instance.second.begin(), instance.second.end() );
+
+        glBindBuffer( GL_ARRAY_BUFFER, m_instanceBuffer );
+        glBufferData( GL_ARRAY_BUFFER, translations.size() * sizeof(GLfloat),
+                      translations.data(), GL_STREAM_DRAW );
+
+        glEnableVertexAttribArray( m_instanceAttrib );
+        glVertexAttribDivisorARB( m_instanceAttrib, 1 );
+
+        GLsizeiptr start = 0;
+
+        for( const INSTANCES::value_type& instance : m_instances )
+        {
+            GLsizei count = instance.second.size() / 2;
+
+            if( count == 0 )
+                continue;
+
+            glVertexAttribPointer( m_instanceAttrib, 2, GL_FLOAT, GL_FALSE, 0,
+                                   (GLvoid*) ( start * sizeof(GLfloat) ) );
+            glDrawArraysInstancedARB( GL_TRIANGLES, instance.first.first,
+                                      instance.first.second, count );
+            start += instance.second.size();
+        }
+
+        glVertexAttribDivisorARB( m_instanceAttrib, 0 );
+        glDisableVertexAttribArray( m_instanceAttrib );
+        checkGlError( "drawing instances" );
+    }
+    else
+    {
+        // Draw the instances one by one
+        for( const INSTANCES::value_type& instance : m_instances )
+        {
+            const std::vector<GLfloat>& translations = instance.second;
+
+            for( unsigned int i = 0; i < translations.size(); i += 2 )
+            {
+                if( m_instanceAttrib >= 0 )
+                {
+                    glVertexAttrib2f( m_instanceAttrib, translations[i], translations[i + 1] );
+                    glDrawArrays( GL_TRIANGLES, instance.first.first, instance.first.second );
+                }
+                else
+                {
+                    glPushMatrix();
+                    glTranslatef( translations[i], translations[i + 1], 0.0f );
+                    glDrawArrays( GL_TRIANGLES, instance.first.first, instance.first.second );
+                    glPopMatrix();
+                }
+            }
+        }
+    }
+
+    // Not instanced vertices are not translated
+    if( m_instanceAttrib >= 0 )
+        glVertexAttrib2f( m_instanceAttrib, 0.0f, 0.0f );
+
+    // Ranges that were not drawn in this frame are likely not used anymore
+    for( INSTANCES::iterator it = m_instances.begin(); it != m_instances.end(); )
+    {
+        if( it->second.empty() )
+        {
+            it = m_instances.erase( it );
+        }
+        else
+        {
+            it->second.clear();
+            ++it;
+        }
+    }
+}
+
+
 void GPU_CACHED_MANAGER::resizeIndices( unsigned int aNewSize )
 {
     if( aNewSize > m_indicesCapacity )
@@ -240,6 +355,13 @@ void GPU_NONCACHED_MANAGER::DrawIndices( unsigned int aOffset, unsigned int aSiz
 }
 
 
+void GPU_NONCACHED_MANAGER::DrawInstance( unsigned int aOffset, unsigned int aSize,
+                                          const VECTOR2D& aTranslation )
+{
+    wxASSERT_MSG( false, wxT( "Not implemented yet" ) );
+}
+
+
 void GPU_NONCACHED_MANAGER::DrawAll()
 {
     // This is the default use case, nothing has to be done
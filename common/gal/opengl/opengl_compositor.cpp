@@ -31,6 +31,7 @@
 #include <gal/opengl/opengl_compositor.h>
 #include <gal/opengl/utils.h>
 
+#include <cmath>
 #include <stdexcept>
 #include <cassert>
 
@@ -290,6 +291,33 @@ void OPENGL_COMPOSITOR::SetBuffer( unsigned int aBufferHandle )
 }
 
 
+void OPENGL_COMPOSITOR::SetClipArea( const BOX2I& aArea )
+{
+    assert( m_initialized );
+
+    if( aArea.GetWidth() <= 0 || aArea.GetHeight() <= 0 )
+    {
+        glDisable( GL_SCISSOR_TEST );
+        return;
+    }
+
+    // Buffers may be larger than the screen (supersampling)
+    VECTOR2U size = ( m_curFbo == DIRECT_RENDERING ) ? GetScreenSize()
+                                                     : m_buffers[m_curBuffer].dimensions;
+    double scaleX = (double) size.x / m_width;
+    double scaleY = (double) size.y / m_height;
+
+    // Scissor box origin is the bottom left corner
+    int left    = std::floor( aArea.GetX() * scaleX );
+    int right   = std::ceil( aArea.GetRight() * scaleX );
+    int bottom  = std::floor( ( (int) m_height - aArea.GetBottom() ) * scaleY );
+    int top     = std::ceil( ( (int) m_height - aArea.GetY() ) * scaleY );
+
+    glScissor( left, bottom, right - left, top - bottom );
+    glEnable( GL_SCISSOR_TEST );
+}
+
+
 void OPENGL_COMPOSITOR::ClearBuffer()
 {
     assert( m_initialized );
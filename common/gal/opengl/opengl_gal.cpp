@@ -33,6 +33,7 @@
 #include <geometry/shape_poly_set.h>
 
 #include <macros.h>
+#include <frame_profiler.h>
 
 #ifdef __WXDEBUG__
 #include <profile.h>
@@ -53,7 +54,6 @@ using namespace KIGFX;
 #include "gl_builtin_shaders.h"
 using namespace KIGFX::BUILTIN_FONT;
 
-static void InitTesselatorCallbacks( GLUtesselator* aTesselator );
 static const int glAttributes[] = { WX_GL_RGBA, WX_GL_DOUBLEBUFFER, WX_GL_DEPTH_SIZE, 8, 0 };
 
 wxGLContext* OPENGL_GAL::glMainContext = NULL;
@@ -66,6 +66,7 @@ SHADER* OPENGL_GAL::shader = NULL;
 OPENGL_GAL::OPENGL_GAL( GAL_DISPLAY_OPTIONS& aDisplayOptions, wxWindow* aParent,
                         wxEvtHandler* aMouseListener, wxEvtHandler* aPaintListener,
                         const wxString& aName ) :
+    VERTEX_GAL( false ),
     wxGLCanvas( aParent, wxID_ANY, (int*) glAttributes, wxDefaultPosition, wxDefaultSize,
                 wxEXPAND, aName ),
     options( aDisplayOptions ), mouseListener( aMouseListener ), paintListener( aPaintListener )
@@ -92,6 +93,7 @@ OPENGL_GAL::OPENGL_GAL( GAL_DISPLAY_OPTIONS& aDisplayOptions, wxWindow* aParent,
 
     // Initialize the flags
     isFramebufferInitialized = false;
+    isFramebufferPreserved   = false;
     isBitmapFontInitialized  = false;
     isInitialized            = false;
     isGrouping               = false;
@@ -131,15 +133,6 @@ OPENGL_GAL::OPENGL_GAL( GAL_DISPLAY_OPTIONS& aDisplayOptions, wxWindow* aParent,
     // Grid color settings are different in Cairo and OpenGL
     SetGridColor( COLOR4D( 0.8, 0.8, 0.8, 0.1 ) );
 
-    // Tesselator initialization
-    tesselator = gluNewTess();
-    InitTesselatorCallbacks( tesselator );
-
-    if( tesselator == NULL )
-        throw std::runtime_error( "Could not create the tesselator" );
-
-    gluTessProperty( tesselator, GLU_TESS_WINDING_RULE, GLU_TESS_WINDING_POSITIVE );
-
     currentManager = nonCachedManager;
 }
 
@@ -150,7 +143,6 @@ OPENGL_GAL::~OPENGL_GAL()
 
     --instanceCounter;
     glFlush();
-    gluDeleteTess( tesselator );
     ClearCache();
 
     delete compositor;
@@ -234,6 +226,7 @@ void OPENGL_GAL::BeginDrawing()
         }
 
         isFramebufferInitialized = true;
+        isFramebufferPreserved = false;
     }
 
     compositor->Begin();
@@ -336,15 +329,22 @@ void OPENGL_GAL::BeginDrawing()
 
 void OPENGL_GAL::EndDrawing()
 {
+    FRAME_PROFILER_SCOPE profilerScope( FRAME_PROFILER::GAL_COMPOSITE );
+
 #ifdef __WXDEBUG__
     PROF_COUNTER totalRealTime( "OPENGL_GAL::EndDrawing()", true );
 #endif /* __WXDEBUG__ */
 
     // Cached & non-cached containers are rendered to the same buffer
     compositor->SetBuffer( mainBuffer );
+    compositor->SetClipArea( clipArea );
     nonCachedManager->EndDrawing();
     cachedManager->EndDrawing();
 
+    // The next frame is drawn without clipping, unless it is requested again
+    compositor->SetClipArea( BOX2I() );
+    clipArea = BOX2I();
+
     // Overlay container is rendered to a different buffer
     compositor->SetBuffer( overlayBuffer );
     overlayManager->EndDrawing();
@@ -360,6 +360,7 @@ void OPENGL_GAL::EndDrawing()
 
     SwapBuffers();
     GL_CONTEXT_MANAGER::Get().UnlockCtx( glPrivContext );
+    isFramebufferPreserved = true;
 
 #ifdef __WXDEBUG__
     totalRealTime.Stop();
@@ -391,447 +392,6 @@ void OPENGL_GAL::EndUpdate()
 }
 
 
-void OPENGL_GAL::DrawLine( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint )
-{
-    const VECTOR2D  startEndVector = aEndPoint - aStartPoint;
-    double          lineAngle = startEndVector.Angle();
-
-    currentManager->Color( strokeColor.r, strokeColor.g, strokeColor.b, strokeColor.a );
-
-    drawLineQuad( aStartPoint, aEndPoint );
-
-    // Line caps
-    if( lineWidth > 1.0 )
-    {
-        drawFilledSemiCircle( aStartPoint, lineWidth / 2, lineAngle + M_PI / 2 );
-        drawFilledSemiCircle( aEndPoint,   lineWidth / 2, lineAngle - M_PI / 2 );
-    }
-}
-
-
-void OPENGL_GAL::DrawSegment( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint,
-                              double aWidth )
-{
-    VECTOR2D startEndVector = aEndPoint - aStartPoint;
-    double   lineAngle      = startEndVector.Angle();
-
-    if( isFillEnabled )
-    {
-        // Filled tracks
-        currentManager->Color( fillColor.r, fillColor.g, fillColor.b, fillColor.a );
-
-        SetLineWidth( aWidth );
-        drawLineQuad( aStartPoint, aEndPoint );
-
-        // Draw line caps
-        drawFilledSemiCircle( aStartPoint, aWidth / 2, lineAngle + M_PI / 2 );
-        drawFilledSemiCircle( aEndPoint,   aWidth / 2, lineAngle - M_PI / 2 );
-    }
-    else
-    {
-        // Outlined tracks
-        double lineLength = startEndVector.EuclideanNorm();
-
-        currentManager->Color( strokeColor.r, strokeColor.g, strokeColor.b, strokeColor.a );
-
-        Save();
-
-        currentManager->Translate( aStartPoint.x, aStartPoint.y, 0.0 );
-        currentManager->Rotate( lineAngle, 0.0f, 0.0f, 1.0f );
-
-        drawLineQuad( VECTOR2D( 0.0,         aWidth / 2.0 ),
-                      VECTOR2D( lineLength,  aWidth / 2.0 ) );
-
-        drawLineQuad( VECTOR2D( 0.0,        -aWidth / 2.0 ),
-                      VECTOR2D( lineLength, -aWidth / 2.0 ) );
-
-        // Draw line caps
-        drawStrokedSemiCircle( VECTOR2D( 0.0, 0.0 ), aWidth / 2, M_PI / 2 );
-        drawStrokedSemiCircle( VECTOR2D( lineLength, 0.0 ), aWidth / 2, -M_PI / 2 );
-
-        Restore();
-    }
-}
-
-
-void OPENGL_GAL::DrawCircle( const VECTOR2D& aCenterPoint, double aRadius )
-{
-    if( isFillEnabled )
-    {
-        currentManager->Reserve( 3 );
-        currentManager->Color( fillColor.r, fillColor.g, fillColor.b, fillColor.a );
-
-        /* Draw a triangle that contains the circle, then shade it leaving only the circle.
-         *  Parameters given to Shader() are indices of the triangle's vertices
-         *  (if you want to understand more, check the vertex shader source [shader.vert]).
-         *  Shader uses this coordinates to determine if fragments are inside the circle or not.
-         *       v2
-         *       /\
-         *      //\\
-         *  v0 /_\/_\ v1
-         */
-        currentManager->Shader( SHADER_FILLED_CIRCLE, 1.0 );
-        currentManager->Vertex( aCenterPoint.x - aRadius * sqrt( 3.0f ),            // v0
-                                aCenterPoint.y - aRadius, layerDepth );
-
-        currentManager->Shader( SHADER_FILLED_CIRCLE, 2.0 );
-        currentManager->Vertex( aCenterPoint.x + aRadius * sqrt( 3.0f),             // v1
-                                aCenterPoint.y - aRadius, layerDepth );
-
-        currentManager->Shader( SHADER_FILLED_CIRCLE, 3.0 );
-        currentManager->Vertex( aCenterPoint.x, aCenterPoint.y + aRadius * 2.0f,    // v2
-                                layerDepth );
-    }
-
-    if( isStrokeEnabled )
-    {
-        currentManager->Reserve( 3 );
-        currentManager->Color( strokeColor.r, strokeColor.g, strokeColor.b, strokeColor.a );
-
-        /* Draw a triangle that contains the circle, then shade it leaving only the circle.
-         *  Parameters given to Shader() are indices of the triangle's vertices
-         *  (if you want to understand more, check the vertex shader source [shader.vert]).
-         *  and the line width. Shader uses this coordinates to determine if fragments are
-         *  inside the circle or not.
-         *       v2
-         *       /\
-         *      //\\
-         *  v0 /_\/_\ v1
-         */
-        double outerRadius = aRadius + ( lineWidth / 2 );
-        currentManager->Shader( SHADER_STROKED_CIRCLE, 1.0, aRadius, lineWidth );
-        currentManager->Vertex( aCenterPoint.x - outerRadius * sqrt( 3.0f ),            // v0
-                                aCenterPoint.y - outerRadius, layerDepth );
-
-        currentManager->Shader( SHADER_STROKED_CIRCLE, 2.0, aRadius, lineWidth );
-        currentManager->Vertex( aCenterPoint.x + outerRadius * sqrt( 3.0f ),            // v1
-                                aCenterPoint.y - outerRadius, layerDepth );
-
-        currentManager->Shader( SHADER_STROKED_CIRCLE, 3.0, aRadius, lineWidth );
-        currentManager->Vertex( aCenterPoint.x, aCenterPoint.y + outerRadius * 2.0f,    // v2
-                                layerDepth );
-    }
-}
-
-
-void OPENGL_GAL::DrawArc( const VECTOR2D& aCenterPoint, double aRadius, double aStartAngle,
-                          double aEndAngle )
-{
-    if( aRadius <= 0 )
-        return;
-
-    // Swap the angles, if start angle is greater than end angle
-    SWAP( aStartAngle, >, aEndAngle );
-
-    Save();
-    currentManager->Translate( aCenterPoint.x, aCenterPoint.y, 0.0 );
-
-    if( isStrokeEnabled )
-    {
-        const double alphaIncrement = 2.0 * M_PI / CIRCLE_POINTS;
-        currentManager->Color( strokeColor.r, strokeColor.g, strokeColor.b, strokeColor.a );
-
-        VECTOR2D p( cos( aStartAngle ) * aRadius, sin( aStartAngle ) * aRadius );
-        double alpha;
-
-        for( alpha = aStartAngle + alphaIncrement; alpha <= aEndAngle; alpha += alphaIncrement )
-        {
-            VECTOR2D p_next( cos( alpha ) * aRadius, sin( alpha ) * aRadius );
-            DrawLine( p, p_next );
-
-            p = p_next;
-        }
-
-        // Draw the last missing part
-        if( alpha != aEndAngle )
-        {
-            VECTOR2D p_last( cos( aEndAngle ) * aRadius, sin( aEndAngle ) * aRadius );
-            DrawLine( p, p_last );
-        }
-    }
-
-    if( isFillEnabled )
-    {
-        const double alphaIncrement = 2 * M_PI / CIRCLE_POINTS;
-        double alpha;
-        currentManager->Color( fillColor.r, fillColor.g, fillColor.b, fillColor.a );
-        currentManager->Shader( SHADER_NONE );
-
-        // Triangle fan
-        for( alpha = aStartAngle; ( alpha + alphaIncrement ) < aEndAngle; )
-        {
-            currentManager->Reserve( 3 );
-            currentManager->Vertex( 0.0, 0.0, 0.0 );
-            currentManager->Vertex( cos( alpha ) * aRadius, sin( alpha ) * aRadius, 0.0 );
-            alpha += alphaIncrement;
-            currentManager->Vertex( cos( alpha ) * aRadius, sin( alpha ) * aRadius, 0.0 );
-        }
-
-        // The last missing triangle
-        const VECTOR2D endPoint( cos( aEndAngle ) * aRadius, sin( aEndAngle ) * aRadius );
-
-        currentManager->Reserve( 3 );
-        currentManager->Vertex( 0.0, 0.0, 0.0 );
-        currentManager->Vertex( cos( alpha ) * aRadius, sin( alpha ) * aRadius, 0.0 );
-        currentManager->Vertex( endPoint.x,    endPoint.y,     0.0 );
-    }
-
-    Restore();
-}
-
-
-void OPENGL_GAL::DrawRectangle( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint )
-{
-    // Compute the diagonal points of the rectangle
-    VECTOR2D diagonalPointA( aEndPoint.x, aStartPoint.y );
-    VECTOR2D diagonalPointB( aStartPoint.x, aEndPoint.y );
-
-    // Stroke the outline
-    if( isStrokeEnabled )
-    {
-        currentManager->Color( strokeColor.r, strokeColor.g, strokeColor.b, strokeColor.a );
-
-        std::deque<VECTOR2D> pointList;
-        pointList.push_back( aStartPoint );
-        pointList.push_back( diagonalPointA );
-        pointList.push_back( aEndPoint );
-        pointList.push_back( diagonalPointB );
-        pointList.push_back( aStartPoint );
-        DrawPolyline( pointList );
-    }
-
-    // Fill the rectangle
-    if( isFillEnabled )
-    {
-        currentManager->Reserve( 6 );
-        currentManager->Shader( SHADER_NONE );
-        currentManager->Color( fillColor.r, fillColor.g, fillColor.b, fillColor.a );
-
-        currentManager->Vertex( aStartPoint.x, aStartPoint.y, layerDepth );
-        currentManager->Vertex( diagonalPointA.x, diagonalPointA.y, layerDepth );
-        currentManager->Vertex( aEndPoint.x, aEndPoint.y, layerDepth );
-
-        currentManager->Vertex( aStartPoint.x, aStartPoint.y, layerDepth );
-        currentManager->Vertex( aEndPoint.x, aEndPoint.y, layerDepth );
-        currentManager->Vertex( diagonalPointB.x, diagonalPointB.y, layerDepth );
-    }
-}
-
-
-void OPENGL_GAL::DrawPolyline( const std::deque<VECTOR2D>& aPointList )
-{
-    drawPolyline( [&](int idx) { return aPointList[idx]; }, aPointList.size() );
-}
-
-
-void OPENGL_GAL::DrawPolyline( const VECTOR2D aPointList[], int aListSize )
-{
-    drawPolyline( [&](int idx) { return aPointList[idx]; }, aListSize );
-}
-
-
-void OPENGL_GAL::DrawPolyline( const SHAPE_LINE_CHAIN& aLineChain )
-{
-    drawPolyline( [&](int idx) { return aLineChain.CPoint(idx); }, aLineChain.PointCount() + 1 );
-}
-
-
-void OPENGL_GAL::DrawPolygon( const std::deque<VECTOR2D>& aPointList )
-{
-    auto points = std::unique_ptr<GLdouble[]>( new GLdouble[3 * aPointList.size()] );
-    GLdouble* ptr = points.get();
-
-    for( const VECTOR2D& p : aPointList )
-    {
-        *ptr++ = p.x;
-        *ptr++ = p.y;
-        *ptr++ = layerDepth;
-    }
-
-    drawPolygon( points.get(), aPointList.size() );
-}
-
-
-void OPENGL_GAL::DrawPolygon( const VECTOR2D aPointList[], int aListSize )
-{
-    auto points = std::unique_ptr<GLdouble[]>( new GLdouble[3 * aListSize] );
-    GLdouble* target = points.get();
-    const VECTOR2D* src = aPointList;
-
-    for( int i = 0; i < aListSize; ++i )
-    {
-        *target++ = src->x;
-        *target++ = src->y;
-        *target++ = layerDepth;
-        ++src;
-    }
-
-    drawPolygon( points.get(), aListSize );
-}
-
-
-void OPENGL_GAL::DrawPolygon( const SHAPE_POLY_SET& aPolySet )
-{
-    for( int j = 0; j < aPolySet.OutlineCount(); ++j )
-    {
-        const SHAPE_LINE_CHAIN& outline = aPolySet.COutline( j );
-        const int pointCount = outline.PointCount();
-        std::unique_ptr<GLdouble[]> points( new GLdouble[3 * pointCount] );
-        GLdouble* ptr = points.get();
-
-        for( int i = 0; i < outline.PointCount(); ++i )
-        {
-            const VECTOR2I& p = outline.CPoint( i );
-            *ptr++ = p.x;
-            *ptr++ = p.y;
-            *ptr++ = layerDepth;
-        }
-
-        drawPolygon( points.get(), pointCount );
-    }
-}
-
-
-void OPENGL_GAL::DrawCurve( const VECTOR2D& aStartPoint, const VECTOR2D& aControlPointA,
-                            const VECTOR2D& aControlPointB, const VECTOR2D& aEndPoint )
-{
-    // FIXME The drawing quality needs to be improved
-    // FIXME Perhaps choose a quad/triangle strip instead?
-    // FIXME Brute force method, use a better (recursive?) algorithm
-
-    std::deque<VECTOR2D> pointList;
-
-    double t  = 0.0;
-    double dt = 1.0 / (double) CURVE_POINTS;
-
-    for( int i = 0; i <= CURVE_POINTS; i++ )
-    {
-        double omt  = 1.0 - t;
-        double omt2 = omt * omt;
-        double omt3 = omt * omt2;
-        double t2   = t * t;
-        double t3   = t * t2;
-
-        VECTOR2D vertex = omt3 * aStartPoint + 3.0 * t * omt2 * aControlPointA
-                          + 3.0 * t2 * omt * aControlPointB + t3 * aEndPoint;
-
-        pointList.push_back( vertex );
-
-        t += dt;
-    }
-
-    DrawPolyline( pointList );
-}
-
-
-void OPENGL_GAL::BitmapText( const wxString& aText, const VECTOR2D& aPosition,
-                             double aRotationAngle )
-{
-    wxASSERT_MSG( !IsTextMirrored(), "No support for mirrored text using bitmap fonts." );
-
-    // Compute text size, so it can be properly justified
-    VECTOR2D textSize;
-    float commonOffset;
-    std::tie( textSize, commonOffset ) = computeBitmapTextSize( aText );
-
-    const double SCALE = GetGlyphSize().y / textSize.y;
-    int tildas = 0;
-    bool overbar = false;
-
-    int overbarLength = 0;
-    double overbarHeight = textSize.y;
-
-    Save();
-
-    currentManager->Color( strokeColor.r, strokeColor.g, strokeColor.b, strokeColor.a );
-    currentManager->Translate( aPosition.x, aPosition.y, layerDepth );
-    currentManager->Rotate( aRotationAngle, 0.0f, 0.0f, -1.0f );
-
-    double sx = SCALE * ( globalFlipX ? -1.0 : 1.0 );
-    double sy = SCALE * ( globalFlipY ? -1.0 : 1.0 );
-
-    currentManager->Scale( sx, sy, 0 );
-    currentManager->Translate( 0, -commonOffset, 0 );
-
-    switch( GetHorizontalJustify() )
-    {
-    case GR_TEXT_HJUSTIFY_CENTER:
-        Translate( VECTOR2D( -textSize.x / 2.0, 0 ) );
-        break;
-
-    case GR_TEXT_HJUSTIFY_RIGHT:
-        //if( !IsTextMirrored() )
-            Translate( VECTOR2D( -textSize.x, 0 ) );
-        break;
-
-    case GR_TEXT_HJUSTIFY_LEFT:
-        //if( IsTextMirrored() )
-            //Translate( VECTOR2D( -textSize.x, 0 ) );
-        break;
-    }
-
-    switch( GetVerticalJustify() )
-    {
-    case GR_TEXT_VJUSTIFY_TOP:
-        Translate( VECTOR2D( 0, -textSize.y ) );
-        overbarHeight = -textSize.y / 2.0;
-        break;
-
-    case GR_TEXT_VJUSTIFY_CENTER:
-        Translate( VECTOR2D( 0, -textSize.y / 2.0 ) );
-        overbarHeight = 0;
-        break;
-
-    case GR_TEXT_VJUSTIFY_BOTTOM:
-        break;
-    }
-
-    for( unsigned int ii = 0; ii < aText.length(); ++ii )
-    {
-        const unsigned int c = aText[ii];
-
-        wxASSERT_MSG( LookupGlyph(c) != nullptr, wxT( "Missing character in bitmap font atlas." ) );
-        wxASSERT_MSG( c != '\n' && c != '\r', wxT( "No support for multiline bitmap text yet" ) );
-
-        // Handle overbar
-        if( c == '~' )
-        {
-            overbar = !overbar;
-            ++tildas;
-            continue;
-        }
-        else if( tildas > 0 )
-        {
-            if( tildas % 2 == 1 )
-            {
-                if( overbar )                   // Overbar begins
-                    overbarLength = 0;
-                else if( overbarLength > 0 )    // Overbar finishes
-                    drawBitmapOverbar( overbarLength, overbarHeight );
-
-                --tildas;
-            }
-
-            // Draw tilda characters if there are any remaining
-            for( int jj = 0; jj < tildas / 2; ++jj )
-                overbarLength += drawBitmapChar( '~' );
-
-            tildas = 0;
-        }
-
-        overbarLength += drawBitmapChar( c );
-    }
-
-    // Handle the case when overbar is active till the end of the drawn text
-    currentManager->Translate( 0, commonOffset, 0 );
-
-    if( overbar )
-        drawBitmapOverbar( overbarLength, overbarHeight );
-
-    Restore();
-}
-
-
 void OPENGL_GAL::DrawGrid()
 {
     if( !gridVisibility )
@@ -846,6 +406,7 @@ void OPENGL_GAL::DrawGrid()
 
     SetTarget( TARGET_NONCACHED );
     compositor->SetBuffer( mainBuffer );
+    compositor->SetClipArea( clipArea );
 
     // Draw the grid
     // For the drawing the start points, end points and increments have
@@ -937,6 +498,8 @@ void OPENGL_GAL::DrawGrid()
     if( gridStyle == GRID_STYLE_DOTS )
         glDisable( GL_STENCIL_TEST );
 
+    compositor->SetClipArea( BOX2I() );
+
     glEnable( GL_DEPTH_TEST );
     glEnable( GL_TEXTURE_2D );
 }
@@ -1004,36 +567,6 @@ void OPENGL_GAL::Transform( const MATRIX3x3D& aTransformation )
 }
 
 
-void OPENGL_GAL::Rotate( double aAngle )
-{
-    currentManager->Rotate( aAngle, 0.0f, 0.0f, 1.0f );
-}
-
-
-void OPENGL_GAL::Translate( const VECTOR2D& aVector )
-{
-    currentManager->Translate( aVector.x, aVector.y, 0.0f );
-}
-
-
-void OPENGL_GAL::Scale( const VECTOR2D& aScale )
-{
-    currentManager->Scale( aScale.x, aScale.y, 0.0f );
-}
-
-
-void OPENGL_GAL::Save()
-{
-    currentManager->PushMatrix();
-}
-
-
-void OPENGL_GAL::Restore()
-{
-    currentManager->PopMatrix();
-}
-
-
 int OPENGL_GAL::BeginGroup()
 {
     isGrouping = true;
@@ -1059,6 +592,12 @@ void OPENGL_GAL::DrawGroup( int aGroupNumber )
 }
 
 
+void OPENGL_GAL::DrawGroupInstance( int aGroupNumber, const VECTOR2D& aOffset )
+{
+    cachedManager->DrawItemInstance( *groups[aGroupNumber], aOffset );
+}
+
+
 void OPENGL_GAL::ChangeGroupColor( int aGroupNumber, const COLOR4D& aNewColor )
 {
     cachedManager->ChangeItemColor( *groups[aGroupNumber], aNewColor );
@@ -1085,6 +624,40 @@ void OPENGL_GAL::ClearCache()
 }
 
 
+GAL* OPENGL_GAL::GetTessellator( int aIndex )
+{
+    wxASSERT( aIndex >= 0 );
+
+    while( (int) tessellators.size() <= aIndex )
+        tessellators.emplace_back( new VERTEX_GAL );
+
+    VERTEX_GAL* tessellator = tessellators[aIndex].get();
+    copyViewSettings( *tessellator );
+
+    return tessellator;
+}
+
+
+int OPENGL_GAL::ImportGroup( GAL* aTessellator, int aGroupNumber )
+{
+    VERTEX_GAL* tessellator = dynamic_cast<VERTEX_GAL*>( aTessellator );
+    wxCHECK( tessellator, -1 );
+
+    unsigned int size;
+    const VERTEX* vertices = tessellator->GetGroupVertices( aGroupNumber, size );
+
+    // The vertices are already transformed and colored, so they are copied as they are
+    int groupNumber = BeginGroup();
+
+    if( size > 0 )
+        cachedManager->CopyVertices( vertices, size );
+
+    EndGroup();
+
+    return groupNumber;
+}
+
+
 void OPENGL_GAL::SaveScreen()
 {
     wxASSERT_MSG( false, wxT( "Not implemented yet" ) );
@@ -1137,6 +710,7 @@ void OPENGL_GAL::ClearTarget( RENDER_TARGET aTarget )
     case TARGET_CACHED:
     case TARGET_NONCACHED:
         compositor->SetBuffer( mainBuffer );
+        compositor->SetClipArea( clipArea );
         break;
 
     case TARGET_OVERLAY:
@@ -1145,330 +719,39 @@ void OPENGL_GAL::ClearTarget( RENDER_TARGET aTarget )
     }
 
     compositor->ClearBuffer();
+    compositor->SetClipArea( BOX2I() );
 
     // Restore the previous state
     compositor->SetBuffer( oldTarget );
 }
 
 
-void OPENGL_GAL::DrawCursor( const VECTOR2D& aCursorPosition )
-{
-    // Now we should only store the position of the mouse cursor
-    // The real drawing routines are in blitCursor()
-    //VECTOR2D screenCursor = worldScreenMatrix * aCursorPosition;
-    //cursorPosition = screenWorldMatrix * VECTOR2D( screenCursor.x, screenCursor.y );
-    cursorPosition = aCursorPosition;
-}
-
-
-void OPENGL_GAL::drawLineQuad( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint )
-{
-    /* Helper drawing:                   ____--- v3       ^
-     *                           ____---- ...   \          \
-     *                   ____----      ...       \   end    \
-     *     v1    ____----           ...    ____----          \ width
-     *       ----                ...___----        \          \
-     *       \             ___...--                 \          v
-     *        \    ____----...                ____---- v2
-     *         ----     ...           ____----
-     *  start   \    ...      ____----
-     *           \... ____----
-     *            ----
-     *            v0
-     * dots mark triangles' hypotenuses
-     */
-
-    VECTOR2D startEndVector = aEndPoint - aStartPoint;
-    double   lineLength     = startEndVector.EuclideanNorm();
-
-    if( lineLength <= 0.0 )
-        return;
-
-    double   scale          = 0.5 * lineWidth / lineLength;
-
-    // The perpendicular vector also needs transformations
-    glm::vec4 vector = currentManager->GetTransformation() *
-                       glm::vec4( -startEndVector.y * scale, startEndVector.x * scale, 0.0, 0.0 );
-
-    currentManager->Reserve( 6 );
-
-    // Line width is maintained by the vertex shader
-    currentManager->Shader( SHADER_LINE, vector.x, vector.y, lineWidth );
-    currentManager->Vertex( aStartPoint.x, aStartPoint.y, layerDepth );    // v0
-
-    currentManager->Shader( SHADER_LINE, -vector.x, -vector.y, lineWidth );
-    currentManager->Vertex( aStartPoint.x, aStartPoint.y, layerDepth );    // v1
-
-    currentManager->Shader( SHADER_LINE, -vector.x, -vector.y, lineWidth );
-    currentManager->Vertex( aEndPoint.x, aEndPoint.y, layerDepth );        // v3
-
-    currentManager->Shader( SHADER_LINE, vector.x, vector.y, lineWidth );
-    currentManager->Vertex( aStartPoint.x, aStartPoint.y, layerDepth );    // v0
-
-    currentManager->Shader( SHADER_LINE, -vector.x, -vector.y, lineWidth );
-    currentManager->Vertex( aEndPoint.x, aEndPoint.y, layerDepth );        // v3
-
-    currentManager->Shader( SHADER_LINE, vector.x, vector.y, lineWidth );
-    currentManager->Vertex( aEndPoint.x, aEndPoint.y, layerDepth );        // v2
-}
-
-
-void OPENGL_GAL::drawSemiCircle( const VECTOR2D& aCenterPoint, double aRadius, double aAngle )
+bool OPENGL_GAL::SetClipArea( const BOX2I& aArea )
 {
-    if( isFillEnabled )
-    {
-        currentManager->Color( fillColor.r, fillColor.g, fillColor.b, fillColor.a );
-        drawFilledSemiCircle( aCenterPoint, aRadius, aAngle );
-    }
+    // Freshly created framebuffers do not contain anything to be preserved
+    if( !isFramebufferPreserved )
+        return false;
 
-    if( isStrokeEnabled )
-    {
-        currentManager->Color( strokeColor.r, strokeColor.g, strokeColor.b, strokeColor.a );
-        drawStrokedSemiCircle( aCenterPoint, aRadius, aAngle );
-    }
-}
-
-
-void OPENGL_GAL::drawFilledSemiCircle( const VECTOR2D& aCenterPoint, double aRadius,
-                                       double aAngle )
-{
-    Save();
-
-    currentManager->Reserve( 3 );
-    currentManager->Translate( aCenterPoint.x, aCenterPoint.y, 0.0f );
-    currentManager->Rotate( aAngle, 0.0f, 0.0f, 1.0f );
-
-    /* Draw a triangle that contains the semicircle, then shade it to leave only
-     * the semicircle. Parameters given to Shader() are indices of the triangle's vertices
-     * (if you want to understand more, check the vertex shader source [shader.vert]).
-     * Shader uses these coordinates to determine if fragments are inside the semicircle or not.
-     *       v2
-     *       /\
-     *      /__\
-     *  v0 //__\\ v1
-     */
-    currentManager->Shader( SHADER_FILLED_CIRCLE, 4.0f );
-    currentManager->Vertex( -aRadius * 3.0f / sqrt( 3.0f ), 0.0f, layerDepth );     // v0
-
-    currentManager->Shader( SHADER_FILLED_CIRCLE, 5.0f );
-    currentManager->Vertex( aRadius * 3.0f / sqrt( 3.0f ), 0.0f, layerDepth );      // v1
-
-    currentManager->Shader( SHADER_FILLED_CIRCLE, 6.0f );
-    currentManager->Vertex( 0.0f, aRadius * 2.0f, layerDepth );                     // v2
-
-    Restore();
-}
+    // Framebuffers may be scaled with respect to the screen (e.g. on Retina displays)
+    VECTOR2U framebufferSize = compositor->GetScreenSize();
+    double scaleX = (double) framebufferSize.x / screenSize.x;
+    double scaleY = (double) framebufferSize.y / screenSize.y;
 
+    VECTOR2I origin( std::floor( aArea.GetX() * scaleX ), std::floor( aArea.GetY() * scaleY ) );
+    VECTOR2I end( std::ceil( aArea.GetRight() * scaleX ), std::ceil( aArea.GetBottom() * scaleY ) );
+    clipArea = BOX2I( origin, end - origin );
 
-void OPENGL_GAL::drawStrokedSemiCircle( const VECTOR2D& aCenterPoint, double aRadius,
-                                        double aAngle )
-{
-    double outerRadius = aRadius + ( lineWidth / 2 );
-
-    Save();
-
-    currentManager->Reserve( 3 );
-    currentManager->Translate( aCenterPoint.x, aCenterPoint.y, 0.0f );
-    currentManager->Rotate( aAngle, 0.0f, 0.0f, 1.0f );
-
-    /* Draw a triangle that contains the semicircle, then shade it to leave only
-     * the semicircle. Parameters given to Shader() are indices of the triangle's vertices
-     * (if you want to understand more, check the vertex shader source [shader.vert]), the
-     * radius and the line width. Shader uses these coordinates to determine if fragments are
-     * inside the semicircle or not.
-     *       v2
-     *       /\
-     *      /__\
-     *  v0 //__\\ v1
-     */
-    currentManager->Shader( SHADER_STROKED_CIRCLE, 4.0f, aRadius, lineWidth );
-    currentManager->Vertex( -outerRadius * 3.0f / sqrt( 3.0f ), 0.0f, layerDepth );     // v0
-
-    currentManager->Shader( SHADER_STROKED_CIRCLE, 5.0f, aRadius, lineWidth );
-    currentManager->Vertex( outerRadius * 3.0f / sqrt( 3.0f ), 0.0f, layerDepth );      // v1
-
-    currentManager->Shader( SHADER_STROKED_CIRCLE, 6.0f, aRadius, lineWidth );
-    currentManager->Vertex( 0.0f, outerRadius * 2.0f, layerDepth );                     // v2
-
-    Restore();
+    return true;
 }
 
 
-void OPENGL_GAL::drawPolygon( GLdouble* aPoints, int aPointCount )
-{
-    currentManager->Shader( SHADER_NONE );
-    currentManager->Color( fillColor.r, fillColor.g, fillColor.b, fillColor.a );
-
-    // Any non convex polygon needs to be tesselated
-    // for this purpose the GLU standard functions are used
-    TessParams params = { currentManager, tessIntersects };
-    gluTessBeginPolygon( tesselator, &params );
-    gluTessBeginContour( tesselator );
-
-    GLdouble* point = aPoints;
-
-    for( int i = 0; i < aPointCount; ++i )
-    {
-        gluTessVertex( tesselator, point, point );
-        point += 3;     // 3 coordinates
-    }
-
-    gluTessEndContour( tesselator );
-    gluTessEndPolygon( tesselator );
-
-    // Free allocated intersecting points
-    tessIntersects.clear();
-}
-
-
-void OPENGL_GAL::drawPolyline( std::function<VECTOR2D (int)> aPointGetter, int aPointCount )
-{
-    if( aPointCount < 2 )
-        return;
-
-    currentManager->Color( strokeColor.r, strokeColor.g, strokeColor.b, strokeColor.a );
-    int i;
-
-    for( i = 1; i < aPointCount; ++i )
-    {
-        auto start = aPointGetter( i - 1 );
-        auto end = aPointGetter( i );
-        const VECTOR2D startEndVector = ( end - start );
-        double lineAngle = startEndVector.Angle();
-
-        drawLineQuad( start, end );
-
-        // There is no need to draw line caps on both ends of polyline's segments
-        drawFilledSemiCircle( start, lineWidth / 2, lineAngle + M_PI / 2 );
-    }
-
-    // ..and now - draw the ending cap
-    auto start = aPointGetter( i - 2 );
-    auto end = aPointGetter( i - 1 );
-    const VECTOR2D startEndVector = ( end - start );
-    double lineAngle = startEndVector.Angle();
-    drawFilledSemiCircle( end, lineWidth / 2, lineAngle - M_PI / 2 );
-}
-
-
-int OPENGL_GAL::drawBitmapChar( unsigned long aChar )
-{
-    const float TEX_X = font_image.width;
-    const float TEX_Y = font_image.height;
-
-    const FONT_GLYPH_TYPE* glyph = LookupGlyph(aChar);
-    if( !glyph ) return 0;
-
-    const float X = glyph->atlas_x + font_information.smooth_pixels;
-    const float Y = glyph->atlas_y + font_information.smooth_pixels;
-    const float XOFF =  glyph->minx;
-
-    // adjust for height rounding
-    const float round_adjust =   ( glyph->maxy - glyph->miny )
-                               - float( glyph->atlas_h - font_information.smooth_pixels * 2 );
-    const float top_adjust   = font_information.max_y - glyph->maxy;
-    const float YOFF = round_adjust + top_adjust;
-    const float W    = glyph->atlas_w  - font_information.smooth_pixels *2;
-    const float H    = glyph->atlas_h  - font_information.smooth_pixels *2;
-    const float B    = 0;
-
-    currentManager->Reserve( 6 );
-    Translate( VECTOR2D( XOFF, YOFF ) );
-    /* Glyph:
-    * v0    v1
-    *   +--+
-    *   | /|
-    *   |/ |
-    *   +--+
-    * v2    v3
-    */
-    currentManager->Shader( SHADER_FONT, X / TEX_X, ( Y + H ) / TEX_Y );
-    currentManager->Vertex( -B,      -B, 0 );             // v0
-
-    currentManager->Shader( SHADER_FONT, ( X + W ) / TEX_X, ( Y + H ) / TEX_Y );
-    currentManager->Vertex( W + B,   -B, 0 );             // v1
-
-    currentManager->Shader( SHADER_FONT, X / TEX_X, Y / TEX_Y );
-    currentManager->Vertex( -B,   H + B, 0 );             // v2
-
-
-    currentManager->Shader( SHADER_FONT, ( X + W ) / TEX_X, ( Y + H ) / TEX_Y );
-    currentManager->Vertex( W + B, -B, 0 );               // v1
-
-    currentManager->Shader( SHADER_FONT, X / TEX_X, Y / TEX_Y );
-    currentManager->Vertex( -B,  H + B, 0 );              // v2
-
-    currentManager->Shader( SHADER_FONT, ( X + W ) / TEX_X, Y / TEX_Y );
-    currentManager->Vertex( W + B,  H + B, 0 );           // v3
-
-    Translate( VECTOR2D( -XOFF + glyph->advance, -YOFF ) );
-
-    return glyph->advance;
-}
-
-
-void OPENGL_GAL::drawBitmapOverbar( double aLength, double aHeight )
-{
-    // To draw an overbar, simply draw an overbar
-    const FONT_GLYPH_TYPE* glyph = LookupGlyph( '_' );
-    const float H = glyph->maxy - glyph->miny;
-
-    Save();
-
-    Translate( VECTOR2D( -aLength, -aHeight-1.5*H ) );
-
-    currentManager->Reserve( 6 );
-    currentManager->Color( strokeColor.r, strokeColor.g, strokeColor.b, 1 );
-
-    currentManager->Shader( 0 );
-
-    currentManager->Vertex( 0, 0, 0 );          // v0
-    currentManager->Vertex( aLength, 0, 0 );    // v1
-    currentManager->Vertex( 0, H, 0 );          // v2
-
-    currentManager->Vertex( aLength, 0, 0 );    // v1
-    currentManager->Vertex( 0, H, 0 );          // v2
-    currentManager->Vertex( aLength, H, 0 );    // v3
-
-    Restore();
-}
-
-std::pair<VECTOR2D, float> OPENGL_GAL::computeBitmapTextSize( const wxString& aText ) const
+void OPENGL_GAL::DrawCursor( const VECTOR2D& aCursorPosition )
 {
-    VECTOR2D textSize( 0, 0 );
-    float commonOffset = std::numeric_limits<float>::max();
-    bool wasTilda = false;
-
-    for( unsigned int i = 0; i < aText.length(); ++i )
-    {
-        // Remove overbar control characters
-        if( aText[i] == '~' )
-        {
-            if( !wasTilda )
-            {
-                // Only double tildas are counted as characters, so skip it as it might
-                // be an overbar control character
-                wasTilda = true;
-                continue;
-            }
-            else
-            {
-                // Double tilda detected, reset the state and process as a normal character
-                wasTilda = false;
-            }
-        }
-
-        const FONT_GLYPH_TYPE* glyph = LookupGlyph(aText[i]);
-        if( glyph ) {
-            textSize.x  += glyph->advance;
-            textSize.y   = std::max<float>( textSize.y, font_information.max_y - glyph->miny );
-            commonOffset = std::min<float>( font_information.max_y - glyph->maxy, commonOffset );
-        }
-    }
-
-    textSize.y -= commonOffset;
-
-    return std::make_pair( textSize, commonOffset );
+    // Now we should only store the position of the mouse cursor
+    // The real drawing routines are in blitCursor()
+    //VECTOR2D screenCursor = worldScreenMatrix * aCursorPosition;
+    //cursorPosition = screenWorldMatrix * VECTOR2D( screenCursor.x, screenCursor.y );
+    cursorPosition = aCursorPosition;
 }
 
 
@@ -1585,53 +868,3 @@ void OPENGL_GAL::init()
     GL_CONTEXT_MANAGER::Get().UnlockCtx( glPrivContext );
     isInitialized = true;
 }
-
-
-// ------------------------------------- // Callback functions for the tesselator // ------------------------------------- // Compare Redbook Chapter 11
-void CALLBACK VertexCallback( GLvoid* aVertexPtr, void* aData )
-{
-    GLdouble* vertex = static_cast<GLdouble*>( aVertexPtr );
-    OPENGL_GAL::TessParams* param = static_cast<OPENGL_GAL::TessParams*>( aData );
-    VERTEX_MANAGER* vboManager = param->vboManager;
-
-    assert( vboManager );
-    vboManager->Vertex( vertex[0], vertex[1], vertex[2] );
-}
-
-
-void CALLBACK CombineCallback( GLdouble coords[3],
-                               GLdouble* vertex_data[4],
-                               GLfloat weight[4], GLdouble** dataOut, void* aData )
-{
-    GLdouble* vertex = new GLdouble[3];
-    OPENGL_GAL::TessParams* param = static_cast<OPENGL_GAL::TessParams*>( aData );
-
-    // Save the pointer so we can delete it later
-    param->intersectPoints.push_back( boost::shared_array<GLdouble>( vertex ) );
-
-    memcpy( vertex, coords, 3 * sizeof(GLdouble) );
-
-    *dataOut = vertex;
-}
-
-
-void CALLBACK EdgeCallback( GLboolean aEdgeFlag )
-{
-    // This callback is needed to force GLU tesselator to use triangles only
-}
-
-
-void CALLBACK ErrorCallback( GLenum aErrorCode )
-{
-    //throw std::runtime_error( std::string( "Tessellation error: " ) +
-                              //std::string( (const char*) gluErrorString( aErrorCode ) );
-}
-
-
-static void InitTesselatorCallbacks( GLUtesselator* aTesselator )
-{
-    gluTessCallback( aTesselator, GLU_TESS_VERTEX_DATA,  ( void (CALLBACK*)() )VertexCallback );
-    gluTessCallback( aTesselator, GLU_TESS_COMBINE_DATA, ( void (CALLBACK*)() )CombineCallback );
-    gluTessCallback( aTesselator, GLU_TESS_EDGE_FLAG,    ( void (CALLBACK*)() )EdgeCallback );
-    gluTessCallback( aTesselator, GLU_TESS_ERROR,        ( void (CALLBACK*)() )ErrorCallback );
-}
@@ -34,12 +34,15 @@
 
 using namespace KIGFX;
 
-VERTEX_CONTAINER* VERTEX_CONTAINER::MakeContainer( bool aCached )
+VERTEX_CONTAINER* VERTEX_CONTAINER::MakeContainer( bool aCached, unsigned int aInitialSize )
 {
+    if( aInitialSize == 0 )
+        aInitialSize = defaultInitSize;
+
     if( aCached )
-        return new CACHED_CONTAINER;
+        return new CACHED_CONTAINER( aInitialSize );
     else
-        return new NONCACHED_CONTAINER;
+        return new NONCACHED_CONTAINER( aInitialSize );
 }
 
 
@@ -34,7 +34,7 @@
 using namespace KIGFX;
 
 VERTEX_ITEM::VERTEX_ITEM( const VERTEX_MANAGER& aManager ) :
-    m_manager( aManager ), m_offset( 0 ), m_size( 0 )
+    m_manager( aManager ), m_offset( 0 ), m_size( 0 ), m_chunk( -1 )
 {
     // As the item is created, we are going to modify it, so call to SetItem() is needed
     m_manager.SetItem( *this );
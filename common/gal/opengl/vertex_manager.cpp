@@ -34,13 +34,14 @@
 #include <gal/opengl/gpu_manager.h>
 #include <gal/opengl/vertex_item.h>
 #include <confirm.h>
+#include <cstring>
 
 using namespace KIGFX;
 
-VERTEX_MANAGER::VERTEX_MANAGER( bool aCached ) :
+VERTEX_MANAGER::VERTEX_MANAGER( bool aCached, unsigned int aInitialSize ) :
     m_noTransform( true ), m_transform( 1.0f ), m_reserved( NULL ), m_reservedSpace( 0 )
 {
-    m_container.reset( VERTEX_CONTAINER::MakeContainer( aCached ) );
+    m_container.reset( VERTEX_CONTAINER::MakeContainer( aCached, aInitialSize ) );
     m_gpu.reset( GPU_MANAGER::MakeManager( m_container.get() ) );
 
     // There is no shader used by default
@@ -57,6 +58,8 @@ void VERTEX_MANAGER::Map()
 
 void VERTEX_MANAGER::Unmap()
 {
+    // Updates are finished, so it is a good moment to reduce fragmentation
+    m_container->Compact();
     m_container->Unmap();
 }
 
@@ -154,6 +157,30 @@ bool VERTEX_MANAGER::Vertices( const VERTEX aVertices[], unsigned int aSize )
 }
 
 
+bool VERTEX_MANAGER::CopyVertices( const VERTEX aVertices[], unsigned int aSize )
+{
+    // flag to avoid hanging by calling DisplayError too many times:
+    static bool show_err = true;
+
+    VERTEX* newVertex = m_container->Allocate( aSize );
+
+    if( newVertex == NULL )
+    {
+        if( show_err )
+        {
+            DisplayError( NULL, wxT( "VERTEX_MANAGER::CopyVertices: Vertex allocation error" ) );
+            show_err = false;
+        }
+
+        return false;
+    }
+
+    memcpy( newVertex, aVertices, aSize * VertexSize );
+
+    return true;
+}
+
+
 void VERTEX_MANAGER::SetItem( VERTEX_ITEM& aItem ) const
 {
     m_container->SetItem( &aItem );
@@ -218,6 +245,18 @@ VERTEX* VERTEX_MANAGER::GetVertices( const VERTEX_ITEM& aItem ) const
 }
 
 
+VERTEX* VERTEX_MANAGER::GetVertices( unsigned int aOffset ) const
+{
+    return m_container->GetVertices( aOffset );
+}
+
+
+unsigned int VERTEX_MANAGER::GetSize() const
+{
+    return m_container->GetSize();
+}
+
+
 void VERTEX_MANAGER::SetShader( SHADER& aShader ) const
 {
     m_gpu->SetShader( aShader );
@@ -245,6 +284,12 @@ void VERTEX_MANAGER::DrawItem( const VERTEX_ITEM& aItem ) const
 }
 
 
+void VERTEX_MANAGER::DrawItemInstance( const VERTEX_ITEM& aItem, const VECTOR2D& aOffset ) const
+{
+    m_gpu->DrawInstance( aItem.GetOffset(), aItem.GetSize(), aOffset );
+}
+
+
 void VERTEX_MANAGER::EndDrawing() const
 {
     m_gpu->EndDrawing();
@@ -37,6 +37,7 @@ const double STROKE_FONT::OVERBAR_POSITION_FACTOR = 1.22;
 const double STROKE_FONT::BOLD_FACTOR = 1.3;
 const double STROKE_FONT::STROKE_FONT_SCALE = 1.0 / 21.0;
 const double STROKE_FONT::ITALIC_TILT = 1.0 / 8;
+const unsigned int STROKE_FONT::TEXT_CACHE_SIZE = 4096;
 
 STROKE_FONT::STROKE_FONT( GAL* aGal ) :
     m_gal( aGal )
@@ -46,8 +47,11 @@ STROKE_FONT::STROKE_FONT( GAL* aGal ) :
 
 bool STROKE_FONT::LoadNewStrokeFont( const char* const aNewStrokeFont[], int aNewStrokeFontSize )
 {
+    m_glyphPoints.clear();
+    m_glyphStrokeSizes.clear();
     m_glyphs.clear();
     m_glyphBoundingBoxes.clear();
+    m_textCache.clear();
     m_glyphs.resize( aNewStrokeFontSize );
     m_glyphBoundingBoxes.resize( aNewStrokeFontSize );
 
@@ -112,7 +116,17 @@ bool STROKE_FONT::LoadNewStrokeFont( const char* const aNewStrokeFont[], int aNe
         if( pointList.size() > 0 )
             glyph.push_back( pointList );
 
-        m_glyphs[j] = glyph;
+        // Store the strokes in the contiguous arrays
+        GLYPH_SPAN& span = m_glyphs[j];
+        span.m_firstPoint = m_glyphPoints.size();
+        span.m_firstStroke = m_glyphStrokeSizes.size();
+        span.m_strokeCount = glyph.size();
+
+        for( const std::deque<VECTOR2D>& stroke : glyph )
+        {
+            m_glyphPoints.insert( m_glyphPoints.end(), stroke.begin(), stroke.end() );
+            m_glyphStrokeSizes.push_back( stroke.size() );
+        }
 
         // Compute the bounding box of the glyph
         m_glyphBoundingBoxes[j] = computeBoundingBox( glyph, glyphBoundingX );
@@ -241,18 +255,8 @@ void STROKE_FONT::Draw( const UTF8& aText, const VECTOR2D& aPosition, double aRo
 
 void STROKE_FONT::drawSingleLineText( const UTF8& aText )
 {
-    // By default the overbar is turned off
-    bool overbar = false;
-
-    double      xOffset;
-    VECTOR2D    glyphSize( m_gal->GetGlyphSize() );
-    double      overbar_italic_comp = computeOverbarVerticalPosition() * ITALIC_TILT;
-
-    if( m_gal->IsTextMirrored() )
-        overbar_italic_comp = -overbar_italic_comp;
-
-    // Compute the text size
-    VECTOR2D textSize = computeTextLineSize( aText );
+    const TEXT_LINE_SHAPE& shape = getTextLineShape( aText );
+    const VECTOR2D& textSize = shape.m_size;
     double half_thickness = m_gal->GetLineWidth()/2;
 
     // Context needs to be saved before any transformations
@@ -286,12 +290,88 @@ void STROKE_FONT::drawSingleLineText( const UTF8& aText )
         break;
     }
 
-    if( m_gal->IsTextMirrored() )
+    // The whole line is submitted at once
+    if( !shape.m_strokeSizes.empty() )
+    {
+        m_gal->DrawPolylines( &shape.m_points[0], &shape.m_strokeSizes[0],
+                              shape.m_strokeSizes.size() );
+    }
+
+    m_gal->Restore();
+}
+
+
+bool STROKE_FONT::TEXT_LINE_KEY::operator<( const TEXT_LINE_KEY& aOther ) const
+{
+    if( m_glyphSize.x != aOther.m_glyphSize.x )
+        return m_glyphSize.x < aOther.m_glyphSize.x;
+
+    if( m_glyphSize.y != aOther.m_glyphSize.y )
+        return m_glyphSize.y < aOther.m_glyphSize.y;
+
+    if( m_lineWidth != aOther.m_lineWidth )
+        return m_lineWidth < aOther.m_lineWidth;
+
+    if( m_italic != aOther.m_italic )
+        return m_italic < aOther.m_italic;
+
+    if( m_mirrored != aOther.m_mirrored )
+        return m_mirrored < aOther.m_mirrored;
+
+    return m_text < aOther.m_text;
+}
+
+
+const STROKE_FONT::TEXT_LINE_SHAPE& STROKE_FONT::getTextLineShape( const UTF8& aText )
+{
+    TEXT_LINE_KEY key;
+
+    key.m_text = aText;
+    key.m_glyphSize = m_gal->GetGlyphSize();
+    key.m_lineWidth = m_gal->GetLineWidth();
+    key.m_italic = m_gal->IsFontItalic();
+    key.m_mirrored = m_gal->IsTextMirrored();
+
+    auto it = m_textCache.find( key );
+
+    if( it != m_textCache.end() )
+        return it->second;
+
+    // Texts are usually drawn with a few distinct sizes, so when the cache is full
+    // it is simply restarted instead of tracking the least recently used entries.
+    if( m_textCache.size() >= TEXT_CACHE_SIZE )
+        m_textCache.clear();
+
+    TEXT_LINE_SHAPE& shape = m_textCache[key];
+    tessellateTextLine( aText, shape );
+
+    return shape;
+}
+
+
+void STROKE_FONT::tessellateTextLine( const UTF8& aText, TEXT_LINE_SHAPE& aShape ) const
+{
+    // By default the overbar is turned off
+    bool overbar = false;
+
+    double      xOffset;
+    VECTOR2D    glyphSize( m_gal->GetGlyphSize() );
+    bool        italic = m_gal->IsFontItalic();
+    bool        mirrored = m_gal->IsTextMirrored();
+    double      overbar_italic_comp = computeOverbarVerticalPosition() * ITALIC_TILT;
+
+    if( mirrored )
+        overbar_italic_comp = -overbar_italic_comp;
+
+    // Compute the text size
+    aShape.m_size = computeTextLineSize( aText );
+
+    if( mirrored )
     {
         // In case of mirrored text invert the X scale of points and their X direction
         // (m_glyphSize.x) and start drawing from the position where text normally should end
         // (textSize.x)
-        xOffset = textSize.x - m_gal->GetLineWidth();
+        xOffset = aShape.m_size.x - m_gal->GetLineWidth();
         glyphSize.x = -glyphSize.x;
     }
     else
@@ -318,13 +398,9 @@ void STROKE_FONT::drawSingleLineText( const UTF8& aText )
             // If it is a double tilda, just process the second one
         }
 
-        int dd = *chIt - ' ';
-
-        if( dd >= (int) m_glyphBoundingBoxes.size() || dd < 0 )
-            dd = '?' - ' ';
-
-        GLYPH& glyph = m_glyphs[dd];
-        BOX2D& bbox  = m_glyphBoundingBoxes[dd];
+        int dd = glyphIndex( *chIt );
+        const GLYPH_SPAN& glyph = m_glyphs[dd];
+        const BOX2D& bbox = m_glyphBoundingBoxes[dd];
 
         if( overbar )
         {
@@ -339,46 +415,43 @@ void STROKE_FONT::drawSingleLineText( const UTF8& aText )
                 last_had_overbar = true;
             }
 
-            VECTOR2D startOverbar( overbar_start_x, overbar_start_y );
-            VECTOR2D endOverbar( overbar_end_x, overbar_end_y );
-
-            m_gal->DrawLine( startOverbar, endOverbar );
+            aShape.m_points.push_back( VECTOR2D( overbar_start_x, overbar_start_y ) );
+            aShape.m_points.push_back( VECTOR2D( overbar_end_x, overbar_end_y ) );
+            aShape.m_strokeSizes.push_back( 2 );
         }
         else
         {
             last_had_overbar = false;
         }
 
-        for( GLYPH::iterator pointListIt = glyph.begin(); pointListIt != glyph.end();
-             ++pointListIt )
+        const VECTOR2D* point = m_glyphPoints.data() + glyph.m_firstPoint;
+
+        for( int stroke = 0; stroke < glyph.m_strokeCount; ++stroke )
         {
-            std::deque<VECTOR2D> pointListScaled;
+            int strokeSize = m_glyphStrokeSizes[glyph.m_firstStroke + stroke];
 
-            for( std::deque<VECTOR2D>::iterator pointIt = pointListIt->begin();
-                 pointIt != pointListIt->end(); ++pointIt )
+            for( int i = 0; i < strokeSize; ++i, ++point )
             {
-                VECTOR2D pointPos( pointIt->x * glyphSize.x + xOffset, pointIt->y * glyphSize.y );
+                VECTOR2D pointPos( point->x * glyphSize.x + xOffset, point->y * glyphSize.y );
 
-                if( m_gal->IsFontItalic() )
+                if( italic )
                 {
                     // FIXME should be done other way - referring to the lowest Y value of point
                     // because now italic fonts are translated a bit
-                    if( m_gal->IsTextMirrored() )
+                    if( mirrored )
                         pointPos.x += pointPos.y * STROKE_FONT::ITALIC_TILT;
                     else
                         pointPos.x -= pointPos.y * STROKE_FONT::ITALIC_TILT;
                 }
 
-                pointListScaled.push_back( pointPos );
+                aShape.m_points.push_back( pointPos );
             }
 
-            m_gal->DrawPolyline( pointListScaled );
+            aShape.m_strokeSizes.push_back( strokeSize );
         }
 
         xOffset += glyphSize.x * bbox.GetEnd().x;
     }
-
-    m_gal->Restore();
 }
 
 
@@ -427,10 +500,7 @@ VECTOR2D STROKE_FONT::ComputeStringBoundaryLimits( const UTF8& aText, VECTOR2D a
         }
 
         // Index in the bounding boxes table
-        int dd = *it - ' ';
-
-        if( dd >= (int) m_glyphBoundingBoxes.size() || dd < 0 )
-            dd = '?' - ' ';
+        int dd = glyphIndex( *it );
 
         const BOX2D& box = m_glyphBoundingBoxes[dd];
 
@@ -0,0 +1,210 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <algorithm>
+#include <climits>
+
+#include <geometry/seg_batch.h>
+
+#if defined( __AVX2__ )
+#define SEG_BATCH_AVX2
+#include <immintrin.h>
+#elif defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#define SEG_BATCH_SSE2
+#include <emmintrin.h>
+#endif
+
+// The vector kernels load the coordinates straight from the VECTOR2I arrays
+static_assert( sizeof( VECTOR2I ) == 2 * sizeof( int ), "VECTOR2I must be a packed pair of ints" );
+
+
+namespace
+{
+
+///> Reference bounding box inflated by the clearance, clamped to the int range.
+struct QUERY_BOX
+{
+    int xmin, ymin, xmax, ymax;
+};
+
+
+inline int clampCoord( int64_t aValue )
+{
+    return (int) std::max( (int64_t) INT_MIN, std::min( (int64_t) INT_MAX, aValue ) );
+}
+
+
+inline QUERY_BOX makeQueryBox( const SEG& aRef, int aClearance )
+{
+    QUERY_BOX q;
+
+    q.xmin = clampCoord( (int64_t) std::min( aRef.A.x, aRef.B.x ) - aClearance );
+    q.ymin = clampCoord( (int64_t) std::min( aRef.A.y, aRef.B.y ) - aClearance );
+    q.xmax = clampCoord( (int64_t) std::max( aRef.A.x, aRef.B.x ) + aClearance );
+    q.ymax = clampCoord( (int64_t) std::max( aRef.A.y, aRef.B.y ) + aClearance );
+
+    return q;
+}
+
+
+inline bool scalarTest( const VECTOR2I& aA, const VECTOR2I& aB, const QUERY_BOX& aQ )
+{
+    if( std::min( aA.x, aB.x ) > aQ.xmax || std::max( aA.x, aB.x ) < aQ.xmin )
+        return false;
+
+    if( std::min( aA.y, aB.y ) > aQ.ymax || std::max( aA.y, aB.y ) < aQ.ymin )
+        return false;
+
+    return true;
+}
+
+
+#if defined( SEG_BATCH_AVX2 )
+
+///> Splits 8 consecutive points into x and y vectors.
+inline void load8( const VECTOR2I* aPoints, __m256i& aXs, __m256i& aYs )
+{
+    __m256i lo = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( aPoints ) );
+    __m256i hi = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( aPoints + 4 ) );
+
+    // (x0 y0 x1 y1 | x2 y2 x3 y3) -> (x0 x1 y0 y1 | x2 x3 y2 y3) -> (x0 x1 x2 x3 | y0 y1 y2 y3)
+    lo = _mm256_permute4x64_epi64( _mm256_shuffle_epi32( lo, _MM_SHUFFLE( 3, 1, 2, 0 ) ),
+                                   _MM_SHUFFLE( 3, 1, 2, 0 ) );
+    hi = _mm256_permute4x64_epi64( _mm256_shuffle_epi32( hi, _MM_SHUFFLE( 3, 1, 2, 0 ) ),
+                                   _MM_SHUFFLE( 3, 1, 2, 0 ) );
+
+    aXs = _mm256_permute2x128_si256( lo, hi, 0x20 );
+    aYs = _mm256_permute2x128_si256( lo, hi, 0x31 );
+}
+
+
+inline uint32_t test8( const VECTOR2I* aPoints, const QUERY_BOX& aQ )
+{
+    __m256i ax, ay, bx, by;
+
+    load8( aPoints, ax, ay );
+    load8( aPoints + 1, bx, by );
+
+    const __m256i xmin = _mm256_min_epi32( ax, bx );
+    const __m256i xmax = _mm256_max_epi32( ax, bx );
+    const __m256i ymin = _mm256_min_epi32( ay, by );
+    const __m256i ymax = _mm256_max_epi32( ay, by );
+
+    __m256i reject = _mm256_cmpgt_epi32( xmin, _mm256_set1_epi32( aQ.xmax ) );
+    reject = _mm256_or_si256( reject, _mm256_cmpgt_epi32( _mm256_set1_epi32( aQ.xmin ), xmax ) );
+    reject = _mm256_or_si256( reject, _mm256_cmpgt_epi32( ymin, _mm256_set1_epi32( aQ.ymax ) ) );
+    reject = _mm256_or_si256( reject, _mm256_cmpgt_epi32( _mm256_set1_epi32( aQ.ymin ), ymax ) );
+
+    return ~_mm256_movemask_ps( _mm256_castsi256_ps( reject ) ) & 0xff;
+}
+
+#elif defined( SEG_BATCH_SSE2 )
+
+///> Splits 4 consecutive points into x and y vectors.
+inline void load4( const VECTOR2I* aPoints, __m128i& aXs, __m128i& aYs )
+{
+    __m128i lo = _mm_loadu_si128( reinterpret_cast<const __m128i*>( aPoints ) );
+    __m128i hi = _mm_loadu_si128( reinterpret_cast<const __m128i*>( aPoints + 2 ) );
+
+    // (x0 y0 x1 y1) -> (x0 x1 y0 y1)
+    lo = _mm_shuffle_epi32( lo, _MM_SHUFFLE( 3, 1, 2, 0 ) );
+    hi = _mm_shuffle_epi32( hi, _MM_SHUFFLE( 3, 1, 2, 0 ) );
+
+    aXs = _mm_unpacklo_epi64( lo, hi );
+    aYs = _mm_unpackhi_epi64( lo, hi );
+}
+
+
+// SSE2 has no 32-bit integer min/max, emulate them with a compare and a blend
+inline __m128i min4( __m128i aA, __m128i aB )
+{
+    const __m128i gt = _mm_cmpgt_epi32( aA, aB );
+    return _mm_or_si128( _mm_and_si128( gt, aB ), _mm_andnot_si128( gt, aA ) );
+}
+
+
+inline __m128i max4( __m128i aA, __m128i aB )
+{
+    const __m128i gt = _mm_cmpgt_epi32( aA, aB );
+    return _mm_or_si128( _mm_and_si128( gt, aA ), _mm_andnot_si128( gt, aB ) );
+}
+
+
+inline uint32_t test4( const VECTOR2I* aPoints, const QUERY_BOX& aQ )
+{
+    __m128i ax, ay, bx, by;
+
+    load4( aPoints, ax, ay );
+    load4( aPoints + 1, bx, by );
+
+    __m128i reject = _mm_cmpgt_epi32( min4( ax, bx ), _mm_set1_epi32( aQ.xmax ) );
+    reject = _mm_or_si128( reject, _mm_cmplt_epi32( max4( ax, bx ), _mm_set1_epi32( aQ.xmin ) ) );
+    reject = _mm_or_si128( reject, _mm_cmpgt_epi32( min4( ay, by ), _mm_set1_epi32( aQ.ymax ) ) );
+    reject = _mm_or_si128( reject, _mm_cmplt_epi32( max4( ay, by ), _mm_set1_epi32( aQ.ymin ) ) );
+
+    return ~_mm_movemask_ps( _mm_castsi128_ps( reject ) ) & 0xf;
+}
+
+#endif
+
+}
+
+
+uint32_t SegBatchFilter( const VECTOR2I* aPoints, int aCount, const SEG& aRef, int aClearance )
+{
+    const QUERY_BOX q = makeQueryBox( aRef, aClearance );
+    uint32_t mask = 0;
+    int i = 0;
+
+    aCount = std::min( aCount, SEG_BATCH_SIZE );
+
+#if defined( SEG_BATCH_AVX2 )
+    // 8 segments need 9 points, the loads read the points [i, i + 8]
+    for( ; i + 8 <= aCount; i += 8 )
+        mask |= test8( aPoints + i, q ) << i;
+#elif defined( SEG_BATCH_SSE2 )
+    // 4 segments need 5 points, the loads read the points [i, i + 4]
+    for( ; i + 4 <= aCount; i += 4 )
+        mask |= test4( aPoints + i, q ) << i;
+#endif
+
+    for( ; i < aCount; i++ )
+    {
+        if( scalarTest( aPoints[i], aPoints[i + 1], q ) )
+            mask |= 1u << i;
+    }
+
+    return mask;
+}
+
+
+const char* SegBatchDescribe()
+{
+#if defined( SEG_BATCH_AVX2 )
+    return "avx2";
+#elif defined( SEG_BATCH_SSE2 )
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
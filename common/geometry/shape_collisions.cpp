@@ -149,16 +149,13 @@ static VECTOR2I pushoutForce( const SHAPE_CIRCLE& aA, const SEG& aB, int aCleara
 static inline bool Collide( const SHAPE_CIRCLE& aA, const SHAPE_LINE_CHAIN& aB, int aClearance,
                             bool aNeedMTV, VECTOR2I& aMTV )
 {
-    bool found = false;
+    const VECTOR2I c = aA.GetCenter();
 
-    for( int s = 0; s < aB.SegmentCount(); s++ )
-    {
-        if( aA.Collide( aB.CSegment( s ), aClearance ) )
-        {
-            found = true;
-            break;
-        }
-    }
+    // Only the segments whose bounding boxes are within reach of the circle can collide
+    bool found = aB.VisitSegmentsNear( SEG( c, c ), aClearance + aA.GetRadius(),
+                                       [&]( int s ) {
+        return aA.Collide( aB.CSegment( s ), aClearance );
+    } );
 
     if( !aNeedMTV || !found )
         return found;
@@ -220,11 +217,16 @@ static inline bool Collide( const SHAPE_CIRCLE& aA, const SHAPE_SEGMENT& aSeg, i
 static inline bool Collide( const SHAPE_LINE_CHAIN& aA, const SHAPE_LINE_CHAIN& aB, int aClearance,
                             bool aNeedMTV, VECTOR2I& aMTV )
 {
-    for( int i = 0; i < aB.SegmentCount(); i++ )
-        if( aA.Collide( aB.CSegment( i ), aClearance ) )
-            return true;
+    if( !aA.PointCount() )
+        return false;
 
-    return false;
+    const BOX2I bbox = aA.BBox();
+    const SEG diag( bbox.GetOrigin(), bbox.GetEnd() );
+
+    // Skip the segments of aB lying far away from aA as a whole
+    return aB.VisitSegmentsNear( diag, aClearance, [&]( int i ) {
+        return aA.Collide( aB.CSegment( i ), aClearance );
+    } );
 }
 
 
@@ -245,15 +247,13 @@ static inline bool Collide( const SHAPE_CONVEX& aA, const SHAPE_CONVEX& aB, int
 static inline bool Collide( const SHAPE_RECT& aA, const SHAPE_LINE_CHAIN& aB, int aClearance,
                             bool aNeedMTV, VECTOR2I& aMTV )
 {
-    for( int s = 0; s < aB.SegmentCount(); s++ )
-    {
-        SEG seg = aB.CSegment( s );
+    const SEG diag( aA.GetPosition(), aA.GetPosition() + aA.GetSize() );
 
-        if( aA.Collide( seg, aClearance ) )
-            return true;
-    }
+    return aB.VisitSegmentsNear( diag, aClearance, [&]( int s ) {
+        SEG seg = aB.CSegment( s );
 
-    return false;
+        return aA.Collide( seg, aClearance );
+    } );
 }
 
 
@@ -22,6 +22,8 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#include <algorithm>
+
 #include <geometry/shape_line_chain.h>
 #include <geometry/shape_circle.h>
 
@@ -40,21 +42,15 @@ bool SHAPE_LINE_CHAIN::Collide( const SEG& aSeg, int aClearance ) const
     BOX2I box_a( aSeg.A, aSeg.B - aSeg.A );
     BOX2I::ecoord_type dist_sq = (BOX2I::ecoord_type) aClearance * aClearance;
 
-    for( int i = 0; i < SegmentCount(); i++ )
-    {
+    // The batch filter only skips segments whose bounding boxes are too far from aSeg
+    return VisitSegmentsNear( aSeg, aClearance, [&]( int i ) {
         const SEG& s = CSegment( i );
         BOX2I box_b( s.A, s.B - s.A );
 
         BOX2I::ecoord_type d = box_a.SquaredDistance( box_b );
 
-        if( d < dist_sq )
-        {
-            if( s.Collide( aSeg, aClearance ) )
-                return true;
-        }
-    }
-
-    return false;
+        return d < dist_sq && s.Collide( aSeg, aClearance );
+    } );
 }
 
 
@@ -229,8 +225,8 @@ struct compareOriginDistance
 
 int SHAPE_LINE_CHAIN::Intersect( const SEG& aSeg, INTERSECTIONS& aIp ) const
 {
-    for( int s = 0; s < SegmentCount(); s++ )
-    {
+    // Intersecting segments always have overlapping bounding boxes
+    VisitSegmentsNear( aSeg, 0, [&]( int s ) {
         OPT_VECTOR2I p = CSegment( s ).Intersect( aSeg );
 
         if( p )
@@ -241,7 +237,9 @@ int SHAPE_LINE_CHAIN::Intersect( const SEG& aSeg, INTERSECTIONS& aIp ) const
             is.p = *p;
             aIp.push_back( is );
         }
-    }
+
+        return false;
+    } );
 
     compareOriginDistance comp( aSeg.A );
     sort( aIp.begin(), aIp.end(), comp );
@@ -262,8 +260,8 @@ int SHAPE_LINE_CHAIN::Intersect( const SHAPE_LINE_CHAIN& aChain, INTERSECTIONS&
         if( !bb_other.Intersects( bb_cur ) )
             continue;
 
-        for( int s2 = 0; s2 < aChain.SegmentCount(); s2++ )
-        {
+        // SEG::Contains() accepts points up to 1 unit away from the segment
+        aChain.VisitSegmentsNear( a, 1, [&]( int s2 ) {
             const SEG& b = aChain.CSegment( s2 );
             INTERSECTION is;
 
@@ -289,7 +287,9 @@ int SHAPE_LINE_CHAIN::Intersect( const SHAPE_LINE_CHAIN& aChain, INTERSECTIONS&
                     aIp.push_back( is );
                 }
             }
-        }
+
+            return false;
+        } );
     }
 
     return aIp.size();
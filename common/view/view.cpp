@@ -34,6 +34,14 @@
 #include <gal/definitions.h>
 #include <gal/graphics_abstraction_layer.h>
 #include <painter.h>
+#include <frame_profiler.h>
+
+#include <algorithm>
+#include <memory>
+
+#ifdef USE_OPENMP
+#include <omp.h>
+#endif /* USE_OPENMP */
 
 #ifdef __WXDEBUG__
 #include <profile.h>
@@ -89,6 +97,7 @@ private:
     VIEW*   m_view;             ///< Current dynamic view the item is assigned to.
     int     m_flags;            ///< Visibility flags
     int     m_requiredUpdate;   ///< Flag required for updating
+    BOX2I   m_bbox;             ///< Bounding box the item is indexed with
 
     ///> Helper for storing cached items group ids
     typedef std::pair<int, int> GroupPair;
@@ -260,7 +269,11 @@ VIEW::VIEW( bool aIsDynamic ) :
     m_mirrorX( false ), m_mirrorY( false ),
     m_painter( NULL ),
     m_gal( NULL ),
-    m_dynamic( aIsDynamic )
+    m_dynamic( aIsDynamic ),
+    m_isDirtyArea( false ),
+    m_partialRedraw( false ),
+    m_useInstancing( false ),
+    m_frameCounter( 0 )
 {
     m_boundary.SetMaximum();
     m_allItems.reserve( 32768 );
@@ -310,6 +323,7 @@ void VIEW::Add( VIEW_ITEM* aItem )
 
     aItem->ViewGetLayers( layers, layers_count );
     aItem->viewPrivData()->saveLayers( layers, layers_count );
+    aItem->viewPrivData()->m_bbox = aItem->ViewBBox();
 
     m_allItems.push_back( aItem );
 
@@ -317,7 +331,7 @@ void VIEW::Add( VIEW_ITEM* aItem )
     {
         VIEW_LAYER& l = m_layers[layers[i]];
         l.items->Insert( aItem );
-        MarkTargetDirty( l.target );
+        MarkTargetDirty( l.target, aItem->viewPrivData()->m_bbox );
     }
 
     SetVisible( aItem, true );
@@ -350,7 +364,7 @@ void VIEW::Remove( VIEW_ITEM* aItem )
     {
         VIEW_LAYER& l = m_layers[layers[i]];
         l.items->Remove( aItem );
-        MarkTargetDirty( l.target );
+        MarkTargetDirty( l.target, viewData->m_bbox );
 
         // Clear the GAL cache
         int prevGroup = viewData->getGroup( layers[i] );
@@ -472,6 +486,7 @@ void VIEW::SetGAL( GAL* aGal )
 
     // clear group numbers, so everything is going to be recached
     clearGroupCache();
+    clearInstanceTemplates( false );
 
     // every target has to be refreshed
     MarkDirty();
@@ -715,6 +730,13 @@ void VIEW::ChangeLayerDepth( int aLayer, int aDepth )
     m_gal->BeginUpdate();
     changeItemsDepth visitor( aLayer, aDepth, m_gal );
     m_layers[aLayer].items->Query( r, visitor );
+
+    for( INSTANCE_TEMPLATES::value_type& tmpl : m_instanceTemplates )
+    {
+        if( tmpl.second.layer == aLayer )
+            m_gal->ChangeGroupDepth( tmpl.second.group, aDepth );
+    }
+
     m_gal->EndUpdate();
 
     MarkTargetDirty( m_layers[aLayer].target );
@@ -837,19 +859,205 @@ struct VIEW::drawItem
 };
 
 
+/**
+ * Wraps an R-tree query visitor to tell the time spent searching the tree from the time
+ * spent in the visitor. The search time is added to the VIEW_QUERY section of the frame
+ * profiler when the query is finished.
+ */
+template <class VISITOR>
+class QUERY_TIMER
+{
+public:
+    QUERY_TIMER( VISITOR& aVisitor ) :
+        m_visitor( aVisitor ),
+        m_visitTime( 0 ),
+        m_start( std::chrono::steady_clock::now() )
+    {
+    }
+
+    ~QUERY_TIMER()
+    {
+        auto elapsed = std::chrono::steady_clock::now() - m_start - m_visitTime;
+
+        FRAME_PROFILER::Instance().AddSample( FRAME_PROFILER::VIEW_QUERY,
+                std::chrono::duration_cast<std::chrono::nanoseconds>( elapsed ).count() );
+    }
+
+    bool operator()( VIEW_ITEM* aItem )
+    {
+        auto start = std::chrono::steady_clock::now();
+        bool result = m_visitor( aItem );
+
+        m_visitTime += std::chrono::steady_clock::now() - start;
+
+        return result;
+    }
+
+private:
+    VISITOR& m_visitor;
+    std::chrono::steady_clock::duration m_visitTime;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+
+struct VIEW::drawTileItem
+{
+    drawTileItem( VIEW* aView, int aLayer, TILE& aTile ) :
+        view( aView ), layer( aLayer ), tile( aTile )
+    {
+    }
+
+    bool operator()( VIEW_ITEM* aItem )
+    {
+        bool drawCondition = aItem->viewPrivData()->isRenderable() &&
+                             aItem->ViewGetLOD( layer, view ) < view->m_scale;
+        if( !drawCondition )
+            return true;
+
+        // Tiles are always drawn in the immediate mode, the GAL cache is not thread-safe
+        if( !tile.painter->Draw( aItem, layer ) )
+            tile.fallback.push_back( aItem );
+
+        return true;
+    }
+
+    VIEW* view;
+    int layer;
+    TILE& tile;
+};
+
+
 void VIEW::redrawRect( const BOX2I& aRect )
 {
+    // Software rendering GALs may split the screen into tiles drawn concurrently
+    std::vector<TILE> tiles;
+    int tileCount = m_gal->GetTileCount();
+
+    // Partial redraws cover small areas, splitting them is not worth the overhead
+    if( tileCount > 1 && !m_partialRedraw )
+    {
+        for( int i = 0; i < tileCount; ++i )
+        {
+            TILE tile;
+            tile.gal = NULL;
+            tile.painter.reset( m_painter->Clone() );
+
+            if( !tile.painter )
+                break;
+
+            tiles.push_back( std::move( tile ) );
+        }
+
+        if( (int) tiles.size() < tileCount )
+            tiles.clear();
+    }
+
     for( VIEW_LAYER* l : m_orderedLayers )
     {
         if( l->visible && IsTargetDirty( l->target ) && areRequiredLayersEnabled( l->id ) )
         {
-            drawItem drawFunc( this, l->id );
-
             m_gal->SetTarget( l->target );
             m_gal->SetLayerDepth( l->renderingOrder );
-            l->items->Query( aRect, drawFunc );
+
+            if( !tiles.empty() )
+            {
+                redrawTiles( *l, aRect, tiles );
+            }
+            else
+            {
+                drawItem drawFunc( this, l->id );
+
+                if( FRAME_PROFILER::IsEnabled() )
+                {
+                    QUERY_TIMER<drawItem> timer( drawFunc );
+                    l->items->Query( aRect, timer );
+                }
+                else
+                {
+                    l->items->Query( aRect, drawFunc );
+                }
+            }
+        }
+    }
+}
+
+
+void VIEW::redrawTiles( VIEW_LAYER& aLayer, const BOX2I& aRect, std::vector<TILE>& aTiles )
+{
+    const int tileCount = aTiles.size();
+
+    // Items touching the tile borders have to be drawn in both tiles
+    const int margin = std::abs( ToWorld( VECTOR2D( 2.0, 2.0 ), false ).x ) + 1;
+
+    for( int i = 0; i < tileCount; ++i )
+    {
+        TILE& tile = aTiles[i];
+        BOX2I screenArea;
+
+        // Binds the tile to the current target of the main GAL
+        tile.gal = m_gal->GetTile( i, screenArea );
+        tile.gal->SetLayerDepth( aLayer.renderingOrder );
+        tile.painter->SetGAL( tile.gal );
+
+        VECTOR2D start = ToWorld( VECTOR2D( screenArea.GetOrigin() ) );
+        VECTOR2D end = ToWorld( VECTOR2D( screenArea.GetEnd() ) );
+
+        BOX2I area( VECTOR2I( start ), VECTOR2I( end - start ) );
+        area.Normalize();
+        area.Inflate( margin );
+
+        // Only the requested part of the tile is drawn
+        VECTOR2I origin( std::max( area.GetX(), aRect.GetX() ),
+                         std::max( area.GetY(), aRect.GetY() ) );
+        VECTOR2I corner( std::min( area.GetRight(), aRect.GetRight() ),
+                         std::min( area.GetBottom(), aRect.GetBottom() ) );
+
+        tile.area = BOX2I( origin, corner - origin );
+        tile.fallback.clear();
+    }
+
+    // The tree must not be restructured while the tiles are querying it
+    aLayer.items->Flush();
+
+    int i;
+
+#ifdef USE_OPENMP
+    #pragma omp parallel for schedule(dynamic, 1) private(i)
+#endif /* USE_OPENMP */
+    for( i = 0; i < tileCount; ++i )
+    {
+        TILE& tile = aTiles[i];
+
+        if( tile.area.GetWidth() < 0 || tile.area.GetHeight() < 0 )
+            continue;
+
+        drawTileItem drawFunc( this, aLayer.id, tile );
+
+        if( FRAME_PROFILER::IsEnabled() )
+        {
+            QUERY_TIMER<drawTileItem> timer( drawFunc );
+            aLayer.items->QueryConcurrent( tile.area, timer );
+        }
+        else
+        {
+            aLayer.items->QueryConcurrent( tile.area, drawFunc );
         }
+
+        tile.gal->Flush();
     }
+
+    // Items drawn with VIEW_ITEM::ViewDraw() use the VIEW, so they have to be handled
+    // in the main thread. An item may have been found by several tiles.
+    std::vector<VIEW_ITEM*> fallback;
+
+    for( TILE& tile : aTiles )
+        fallback.insert( fallback.end(), tile.fallback.begin(), tile.fallback.end() );
+
+    std::sort( fallback.begin(), fallback.end() );
+    fallback.erase( std::unique( fallback.begin(), fallback.end() ), fallback.end() );
+
+    for( VIEW_ITEM* item : fallback )
+        draw( item, aLayer.id );
 }
 
 
@@ -869,7 +1077,7 @@ void VIEW::draw( VIEW_ITEM* aItem, int aLayer, bool aImmediate )
         {
             m_gal->DrawGroup( group );
         }
-        else
+        else if( !drawInstance( aItem, aLayer ) )
         {
             group = m_gal->BeginGroup();
             viewData->setGroup( aLayer, group );
@@ -889,6 +1097,105 @@ void VIEW::draw( VIEW_ITEM* aItem, int aLayer, bool aImmediate )
 }
 
 
+bool VIEW::drawInstance( VIEW_ITEM* aItem, int aLayer )
+{
+    if( !IsInstancing() )
+        return false;
+
+    INSTANCE_KEY key;
+    VECTOR2D origin;
+
+    if( !m_painter->GetInstanceKey( aItem, aLayer, key, origin ) )
+        return false;
+
+    INSTANCE_TEMPLATES::iterator it = m_instanceTemplates.find( key );
+
+    if( it == m_instanceTemplates.end() )
+    {
+        // Draw the item with its origin placed at (0, 0)
+        INSTANCE_TEMPLATE tmpl;
+        tmpl.layer = aLayer;
+        tmpl.group = m_gal->BeginGroup();
+        m_gal->Save();
+        m_gal->Translate( -origin );
+
+        if( !m_painter->Draw( aItem, aLayer ) )
+            aItem->ViewDraw( aLayer, this );
+
+        m_gal->Restore();
+        m_gal->EndGroup();
+
+        it = m_instanceTemplates.insert( std::make_pair( key, tmpl ) ).first;
+    }
+
+    it->second.lastUsed = m_frameCounter;
+    m_gal->DrawGroupInstance( it->second.group, origin );
+
+    return true;
+}
+
+
+bool VIEW::isInstanced( const VIEW_ITEM* aItem, int aLayer ) const
+{
+    if( !IsInstancing() )
+        return false;
+
+    INSTANCE_KEY key;
+    VECTOR2D origin;
+
+    return m_painter->GetInstanceKey( aItem, aLayer, key, origin );
+}
+
+
+void VIEW::SetInstancing( bool aEnabled )
+{
+    if( m_useInstancing == aEnabled )
+        return;
+
+    m_useInstancing = aEnabled;
+
+    // Items are going to be drawn in a different way
+    if( m_gal )
+        RecacheAllItems();
+}
+
+
+bool VIEW::IsInstancing() const
+{
+    return m_useInstancing && m_gal && m_gal->IsInstancingSupported();
+}
+
+
+void VIEW::clearInstanceTemplates( bool aDeleteGroups )
+{
+    if( aDeleteGroups )
+    {
+        for( INSTANCE_TEMPLATES::value_type& tmpl : m_instanceTemplates )
+            m_gal->DeleteGroup( tmpl.second.group );
+    }
+
+    m_instanceTemplates.clear();
+}
+
+
+void VIEW::purgeInstanceTemplates()
+{
+    for( INSTANCE_TEMPLATES::iterator it = m_instanceTemplates.begin();
+            it != m_instanceTemplates.end(); )
+    {
+        if( m_frameCounter - it->second.lastUsed > INSTANCE_TEMPLATE_LIFETIME )
+        {
+            m_gal->DeleteGroup( it->second.group );
+            it = m_instanceTemplates.erase( it );
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+
 void VIEW::draw( VIEW_ITEM* aItem, bool aImmediate )
 {
     int layers[VIEW_MAX_LAYERS], layers_count;
@@ -956,19 +1263,122 @@ void VIEW::Clear()
         i->second.items->RemoveAll();
 
     m_gal->ClearCache();
+    clearInstanceTemplates( false );
+}
+
+
+void VIEW::MarkTargetDirty( int aTarget, const BOX2I& aArea )
+{
+    wxASSERT( aTarget < TARGETS_NUMBER );
+
+    // Overlay contains few items, it is cheaper to redraw it as a whole
+    if( aTarget == TARGET_OVERLAY )
+    {
+        m_dirtyTargets[aTarget] = true;
+        return;
+    }
+
+    if( m_isDirtyArea )
+    {
+        m_dirtyArea.Merge( aArea );
+    }
+    else
+    {
+        m_dirtyArea = aArea;
+        m_dirtyArea.Normalize();
+        m_isDirtyArea = true;
+    }
+}
+
+
+bool VIEW::getPartialRedrawArea( BOX2I& aScreenArea ) const
+{
+    if( !m_isDirtyArea || m_dirtyTargets[TARGET_CACHED] || m_dirtyTargets[TARGET_NONCACHED] )
+        return false;
+
+    const VECTOR2I& screenSize = m_gal->GetScreenPixelSize();
+
+    if( screenSize.x <= 0 || screenSize.y <= 0 )
+        return false;
+
+    // Clamp the dirty area to the screen before the conversion, as it may be huge
+    BOX2D viewport = GetViewport();
+    VECTOR2D start( std::max<double>( m_dirtyArea.GetX(), viewport.GetX() ),
+                    std::max<double>( m_dirtyArea.GetY(), viewport.GetY() ) );
+    VECTOR2D end( std::min<double>( m_dirtyArea.GetRight(), viewport.GetRight() ),
+                  std::min<double>( m_dirtyArea.GetBottom(), viewport.GetBottom() ) );
+
+    if( start.x > end.x || start.y > end.y )
+    {
+        // Nothing visible has changed
+        aScreenArea = BOX2I();
+        return true;
+    }
+
+    VECTOR2D p1 = ToScreen( start );
+    VECTOR2D p2 = ToScreen( end );
+
+    // Antialiased edges may exceed the bounding boxes a bit
+    const int margin = 2;
+    int left    = std::max( 0, (int) std::floor( std::min( p1.x, p2.x ) ) - margin );
+    int top     = std::max( 0, (int) std::floor( std::min( p1.y, p2.y ) ) - margin );
+    int right   = std::min( screenSize.x, (int) std::ceil( std::max( p1.x, p2.x ) ) + margin );
+    int bottom  = std::min( screenSize.y, (int) std::ceil( std::max( p1.y, p2.y ) ) + margin );
+
+    if( (double) ( right - left ) * ( bottom - top )
+            > MAX_PARTIAL_REDRAW_AREA * screenSize.x * screenSize.y )
+        return false;
+
+    aScreenArea = BOX2I( VECTOR2I( left, top ), VECTOR2I( right - left, bottom - top ) );
+
+    return true;
 }
 
 
 void VIEW::ClearTargets()
 {
+    m_partialRedraw = false;
+
     if( IsTargetDirty( TARGET_CACHED ) || IsTargetDirty( TARGET_NONCACHED ) )
     {
-        // TARGET_CACHED and TARGET_NONCACHED have to be redrawn together, as they contain
-        // layers that rely on each other (eg. netnames are noncached, but tracks - are cached)
-        m_gal->ClearTarget( TARGET_NONCACHED );
-        m_gal->ClearTarget( TARGET_CACHED );
+        BOX2I screenArea;
 
-        MarkDirty();
+        // The GAL has to keep the targets contents from the previous frame
+        if( getPartialRedrawArea( screenArea ) && m_gal->SetClipArea( screenArea ) )
+        {
+            if( screenArea.GetWidth() <= 0 || screenArea.GetHeight() <= 0 )
+            {
+                // Changes are not visible, there is nothing to be redrawn
+                markTargetClean( TARGET_CACHED );
+                markTargetClean( TARGET_NONCACHED );
+            }
+            else
+            {
+                // Only the clip area is cleared and redrawn
+                VECTOR2D start = ToWorld( VECTOR2D( screenArea.GetOrigin() ) );
+                VECTOR2D end = ToWorld( VECTOR2D( screenArea.GetEnd() ) );
+
+                m_redrawArea = BOX2I( VECTOR2I( start ), VECTOR2I( end - start ) );
+                m_redrawArea.Normalize();
+                m_redrawArea.Inflate( std::abs( ToWorld( 1.0 ) ) + 1 );
+                m_partialRedraw = true;
+            }
+        }
+
+        if( m_partialRedraw )
+        {
+            m_gal->ClearTarget( TARGET_NONCACHED );
+            m_gal->ClearTarget( TARGET_CACHED );
+        }
+        else if( IsTargetDirty( TARGET_CACHED ) || IsTargetDirty( TARGET_NONCACHED ) )
+        {
+            // TARGET_CACHED and TARGET_NONCACHED have to be redrawn together, as they contain
+            // layers that rely on each other (eg. netnames are noncached, but tracks - are cached)
+            m_gal->ClearTarget( TARGET_NONCACHED );
+            m_gal->ClearTarget( TARGET_CACHED );
+
+            MarkDirty();
+        }
     }
 
     if( IsTargetDirty( TARGET_OVERLAY ) )
@@ -980,6 +1390,8 @@ void VIEW::ClearTargets()
 
 void VIEW::Redraw()
 {
+    FRAME_PROFILER_SCOPE profilerScope( FRAME_PROFILER::VIEW_REDRAW );
+
 #ifdef __WXDEBUG__
     PROF_COUNTER totalRealTime;
 #endif /* __WXDEBUG__ */
@@ -989,7 +1401,13 @@ void VIEW::Redraw()
                    ToWorld( screenSize ) - ToWorld( VECTOR2D( 0, 0 ) ) );
     rect.Normalize();
 
-    redrawRect( rect );
+    // ClearTargets() may have limited the redraw to the dirty area
+    redrawRect( m_partialRedraw ? m_redrawArea : rect );
+    m_partialRedraw = false;
+
+    // Instance templates that have not been drawn for a while are likely not needed anymore
+    ++m_frameCounter;
+    purgeInstanceTemplates();
 
     // All targets were redrawn, so nothing is dirty
     markTargetClean( TARGET_CACHED );
@@ -1042,7 +1460,8 @@ void VIEW::clearGroupCache()
 }
 
 
-void VIEW::invalidateItem( VIEW_ITEM* aItem, int aUpdateFlags )
+void VIEW::invalidateItem( VIEW_ITEM* aItem, int aUpdateFlags,
+                           std::vector<CACHE_JOB>* aGeometryJobs )
 {
     // updateLayers updates geometry too, so we do not have to update both of them at the same time
     if( aUpdateFlags & LAYERS )
@@ -1060,14 +1479,29 @@ void VIEW::invalidateItem( VIEW_ITEM* aItem, int aUpdateFlags )
 
         if( IsCached( layerId ) )
         {
-            if( aUpdateFlags & ( GEOMETRY | LAYERS ) )
-                updateItemGeometry( aItem, layerId );
+            if( ( aUpdateFlags & ( GEOMETRY | LAYERS ) ) && isInstanced( aItem, layerId ) )
+            {
+                // Instances are drawn using shared groups created on demand in draw()
+                int group = aItem->viewPrivData()->getGroup( layerId );
+
+                if( group >= 0 )
+                    m_gal->DeleteGroup( group );
+
+                aItem->viewPrivData()->setGroup( layerId, -1 );
+            }
+            else if( aUpdateFlags & ( GEOMETRY | LAYERS ) )
+            {
+                if( aGeometryJobs )
+                    aGeometryJobs->push_back( CACHE_JOB { aItem, layerId, -1, false } );
+                else
+                    updateItemGeometry( aItem, layerId );
+            }
             else if( aUpdateFlags & COLOR )
                 updateItemColor( aItem, layerId );
         }
 
-        // Mark those layers as dirty, so the VIEW will be refreshed
-        MarkTargetDirty( m_layers[layerId].target );
+        // Mark the item area as dirty, so the VIEW will be refreshed
+        MarkTargetDirty( m_layers[layerId].target, aItem->viewPrivData()->m_bbox );
     }
 
     aItem->viewPrivData()->clearUpdateFlags();
@@ -1138,10 +1572,118 @@ void VIEW::updateItemGeometry( VIEW_ITEM* aItem, int aLayer )
 }
 
 
+void VIEW::updateItemsGeometry( std::vector<CACHE_JOB>& aJobs )
+{
+    const int jobCount = aJobs.size();
+    int threadCount = 1;
+
+#ifdef USE_OPENMP
+    threadCount = omp_get_max_threads();
+#endif /* USE_OPENMP */
+
+    // Every worker thread needs its own tessellator and painter
+    std::vector<GAL*> tessellators;
+    std::vector< std::unique_ptr<PAINTER> > painters;
+
+    if( threadCount > 1 && jobCount >= MIN_PARALLEL_CACHE_JOBS )
+    {
+        for( int i = 0; i < threadCount; ++i )
+        {
+            GAL* tessellator = m_gal->GetTessellator( i );
+            std::unique_ptr<PAINTER> painter( m_painter->Clone() );
+
+            if( !tessellator || !painter )
+                break;
+
+            painter->SetGAL( tessellator );
+            tessellators.push_back( tessellator );
+            painters.push_back( std::move( painter ) );
+        }
+    }
+
+    const int workerCount = tessellators.size();
+
+    if( workerCount < 2 )
+    {
+        for( CACHE_JOB& job : aJobs )
+            updateItemGeometry( job.item, job.layer );
+
+        return;
+    }
+
+    for( int first = 0; first < jobCount; first += CACHE_BATCH_SIZE )
+    {
+        const int last = std::min( first + CACHE_BATCH_SIZE, jobCount );
+        int i;
+
+        // Tessellation: jobs are interleaved between workers, as neighbouring items
+        // (e.g. pads of a footprint) tend to have a similar complexity
+#ifdef USE_OPENMP
+        #pragma omp parallel for schedule(static, 1) private(i)
+#endif /* USE_OPENMP */
+        for( i = 0; i < workerCount; ++i )
+        {
+            GAL* gal = tessellators[i];
+            PAINTER* painter = painters[i].get();
+
+            for( int j = first + i; j < last; j += workerCount )
+            {
+                CACHE_JOB& job = aJobs[j];
+
+                gal->SetLayerDepth( m_layers.at( job.layer ).renderingOrder );
+                job.group = gal->BeginGroup();
+                job.painted = painter->Draw( static_cast<EDA_ITEM*>( job.item ), job.layer );
+                gal->EndGroup();
+            }
+        }
+
+        // Upload: the groups are replaced in the same order as they would be drawn serially
+        for( int j = first; j < last; ++j )
+        {
+            CACHE_JOB& job = aJobs[j];
+
+            // Items drawn with VIEW_ITEM::ViewDraw() use the VIEW, so they have to be
+            // handled in the main thread
+            if( !job.painted )
+            {
+                updateItemGeometry( job.item, job.layer );
+                continue;
+            }
+
+            auto viewData = job.item->viewPrivData();
+
+            if( !viewData )
+                continue;
+
+            VIEW_LAYER& l = m_layers.at( job.layer );
+
+            m_gal->SetTarget( l.target );
+            m_gal->SetLayerDepth( l.renderingOrder );
+
+            int group = viewData->getGroup( job.layer );
+
+            if( group >= 0 )
+                m_gal->DeleteGroup( group );
+
+            group = m_gal->ImportGroup( tessellators[( j - first ) % workerCount], job.group );
+            viewData->setGroup( job.layer, group );
+        }
+
+        for( GAL* tessellator : tessellators )
+            tessellator->ClearCache();
+    }
+}
+
+
 void VIEW::updateBbox( VIEW_ITEM* aItem )
 {
+    auto viewData = aItem->viewPrivData();
     int layers[VIEW_MAX_LAYERS], layers_count;
 
+    // Both the previous and the new area of the item have to be redrawn
+    BOX2I prevBbox = viewData->m_bbox;
+    viewData->m_bbox = aItem->ViewBBox();
+
     aItem->ViewGetLayers( layers, layers_count );
 
     for( int i = 0; i < layers_count; ++i )
@@ -1149,7 +1691,8 @@ void VIEW::updateBbox( VIEW_ITEM* aItem )
         VIEW_LAYER& l = m_layers[layers[i]];
         l.items->Remove( aItem );
         l.items->Insert( aItem );
-        MarkTargetDirty( l.target );
+        MarkTargetDirty( l.target, prevBbox );
+        MarkTargetDirty( l.target, viewData->m_bbox );
     }
 }
 
@@ -1169,7 +1712,7 @@ void VIEW::updateLayers( VIEW_ITEM* aItem )
     {
         VIEW_LAYER& l = m_layers[layers[i]];
         l.items->Remove( aItem );
-        MarkTargetDirty( l.target );
+        MarkTargetDirty( l.target, viewData->m_bbox );
 
         if( IsCached( l.id ) )
         {
@@ -1187,12 +1730,13 @@ void VIEW::updateLayers( VIEW_ITEM* aItem )
     // Add the item to new layer set
     aItem->ViewGetLayers( layers, layers_count );
     viewData->saveLayers( layers, layers_count );
+    viewData->m_bbox = aItem->ViewBBox();
 
     for( int i = 0; i < layers_count; i++ )
     {
         VIEW_LAYER& l = m_layers[layers[i]];
         l.items->Insert( aItem );
-        MarkTargetDirty( l.target );
+        MarkTargetDirty( l.target, viewData->m_bbox );
     }
 }
 
@@ -1220,6 +1764,7 @@ void VIEW::RecacheAllItems()
     BOX2I r;
 
     r.SetMaximum();
+    clearInstanceTemplates();
 
     for( LAYER_MAP_ITER i = m_layers.begin(); i != m_layers.end(); ++i )
     {
@@ -1236,6 +1781,10 @@ void VIEW::RecacheAllItems()
 
 void VIEW::UpdateItems()
 {
+    FRAME_PROFILER_SCOPE profilerScope( FRAME_PROFILER::VIEW_UPDATE );
+
+    std::vector<CACHE_JOB> geometryJobs;
+
     m_gal->BeginUpdate();
 
     for( VIEW_ITEM* item : m_allItems )
@@ -1247,11 +1796,13 @@ void VIEW::UpdateItems()
 
         if( viewData->m_requiredUpdate != NONE )
         {
-            invalidateItem( item, viewData->m_requiredUpdate );
+            invalidateItem( item, viewData->m_requiredUpdate, &geometryJobs );
             viewData->m_requiredUpdate = NONE;
         }
     }
 
+    updateItemsGeometry( geometryJobs );
+
     m_gal->EndUpdate();
 }
 
@@ -1361,5 +1912,9 @@ void VIEW::Update( VIEW_ITEM* aItem, int aUpdateFlags )
 }
 
 const int VIEW::TOP_LAYER_MODIFIER = -VIEW_MAX_LAYERS;
+const int VIEW::MIN_PARALLEL_CACHE_JOBS = 256;
+const int VIEW::CACHE_BATCH_SIZE = 16384;
+const unsigned int VIEW::INSTANCE_TEMPLATE_LIFETIME = 100;
+const double VIEW::MAX_PARTIAL_REDRAW_AREA = 0.3;
 
 };
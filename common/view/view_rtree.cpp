@@ -0,0 +1,284 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <view/view_item.h>
+#include <view/view_rtree.h>
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+
+using namespace KIGFX;
+
+const int VIEW_RTREE::NODE_CAPACITY;
+const int VIEW_RTREE::STACK_SIZE;
+const int VIEW_RTREE::MIN_REBUILD_SIZE;
+
+
+VIEW_RTREE::VIEW_RTREE() :
+    m_leafNodeCount( 0 ),
+    m_packedCount( 0 ),
+    m_removedEntries( 0 ),
+    m_dynamicCount( 0 ),
+    m_needsRebuild( false ),
+    m_queryDepth( 0 )
+{
+}
+
+
+void VIEW_RTREE::Insert( VIEW_ITEM* aItem )
+{
+    const BOX2I& bbox = aItem->ViewBBox();
+    ENTRY entry;
+
+    entry.m_min[0] = bbox.GetX();
+    entry.m_min[1] = bbox.GetY();
+    entry.m_max[0] = bbox.GetRight();
+    entry.m_max[1] = bbox.GetBottom();
+    entry.m_item = aItem;
+
+    if( !m_entryIndex.empty() )
+        m_entryIndex[aItem] = m_entries.size();
+
+    m_entries.push_back( entry );
+}
+
+
+void VIEW_RTREE::Remove( VIEW_ITEM* aItem )
+{
+    if( removeEntry( aItem ) )
+        return;
+
+    // FIXME: use cached bbox or ptr_map to speed up pointer <-> node lookups.
+    const int       mmin[2] = { INT_MIN, INT_MIN };
+    const int       mmax[2] = { INT_MAX, INT_MAX };
+
+    m_dynamic.Remove( mmin, mmax, aItem );
+
+    if( m_dynamicCount > 0 )
+        --m_dynamicCount;
+}
+
+
+void VIEW_RTREE::RemoveAll()
+{
+    m_nodes.clear();
+    m_entries.clear();
+    m_entryIndex.clear();
+    m_dynamic.RemoveAll();
+
+    m_leafNodeCount = 0;
+    m_packedCount = 0;
+    m_removedEntries = 0;
+    m_dynamicCount = 0;
+    m_needsRebuild = false;
+}
+
+
+bool VIEW_RTREE::removeEntry( VIEW_ITEM* aItem )
+{
+    if( m_entries.empty() )
+        return false;
+
+    if( m_entryIndex.empty() )
+    {
+        m_entryIndex.reserve( m_entries.size() );
+
+        for( int i = 0; i < (int) m_entries.size(); ++i )
+        {
+            if( m_entries[i].m_item )
+                m_entryIndex[m_entries[i].m_item] = i;
+        }
+    }
+
+    std::unordered_map<VIEW_ITEM*, int>::iterator it = m_entryIndex.find( aItem );
+
+    if( it == m_entryIndex.end() )
+        return false;
+
+    // Node bounding boxes are left untouched, they are only a bit larger than necessary
+    m_entries[it->second].m_item = NULL;
+
+    if( it->second < m_packedCount )
+    {
+        ++m_removedEntries;
+
+        if( m_removedEntries > MIN_REBUILD_SIZE && m_removedEntries > m_packedCount / 2 )
+            m_needsRebuild = true;
+    }
+
+    m_entryIndex.erase( it );
+
+    return true;
+}
+
+
+void VIEW_RTREE::flush()
+{
+    if( m_packedCount == (int) m_entries.size() && !m_needsRebuild )
+        return;
+
+    int stored = m_packedCount - m_removedEntries;
+    int added = m_dynamicCount + m_entries.size() - m_packedCount;
+
+    // Large batches (e.g. loading a board to an empty tree) are bulk loaded, while single
+    // items are cheaper to put in the dynamic tree
+    if( m_needsRebuild || ( added > MIN_REBUILD_SIZE && added > stored / 4 ) )
+    {
+        rebuild();
+        return;
+    }
+
+    for( int i = m_packedCount; i < (int) m_entries.size(); ++i )
+    {
+        const ENTRY& entry = m_entries[i];
+
+        if( !entry.m_item )
+            continue;
+
+        m_dynamic.Insert( entry.m_min, entry.m_max, entry.m_item );
+        m_dynamicCount++;
+
+        if( !m_entryIndex.empty() )
+            m_entryIndex.erase( entry.m_item );
+    }
+
+    m_entries.resize( m_packedCount );
+}
+
+
+template <class T>
+void VIEW_RTREE::sortTiles( std::vector<T>& aBoxes )
+{
+    // Sort-Tile-Recursive: the boxes are sorted by X, divided into vertical slices
+    // of sqrt(N / NODE_CAPACITY) nodes and then every slice is sorted by Y
+    const int count = aBoxes.size();
+    const int nodeCount = ( count + NODE_CAPACITY - 1 ) / NODE_CAPACITY;
+    const int sliceSize = std::ceil( std::sqrt( (double) nodeCount ) ) * NODE_CAPACITY;
+
+    std::sort( aBoxes.begin(), aBoxes.end(), []( const T& aA, const T& aB ) {
+        return (int64_t) aA.m_min[0] + aA.m_max[0] < (int64_t) aB.m_min[0] + aB.m_max[0];
+    } );
+
+    for( int start = 0; start < count; start += sliceSize )
+    {
+        typename std::vector<T>::iterator end = start + sliceSize < count ?
+                aBoxes.begin() + start + sliceSize : aBoxes.end();
+
+        std::sort( aBoxes.begin() + start, end, []( const T& aA, const T& aB ) {
+            return (int64_t) aA.m_min[1] + aA.m_max[1] < (int64_t) aB.m_min[1] + aB.m_max[1];
+        } );
+    }
+}
+
+
+template <class T>
+static void makeNode( const std::vector<T>& aChildren, int aFirst, int aCount,
+                      int& aMinX, int& aMinY, int& aMaxX, int& aMaxY )
+{
+    aMinX = aMinY = INT_MAX;
+    aMaxX = aMaxY = INT_MIN;
+
+    for( int i = aFirst; i < aFirst + aCount; ++i )
+    {
+        aMinX = std::min( aMinX, aChildren[i].m_min[0] );
+        aMinY = std::min( aMinY, aChildren[i].m_min[1] );
+        aMaxX = std::max( aMaxX, aChildren[i].m_max[0] );
+        aMaxY = std::max( aMaxY, aChildren[i].m_max[1] );
+    }
+}
+
+
+void VIEW_RTREE::rebuild()
+{
+    std::vector<ENTRY> entries;
+
+    entries.reserve( m_entries.size() - m_removedEntries + m_dynamicCount );
+
+    for( const ENTRY& entry : m_entries )
+    {
+        if( entry.m_item )
+            entries.push_back( entry );
+    }
+
+    VIEW_RTREE_BASE::Iterator it;
+
+    for( m_dynamic.GetFirst( it ); !it.IsNull(); m_dynamic.GetNext( it ) )
+    {
+        ENTRY entry;
+        it.GetBounds( entry.m_min, entry.m_max );
+        entry.m_item = *it;
+        entries.push_back( entry );
+    }
+
+    RemoveAll();
+    m_entries.swap( entries );
+    m_packedCount = m_entries.size();
+
+    if( m_entries.empty() )
+        return;
+
+    // Leaf nodes
+    sortTiles( m_entries );
+
+    const int entryCount = m_entries.size();
+    NODE node;
+
+    m_nodes.reserve( ( entryCount / ( NODE_CAPACITY - 1 ) ) + 1 );
+
+    for( int i = 0; i < entryCount; i += NODE_CAPACITY )
+    {
+        node.m_first = i;
+        node.m_count = std::min( NODE_CAPACITY, entryCount - i );
+        makeNode( m_entries, node.m_first, node.m_count,
+                  node.m_min[0], node.m_min[1], node.m_max[0], node.m_max[1] );
+        m_nodes.push_back( node );
+    }
+
+    m_leafNodeCount = m_nodes.size();
+
+    // Upper levels, until there is a single root node. Reordering nodes of a level does not
+    // affect their children, so every level is sorted just before its parents are created.
+    int levelStart = 0;
+    int levelEnd = m_nodes.size();
+
+    while( levelEnd - levelStart > 1 )
+    {
+        std::vector<NODE> level( m_nodes.begin() + levelStart, m_nodes.begin() + levelEnd );
+        sortTiles( level );
+        std::copy( level.begin(), level.end(), m_nodes.begin() + levelStart );
+
+        for( int i = levelStart; i < levelEnd; i += NODE_CAPACITY )
+        {
+            node.m_first = i;
+            node.m_count = std::min( NODE_CAPACITY, levelEnd - i );
+            makeNode( m_nodes, node.m_first, node.m_count,
+                      node.m_min[0], node.m_min[1], node.m_max[0], node.m_max[1] );
+            m_nodes.push_back( node );
+        }
+
+        levelStart = levelEnd;
+        levelEnd = m_nodes.size();
+    }
+}
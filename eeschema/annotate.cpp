@@ -156,7 +156,9 @@ void SCH_EDIT_FRAME::AnnotateComponents( bool              aAnnotateSchematic,
 
     // Recalculate and update reference numbers in schematic
     references.Annotate( useSheetNum, idStep, lockedComponents );
-    references.UpdateAnnotation();
+
+    // Components already annotated are left untouched when the annotation is not reset
+    references.UpdateAnnotation( !aResetAnnotation );
 
     wxArrayString errors;
 
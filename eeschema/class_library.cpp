@@ -48,6 +48,7 @@
 #include <wx/progdlg.h>
 #include <wx/tokenzr.h>
 #include <wx/regex.h>
+#include <wx/stopwatch.h>
 
 #define DUPLICATE_NAME_MSG  \
     _(  "Library '%s' has duplicate entry name '%s'.\n" \
@@ -137,6 +138,21 @@ void PART_LIB::GetAliasNames( wxArrayString& aNames )
 }
 
 
+void PART_LIB::GetAliases( std::vector<LIB_ALIAS*>& aAliases )
+{
+    m_plugin->EnumerateSymbolLib( aAliases, fileName.GetFullPath() );
+}
+
+
+wxDateTime PART_LIB::GetFileModificationTime() const
+{
+    if( !fileName.FileExists() )
+        return wxDateTime();
+
+    return fileName.GetModificationTime();
+}
+
+
 void PART_LIB::GetEntryTypePowerNames( wxArrayString& aNames )
 {
     wxArrayString aliases;
@@ -396,10 +412,106 @@ wxArrayString PART_LIBS::GetLibraryNames( bool aSorted )
 }
 
 
+static bool sameFileTime( const wxDateTime& aFirst, const wxDateTime& aSecond )
+{
+    if( !aFirst.IsValid() || !aSecond.IsValid() )
+        return aFirst.IsValid() == aSecond.IsValid();
+
+    return aFirst == aSecond;
+}
+
+
+void PART_LIBS::updateAliasIndex()
+{
+    // The plugins reload library files changed on disk when they are accessed, which
+    // happens here only when a library is indexed again.
+    wxLongLong now = wxGetLocalTimeMillis();
+    bool checkFiles = now < m_lastFileCheck || now - m_lastFileCheck >= FILE_CHECK_INTERVAL;
+
+    if( checkFiles )
+        m_lastFileCheck = now;
+
+    // Find the first library which is not indexed or has changed since it was indexed.
+    unsigned first = 0;
+
+    for( ; first < m_indexedLibs.size() && first < size(); ++first )
+    {
+        const INDEXED_LIB& indexed = m_indexedLibs[first];
+        const PART_LIB&    lib = (*this)[first];
+
+        if( indexed.m_lib != &lib || indexed.m_modHash != lib.GetModHash()
+          || indexed.m_pluginModHash != lib.GetPluginModHash() )
+            break;
+
+        if( checkFiles && !sameFileTime( indexed.m_fileTime, lib.GetFileModificationTime() ) )
+            break;
+    }
+
+    if( first == m_indexedLibs.size() && first == size() )
+        return;
+
+    // Aliases of a library hide the ones of the following libraries, so all the
+    // libraries after the first changed one are indexed again.
+    for( auto it = m_aliasIndex.begin(); it != m_aliasIndex.end(); )
+    {
+        if( it->second.m_libIndex >= first )
+            it = m_aliasIndex.erase( it );
+        else
+            ++it;
+    }
+
+    m_indexedLibs.resize( first );
+
+    for( unsigned ii = first; ii < size(); ++ii )
+    {
+        PART_LIB& lib = (*this)[ii];
+        std::vector<LIB_ALIAS*> aliases;
+
+        lib.GetAliases( aliases );
+
+        for( LIB_ALIAS* alias : aliases )
+        {
+            ALIAS_INDEX_ENTRY entry = { alias, ii };
+
+            // Does not replace an alias of a previous library.
+            m_aliasIndex.insert( std::make_pair( alias->GetName(), entry ) );
+        }
+
+        INDEXED_LIB indexed = { &lib, lib.GetModHash(), lib.GetPluginModHash(),
+                                lib.GetFileModificationTime() };
+        m_indexedLibs.push_back( indexed );
+    }
+}
+
+
+LIB_ALIAS* PART_LIBS::findIndexedAlias( const wxString& aName )
+{
+    updateAliasIndex();
+
+    auto it = m_aliasIndex.find( aName );
+
+    return it != m_aliasIndex.end() ? it->second.m_alias : NULL;
+}
+
+
 LIB_PART* PART_LIBS::FindLibPart( const LIB_ID& aLibId, const wxString& aLibraryName )
 {
     LIB_PART* part = NULL;
 
+    // Searching all the libraries is the common case (e.g. when resolving all the
+    // components of a schematic): use the index.  The libraries are searched one by one
+    // only if the alias found first has no part.
+    if( aLibraryName.IsEmpty() )
+    {
+        LIB_ALIAS* alias = findIndexedAlias( aLibId.GetLibItemName() );
+
+        if( !alias )
+            return NULL;
+
+        if( alias->GetPart() )
+            return alias->GetPart();
+    }
+
     for( PART_LIB& lib : *this )
     {
         if( !aLibraryName.IsEmpty() && lib.GetName() != aLibraryName )
@@ -419,6 +531,9 @@ LIB_ALIAS* PART_LIBS::FindLibraryAlias( const LIB_ID& aLibId, const wxString& aL
 {
     LIB_ALIAS* entry = NULL;
 
+    if( aLibraryName.IsEmpty() )
+        return findIndexedAlias( aLibId.GetLibItemName() );
+
     for( PART_LIB& lib : *this )
     {
         if( !aLibraryName.IsEmpty() && lib.GetName() != aLibraryName )
@@ -37,8 +37,11 @@
 #include <sch_io_mgr.h>
 
 #include <project.h>
+#include <hashtables.h>
 
 #include <map>
+#include <unordered_map>
+#include <vector>
 
 class LIB_ID;
 class LINE_READER;
@@ -311,6 +314,55 @@ public:
                                  const wxString& aLibraryName = wxEmptyString );
 
     int GetLibraryCount() { return size(); }
+
+private:
+    ///> Entry of the alias index: the alias found first when searching the libraries in order
+    struct ALIAS_INDEX_ENTRY
+    {
+        LIB_ALIAS*  m_alias;
+        unsigned    m_libIndex;         ///< Position of the library of m_alias in the list
+    };
+
+    ///> State of a library when its aliases were added to the alias index
+    struct INDEXED_LIB
+    {
+        PART_LIB*   m_lib;
+        int         m_modHash;          ///< PART_LIB::GetModHash()
+        int         m_pluginModHash;    ///< PART_LIB::GetPluginModHash()
+        wxDateTime  m_fileTime;         ///< PART_LIB::GetFileModificationTime()
+    };
+
+    ///> Minimal time between checks of the library files modification times (ms)
+    static const int FILE_CHECK_INTERVAL = 1000;
+
+    ///> Alias names of all the libraries, to avoid searching every library by name
+    std::unordered_map<wxString, ALIAS_INDEX_ENTRY, WXSTRING_HASH> m_aliasIndex;
+
+    ///> Libraries covered by m_aliasIndex, in the list order
+    std::vector<INDEXED_LIB> m_indexedLibs;
+
+    ///> Time of the last check of the library files (see updateAliasIndex())
+    wxLongLong m_lastFileCheck;
+
+    /**
+     * Function updateAliasIndex
+     * brings the alias index up to date.  Only the aliases of the libraries added, moved
+     * or modified since the last update (and of the libraries which follow them in the
+     * list) are indexed again.  Libraries whose files have changed on disk are reloaded;
+     * the files are checked at most once per FILE_CHECK_INTERVAL, so a batch of lookups
+     * does not read the modification time of every library file for each lookup.
+     *
+     * @throw IO_ERROR if a library cannot be loaded.
+     */
+    void updateAliasIndex();
+
+    /**
+     * Function findIndexedAlias
+     * searches the alias index for \a aName.
+     *
+     * @return the alias of the first library containing \a aName, or NULL if not found.
+     */
+    LIB_ALIAS* findIndexedAlias( const wxString& aName );
 };
 
 
@@ -343,6 +395,18 @@ public:
 
     int GetModHash() const { return m_mod_hash; }
 
+    /**
+     * Return the modification hash of the library plugin.  Unlike GetModHash(), it also
+     * changes when the plugin reloads the library file.
+     */
+    int GetPluginModHash() const { return m_plugin->GetModifyHash(); }
+
+    /**
+     * Return the modification time of the library file, or an invalid date if the file
+     * does not exist.
+     */
+    wxDateTime GetFileModificationTime() const;
+
     SCH_IO_MGR::SCH_FILE_T GetPluginType() const { return m_pluginType; }
 
     void SetPluginType( SCH_IO_MGR::SCH_FILE_T aPluginType );
@@ -398,6 +462,13 @@ public:
      */
     void GetAliasNames( wxArrayString& aNames );
 
+    /**
+     * Load a vector with all the alias objects in this library.
+     *
+     * @param aAliases - Vector to receive the aliases, which remain owned by the library.
+     */
+    void GetAliases( std::vector<LIB_ALIAS*>& aAliases );
+
     /**
      * Load a string array with the names of  entries of type POWER in this library.
      *
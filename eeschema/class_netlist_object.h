@@ -36,6 +36,11 @@
 #include <lib_pin.h>      // LIB_PIN::PinStringNum( m_PinNum )
 #include <sch_item_struct.h>
 
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
 class NETLIST_OBJECT_LIST;
 class SCH_COMPONENT;
 
@@ -288,6 +293,53 @@ class NETLIST_OBJECT_LIST : public NETLIST_OBJECTS
     int m_lastBusNetCode;   // Used in intermediate calculation:
                             // last net code created for bus members
 
+    // Items indexed by their end points (see pointKey())
+    typedef std::unordered_map<uint64_t, std::vector<unsigned> > POINT_INDEX;
+
+    // Wire or bus segments of a sheet, indexed by the lines they lie on
+    struct SEGMENT_INDEX
+    {
+        std::unordered_map<int, std::vector<unsigned> > m_horizontal;   // by y coordinate
+        std::unordered_map<int, std::vector<unsigned> > m_vertical;     // by x coordinate
+        std::vector<unsigned> m_other;                                  // skewed segments
+
+        void Add( unsigned aIdx, const NETLIST_OBJECT* aSegment );
+        void Clear();
+    };
+
+    // Labels having the same text and type (or the same text and sheet)
+    typedef std::pair<wxString, int> LABEL_KEY;
+
+    struct LABEL_GROUP
+    {
+        LABEL_GROUP() : m_merged( false ) {}
+
+        std::vector<unsigned> m_items;
+        bool m_merged;      // all the items are known to share a single net
+    };
+
+    // Intermediate data used by BuildNetListInfo(), released when it is finished:
+
+    // Union-find parents of net codes and bus net codes. Merged nets are not renamed in
+    // the whole list, each item keeps its net code until the nets are resolved.
+    std::vector<int> m_netCodeParents;
+    std::vector<int> m_busNetCodeParents;
+
+    // Indexes of the first items of sheets (the list is sorted by sheets)
+    std::vector<unsigned> m_sheetStarts;
+
+    // Connectable items of the currently processed sheet
+    POINT_INDEX   m_wireEnds;
+    POINT_INDEX   m_busEnds;
+    SEGMENT_INDEX m_wireSegments;
+    SEGMENT_INDEX m_busSegments;
+
+    // Labels by text and sheet number
+    std::map<LABEL_KEY, std::vector<unsigned> > m_sheetLabels;
+
+    // Pin labels and global labels by text and type
+    std::map<LABEL_KEY, LABEL_GROUP> m_globalLabels;
+
 public:
     /**
      * Constructor.
@@ -316,6 +368,26 @@ public:
      */
     bool BuildNetListInfo( SCH_SHEET_LIST& aSheets );
 
+    /**
+     * Function BuildSheetConnections
+     * finds the connections between items of a single sheet (made by wires, buses, junctions
+     * and labels connected to wires and buses), the connections made by labels
+     * are not searched. Items connected together get the same (bus) net code.
+     * The result is stored by SCH_SCREEN_CONNECTIVITY and used by BuildNetListInfo().
+     */
+    void BuildSheetConnections();
+
+    /**
+     * @return the net code that will be assigned to the next new net, i.e. net codes
+     * used by the items are lower.
+     */
+    int GetLastNetCode() const { return m_lastNetCode; }
+
+    /**
+     * @return the bus net code that will be assigned to the next new bus net.
+     */
+    int GetLastBusNetCode() const { return m_lastBusNetCode; }
+
     /**
      * Acces to an item in list
      */
@@ -381,23 +453,6 @@ public:
      */
     void SortListbySheet();
 
-    /**
-     * Counts number of pins connected on the same net.
-     * Used to count all pins connected to a no connect symbol
-     * @return the pin count of the net starting at aNetStart
-     * @param aNetStart = index in list of net objects of the first item
-     */
-    int CountPinsInNet( unsigned aNetStart );
-
-    /**
-     * Function TestforNonOrphanLabel
-     * Sheet labels are expected to be connected to a hierarchical label.
-     * Hierarchical labels are expected to be connected to a sheet label.
-     * Global labels are expected to be not orphan (connected to at least one other global label.
-     * this function tests the connection to an other suitable label
-     */
-    void TestforNonOrphanLabel( unsigned aNetItemRef, unsigned aStartNet );
-
     /**
      * Function TestforSimilarLabels
      * detects labels which are different when using case sensitive comparisons
@@ -423,10 +478,58 @@ private:
     /*
      * Propagate aNewNetCode to items having an internal netcode aOldNetCode
      * used to interconnect group of items already physically connected,
-     * when a new connection is found between aOldNetCode and aNewNetCode
+     * when a new connection is found between aOldNetCode and aNewNetCode.
+     * The items are not modified, aOldNetCode is only marked as merged
+     * (see findNetCode() and resolveNetCodes())
      */
     void propagateNetCode( int aOldNetCode, int aNewNetCode, bool aIsBus );
 
+    /*
+     * Return the net code that aNetCode has been merged into, or aNetCode if it has
+     * not been merged into any other net.
+     */
+    int findNetCode( int aNetCode, bool aIsBus );
+
+    /*
+     * Replace the (bus) net codes of all items with the codes they were merged into
+     */
+    void resolveNetCodes( bool aIsBus );
+
+    /*
+     * Index the items of a sheet to find the connections by location.
+     * @param aStart is the index of the first item of the sheet
+     */
+    void indexSheetItems( unsigned aStart );
+
+    /*
+     * Index labels by their text and sheet, to find the connections by name.
+     */
+    void indexLabels();
+
+    /*
+     * Release the data used to build the connections
+     */
+    void clearIndexes();
+
+    /*
+     * Return the number of a sheet (the index in m_sheetStarts) or -1 if the sheet
+     * does not contain any item
+     */
+    int findSheet( const SCH_SHEET_PATH& aSheetPath ) const;
+
+    /*
+     * Key of an end point in POINT_INDEX
+     */
+    static uint64_t pointKey( const wxPoint& aPoint )
+    {
+        return ( (uint64_t) (uint32_t) aPoint.x << 32 ) | (uint32_t) aPoint.y;
+    }
+
+    /*
+     * Connect a label to aLabelRef net
+     */
+    void connectLabel( NETLIST_OBJECT* aLabel, NETLIST_OBJECT* aLabelRef );
+
     /*
      * This function merges the net codes of groups of objects already connected
      * to labels (wires, bus, pins ... ) when 2 labels are equivalents
@@ -454,16 +557,19 @@ private:
      */
     void sheetLabelConnect( NETLIST_OBJECT* aSheetLabel );
 
-    void pointToPointConnect( NETLIST_OBJECT* aRef, bool aIsBus, int start );
+    /**
+     * Search connections between items having common end points.
+     * Search is done in the currently indexed sheet (see indexSheetItems())
+     */
+    void pointToPointConnect( NETLIST_OBJECT* aRef, bool aIsBus );
 
     /**
      * Search connections between a junction and segments
      * Propagate the junction net code to objects connected by this junction.
      * The junction must have a valid net code
-     * The list of objects is expected sorted by sheets.
-     * Search is done from index aIdxStart to the last element of list
+     * Search is done in the currently indexed sheet (see indexSheetItems())
      */
-    void segmentToPointConnect( NETLIST_OBJECT* aJonction, bool aIsBus, int aIdxStart );
+    void segmentToPointConnect( NETLIST_OBJECT* aJonction, bool aIsBus );
 
 
     /**
@@ -41,9 +41,14 @@
 
 #include <../eeschema/general.h>
 
+#include <memory>
+
 
 class LIB_PIN;
+class NETLIST_OBJECT_LIST;
 class SCH_COMPONENT;
+class SCH_SCREEN_CONNECTIVITY;
+class SCH_SCREEN_INDEX;
 class SCH_SHEET_PATH;
 class SCH_SHEET_PIN;
 class SCH_LINE;
@@ -85,6 +90,25 @@ private:
     int     m_modification_sync;        ///< inequality with PART_LIBS::GetModificationHash()
                                         ///< will trigger ResolveAll().
 
+    /// Connections made by the screen items, kept between netlist builds.
+    std::unique_ptr<SCH_SCREEN_CONNECTIVITY> m_connectivity;
+
+    /// Spatial index of the draw list items, used to find items at a given position.
+    mutable std::unique_ptr<SCH_SCREEN_INDEX> m_index;
+
+    /**
+     * Function itemsChanged
+     * invalidates data computed from the draw list items (connections and the spatial index).
+     */
+    void itemsChanged();
+
+    /**
+     * Function getItemsAt
+     * returns the draw list items that might be located at \a aPosition, in the draw list
+     * order. Only bounding boxes are compared, items still have to be hit tested.
+     */
+    std::vector<SCH_ITEM*> getItemsAt( const wxPoint& aPosition, int aAccuracy = 0 ) const;
+
     /**
      * Function addConnectedItemsToBlock
      * add items connected at \a aPosition to the block pick list.
@@ -141,6 +165,7 @@ public:
     {
         m_drawList.Append( aItem );
         --m_modification_sync;
+        itemsChanged();
     }
 
     /**
@@ -153,8 +178,36 @@ public:
     {
         m_drawList.Append( aList );
         --m_modification_sync;
+        itemsChanged();
+    }
+
+    /**
+     * Function SetModify
+     * marks the screen as modified. Items might have been moved or changed, so the stored
+     * connections and the spatial index are not valid anymore.
+     */
+    void SetModify()
+    {
+        BASE_SCREEN::SetModify();
+        itemsChanged();
     }
 
+    /**
+     * Function GetConnectivity
+     * returns the items of the screen that make connections, with the connections made
+     * inside the screen already found (see SCH_SCREEN_CONNECTIVITY). The items are stored
+     * until the screen is modified.
+     * @param aSheetPath is the sheet instance the items are requested for.
+     */
+    const NETLIST_OBJECT_LIST& GetConnectivity( SCH_SHEET_PATH* aSheetPath );
+
+    /**
+     * Function SetConnectivityDirty
+     * removes the stored connections, it has to be called when items making connections
+     * are added, removed or modified without calling SetModify().
+     */
+    void SetConnectivityDirty();
+
     /**
      * Function GetCurItem
      * returns the currently selected SCH_ITEM, overriding BASE_SCREEN::GetCurItem().
@@ -165,9 +218,11 @@ public:
     /**
      * Function SetCurItem
      * sets the currently selected object, m_CurrentItem.
+     * The current item may be moved without notifying the screen, so it is always tested
+     * by the position queries until another item becomes the current one.
      * @param aItem Any object derived from SCH_ITEM
      */
-    void SetCurItem( SCH_ITEM* aItem ) { BASE_SCREEN::SetCurItem( (EDA_ITEM*) aItem ); }
+    void SetCurItem( SCH_ITEM* aItem );
 
     /**
      * Function Clear
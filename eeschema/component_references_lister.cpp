@@ -31,6 +31,9 @@
 
 #include <wx/regex.h>
 #include <algorithm>
+#include <map>
+#include <tuple>
+#include <unordered_map>
 #include <vector>
 
 #include <fctsys.h>
@@ -40,8 +43,6 @@
 #include <sch_component.h>
 
 
-//#define USE_OLD_ALGO
-
 
 void SCH_REFERENCE_LIST::RemoveItem( unsigned int aIndex )
 {
@@ -138,28 +139,6 @@ bool SCH_REFERENCE_LIST::sortByTimeStamp( const SCH_REFERENCE& item1,
     return ii < 0;
 }
 
-int SCH_REFERENCE_LIST::FindUnit( size_t aIndex, int aUnit )
-{
-    int NumRef;
-
-    NumRef = componentFlatList[aIndex].m_NumRef;
-
-    for( size_t ii = 0; ii < componentFlatList.size(); ii++ )
-    {
-        if(  ( aIndex == ii )
-          || ( componentFlatList[ii].m_IsNew )
-          || ( componentFlatList[ii].m_NumRef != NumRef )
-          || ( componentFlatList[aIndex].CompareRef( componentFlatList[ii] ) != 0 ) )
-            continue;
-
-        if( componentFlatList[ii].m_Unit == aUnit )
-            return (int) ii;
-    }
-
-    return -1;
-}
-
-
 void SCH_REFERENCE_LIST::RemoveSubComponentsFromList()
 {
     SCH_COMPONENT* libItem;
@@ -206,94 +185,120 @@ void SCH_REFERENCE_LIST::ResetHiddenReferences()
 }
 
 
-void SCH_REFERENCE_LIST::GetRefsInUse( int aIndex, std::vector< int >& aIdList, int aMinRefId )
+void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId,
+      SCH_MULTI_UNIT_REFERENCE_MAP aLockedUnitMap )
 {
-    aIdList.clear();
+    if ( componentFlatList.size() == 0 )
+        return;
 
-    for( unsigned ii = 0; ii < componentFlatList.size(); ii++ )
-    {
-        if(  ( componentFlatList[aIndex].CompareRef( componentFlatList[ii] ) == 0 )
-          && ( componentFlatList[ii].m_NumRef >= aMinRefId )  )
-            aIdList.push_back( componentFlatList[ii].m_NumRef );
-    }
+    int LastReferenceNumber = 0;
+    int NumberOfUnits, Unit;
 
-    sort( aIdList.begin(), aIdList.end() );
+    // Components with an invisible reference (power...) always are re-annotated.
+    ResetHiddenReferences();
 
-    // Ensure each reference number appears only once.  If there are components with
-    // multiple parts per package the same number will be stored for each part.
-    std::vector< int >::iterator it = unique( aIdList.begin(), aIdList.end() );
+    /* The list is indexed once instead of being rescanned for every reference prefix,
+     * every locked unit and every unit of multi-unit parts (quadratic on large designs).
+     * The indexes are kept up to date while reference numbers and units are assigned.
+     */
+    typedef std::pair<SCH_COMPONENT*, wxString>             INSTANCE_KEY;
+    typedef std::pair<std::string, int>                     REF_KEY;
+    typedef std::tuple<std::string, wxString, std::string>  PART_KEY;
 
-    // Using the C++ unique algorithm only moves the duplicate entries to the end of
-    // of the array.  This removes the duplicate entries from the array.
-    aIdList.resize( it - aIdList.begin() );
-}
+    // Number of components using a reference number, for each reference prefix
+    std::unordered_map< std::string, std::unordered_map<int, int> > refsInUse;
 
+    // Components using a reference (prefix and number), to find units already annotated
+    std::map< REF_KEY, std::vector<unsigned> > refComponents;
 
-int SCH_REFERENCE_LIST::GetLastReference( int aIndex, int aMinValue )
-{
-    int lastNumber = aMinValue;
+    // Components with the same prefix, value and library part, in the list order
+    std::map< PART_KEY, std::vector<unsigned> > partComponents;
 
-    for( unsigned ii = 0; ii < componentFlatList.size(); ii++ )
-    {
-        // search only for the current reference prefix:
-        if( componentFlatList[aIndex].CompareRef( componentFlatList[ii] ) != 0 )
-            continue;
+    // Position of component instances (component and sheet path) in the list
+    std::map< INSTANCE_KEY, unsigned > instances;
 
-        // update max value for the current reference prefix
-        if( lastNumber < componentFlatList[ii].m_NumRef )
-            lastNumber = componentFlatList[ii].m_NumRef;
-    }
+    // Locked unit set containing a component instance
+    std::map< INSTANCE_KEY, SCH_REFERENCE_LIST* > lockedLists;
 
-    return lastNumber;
-}
+    // Reference numbers replaced by locked units, they are freed for the next prefix
+    std::vector< REF_KEY > releasedRefs;
 
+    auto instanceKey = []( const SCH_REFERENCE& aRef )
+    {
+        return INSTANCE_KEY( aRef.GetComp(), aRef.GetSheetPath().Path() );
+    };
 
-int SCH_REFERENCE_LIST::CreateFirstFreeRefId( std::vector<int>& aIdList, int aFirstValue )
-{
-    int expectedId = aFirstValue;
+    auto partKey = []( const SCH_REFERENCE& aRef )
+    {
+        return PART_KEY( aRef.m_Ref, aRef.m_Value->GetText(),
+                         aRef.m_RootCmp->GetLibId().GetLibItemName() );
+    };
+
+    auto setNumRef = [&]( unsigned aIndex, int aNumRef )
+    {
+        SCH_REFERENCE& ref = componentFlatList[aIndex];
 
-    // We search for expected Id a value >= aFirstValue.
-    // Skip existing Id < aFirstValue
-    unsigned ii = 0;
+        if( ref.m_NumRef == aNumRef )
+            return;
 
-    for( ; ii < aIdList.size(); ii++ )
+        releasedRefs.push_back( REF_KEY( ref.m_Ref, ref.m_NumRef ) );
+        refsInUse[ref.m_Ref][aNumRef]++;
+        refComponents[REF_KEY( ref.m_Ref, aNumRef )].push_back( aIndex );
+        ref.m_NumRef  = aNumRef;
+        ref.m_Changed = true;
+    };
+
+    auto setUnit = [&]( unsigned aIndex, int aUnit )
     {
-        if( expectedId <= aIdList[ii] )
-            break;
-    }
+        SCH_REFERENCE& ref = componentFlatList[aIndex];
 
-    // Ids are sorted by increasing value, from aFirstValue
-    // So we search from aFirstValue the first not used value, i.e. the first hole in list.
-    for( ; ii < aIdList.size(); ii++ )
+        if( ref.m_Unit == aUnit )
+            return;
+
+        ref.m_Unit    = aUnit;
+        ref.m_Changed = true;
+    };
+
+    // Is unit aUnit of the component at aIndex annotated already? Only the components
+    // sharing the reference are searched.
+    auto isUnitAnnotated = [&]( unsigned aIndex, int aUnit )
     {
-        if( expectedId != aIdList[ii] )    // This id is not yet used.
-        {
-            // Insert this free Id, in order to keep list sorted
-            aIdList.insert( aIdList.begin() + ii, expectedId );
-            return expectedId;
-        }
+        const SCH_REFERENCE& ref = componentFlatList[aIndex];
+        auto it = refComponents.find( REF_KEY( ref.m_Ref, ref.m_NumRef ) );
 
-        expectedId++;
-    }
+        if( it == refComponents.end() )
+            return false;
 
-    // All existing Id are tested, and all values are found in use.
-    // So Create a new one.
-    aIdList.push_back( expectedId );
-    return expectedId;
-}
+        for( unsigned jj : it->second )
+        {
+            const SCH_REFERENCE& other = componentFlatList[jj];
 
+            if( jj != aIndex && !other.m_IsNew && other.m_NumRef == ref.m_NumRef
+              && other.m_Unit == aUnit )
+                return true;
+        }
 
-void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId,
-      SCH_MULTI_UNIT_REFERENCE_MAP aLockedUnitMap )
-{
-    if ( componentFlatList.size() == 0 )
-        return;
+        return false;
+    };
 
-    int LastReferenceNumber = 0;
-    int NumberOfUnits, Unit;
+    for( unsigned ii = 0; ii < componentFlatList.size(); ii++ )
+    {
+        SCH_REFERENCE& ref = componentFlatList[ii];
 
-    // Components with an invisible reference (power...) always are re-annotated.
-    ResetHiddenReferences();
+        ref.m_Changed = false;
+        refsInUse[ref.m_Ref][ref.m_NumRef]++;
+        refComponents[REF_KEY( ref.m_Ref, ref.m_NumRef )].push_back( ii );
+        partComponents[partKey( ref )].push_back( ii );
+        instances.insert( std::make_pair( instanceKey( ref ), ii ) );
+    }
+
+    // The first set containing an instance wins, as when the map was searched in order
+    for( SCH_MULTI_UNIT_REFERENCE_MAP::value_type& pair : aLockedUnitMap )
+    {
+        for( unsigned thisRefI = 0; thisRefI < pair.second.GetCount(); ++thisRefI )
+            lockedLists.insert( std::make_pair( instanceKey( pair.second[thisRefI] ),
+                                                &pair.second ) );
+    }
 
     /* calculate index of the first component with the same reference prefix
      * than the current component.  All components having the same reference
@@ -302,27 +307,28 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId,
      */
     unsigned first = 0;
 
-    // calculate the last used number for this reference prefix:
-#ifdef USE_OLD_ALGO
-    int minRefId = 0;
-
-    // when using sheet number, ensure ref number >= sheet number* aSheetIntervalId
-    if( aUseSheetNum )
-        minRefId = componentFlatList[first].m_SheetNum * aSheetIntervalId;
-
-    LastReferenceNumber = GetLastReference( first, minRefId );
-#else
     int minRefId = 1;
 
     // when using sheet number, ensure ref number >= sheet number* aSheetIntervalId
     if( aUseSheetNum )
         minRefId = componentFlatList[first].m_SheetNum * aSheetIntervalId + 1;
 
-    // This is the list of all Id already in use for a given reference prefix.
-    // Will be refilled for each new reference prefix.
-    std::vector<int>idList;
-    GetRefsInUse( first, idList, minRefId );
-#endif
+    // Every number below this one is in use for the current reference prefix.
+    int nextFreeRefId = minRefId;
+
+    auto createFirstFreeRefId = [&]( unsigned aIndex )
+    {
+        std::unordered_map<int, int>& inUse = refsInUse[componentFlatList[aIndex].m_Ref];
+
+        for( ; ; nextFreeRefId++ )
+        {
+            auto it = inUse.find( nextFreeRefId );
+
+            if( it == inUse.end() || it->second <= 0 )
+                return nextFreeRefId;
+        }
+    };
+
     for( unsigned ii = 0; ii < componentFlatList.size(); ii++ )
     {
         if( componentFlatList[ii].m_Flag )
@@ -330,44 +336,28 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId,
 
         // Check whether this component is in aLockedUnitMap.
         SCH_REFERENCE_LIST* lockedList = NULL;
-        for( SCH_MULTI_UNIT_REFERENCE_MAP::value_type& pair : aLockedUnitMap )
-        {
-            unsigned n_refs = pair.second.GetCount();
-            for( unsigned thisRefI = 0; thisRefI < n_refs; ++thisRefI )
-            {
-                SCH_REFERENCE &thisRef = pair.second[thisRefI];
+        auto locked = lockedLists.find( instanceKey( componentFlatList[ii] ) );
 
-                if( thisRef.IsSameInstance( componentFlatList[ii] ) )
-                {
-                    lockedList = &pair.second;
-                    break;
-                }
-            }
-            if( lockedList != NULL ) break;
-        }
+        if( locked != lockedLists.end() )
+            lockedList = locked->second;
 
         if(  ( componentFlatList[first].CompareRef( componentFlatList[ii] ) != 0 )
           || ( aUseSheetNum && ( componentFlatList[first].m_SheetNum != componentFlatList[ii].m_SheetNum ) )  )
         {
             // New reference found: we need a new ref number for this reference
             first = ii;
-#ifdef USE_OLD_ALGO
-            minRefId = 0;
-
-            // when using sheet number, ensure ref number >= sheet number* aSheetIntervalId
-            if( aUseSheetNum )
-                minRefId = componentFlatList[ii].m_SheetNum * aSheetIntervalId;
-
-            LastReferenceNumber = componentFlatList.GetLastReference( ii, minRefId );
-#else
             minRefId = 1;
 
             // when using sheet number, ensure ref number >= sheet number* aSheetIntervalId
             if( aUseSheetNum )
                 minRefId = componentFlatList[ii].m_SheetNum * aSheetIntervalId + 1;
 
-            GetRefsInUse( first, idList, minRefId );
-#endif
+            nextFreeRefId = minRefId;
+
+            for( const REF_KEY& released : releasedRefs )
+                refsInUse[released.first][released.second]--;
+
+            releasedRefs.clear();
         }
 
         // Annotation of one part per package components (trivial case).
@@ -375,15 +365,11 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId,
         {
             if( componentFlatList[ii].m_IsNew )
             {
-#ifdef USE_OLD_ALGO
-                LastReferenceNumber++;
-#else
-                LastReferenceNumber = CreateFirstFreeRefId( idList, minRefId );
-#endif
-                componentFlatList[ii].m_NumRef = LastReferenceNumber;
+                LastReferenceNumber = createFirstFreeRefId( ii );
+                setNumRef( ii, LastReferenceNumber );
             }
 
-            componentFlatList[ii].m_Unit  = 1;
+            setUnit( ii, 1 );
             componentFlatList[ii].m_Flag  = 1;
             componentFlatList[ii].m_IsNew = false;
             continue;
@@ -394,15 +380,11 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId,
 
         if( componentFlatList[ii].m_IsNew )
         {
-#ifdef USE_OLD_ALGO
-            LastReferenceNumber++;
-#else
-            LastReferenceNumber = CreateFirstFreeRefId( idList, minRefId );
-#endif
-            componentFlatList[ii].m_NumRef = LastReferenceNumber;
+            LastReferenceNumber = createFirstFreeRefId( ii );
+            setNumRef( ii, LastReferenceNumber );
 
             if( !componentFlatList[ii].IsUnitsLocked() )
-                componentFlatList[ii].m_Unit = 1;
+                setUnit( ii, 1 );
 
             componentFlatList[ii].m_Flag = 1;
         }
@@ -418,22 +400,23 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId,
                 if( thisRef.IsSameInstance( componentFlatList[ii] ) )
                 {
                     // This is the component we're currently annotating. Hold the unit!
-                    componentFlatList[ii].m_Unit = thisRef.m_Unit;
+                    setUnit( ii, thisRef.m_Unit );
                 }
 
                 if( thisRef.CompareValue( componentFlatList[ii] ) != 0 ) continue;
                 if( thisRef.CompareLibName( componentFlatList[ii] ) != 0 ) continue;
 
                 // Find the matching component
-                for( unsigned jj = ii + 1; jj < componentFlatList.size(); jj++ )
-                {
-                    if( ! thisRef.IsSameInstance( componentFlatList[jj] ) ) continue;
-                    componentFlatList[jj].m_NumRef = componentFlatList[ii].m_NumRef;
-                    componentFlatList[jj].m_Unit = thisRef.m_Unit;
-                    componentFlatList[jj].m_IsNew = false;
-                    componentFlatList[jj].m_Flag = 1;
-                    break;
-                }
+                auto instance = instances.find( instanceKey( thisRef ) );
+
+                if( instance == instances.end() || instance->second <= ii )
+                    continue;
+
+                unsigned jj = instance->second;
+                setNumRef( jj, componentFlatList[ii].m_NumRef );
+                setUnit( jj, thisRef.m_Unit );
+                componentFlatList[jj].m_IsNew = false;
+                componentFlatList[jj].m_Flag = 1;
             }
         }
 
@@ -443,29 +426,24 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId,
             * we search for others parts that have the same value and the same
             * reference prefix (ref without ref number)
             */
+            const std::vector<unsigned>& sameParts =
+                    partComponents[partKey( componentFlatList[ii] )];
+
             for( Unit = 1; Unit <= NumberOfUnits; Unit++ )
             {
                 if( componentFlatList[ii].m_Unit == Unit )
                     continue;
 
-                int found = FindUnit( ii, Unit );
-
-                if( found >= 0 )
+                if( isUnitAnnotated( ii, Unit ) )
                     continue; // this unit exists for this reference (unit already annotated)
 
                 // Search a component to annotate ( same prefix, same value, not annotated)
-                for( unsigned jj = ii + 1; jj < componentFlatList.size(); jj++ )
+                for( auto it = std::upper_bound( sameParts.begin(), sameParts.end(), ii );
+                     it != sameParts.end(); ++it )
                 {
-                    if( componentFlatList[jj].m_Flag )    // already tested
-                        continue;
-
-                    if( componentFlatList[ii].CompareRef( componentFlatList[jj] ) != 0 )
-                        continue;
+                    unsigned jj = *it;
 
-                    if( componentFlatList[jj].CompareValue( componentFlatList[ii] ) != 0 )
-                        continue;
-
-                    if( componentFlatList[jj].CompareLibName( componentFlatList[ii] ) != 0 )
+                    if( componentFlatList[jj].m_Flag )    // already tested
                         continue;
 
                     if( !componentFlatList[jj].m_IsNew )
@@ -475,8 +453,8 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId,
                     if( !componentFlatList[jj].IsUnitsLocked()
                         || ( componentFlatList[jj].m_Unit == Unit ) )
                     {
-                        componentFlatList[jj].m_NumRef = componentFlatList[ii].m_NumRef;
-                        componentFlatList[jj].m_Unit   = Unit;
+                        setNumRef( jj, componentFlatList[ii].m_NumRef );
+                        setUnit( jj, Unit );
                         componentFlatList[jj].m_Flag   = 1;
                         componentFlatList[jj].m_IsNew  = false;
                         break;
@@ -702,6 +680,7 @@ SCH_REFERENCE::SCH_REFERENCE( SCH_COMPONENT* aComponent, LIB_PART* aLibPart,
     m_Unit      = aComponent->GetUnitSelection( &aSheetPath );
     m_SheetPath = aSheetPath;
     m_IsNew     = false;
+    m_Changed   = false;
     m_Flag      = 0;
     m_TimeStamp = aComponent->GetTimeStamp();
     m_CmpPos    = aComponent->GetPosition();
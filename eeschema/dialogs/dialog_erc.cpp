@@ -495,82 +495,11 @@ void DIALOG_ERC::TestErc( wxArrayString* aMessagesList )
     // Reset the connection type indicator
     objectsConnectedList->ResetConnectionsType();
 
-    unsigned lastItemIdx;
-    unsigned nextItemIdx = lastItemIdx = 0;
-    int MinConn    = NOC;
-
     /* The netlist generated by SCH_EDIT_FRAME::BuildNetListBase is sorted
-     * by net number, which means we can group netlist items into ranges
-     * that live in the same net. The range from nextItem to the current
-     * item (exclusive) needs to be checked against the current item. The
-     * lastItem variable is used as a helper to pass the last item's number
-     * from one loop iteration to the next, which simplifies the initial
-     * pass.
+     * by net number: items of every net (pins, labels, no connect symbols)
+     * are checked against the other items of the same net.
      */
-
-    for( unsigned itemIdx = 0; itemIdx < objectsConnectedList->size(); itemIdx++ )
-    {
-        auto item = objectsConnectedList->GetItem( itemIdx );
-        auto lastItem = objectsConnectedList->GetItem( lastItemIdx );
-
-        auto lastNet = lastItem->GetNet();
-        auto net = item->GetNet();
-
-        wxASSERT_MSG( lastNet <= net, wxT( "Netlist not correctly ordered" ) );
-
-        if( lastNet != net )
-        {
-            // New net found:
-            MinConn      = NOC;
-            nextItemIdx = itemIdx;
-        }
-
-        switch( item->m_Type )
-        {
-        // These items do not create erc problems
-        case NET_ITEM_UNSPECIFIED:
-        case NET_SEGMENT:
-        case NET_BUS:
-        case NET_JUNCTION:
-        case NET_LABEL:
-        case NET_BUSLABELMEMBER:
-        case NET_PINLABEL:
-        case NET_GLOBBUSLABELMEMBER:
-            break;
-
-        case NET_HIERLABEL:
-        case NET_HIERBUSLABELMEMBER:
-        case NET_SHEETLABEL:
-        case NET_SHEETBUSLABELMEMBER:
-            // ERC problems when pin sheets do not match hierarchical labels.
-            // Each pin sheet must match a hierarchical label
-            // Each hierarchical label must match a pin sheet
-            objectsConnectedList->TestforNonOrphanLabel( itemIdx, nextItemIdx );
-            break;
-        case NET_GLOBLABEL:
-            if( m_tstUniqueGlobalLabels )
-                objectsConnectedList->TestforNonOrphanLabel( itemIdx, nextItemIdx );
-            break;
-
-        case NET_NOCONNECT:
-
-            // ERC problems when a noconnect symbol is connected to more than one pin.
-            MinConn = NET_NC;
-
-            if( objectsConnectedList->CountPinsInNet( nextItemIdx ) > 1 )
-                Diagnose( item, NULL, MinConn, UNC );
-
-            break;
-
-        case NET_PIN:
-
-            // Look for ERC problems between pins:
-            TestOthersItems( objectsConnectedList.get(), itemIdx, nextItemIdx, &MinConn );
-            break;
-        }
-
-        lastItemIdx = itemIdx;
-    }
+    TestNets( objectsConnectedList.get(), m_tstUniqueGlobalLabels );
 
     // Test similar labels (i;e. labels which are identical when
     // using case insensitive comparisons)
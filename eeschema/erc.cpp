@@ -41,8 +41,19 @@
 #include <sch_component.h>
 #include <sch_sheet.h>
 
+#include <hashtables.h>
+
 #include <wx/ffile.h>
 
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <set>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
 
 /* ERC tests :
  *  1 - conflicts between connected pins ( example: 2 connected outputs )
@@ -369,159 +380,277 @@ void Diagnose( NETLIST_OBJECT* aNetItemRef, NETLIST_OBJECT* aNetItemTst,
 }
 
 
-void TestOthersItems( NETLIST_OBJECT_LIST* aList,
-                      unsigned aNetItemRef, unsigned aNetStart,
-                      int* aMinConnexion )
+/**
+ * Struct ERC_NET_DIAG
+ * is an ERC problem found by TestNets() in a net.  Problems are turned into markers by
+ * Diagnose() once all the nets are tested, in the netlist order.
+ */
+struct ERC_NET_DIAG
 {
-    unsigned netItemTst = aNetStart;
-    ELECTRICAL_PINTYPE jj;
-    int erc = OK;
+    unsigned        m_refIdx;           ///< Index of the reference item in the netlist
+    NETLIST_OBJECT* m_tst;
+    int             m_minConn;
+    int             m_diag;
+    bool            m_checkDuplicates;  ///< Unconnected pin, skipped if another instance
+                                        ///< of the pin is connected
+};
+
 
-    /* Analysis of the table of connections. */
-    ELECTRICAL_PINTYPE ref_elect_type = aList->GetItem( aNetItemRef )->m_ElectricalPinType;
-    int local_minconn = NOC;
+/**
+ * Function testNet
+ * performs the ERC tests of all the items of the net [aNetStart, aNetEnd) of \a aList:
+ * electrical conflicts between pins, minimal connection requirements, orphan labels and
+ * no connect symbols connected to several pins.  Pins are checked against a histogram of
+ * the pin types of the net instead of against every other pin, and labels against the
+ * labels of the net they can be connected to.
+ */
+static void testNet( NETLIST_OBJECT_LIST* aList, unsigned aNetStart, unsigned aNetEnd,
+                     bool aTestGlobalLabels, std::vector<ERC_NET_DIAG>& aDiags )
+{
+    // Pins of the net, by electrical type, in the list order
+    std::vector<unsigned> pinsByType[PINTYPE_COUNT];
+    int         pinCount = 0;
+    bool        hasNoConnect = false;
 
-    if( ref_elect_type == PIN_NC )
-        local_minconn = NPI;
+    // Sheets included by sheet labels, sheets of hierarchical labels, global label names
+    std::set<SCH_SHEETS> sheetLabelIncludes;
+    std::set<SCH_SHEETS> hierLabelSheets;
+    std::map<wxString, int> globalLabels;
 
-    /* Test pins connected to NetItemRef */
-    for( ; ; netItemTst++ )
+    for( unsigned ii = aNetStart; ii < aNetEnd; ii++ )
     {
-        if( aNetItemRef == netItemTst )
-            continue;
+        NETLIST_OBJECT* item = aList->GetItem( ii );
 
-        // We examine only a given net. We stop the search if the net changes
-        if( ( netItemTst >= aList->size() ) // End of list
-            || ( aList->GetItemNet( aNetItemRef ) !=
-                 aList->GetItemNet( netItemTst ) ) ) // End of net
+        switch( item->m_Type )
         {
-            /* End net code found: minimum connection test. */
-            if( ( *aMinConnexion < NET_NC ) && ( local_minconn < NET_NC ) )
-            {
-                /* Not connected or not driven pin. */
-                bool seterr = true;
+        case NET_PIN:
+            pinsByType[item->m_ElectricalPinType].push_back( ii );
+            pinCount++;
+            break;
 
-                if( local_minconn == NOC &&
-                    aList->GetItemType( aNetItemRef ) == NET_PIN )
-                {
-                    /* This pin is not connected: for multiple part per
-                     * package, and duplicated pin,
-                     * search for an other instance of this pin
-                     * this will be flagged only if all instances of this pin
-                     * are not connected
-                     * TODO test also if instances connected are connected to
-                     * the same net
-                     */
-                    for( unsigned duplicate = 0; duplicate < aList->size(); duplicate++ )
-                    {
-                        if( aList->GetItemType( duplicate ) != NET_PIN )
-                            continue;
+        case NET_NOCONNECT:
+            hasNoConnect = true;
+            break;
 
-                        if( duplicate == aNetItemRef )
-                            continue;
+        case NET_SHEETLABEL:
+        case NET_SHEETBUSLABELMEMBER:
+            sheetLabelIncludes.insert( item->m_SheetPathInclude );
+            break;
 
-                        if( aList->GetItem( aNetItemRef )->m_PinNum !=
-                            aList->GetItem( duplicate )->m_PinNum )
-                            continue;
+        case NET_HIERLABEL:
+        case NET_HIERBUSLABELMEMBER:
+            hierLabelSheets.insert( item->m_SheetPath );
+            break;
 
-                        if( ( (SCH_COMPONENT*) aList->GetItem( aNetItemRef )->
-                             m_Link )->GetRef( &aList->GetItem( aNetItemRef )-> m_SheetPath ) !=
-                            ( (SCH_COMPONENT*) aList->GetItem( duplicate )->m_Link )
-                           ->GetRef( &aList->GetItem( duplicate )->m_SheetPath ) )
-                            continue;
+        case NET_GLOBLABEL:
+            globalLabels[item->m_Label]++;
+            break;
 
-                        // Same component and same pin. Do dot create error for this pin
-                        // if the other pin is connected (i.e. if duplicate net has an other
-                        // item)
-                        if( (duplicate > 0)
-                          && ( aList->GetItemNet( duplicate ) ==
-                               aList->GetItemNet( duplicate - 1 ) ) )
-                            seterr = false;
-
-                        if( (duplicate < aList->size() - 1)
-                          && ( aList->GetItemNet( duplicate ) ==
-                               aList->GetItemNet( duplicate + 1 ) ) )
-                            seterr = false;
-                    }
-                }
+        default:
+            break;
+        }
+    }
 
-                if( seterr )
-                    Diagnose( aList->GetItem( aNetItemRef ), NULL, local_minconn, WAR );
+    auto addDiag = [&]( unsigned aRefIdx, NETLIST_OBJECT* aTst, int aMinConn, int aDiag,
+                        bool aCheckDuplicates )
+    {
+        ERC_NET_DIAG diag = { aRefIdx, aTst, aMinConn, aDiag, aCheckDuplicates };
+        aDiags.push_back( diag );
+    };
 
-                *aMinConnexion = DRV;   // inhibiting other messages of this
-                                       // type for the net.
-            }
-            return;
-        }
+    int MinConn = NOC;
 
-        switch( aList->GetItemType( netItemTst ) )
+    for( unsigned ii = aNetStart; ii < aNetEnd; ii++ )
+    {
+        NETLIST_OBJECT* item = aList->GetItem( ii );
+
+        switch( item->m_Type )
         {
-        case NET_ITEM_UNSPECIFIED:
-        case NET_SEGMENT:
-        case NET_BUS:
-        case NET_JUNCTION:
-        case NET_LABEL:
+        // ERC problems when pin sheets do not match hierarchical labels.
+        // Each pin sheet must match a hierarchical label
+        // Each hierarchical label must match a pin sheet
         case NET_HIERLABEL:
-        case NET_BUSLABELMEMBER:
         case NET_HIERBUSLABELMEMBER:
-        case NET_SHEETBUSLABELMEMBER:
+            if( !sheetLabelIncludes.count( item->m_SheetPath ) )
+                addDiag( ii, NULL, -1, WAR, false );
+            break;
+
         case NET_SHEETLABEL:
+        case NET_SHEETBUSLABELMEMBER:
+            if( !hierLabelSheets.count( item->m_SheetPathInclude ) )
+                addDiag( ii, NULL, -1, WAR, false );
+            break;
+
         case NET_GLOBLABEL:
-        case NET_GLOBBUSLABELMEMBER:
-        case NET_PINLABEL:
+            if( aTestGlobalLabels && globalLabels[item->m_Label] < 2 )
+                addDiag( ii, NULL, -1, WAR, false );
             break;
 
         case NET_NOCONNECT:
-            local_minconn = std::max( NET_NC, local_minconn );
+            // ERC problems when a noconnect symbol is connected to more than one pin.
+            MinConn = NET_NC;
+
+            if( pinCount > 1 )
+                addDiag( ii, NULL, MinConn, UNC, false );
+
             break;
 
         case NET_PIN:
-            jj = aList->GetItem( netItemTst )->m_ElectricalPinType;
-            local_minconn = std::max( MinimalReq[ref_elect_type][jj], local_minconn );
+        {
+            // Look for ERC problems between pins:
+            ELECTRICAL_PINTYPE ref_elect_type = item->m_ElectricalPinType;
+            int local_minconn = ( ref_elect_type == PIN_NC ) ? NPI : NOC;
+            unsigned netItemTst = aNetEnd;
+
+            if( hasNoConnect )
+                local_minconn = std::max( NET_NC, local_minconn );
+
+            for( int jj = 0; jj < PINTYPE_COUNT; jj++ )
+            {
+                const std::vector<unsigned>& pins = pinsByType[jj];
+
+                // Do not count the tested pin itself
+                if( pins.size() > ( jj == ref_elect_type ? 1u : 0u ) )
+                    local_minconn = std::max( MinimalReq[ref_elect_type][jj], local_minconn );
+
+                // Only the first conflicting pin after the tested one is reported
+                if( DiagErc[ref_elect_type][jj] == OK )
+                    continue;
+
+                auto next = std::upper_bound( pins.begin(), pins.end(), ii );
 
-            if( netItemTst <= aNetItemRef )
-                break;
+                if( next != pins.end() )
+                    netItemTst = std::min( netItemTst, *next );
+            }
 
-            if( erc == OK )
+            if( netItemTst < aNetEnd )
             {
-                erc = DiagErc[ref_elect_type][jj];
+                NETLIST_OBJECT* tst = aList->GetItem( netItemTst );
 
-                if( erc != OK )
+                if( tst->GetConnectionType() == UNCONNECTED )
                 {
-                    if( aList->GetConnectionType( netItemTst ) == UNCONNECTED )
-                    {
-                        Diagnose( aList->GetItem( aNetItemRef ),
-                                  aList->GetItem( netItemTst ),
-                                  0, erc );
-                        aList->SetConnectionType( netItemTst, NOCONNECT_SYMBOL_PRESENT );
-                    }
+                    addDiag( ii, tst, 0, DiagErc[ref_elect_type][tst->m_ElectricalPinType],
+                             false );
+                    tst->SetConnectionType( NOCONNECT_SYMBOL_PRESENT );
                 }
             }
 
+            /* End net code found: minimum connection test. */
+            if( ( MinConn < NET_NC ) && ( local_minconn < NET_NC ) )
+            {
+                /* Not connected or not driven pin.
+                 * An unconnected pin of multiple part per package components is flagged
+                 * only if all instances of this pin are not connected: this is checked
+                 * when markers are created.
+                 */
+                addDiag( ii, NULL, local_minconn, WAR, local_minconn == NOC );
+
+                MinConn = DRV;  // inhibiting other messages of this type for the net.
+            }
+
+            break;
+        }
+
+        // These items do not create erc problems
+        default:
             break;
         }
     }
 }
 
-int NETLIST_OBJECT_LIST::CountPinsInNet( unsigned aNetStart )
+
+void TestNets( NETLIST_OBJECT_LIST* aList, bool aTestGlobalLabels )
 {
-    int count = 0;
-    int curr_net = GetItemNet( aNetStart );
+    // The list is sorted by net code: find the first item of every net.
+    std::vector<unsigned> netStarts;
 
-    /* Test pins connected to NetItemRef */
-    for( unsigned item = aNetStart; item < size(); item++ )
+    for( unsigned ii = 0; ii < aList->size(); ii++ )
     {
-        // We examine only a given net. We stop the search if the net changes
-        if( curr_net != GetItemNet( item ) )   // End of net
-            break;
+        wxASSERT_MSG( ii == 0 || aList->GetItemNet( ii - 1 ) <= aList->GetItemNet( ii ),
+                      wxT( "Netlist not correctly ordered" ) );
 
-        if( GetItemType( item ) == NET_PIN )
-            count++;
+        if( ii == 0 || aList->GetItemNet( ii - 1 ) != aList->GetItemNet( ii ) )
+            netStarts.push_back( ii );
     }
 
-    return count;
+    netStarts.push_back( aList->size() );
+
+    unsigned netCount = netStarts.size() - 1;
+    std::vector< std::vector<ERC_NET_DIAG> > diags( netCount );
+    std::atomic<unsigned> nextNet( 0 );
+
+    // Nets are independent, they are tested in parallel. Markers are created afterwards.
+    auto tester = [&]()
+    {
+        for( unsigned net = nextNet++; net < netCount; net = nextNet++ )
+            testNet( aList, netStarts[net], netStarts[net + 1], aTestGlobalLabels, diags[net] );
+    };
+
+    unsigned threadCount = std::min<unsigned>( std::thread::hardware_concurrency(), netCount );
+
+    // The current thread tests nets as well
+    std::vector<std::thread> threads;
+
+    for( unsigned i = 1; i < threadCount; i++ )
+        threads.push_back( std::thread( tester ) );
+
+    tester();
+
+    for( std::thread& thread : threads )
+        thread.join();
+
+    // Instances (pins with the same number and component reference) of pins that
+    // are connected to something, built only if an unconnected pin is found.
+    std::map< std::pair<long, wxString>, std::vector<unsigned> > pinInstances;
+    bool pinInstancesBuilt = false;
+
+    auto pinInstance = [&]( unsigned aIdx )
+    {
+        NETLIST_OBJECT* pin = aList->GetItem( aIdx );
+        SCH_COMPONENT*  comp = (SCH_COMPONENT*) pin->m_Link;
+
+        return std::make_pair( pin->m_PinNum, comp->GetRef( &pin->m_SheetPath ) );
+    };
+
+    for( unsigned net = 0; net < netCount; net++ )
+    {
+        for( const ERC_NET_DIAG& diag : diags[net] )
+        {
+            if( diag.m_checkDuplicates )
+            {
+                if( !pinInstancesBuilt )
+                {
+                    pinInstancesBuilt = true;
+
+                    for( unsigned n = 0; n < netCount; n++ )
+                    {
+                        // Only pins whose net has other items are connected
+                        if( netStarts[n + 1] - netStarts[n] < 2 )
+                            continue;
+
+                        for( unsigned ii = netStarts[n]; ii < netStarts[n + 1]; ii++ )
+                        {
+                            if( aList->GetItemType( ii ) == NET_PIN )
+                                pinInstances[pinInstance( ii )].push_back( ii );
+                        }
+                    }
+                }
+
+                auto instances = pinInstances.find( pinInstance( diag.m_refIdx ) );
+
+                // Same component and same pin. Do not create error for this pin
+                // if an other instance of the pin is connected
+                if( instances != pinInstances.end()
+                  && ( instances->second.size() > 1 || instances->second[0] != diag.m_refIdx ) )
+                    continue;
+            }
+
+            Diagnose( aList->GetItem( diag.m_refIdx ), diag.m_tst, diag.m_minConn, diag.m_diag );
+        }
+    }
 }
 
+
 bool WriteDiagnosticERC( const wxString& aFullFileName )
 {
     wxString    msg;
@@ -581,77 +710,11 @@ bool WriteDiagnosticERC( const wxString& aFullFileName )
 }
 
 
-void NETLIST_OBJECT_LIST::TestforNonOrphanLabel( unsigned aNetItemRef, unsigned aStartNet )
-{
-    unsigned netItemTst = aStartNet;
-    int      erc = 1;
-
-    // Review the list of labels connected to NetItemRef:
-    for( ; ; netItemTst++ )
-    {
-        if( netItemTst == aNetItemRef )
-            continue;
-
-        /* Is always in the same net? */
-        if( ( netItemTst == size() )
-          || ( GetItemNet( aNetItemRef ) != GetItemNet( netItemTst ) ) )
-        {
-            /* End Netcode found. */
-            if( erc )
-            {
-                /* Glabel or SheetLabel orphaned. */
-                Diagnose( GetItem( aNetItemRef ), NULL, -1, WAR );
-            }
-
-            return;
-        }
-
-        if( GetItem( aNetItemRef )->IsLabelConnected( GetItem( netItemTst ) ) )
-            erc = 0;
-
-        //same thing, different order.
-        if( GetItem( netItemTst )->IsLabelConnected( GetItem( aNetItemRef ) ) )
-            erc = 0;
-    }
-}
-
-
 // this code try to detect similar labels, i.e. labels which are identical
 // when they are compared using case insensitive coparisons.
 
 
-// A helper struct to compare NETLIST_OBJECT items by sheetpath and label texts
-// for a std::set<NETLIST_OBJECT*> container
-// the full text is "sheetpath+label" for local labels and "label" for global labels
-struct compare_labels
-{
-    bool operator() ( const NETLIST_OBJECT* lab1, const NETLIST_OBJECT* lab2 )
-    {
-        wxString str1 = lab1->m_SheetPath.Path() + lab1->m_Label;
-        wxString str2 = lab2->m_SheetPath.Path() + lab2->m_Label;
-
-        return str1.Cmp( str2 ) < 0;
-    }
-};
-
-struct compare_label_names
-{
-    bool operator() ( const NETLIST_OBJECT* lab1, const NETLIST_OBJECT* lab2 )
-    {
-        return lab1->m_Label.Cmp( lab2->m_Label ) < 0;
-    }
-};
-
-struct compare_paths
-{
-    bool operator() ( const NETLIST_OBJECT* lab1, const NETLIST_OBJECT* lab2 )
-    {
-        return lab1->m_SheetPath.Path().Cmp( lab2->m_SheetPath.Path() ) < 0;
-    }
-};
-
-// Helper functions to build the warning messages about Similar Labels:
-static int countIndenticalLabels( std::vector<NETLIST_OBJECT*>& aList, NETLIST_OBJECT* aLabel );
+// Helper function to build the warning messages about Similar Labels:
 static void SimilarLabelsDiagnose( NETLIST_OBJECT* aItemA, NETLIST_OBJECT* aItemB );
 
 
@@ -660,11 +723,20 @@ void NETLIST_OBJECT_LIST::TestforSimilarLabels()
     // Similar labels which are different when using case sensitive comparisons
     // but are equal when using case insensitive comparisons
 
+    struct LABEL
+    {
+        NETLIST_OBJECT* m_item;
+        wxString        m_path;     ///< sheet path of the label
+        wxString        m_key;      ///< "sheetpath+label", identifies different labels
+    };
+
     // list of all labels (used the better item to build diag messages)
-    std::vector<NETLIST_OBJECT*> fullLabelList;
-    // list of all labels , each label appears only once (used to to detect similar labels)
-    std::set<NETLIST_OBJECT*, compare_labels> uniqueLabelList;
-    wxString msg;
+    std::vector<LABEL> fullLabelList;
+
+    // Number of identical labels: for global labels, global labels in the full project,
+    // for local labels, all labels in the sheet (by sheet path and label)
+    std::unordered_map<wxString, int, WXSTRING_HASH> globalLabelCount;
+    std::map< std::pair<wxString, wxString>, int > sheetLabelCount;
 
     // Build a list of differents labels. If inside a given sheet there are
     // more than one given label, only one label is stored.
@@ -683,10 +755,23 @@ void NETLIST_OBJECT_LIST::TestforSimilarLabels()
         case NET_HIERLABEL:
         case NET_HIERBUSLABELMEMBER:
         case NET_GLOBLABEL:
+        {
             // add this label in lists
-            uniqueLabelList.insert( GetItem( netItem ) );
-            fullLabelList.push_back( GetItem( netItem ) );
+            NETLIST_OBJECT* item = GetItem( netItem );
+            LABEL label;
+
+            label.m_item = item;
+            label.m_path = item->m_SheetPath.Path();
+            label.m_key  = label.m_path + item->m_Label;
+            fullLabelList.push_back( label );
+
+            sheetLabelCount[std::make_pair( label.m_path, item->m_Label )]++;
+
+            if( item->IsLabelGlobal() )
+                globalLabelCount[item->m_Label]++;
+
             break;
+        }
 
         case NET_SHEETLABEL:
         case NET_SHEETBUSLABELMEMBER:
@@ -695,120 +780,103 @@ void NETLIST_OBJECT_LIST::TestforSimilarLabels()
         }
     }
 
-    // build global labels and compare
-    std::set<NETLIST_OBJECT*, compare_label_names> loc_labelList;
-    std::set<NETLIST_OBJECT*>::const_iterator it;
-
-    for( it = uniqueLabelList.begin(); it != uniqueLabelList.end(); ++it )
-    {
-        if( (*it)->IsLabelGlobal() )
-            loc_labelList.insert( *it );
-    }
-
-    // compare global labels (same label names appears only once in list)
-    for( it = loc_labelList.begin(); it != loc_labelList.end(); ++it )
+    // list of all labels , each label appears only once (used to to detect similar labels)
+    std::vector<const LABEL*> uniqueLabelList;
+
+    for( const LABEL& label : fullLabelList )
+        uniqueLabelList.push_back( &label );
+
+    // Stable sort, so the first label of the list is kept for identical labels
+    std::stable_sort( uniqueLabelList.begin(), uniqueLabelList.end(),
+                      []( const LABEL* aLabelA, const LABEL* aLabelB )
+                      {
+                          return aLabelA->m_key.Cmp( aLabelB->m_key ) < 0;
+                      } );
+
+    uniqueLabelList.erase( std::unique( uniqueLabelList.begin(), uniqueLabelList.end(),
+                                        []( const LABEL* aLabelA, const LABEL* aLabelB )
+                                        {
+                                            return aLabelA->m_key == aLabelB->m_key;
+                                        } ),
+                           uniqueLabelList.end() );
+
+    auto countIdenticalLabels = [&]( const LABEL* aLabel )
     {
-        std::set<NETLIST_OBJECT*>::const_iterator it_aux = it;
+        if( aLabel->m_item->IsLabelGlobal() )
+            return globalLabelCount[aLabel->m_item->m_Label];
 
-        for( ++it_aux; it_aux != loc_labelList.end(); ++it_aux )
-        {
-            if( (*it)->m_Label.CmpNoCase( (*it_aux)->m_Label ) == 0 )
-            {
-                // Create new marker for ERC.
-                int cntA = countIndenticalLabels( fullLabelList, *it );
-                int cntB = countIndenticalLabels( fullLabelList, *it_aux );
-
-                if( cntA <= cntB )
-                    SimilarLabelsDiagnose( (*it), (*it_aux) );
-                else
-                    SimilarLabelsDiagnose( (*it_aux), (*it) );
-            }
-        }
-    }
-
-    // Build paths list
-    std::set<NETLIST_OBJECT*, compare_paths> pathsList;
+        return sheetLabelCount[std::make_pair( aLabel->m_path, aLabel->m_item->m_Label )];
+    };
 
-    for( it = uniqueLabelList.begin(); it != uniqueLabelList.end(); ++it )
-        pathsList.insert( *it );
-
-    // Examine each label inside a sheet path:
-    for( it = pathsList.begin(); it != pathsList.end(); ++it )
+    auto sortByName = []( const LABEL* aLabelA, const LABEL* aLabelB )
+    {
+        return aLabelA->m_item->m_Label.Cmp( aLabelB->m_item->m_Label ) < 0;
+    };
+
+    // Report the labels of aLabels (sorted by name, each name appearing only once) which
+    // are equal when using case insensitive comparisons. Labels are found with an index
+    // of case-folded names instead of comparing all the labels pairwise.
+    auto reportSimilarLabels = [&]( const std::vector<const LABEL*>& aLabels,
+                                    bool aSkipGlobalPairs )
     {
-        loc_labelList.clear();
+        std::unordered_map<wxString, std::vector<unsigned>, WXSTRING_HASH> foldedNames;
 
-        std::set<NETLIST_OBJECT*>::const_iterator it_aux = uniqueLabelList.begin();
+        for( unsigned ii = 0; ii < aLabels.size(); ii++ )
+            foldedNames[aLabels[ii]->m_item->m_Label.Lower()].push_back( ii );
 
-        for( ; it_aux != uniqueLabelList.end(); ++it_aux )
+        for( unsigned ii = 0; ii < aLabels.size(); ii++ )
         {
-            if( (*it)->m_SheetPath.Path() == (*it_aux)->m_SheetPath.Path() )
-                loc_labelList.insert( *it_aux );
-        }
+            const LABEL* ref = aLabels[ii];
 
-        // at this point, loc_labelList contains labels of the current sheet path.
-        // Detect similar labels (same label names appears only once in list)
-        std::set<NETLIST_OBJECT*>::const_iterator ref_it;
+            for( unsigned jj : foldedNames[ref->m_item->m_Label.Lower()] )
+            {
+                if( jj <= ii )
+                    continue;
 
-        for( ref_it = loc_labelList.begin(); ref_it != loc_labelList.end(); ++ref_it )
-        {
-            NETLIST_OBJECT* ref_item = *ref_it;
-            it_aux = ref_it;
+                const LABEL* tst = aLabels[jj];
 
-            for( ++it_aux; it_aux != loc_labelList.end(); ++it_aux )
-            {
                 // global label versus global label was already examined.
                 // here, at least one label must be local
-                if( ref_item->IsLabelGlobal() && (*it_aux)->IsLabelGlobal() )
+                if( aSkipGlobalPairs && ref->m_item->IsLabelGlobal()
+                  && tst->m_item->IsLabelGlobal() )
                     continue;
 
-                if( ref_item->m_Label.CmpNoCase( (*it_aux)->m_Label ) == 0 )
-                {
-                    // Create new marker for ERC.
-                    int cntA = countIndenticalLabels( fullLabelList, ref_item );
-                    int cntB = countIndenticalLabels( fullLabelList, *it_aux );
-
-                    if( cntA <= cntB )
-                        SimilarLabelsDiagnose( ref_item, (*it_aux) );
-                    else
-                        SimilarLabelsDiagnose( (*it_aux), ref_item );
-                }
+                // Create new marker for ERC.
+                if( countIdenticalLabels( ref ) <= countIdenticalLabels( tst ) )
+                    SimilarLabelsDiagnose( ref->m_item, tst->m_item );
+                else
+                    SimilarLabelsDiagnose( tst->m_item, ref->m_item );
             }
         }
-    }
-}
+    };
 
-// Helper function: count the number of labels identical to aLabel
-//  for global label: global labels in the full project
-//  for local label: all labels in the current sheet
-static int countIndenticalLabels( std::vector<NETLIST_OBJECT*>& aList, NETLIST_OBJECT* aLabel )
-{
-    int count = 0;
+    // build global labels and compare (same label names appears only once in list)
+    std::vector<const LABEL*> globalLabels;
+    std::unordered_set<wxString, WXSTRING_HASH> globalNames;
 
-    if( aLabel->IsLabelGlobal() )
+    for( const LABEL* label : uniqueLabelList )
     {
-        for( unsigned netItem = 0; netItem < aList.size(); ++netItem )
-        {
-            NETLIST_OBJECT* item = aList[netItem];
-
-            if( item->IsLabelGlobal() && item->m_Label == aLabel->m_Label )
-                count++;
-        }
+        if( label->m_item->IsLabelGlobal() && globalNames.insert( label->m_item->m_Label ).second )
+            globalLabels.push_back( label );
     }
-    else
-    {
-        for( unsigned netItem = 0; netItem < aList.size(); ++netItem )
-        {
-            NETLIST_OBJECT* item = aList[netItem];
 
-            if( item->m_Label == aLabel->m_Label &&
-                item->m_SheetPath.Path() == aLabel->m_SheetPath.Path() )
-                count++;
-        }
-    }
+    std::sort( globalLabels.begin(), globalLabels.end(), sortByName );
+    reportSimilarLabels( globalLabels, false );
 
-    return count;
+    // Build paths list, and examine each label inside a sheet path
+    std::map< wxString, std::vector<const LABEL*> > sheetLabels;
+
+    for( const LABEL* label : uniqueLabelList )
+        sheetLabels[label->m_path].push_back( label );
+
+    for( auto& sheet : sheetLabels )
+    {
+        std::sort( sheet.second.begin(), sheet.second.end(), sortByName );
+        reportSimilarLabels( sheet.second, true );
+    }
 }
 
+
 // Helper function: creates a marker for similar labels ERC warning
 static void SimilarLabelsDiagnose( NETLIST_OBJECT* aItemA, NETLIST_OBJECT* aItemB )
 {
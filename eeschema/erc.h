@@ -86,17 +86,16 @@ void Diagnose( NETLIST_OBJECT* NetItemRef, NETLIST_OBJECT* NetItemTst,
                       int MinConnexion, int Diag );
 
 /**
- * Perform ERC testing for electrical conflicts between \a NetItemRef and other items
- * (mainly pin) on the same net.
- * @param aList = a reference to the list of connected objects
- * @param aNetItemRef = index in list of the current object
- * @param aNetStart = index in list of net objects of the first item
- * @param aMinConnexion = a pointer to a variable to store the minimal connection
- * found( NOD, DRV, NPI, NET_NC)
+ * Function TestNets
+ * performs the ERC tests of the items of each net of \a aList: conflicts between pins,
+ * minimal connection requirements, orphan hierarchical and sheet labels and no connect
+ * symbols connected to several pins.  Nets are tested in parallel, using pin type
+ * histograms of the nets, and markers are created in the order of the list.
+ * @param aList = the list of connected objects, sorted by net code
+ * @param aTestGlobalLabels = true to test for global labels not connected to any other
+ *                            global label
  */
-void TestOthersItems( NETLIST_OBJECT_LIST* aList,
-                             unsigned aNetItemRef, unsigned aNetStart,
-                             int* aMinConnexion );
+void TestNets( NETLIST_OBJECT_LIST* aList, bool aTestGlobalLabels );
 
 /**
  * Function TestDuplicateSheetNames( )
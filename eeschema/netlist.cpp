@@ -182,40 +182,20 @@ NETLIST_OBJECT_LIST* SCH_EDIT_FRAME::BuildNetListBase( bool updateStatusText )
 }
 
 
-bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
+void NETLIST_OBJECT_LIST::BuildSheetConnections()
 {
-    SCH_SHEET_PATH* sheet;
-
-    // Fill list with connected items from the flattened sheet list
-    for( unsigned i = 0; i < aSheets.size();  i++ )
-    {
-        sheet = &aSheets[i];
-
-        for( SCH_ITEM* item = sheet->LastScreen()->GetDrawItems(); item; item = item->Next() )
-        {
-            item->GetNetListItem( *this, sheet );
-        }
-    }
+    m_lastNetCode = m_lastBusNetCode = 1;
+    clearIndexes();
 
     if( size() == 0 )
-        return false;
-
-    // Sort objects by Sheet
-    SortListbySheet();
+        return;
 
-    sheet = &(GetItem( 0 )->m_SheetPath);
-    m_lastNetCode = m_lastBusNetCode = 1;
+    indexSheetItems( 0 );
 
-    for( unsigned ii = 0, istart = 0; ii < size(); ii++ )
+    for( unsigned ii = 0; ii < size(); ii++ )
     {
         NETLIST_OBJECT* net_item = GetItem( ii );
 
-        if( net_item->m_SheetPath != *sheet )   // Sheet change
-        {
-            sheet  = &(net_item->m_SheetPath);
-            istart = ii;
-        }
-
         switch( net_item->m_Type )
         {
         case NET_ITEM_UNSPECIFIED:
@@ -237,7 +217,7 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
                 m_lastNetCode++;
             }
 
-            pointToPointConnect( net_item, IS_WIRE, istart );
+            pointToPointConnect( net_item, IS_WIRE );
             break;
 
         case NET_JUNCTION:
@@ -248,7 +228,7 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
                 m_lastNetCode++;
             }
 
-            segmentToPointConnect( net_item, IS_WIRE, istart );
+            segmentToPointConnect( net_item, IS_WIRE );
 
             // Control of the junction, on BUS.
             if( net_item->m_BusNetCode == 0 )
@@ -257,7 +237,7 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
                 m_lastBusNetCode++;
             }
 
-            segmentToPointConnect( net_item, IS_BUS, istart );
+            segmentToPointConnect( net_item, IS_BUS );
             break;
 
         case NET_LABEL:
@@ -270,7 +250,7 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
                 m_lastNetCode++;
             }
 
-            segmentToPointConnect( net_item, IS_WIRE, istart );
+            segmentToPointConnect( net_item, IS_WIRE );
             break;
 
         case NET_SHEETBUSLABELMEMBER:
@@ -285,7 +265,7 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
                 m_lastBusNetCode++;
             }
 
-            pointToPointConnect( net_item, IS_BUS, istart );
+            pointToPointConnect( net_item, IS_BUS );
             break;
 
         case NET_BUSLABELMEMBER:
@@ -298,11 +278,76 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
                 m_lastBusNetCode++;
             }
 
-            segmentToPointConnect( net_item, IS_BUS, istart );
+            segmentToPointConnect( net_item, IS_BUS );
             break;
         }
     }
 
+    resolveNetCodes( IS_WIRE );
+    resolveNetCodes( IS_BUS );
+    clearIndexes();
+}
+
+
+bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
+{
+    // Sheets are processed in order, so the list is sorted by sheets
+    std::vector<SCH_SHEET_PATH*> sheets;
+
+    for( unsigned i = 0; i < aSheets.size();  i++ )
+        sheets.push_back( &aSheets[i] );
+
+    std::stable_sort( sheets.begin(), sheets.end(),
+            []( const SCH_SHEET_PATH* aFirst, const SCH_SHEET_PATH* aSecond )
+            {
+                return aFirst->Cmp( *aSecond ) < 0;
+            } );
+
+    clearIndexes();
+    int netOffset = 0;
+    int busNetOffset = 0;
+
+    // Fill list with connected items from the flattened sheet list.
+    // Connections inside sheets are the same for all instances of a screen, so they are
+    // stored by screens and only the net codes are shifted for every sheet instance.
+    for( SCH_SHEET_PATH* sheet : sheets )
+    {
+        const NETLIST_OBJECT_LIST& sheetItems = sheet->LastScreen()->GetConnectivity( sheet );
+
+        if( sheetItems.empty() )
+            continue;
+
+        m_sheetStarts.push_back( size() );
+
+        for( NETLIST_OBJECT* sheetItem : sheetItems )
+        {
+            NETLIST_OBJECT* item = new NETLIST_OBJECT( *sheetItem );
+            item->m_SheetPath = *sheet;
+            item->m_SheetPathInclude = *sheet;
+
+            // Sheet pins are connected to the labels of the sheet they belong to
+            if( item->m_Type == NET_SHEETLABEL || item->m_Type == NET_SHEETBUSLABELMEMBER )
+                item->m_SheetPathInclude.push_back( static_cast<SCH_SHEET*>( item->m_Link ) );
+
+            if( item->GetNet() )
+                item->SetNet( item->GetNet() + netOffset );
+
+            if( item->m_BusNetCode )
+                item->m_BusNetCode += busNetOffset;
+
+            push_back( item );
+        }
+
+        netOffset += sheetItems.GetLastNetCode();
+        busNetOffset += sheetItems.GetLastBusNetCode();
+    }
+
+    if( size() == 0 )
+        return false;
+
+    m_lastNetCode = netOffset + 1;
+    m_lastBusNetCode = busNetOffset + 1;
+
 #if defined(NETLIST_DEBUG) && defined(DEBUG)
     std::cout << "\n\nafter sheet local\n\n";
     DumpNetTable();
@@ -312,6 +357,8 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
     connectBusLabels();
 
     // Group objects by label.
+    indexLabels();
+
     for( unsigned ii = 0; ii < size(); ii++ )
     {
         switch( GetItem( ii )->m_Type )
@@ -355,6 +402,9 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
             sheetLabelConnect( GetItem( ii ) );
     }
 
+    resolveNetCodes( IS_WIRE );
+    clearIndexes();
+
     // Sort objects by NetCode
     SortListbyNetcode();
 
@@ -607,22 +657,24 @@ void NETLIST_OBJECT_LIST::sheetLabelConnect( NETLIST_OBJECT* SheetLabel )
     if( SheetLabel->GetNet() == 0 )
         return;
 
-    for( unsigned ii = 0; ii < size(); ii++ )
+    //use SheetInclude, not the sheet!!
+    int sheet = findSheet( SheetLabel->m_SheetPathInclude );
+
+    if( sheet < 0 )
+        return;
+
+    auto labels = m_sheetLabels.find( LABEL_KEY( SheetLabel->m_Label, sheet ) );
+
+    if( labels == m_sheetLabels.end() )
+        return;
+
+    for( unsigned ii : labels->second )
     {
         NETLIST_OBJECT* ObjetNet = GetItem( ii );
 
-        if( ObjetNet->m_SheetPath != SheetLabel->m_SheetPathInclude )
-            continue;  //use SheetInclude, not the sheet!!
-
         if( (ObjetNet->m_Type != NET_HIERLABEL ) && (ObjetNet->m_Type != NET_HIERBUSLABELMEMBER ) )
             continue;
 
-        if( ObjetNet->GetNet() == SheetLabel->GetNet() )
-            continue;  //already connected.
-
-        if( ObjetNet->m_Label != SheetLabel->m_Label )
-            continue;  //different names.
-
         // Propagate Netcode having all the objects of the same Netcode.
         if( ObjetNet->GetNet() )
             propagateNetCode( ObjetNet->GetNet(), SheetLabel->GetNet(), IS_WIRE );
@@ -637,6 +689,17 @@ void NETLIST_OBJECT_LIST::connectBusLabels()
     // Propagate the net code between all bus label member objects connected by they name.
     // If the net code is not yet existing, a new one is created
     // Search is done in the entire list
+    // Members of the same bus having the same member number are connected together
+    std::map<std::pair<int, int>, std::vector<unsigned> > members;
+
+    for( unsigned ii = 0; ii < size(); ii++ )
+    {
+        NETLIST_OBJECT* Label = GetItem( ii );
+
+        if( Label->IsLabelBusMemberType() )
+            members[ std::make_pair( Label->m_BusNetCode, Label->m_Member ) ].push_back( ii );
+    }
+
     for( unsigned ii = 0; ii < size(); ii++ )
     {
         NETLIST_OBJECT* Label = GetItem( ii );
@@ -650,25 +713,24 @@ void NETLIST_OBJECT_LIST::connectBusLabels()
                 m_lastNetCode++;
             }
 
-            for( unsigned jj = ii + 1; jj < size(); jj++ )
+            const std::vector<unsigned>& group =
+                    members[ std::make_pair( Label->m_BusNetCode, Label->m_Member ) ];
+
+            // The first member of a group connects all the others, so for the next ones
+            // the group is already connected
+            if( group.front() != ii )
+                continue;
+
+            for( unsigned jj = 1; jj < group.size(); jj++ )
             {
-                NETLIST_OBJECT* LabelInTst =  GetItem( jj );
+                NETLIST_OBJECT* LabelInTst = GetItem( group[jj] );
 
-                if( LabelInTst->IsLabelBusMemberType() )
-                {
-                    if( LabelInTst->m_BusNetCode != Label->m_BusNetCode )
-                        continue;
-
-                    if( LabelInTst->m_Member != Label->m_Member )
-                        continue;
-
-                    if( LabelInTst->GetNet() == 0 )
-                        // Append this object to the current net
-                        LabelInTst->SetNet( Label->GetNet() );
-                    else
-                        // Merge the 2 net codes, they are connected.
-                        propagateNetCode( LabelInTst->GetNet(), Label->GetNet(), IS_WIRE );
-                }
+                if( LabelInTst->GetNet() == 0 )
+                    // Append this object to the current net
+                    LabelInTst->SetNet( Label->GetNet() );
+                else
+                    // Merge the 2 net codes, they are connected.
+                    propagateNetCode( LabelInTst->GetNet(), Label->GetNet(), IS_WIRE );
             }
         }
     }
@@ -677,151 +739,264 @@ void NETLIST_OBJECT_LIST::connectBusLabels()
 
 void NETLIST_OBJECT_LIST::propagateNetCode( int aOldNetCode, int aNewNetCode, bool aIsBus )
 {
+    aOldNetCode = findNetCode( aOldNetCode, aIsBus );
+    aNewNetCode = findNetCode( aNewNetCode, aIsBus );
+
     if( aOldNetCode == aNewNetCode )
         return;
 
-    if( aIsBus == false )    // Propagate NetCode
-    {
-        for( unsigned jj = 0; jj < size(); jj++ )
-        {
-            NETLIST_OBJECT* object = GetItem( jj );
+    std::vector<int>& parents = aIsBus ? m_busNetCodeParents : m_netCodeParents;
+    int maxNetCode = std::max( aOldNetCode, aNewNetCode );
 
-            if( object->GetNet() == aOldNetCode )
-                object->SetNet( aNewNetCode );
-        }
+    // Net codes that have not been merged yet are their own parents
+    for( int code = parents.size(); code <= maxNetCode; code++ )
+        parents.push_back( code );
+
+    parents[aOldNetCode] = aNewNetCode;
+}
+
+
+int NETLIST_OBJECT_LIST::findNetCode( int aNetCode, bool aIsBus )
+{
+    std::vector<int>& parents = aIsBus ? m_busNetCodeParents : m_netCodeParents;
+
+    if( aNetCode < 0 || aNetCode >= (int) parents.size() )
+        return aNetCode;
+
+    int root = aNetCode;
+
+    while( parents[root] != root )
+        root = parents[root];
+
+    // Shorten the path for the next searches
+    while( parents[aNetCode] != root )
+    {
+        int next = parents[aNetCode];
+        parents[aNetCode] = root;
+        aNetCode = next;
     }
-    else               // Propagate BusNetCode
+
+    return root;
+}
+
+
+void NETLIST_OBJECT_LIST::resolveNetCodes( bool aIsBus )
+{
+    for( unsigned ii = 0; ii < size(); ii++ )
     {
-        for( unsigned jj = 0; jj < size(); jj++ )
-        {
-            NETLIST_OBJECT* object = GetItem( jj );
+        NETLIST_OBJECT* item = GetItem( ii );
 
-            if( object->m_BusNetCode == aOldNetCode )
-                object->m_BusNetCode = aNewNetCode;
-        }
+        if( aIsBus )
+            item->m_BusNetCode = findNetCode( item->m_BusNetCode, IS_BUS );
+        else
+            item->SetNet( findNetCode( item->GetNet(), IS_WIRE ) );
     }
 }
 
 
-void NETLIST_OBJECT_LIST::pointToPointConnect( NETLIST_OBJECT* aRef, bool aIsBus, int start )
+void NETLIST_OBJECT_LIST::SEGMENT_INDEX::Add( unsigned aIdx, const NETLIST_OBJECT* aSegment )
+{
+    // A point may lie on a horizontal segment only if it has the same y coordinate,
+    // and on a vertical segment only if it has the same x coordinate
+    if( aSegment->m_Start.y == aSegment->m_End.y )
+        m_horizontal[aSegment->m_Start.y].push_back( aIdx );
+    else if( aSegment->m_Start.x == aSegment->m_End.x )
+        m_vertical[aSegment->m_Start.x].push_back( aIdx );
+    else
+        m_other.push_back( aIdx );
+}
+
+
+void NETLIST_OBJECT_LIST::SEGMENT_INDEX::Clear()
 {
-    int netCode;
+    m_horizontal.clear();
+    m_vertical.clear();
+    m_other.clear();
+}
+
+
+void NETLIST_OBJECT_LIST::indexSheetItems( unsigned aStart )
+{
+    m_wireEnds.clear();
+    m_busEnds.clear();
+    m_wireSegments.Clear();
+    m_busSegments.Clear();
+
+    const SCH_SHEET_PATH& sheet = GetItem( aStart )->m_SheetPath;
+
+    auto addEnds = [this]( POINT_INDEX& aIndex, unsigned aIdx )
+    {
+        NETLIST_OBJECT* item = GetItem( aIdx );
+        aIndex[ pointKey( item->m_Start ) ].push_back( aIdx );
 
-    if( aIsBus == false )    // Objects other than BUS and BUSLABELS
+        if( item->m_End != item->m_Start )
+            aIndex[ pointKey( item->m_End ) ].push_back( aIdx );
+    };
+
+    for( unsigned ii = aStart; ii < size() && GetItem( ii )->m_SheetPath == sheet; ii++ )
     {
-        netCode = aRef->GetNet();
+        NETLIST_OBJECT* item = GetItem( ii );
+        bool isWire = false;
+        bool isBus = false;
 
-        for( unsigned i = start; i < size(); i++ )
+        switch( item->m_Type )
         {
-            NETLIST_OBJECT* item = GetItem( i );
+        case NET_SEGMENT:
+            m_wireSegments.Add( ii, item );
+            isWire = true;
+            break;
 
-            if( item->m_SheetPath != aRef->m_SheetPath )  //used to be > (why?)
-                continue;
+        case NET_PIN:
+        case NET_LABEL:
+        case NET_HIERLABEL:
+        case NET_GLOBLABEL:
+        case NET_SHEETLABEL:
+        case NET_PINLABEL:
+        case NET_NOCONNECT:
+            isWire = true;
+            break;
 
-            switch( item->m_Type )
-            {
-            case NET_SEGMENT:
-            case NET_PIN:
-            case NET_LABEL:
-            case NET_HIERLABEL:
-            case NET_GLOBLABEL:
-            case NET_SHEETLABEL:
-            case NET_PINLABEL:
-            case NET_JUNCTION:
-            case NET_NOCONNECT:
-                if( aRef->m_Start == item->m_Start
-                    || aRef->m_Start == item->m_End
-                    || aRef->m_End   == item->m_Start
-                    || aRef->m_End   == item->m_End )
-                {
-                    if( item->GetNet() == 0 )
-                        item->SetNet( netCode );
-                    else
-                        propagateNetCode( item->GetNet(), netCode, IS_WIRE );
-                }
-                break;
+        case NET_BUS:
+            m_busSegments.Add( ii, item );
+            isBus = true;
+            break;
 
-            case NET_BUS:
-            case NET_BUSLABELMEMBER:
-            case NET_SHEETBUSLABELMEMBER:
-            case NET_HIERBUSLABELMEMBER:
-            case NET_GLOBBUSLABELMEMBER:
-            case NET_ITEM_UNSPECIFIED:
-                break;
-            }
+        case NET_BUSLABELMEMBER:
+        case NET_SHEETBUSLABELMEMBER:
+        case NET_HIERBUSLABELMEMBER:
+        case NET_GLOBBUSLABELMEMBER:
+            isBus = true;
+            break;
+
+        case NET_JUNCTION:
+            isWire = true;
+            isBus = true;
+            break;
+
+        case NET_ITEM_UNSPECIFIED:
+            break;
         }
+
+        if( isWire )
+            addEnds( m_wireEnds, ii );
+
+        if( isBus )
+            addEnds( m_busEnds, ii );
     }
-    else    // Object type BUS, BUSLABELS, and junctions.
+}
+
+
+void NETLIST_OBJECT_LIST::indexLabels()
+{
+    for( unsigned sheet = 0; sheet < m_sheetStarts.size(); sheet++ )
     {
-        netCode = aRef->m_BusNetCode;
+        unsigned end = ( sheet + 1 < m_sheetStarts.size() ) ? m_sheetStarts[sheet + 1] : size();
 
-        for( unsigned i = start; i < size(); i++ )
+        for( unsigned ii = m_sheetStarts[sheet]; ii < end; ii++ )
         {
-            NETLIST_OBJECT* item = GetItem( i );
+            NETLIST_OBJECT* item = GetItem( ii );
 
-            if( item->m_SheetPath != aRef->m_SheetPath )
+            if( !item->IsLabelType() )
                 continue;
 
-            switch( item->m_Type )
-            {
-            case NET_ITEM_UNSPECIFIED:
-            case NET_SEGMENT:
-            case NET_PIN:
-            case NET_LABEL:
-            case NET_HIERLABEL:
-            case NET_GLOBLABEL:
-            case NET_SHEETLABEL:
-            case NET_PINLABEL:
-            case NET_NOCONNECT:
-                break;
+            m_sheetLabels[ LABEL_KEY( item->m_Label, sheet ) ].push_back( ii );
 
-            case NET_BUS:
-            case NET_BUSLABELMEMBER:
-            case NET_SHEETBUSLABELMEMBER:
-            case NET_HIERBUSLABELMEMBER:
-            case NET_GLOBBUSLABELMEMBER:
-            case NET_JUNCTION:
-                if(  aRef->m_Start == item->m_Start
-                  || aRef->m_Start == item->m_End
-                  || aRef->m_End   == item->m_Start
-                  || aRef->m_End   == item->m_End )
-                {
-                    if( item->m_BusNetCode == 0 )
-                        item->m_BusNetCode = netCode;
-                    else
-                        propagateNetCode( item->m_BusNetCode, netCode, IS_BUS );
-                }
-                break;
-            }
+            if( item->IsLabelGlobal() )
+                m_globalLabels[ LABEL_KEY( item->m_Label, item->m_Type ) ].m_items.push_back( ii );
         }
     }
 }
 
 
-void NETLIST_OBJECT_LIST::segmentToPointConnect( NETLIST_OBJECT* aJonction,
-                                                 bool aIsBus, int aIdxStart )
+void NETLIST_OBJECT_LIST::clearIndexes()
 {
-    for( unsigned i = aIdxStart; i < size(); i++ )
+    m_netCodeParents.clear();
+    m_busNetCodeParents.clear();
+    m_sheetStarts.clear();
+    m_wireEnds.clear();
+    m_busEnds.clear();
+    m_wireSegments.Clear();
+    m_busSegments.Clear();
+    m_sheetLabels.clear();
+    m_globalLabels.clear();
+}
+
+
+int NETLIST_OBJECT_LIST::findSheet( const SCH_SHEET_PATH& aSheetPath ) const
+{
+    auto it = std::lower_bound( m_sheetStarts.begin(), m_sheetStarts.end(), aSheetPath,
+            [this]( unsigned aIdx, const SCH_SHEET_PATH& aPath )
+            {
+                return GetItem( aIdx )->m_SheetPath.Cmp( aPath ) < 0;
+            } );
+
+    // Different sheet paths might have the same time stamps, so check all the candidates
+    for( ; it != m_sheetStarts.end() && GetItem( *it )->m_SheetPath.Cmp( aSheetPath ) == 0; ++it )
     {
-        NETLIST_OBJECT* segment = GetItem( i );
+        if( GetItem( *it )->m_SheetPath == aSheetPath )
+            return it - m_sheetStarts.begin();
+    }
+
+    return -1;
+}
+
 
-        // if different sheets, obviously no physical connection between elements.
-        if( segment->m_SheetPath != aJonction->m_SheetPath )
+void NETLIST_OBJECT_LIST::pointToPointConnect( NETLIST_OBJECT* aRef, bool aIsBus )
+{
+    // Objects other than BUS and BUSLABELS use m_wireEnds,
+    // objects type BUS, BUSLABELS, and junctions use m_busEnds
+    const POINT_INDEX& ends = aIsBus ? m_busEnds : m_wireEnds;
+    int netCode = aIsBus ? aRef->m_BusNetCode : aRef->GetNet();
+
+    for( int ii = 0; ii < 2; ii++ )
+    {
+        if( ii == 1 && aRef->m_End == aRef->m_Start )
+            break;
+
+        auto candidates = ends.find( pointKey( ii == 0 ? aRef->m_Start : aRef->m_End ) );
+
+        if( candidates == ends.end() )
             continue;
 
-        if( aIsBus == IS_WIRE )
+        for( unsigned idx : candidates->second )
         {
-            if( segment->m_Type != NET_SEGMENT )
-                continue;
+            NETLIST_OBJECT* item = GetItem( idx );
+
+            if( aIsBus == false )
+            {
+                if( item->GetNet() == 0 )
+                    item->SetNet( netCode );
+                else
+                    propagateNetCode( item->GetNet(), netCode, IS_WIRE );
+            }
+            else
+            {
+                if( item->m_BusNetCode == 0 )
+                    item->m_BusNetCode = netCode;
+                else
+                    propagateNetCode( item->m_BusNetCode, netCode, IS_BUS );
+            }
         }
-        else
+    }
+}
+
+
+void NETLIST_OBJECT_LIST::segmentToPointConnect( NETLIST_OBJECT* aJonction, bool aIsBus )
+{
+    // Only the segments of the current sheet are indexed: if different sheets,
+    // obviously no physical connection between elements.
+    const SEGMENT_INDEX& segments = aIsBus ? m_busSegments : m_wireSegments;
+    const wxPoint& point = aJonction->m_Start;
+
+    auto connect = [&]( const std::vector<unsigned>& aCandidates )
+    {
+        for( unsigned idx : aCandidates )
         {
-            if( segment->m_Type != NET_BUS )
+            NETLIST_OBJECT* segment = GetItem( idx );
+
+            if( !IsPointOnSegment( segment->m_Start, segment->m_End, point ) )
                 continue;
-        }
 
-        if( IsPointOnSegment( segment->m_Start, segment->m_End, aJonction->m_Start ) )
-        {
             // Propagation Netcode has all the objects of the same Netcode.
             if( aIsBus == IS_WIRE )
             {
@@ -838,7 +1013,28 @@ void NETLIST_OBJECT_LIST::segmentToPointConnect( NETLIST_OBJECT* aJonction,
                     segment->m_BusNetCode = aJonction->m_BusNetCode;
             }
         }
-    }
+    };
+
+    auto horizontal = segments.m_horizontal.find( point.y );
+
+    if( horizontal != segments.m_horizontal.end() )
+        connect( horizontal->second );
+
+    auto vertical = segments.m_vertical.find( point.x );
+
+    if( vertical != segments.m_vertical.end() )
+        connect( vertical->second );
+
+    connect( segments.m_other );
+}
+
+
+void NETLIST_OBJECT_LIST::connectLabel( NETLIST_OBJECT* aLabel, NETLIST_OBJECT* aLabelRef )
+{
+    if( aLabel->GetNet() )
+        propagateNetCode( aLabel->GetNet(), aLabelRef->GetNet(), IS_WIRE );
+    else
+        aLabel->SetNet( aLabelRef->GetNet() );
 }
 
 
@@ -847,40 +1043,44 @@ void NETLIST_OBJECT_LIST::labelConnect( NETLIST_OBJECT* aLabelRef )
     if( aLabelRef->GetNet() == 0 )
         return;
 
-    for( unsigned i = 0; i < size(); i++ )
+    // NET_HIERLABEL are used to connect sheets.
+    // NET_LABEL are local to a sheet
+    // NET_GLOBLABEL are global.
+    // NET_PINLABEL is a kind of global label (generated by a power pin invisible)
+
+    // Labels of any type are connected inside a sheet
+    auto labels = m_sheetLabels.find( LABEL_KEY( aLabelRef->m_Label,
+                                                 findSheet( aLabelRef->m_SheetPath ) ) );
+
+    if( labels != m_sheetLabels.end() )
     {
-        NETLIST_OBJECT* item = GetItem( i );
+        for( unsigned ii : labels->second )
+            connectLabel( GetItem( ii ), aLabelRef );
+    }
 
-        if( item->GetNet() == aLabelRef->GetNet() )
+    // In other sheets, pin labels are connected to all labels and
+    // global labels only connect other global labels of the same type.
+    for( int type : { NET_PINLABEL, NET_GLOBLABEL, NET_GLOBBUSLABELMEMBER } )
+    {
+        if( type != NET_PINLABEL && type != aLabelRef->m_Type )
             continue;
 
-        if( item->m_SheetPath != aLabelRef->m_SheetPath )
-        {
-            if( item->m_Type != NET_PINLABEL && item->m_Type != NET_GLOBLABEL
-                && item->m_Type != NET_GLOBBUSLABELMEMBER )
-                continue;
+        auto group = m_globalLabels.find( LABEL_KEY( aLabelRef->m_Label, type ) );
 
-            if( (item->m_Type == NET_GLOBLABEL
-                 || item->m_Type == NET_GLOBBUSLABELMEMBER)
-               && item->m_Type != aLabelRef->m_Type )
-                //global labels only connect other global labels.
-                continue;
-        }
+        if( group == m_globalLabels.end() )
+            continue;
 
-        // NET_HIERLABEL are used to connect sheets.
-        // NET_LABEL are local to a sheet
-        // NET_GLOBLABEL are global.
-        // NET_PINLABEL is a kind of global label (generated by a power pin invisible)
-        if( item->IsLabelType() )
+        if( group->second.m_merged )
         {
-            if( item->m_Label != aLabelRef->m_Label )
-                continue;
-
-            if( item->GetNet() )
-                propagateNetCode( item->GetNet(), aLabelRef->GetNet(), IS_WIRE );
-            else
-                item->SetNet( aLabelRef->GetNet() );
+            // The labels were already connected together, so it is enough to connect one
+            connectLabel( GetItem( group->second.m_items.front() ), aLabelRef );
+            continue;
         }
+
+        for( unsigned ii : group->second.m_items )
+            connectLabel( GetItem( ii ), aLabelRef );
+
+        group->second.m_merged = true;
     }
 }
 
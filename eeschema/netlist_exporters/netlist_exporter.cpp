@@ -237,17 +237,25 @@ SCH_COMPONENT* NETLIST_EXPORTER::findNextComponentAndCreatePinList( EDA_ITEM*
 bool NETLIST_EXPORTER::addPinToComponentPinList( SCH_COMPONENT* aComponent,
                                       SCH_SHEET_PATH* aSheetPath, LIB_PIN* aPin )
 {
-    // Search the PIN description for Pin in g_NetObjectslist
-    for( unsigned ii = 0; ii < m_masterList->size(); ii++ )
+    if( m_componentPins.empty() )
     {
-        NETLIST_OBJECT* pin = m_masterList->GetItem( ii );
+        for( unsigned ii = 0; ii < m_masterList->size(); ii++ )
+        {
+            NETLIST_OBJECT* pin = m_masterList->GetItem( ii );
 
-        if( pin->m_Type != NET_PIN )
-            continue;
+            if( pin->m_Type == NET_PIN )
+                m_componentPins[pin->m_Link].push_back( pin );
+        }
+    }
 
-        if( pin->m_Link != aComponent )
-            continue;
+    auto componentPins = m_componentPins.find( aComponent );
+
+    if( componentPins == m_componentPins.end() )
+        return false;
 
+    // Search the PIN description for Pin in the pins of the component
+    for( NETLIST_OBJECT* pin : componentPins->second )
+    {
         if( pin->m_PinNum != aPin->GetNumber() )
             continue;
 
@@ -326,39 +334,52 @@ void NETLIST_EXPORTER::findAllInstancesOfComponent( SCH_COMPONENT*  aComponent,
                                          SCH_SHEET_PATH* aSheetPath )
 {
     wxString    ref = aComponent->GetRef( aSheetPath );
-    wxString    ref2;
 
-    SCH_SHEET_LIST sheetList( g_RootSheet );
-
-    for( unsigned i = 0;  i < sheetList.size();  i++ )
+    if( !m_sheetList )
     {
-        for( EDA_ITEM* item = sheetList[i].LastDrawList();  item;  item = item->Next() )
+        m_sheetList.reset( new SCH_SHEET_LIST( g_RootSheet ) );
+
+        for( unsigned i = 0;  i < m_sheetList->size();  i++ )
         {
-            if( item->Type() != SCH_COMPONENT_T )
-                continue;
+            SCH_SHEET_PATH& sheet = ( *m_sheetList )[i];
 
-            SCH_COMPONENT*  comp2 = (SCH_COMPONENT*) item;
+            for( EDA_ITEM* item = sheet.LastDrawList();  item;  item = item->Next() )
+            {
+                if( item->Type() != SCH_COMPONENT_T )
+                    continue;
 
-            ref2 = comp2->GetRef( &sheetList[i] );
+                SCH_COMPONENT* comp = (SCH_COMPONENT*) item;
 
-            if( ref2.CmpNoCase( ref ) != 0 )
-                continue;
+                m_componentsByRef[comp->GetRef( &sheet ).Lower()].push_back(
+                        std::make_pair( comp, i ) );
+            }
+        }
+    }
 
-            int unit2 = comp2->GetUnitSelection( &sheetList[i] );  // slow
+    auto instances = m_componentsByRef.find( ref.Lower() );
 
-            for( LIB_PIN* pin = aEntry->GetNextPin();  pin;  pin = aEntry->GetNextPin( pin ) )
-            {
-                wxASSERT( pin->Type() == LIB_PIN_T );
+    if( instances == m_componentsByRef.end() )
+        return;
 
-                if( pin->GetUnit() && pin->GetUnit() != unit2 )
-                    continue;
+    for( const std::pair<SCH_COMPONENT*, unsigned>& instance : instances->second )
+    {
+        SCH_COMPONENT*  comp2 = instance.first;
+        SCH_SHEET_PATH& sheet2 = ( *m_sheetList )[instance.second];
 
-                if( pin->GetConvert() && pin->GetConvert() != comp2->GetConvert() )
-                    continue;
+        int unit2 = comp2->GetUnitSelection( &sheet2 );  // slow
 
-                // A suitable pin is found: add it to the current list
-                addPinToComponentPinList( comp2, &sheetList[i], pin );
-            }
+        for( LIB_PIN* pin = aEntry->GetNextPin();  pin;  pin = aEntry->GetNextPin( pin ) )
+        {
+            wxASSERT( pin->Type() == LIB_PIN_T );
+
+            if( pin->GetUnit() && pin->GetUnit() != unit2 )
+                continue;
+
+            if( pin->GetConvert() && pin->GetConvert() != comp2->GetConvert() )
+                continue;
+
+            // A suitable pin is found: add it to the current list
+            addPinToComponentPinList( comp2, &sheet2, pin );
         }
     }
 }
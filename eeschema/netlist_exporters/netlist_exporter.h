@@ -26,7 +26,12 @@
 #ifndef NETLIST_EXPORTER_H
 #define NETLIST_EXPORTER_H
 
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
 #include <kicad_string.h>
+#include <hashtables.h>
 
 #include <class_libentry.h>
 #include <class_netlist_object.h>
@@ -34,6 +39,7 @@
 #include <sch_component.h>
 #include <sch_text.h>
 #include <sch_sheet.h>
+#include <sch_sheet_path.h>
 
 /**
  * Class UNIQUE_STRINGS
@@ -106,6 +112,21 @@ protected:
     // share a code generated std::set<void*> to reduce code volume
     std::set<void*>     m_Libraries;    ///< unique libraries used
 
+    /// Pins found in m_masterList for each component, in the list order (no ownership).
+    /// Built on first use by addPinToComponentPinList(), instead of searching the whole
+    /// list for every pin of every component.
+    std::unordered_map< SCH_ITEM*, std::vector<NETLIST_OBJECT*> > m_componentPins;
+
+    /// Sheet list of the hierarchy, used by m_componentsByRef
+    std::unique_ptr<SCH_SHEET_LIST> m_sheetList;
+
+    /// Instances (component and index in m_sheetList) of each reference designator,
+    /// stored in lower case, in the hierarchy order.  Built on first use by
+    /// findAllInstancesOfComponent(), instead of walking the hierarchy for every
+    /// multiple parts per package component.
+    std::unordered_map< wxString, std::vector< std::pair<SCH_COMPONENT*, unsigned> >,
+                        WXSTRING_HASH > m_componentsByRef;
+
     /**
      * Function sprintPinNetName
      * formats the net name for \a aPin using \a aNetNameFormat into \a aResult.
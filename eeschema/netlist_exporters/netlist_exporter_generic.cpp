@@ -24,6 +24,7 @@
  */
 
 #include <build_version.h>
+#include <confirm.h>
 #include <sch_base_frame.h>
 #include <class_library.h>
 
@@ -32,51 +33,270 @@
 
 static bool sortPinsByNumber( LIB_PIN* aPin1, LIB_PIN* aPin2 );
 
+
+/**
+ * Class GENERIC_NETLIST_WRITER
+ * receives the generic netlist tree one node at a time, so the tree is formatted (as XML or
+ * as an S-expression) while the design is walked.  The attributes and the text of a node are
+ * always given before its child nodes.
+ */
+class GENERIC_NETLIST_WRITER
+{
+public:
+    virtual ~GENERIC_NETLIST_WRITER() {}
+
+    /// Start a new node, child of the current node
+    virtual void BeginNode( const wxString& aName ) = 0;
+
+    /// Add an attribute to the current node
+    virtual void AddAttribute( const wxString& aName, const wxString& aValue ) = 0;
+
+    /// Add textual content to the current node, empty strings are skipped
+    virtual void AddText( const wxString& aContent ) = 0;
+
+    /// Finish the current node
+    virtual void EndNode() = 0;
+};
+
+
+/**
+ * Class XML_STREAM_FORMATTER
+ * formats the generic netlist tree as XML directly to an OUTPUTFORMATTER.  The output is
+ * byte for byte what wxXmlDocument::Save() (with an indentation step of 2) produces for the
+ * equivalent XNODE tree, without having to build the tree in memory first.
+ */
+class XML_STREAM_FORMATTER : public GENERIC_NETLIST_WRITER
+{
+public:
+    XML_STREAM_FORMATTER( OUTPUTFORMATTER* aOut ) :
+        m_out( aOut )
+    {
+        m_out->Print( 0, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n" );
+    }
+
+    void BeginNode( const wxString& aName ) override
+    {
+        // Element nodes start on a new line, indented by 2 spaces per nesting level
+        if( !m_nodes.empty() )
+        {
+            beginContent();
+            m_nodes.back().m_lastIsText = false;
+            m_out->Print( 0, "\n%*s", int( 2 * m_nodes.size() ), "" );
+        }
+
+        m_out->Print( 0, "<%s", TO_UTF8( aName ) );
+        m_nodes.push_back( NODE( aName ) );
+    }
+
+    void AddAttribute( const wxString& aName, const wxString& aValue ) override
+    {
+        m_out->Print( 0, " %s=\"%s\"", TO_UTF8( aName ), TO_UTF8( escape( aValue, true ) ) );
+    }
+
+    void AddText( const wxString& aContent ) override
+    {
+        if( aContent.Len() > 0 )
+        {
+            beginContent();
+            m_nodes.back().m_lastIsText = true;
+            m_out->Print( 0, "%s", TO_UTF8( escape( aContent, false ) ) );
+        }
+    }
+
+    void EndNode() override
+    {
+        const NODE& node = m_nodes.back();
+
+        if( !node.m_hasContent )
+            m_out->Print( 0, "/>" );
+        else if( node.m_lastIsText )
+            m_out->Print( 0, "</%s>", TO_UTF8( node.m_name ) );
+        else
+            m_out->Print( 0, "\n%*s</%s>", int( 2 * ( m_nodes.size() - 1 ) ), "",
+                          TO_UTF8( node.m_name ) );
+
+        m_nodes.pop_back();
+
+        if( m_nodes.empty() )
+            m_out->Print( 0, "\n" );
+    }
+
+private:
+    struct NODE
+    {
+        NODE( const wxString& aName ) :
+            m_name( aName ), m_hasContent( false ), m_lastIsText( false )
+        {
+        }
+
+        wxString    m_name;
+        bool        m_hasContent;   ///< the start tag is closed, there are child nodes
+        bool        m_lastIsText;   ///< the last child node is a text node
+    };
+
+    ///> Closes the start tag of the current node before its first child node
+    void beginContent()
+    {
+        if( !m_nodes.back().m_hasContent )
+        {
+            m_out->Print( 0, ">" );
+            m_nodes.back().m_hasContent = true;
+        }
+    }
+
+    ///> Escapes the special characters the same way as wxXmlDocument::Save()
+    static wxString escape( const wxString& aStr, bool aAttribute )
+    {
+        wxString escaped;
+        escaped.reserve( aStr.length() );
+
+        for( wxString::const_iterator it = aStr.begin(); it != aStr.end(); ++it )
+        {
+            const wxChar c = *it;
+
+            switch( c )
+            {
+            case '<':   escaped.append( wxT( "&lt;" ) );    break;
+            case '>':   escaped.append( wxT( "&gt;" ) );    break;
+            case '&':   escaped.append( wxT( "&amp;" ) );   break;
+            case '\r':  escaped.append( wxT( "&#xD;" ) );   break;
+
+            case '"':
+                escaped.append( aAttribute ? wxT( "&quot;" ) : wxT( "\"" ) );
+                break;
+
+            case '\t':
+                escaped.append( aAttribute ? wxT( "&#x9;" ) : wxT( "\t" ) );
+                break;
+
+            case '\n':
+                escaped.append( aAttribute ? wxT( "&#xA;" ) : wxT( "\n" ) );
+                break;
+
+            default:
+                escaped.append( c );
+            }
+        }
+
+        return escaped;
+    }
+
+    OUTPUTFORMATTER*    m_out;
+    std::vector<NODE>   m_nodes;    ///< the current node and its ancestors
+};
+
+
+/**
+ * Class XNODE_STREAM_FORMATTER
+ * formats the generic netlist tree as an S-expression directly to an OUTPUTFORMATTER.
+ * The output is the same as XNODE::Format() would produce for the whole tree, without
+ * having to build it in memory first.
+ */
+class XNODE_STREAM_FORMATTER : public GENERIC_NETLIST_WRITER
+{
+public:
+    XNODE_STREAM_FORMATTER( OUTPUTFORMATTER* aOut ) :
+        m_out( aOut ), m_nestLevel( 0 )
+    {
+    }
+
+    void BeginNode( const wxString& aName ) override
+    {
+        // XNODE::Format() starts every child node on a new line: after its parent
+        // attributes for the first child, after the previous sibling for the others.
+        if( m_nestLevel > 0 )
+            m_out->Print( 0, "\n" );
+
+        m_out->Print( m_nestLevel++, "(%s", m_out->Quotew( aName ).c_str() );
+    }
+
+    void AddAttribute( const wxString& aName, const wxString& aValue ) override
+    {
+        m_out->Print( 0, " (%s %s)",
+                      m_out->Quotew( aName ).c_str(),
+                      m_out->Quotew( aValue ).c_str() );
+    }
+
+    void AddText( const wxString& aContent ) override
+    {
+        if( aContent.Len() > 0 )
+            m_out->Print( 0, " %s", m_out->Quotew( aContent ).c_str() );
+    }
+
+    void EndNode() override
+    {
+        m_nestLevel--;
+        m_out->Print( 0, ")" );
+    }
+
+private:
+    OUTPUTFORMATTER*    m_out;
+    int                 m_nestLevel;
+};
+
+
 bool NETLIST_EXPORTER_GENERIC::WriteNetlist( const wxString& aOutFileName, unsigned aNetlistOptions )
 {
     // Prepare list of nets generation
     for( unsigned ii = 0; ii < m_masterList->size(); ii++ )
         m_masterList->GetItem( ii )->m_Flag = 0;
 
-    // output the XML format netlist.
-    wxXmlDocument   xdoc;
+    // output the XML format netlist, written while the design is walked.
+    try
+    {
+        // binary mode, as wxXmlDocument::Save() does not translate line endings
+        FILE_OUTPUTFORMATTER formatter( aOutFileName, wxT( "wb" ) );
+        XML_STREAM_FORMATTER xml( &formatter );
 
-    xdoc.SetRoot( makeRoot( GNL_ALL ) );
+        writeRoot( xml, GNL_ALL );
+    }
+    catch( const IO_ERROR& ioe )
+    {
+        DisplayError( NULL, ioe.What() );
+        return false;
+    }
 
-    return xdoc.Save( aOutFileName, 2 /* indent bug, today was ignored by wxXml lib */ );
+    return true;
 }
 
 
-XNODE* NETLIST_EXPORTER_GENERIC::makeRoot( int aCtl )
+void NETLIST_EXPORTER_GENERIC::formatRoot( OUTPUTFORMATTER* aOut, int aCtl )
 {
-    XNODE*      xroot = node( wxT( "export" ) );
+    XNODE_STREAM_FORMATTER formatter( aOut );
+
+    writeRoot( formatter, aCtl );
+}
 
-    xroot->AddAttribute( wxT( "version" ), wxT( "D" ) );
+
+void NETLIST_EXPORTER_GENERIC::writeRoot( GENERIC_NETLIST_WRITER& aOut, int aCtl )
+{
+    aOut.BeginNode( wxT( "export" ) );
+    aOut.AddAttribute( wxT( "version" ), wxT( "D" ) );
 
     if( aCtl & GNL_HEADER )
         // add the "design" header
-        xroot->AddChild( makeDesignHeader() );
+        makeDesignHeader( aOut );
 
     if( aCtl & GNL_COMPONENTS )
-        xroot->AddChild( makeComponents() );
+        makeComponents( aOut );
 
     if( aCtl & GNL_PARTS )
-        xroot->AddChild( makeLibParts() );
+        makeLibParts( aOut );
 
     if( aCtl & GNL_LIBRARIES )
         // must follow makeGenericLibParts()
-        xroot->AddChild( makeLibraries() );
+        makeLibraries( aOut );
 
     if( aCtl & GNL_NETS )
-        xroot->AddChild( makeListOfNets() );
+        makeListOfNets( aOut );
 
-    return xroot;
+    aOut.EndNode();
 }
 
 
-XNODE* NETLIST_EXPORTER_GENERIC::makeComponents()
+void NETLIST_EXPORTER_GENERIC::makeComponents( GENERIC_NETLIST_WRITER& aOut )
 {
-    XNODE*      xcomps = node( wxT( "components" ) );
+    aOut.BeginNode( wxT( "components" ) );
 
     wxString    timeStamp;
 
@@ -123,31 +343,28 @@ XNODE* NETLIST_EXPORTER_GENERIC::makeComponents()
 
             schItem = comp;
 
-            XNODE* xcomp;  // current component being constructed
-
             // Output the component's elements in order of expected access frequency.
             // This may not always look best, but it will allow faster execution
             // under XSL processing systems which do sequential searching within
             // an element.
 
-            xcomps->AddChild( xcomp = node( sComponent ) );
-            xcomp->AddAttribute( sRef, comp->GetRef( &sheetList[i] ) );
+            aOut.BeginNode( sComponent );
+            aOut.AddAttribute( sRef, comp->GetRef( &sheetList[i] ) );
 
-            xcomp->AddChild( node( sValue, comp->GetField( VALUE )->GetText() ) );
+            node( aOut, sValue, comp->GetField( VALUE )->GetText() );
 
             if( !comp->GetField( FOOTPRINT )->IsVoid() )
-                xcomp->AddChild( node( sFootprint, comp->GetField( FOOTPRINT )->GetText() ) );
+                node( aOut, sFootprint, comp->GetField( FOOTPRINT )->GetText() );
 
             if( !comp->GetField( DATASHEET )->IsVoid() )
-                xcomp->AddChild( node( sDatasheet, comp->GetField( DATASHEET )->GetText() ) );
+                node( aOut, sDatasheet, comp->GetField( DATASHEET )->GetText() );
 
             // Export all user defined fields within the component,
             // which start at field index MANDATORY_FIELDS.  Only output the <fields>
             // container element if there are any <field>s.
             if( comp->GetFieldCount() > MANDATORY_FIELDS )
             {
-                XNODE* xfields;
-                xcomp->AddChild( xfields = node( sFields ) );
+                aOut.BeginNode( sFields );
 
                 for( int fldNdx = MANDATORY_FIELDS; fldNdx < comp->GetFieldCount(); ++fldNdx )
                 {
@@ -156,58 +373,61 @@ XNODE* NETLIST_EXPORTER_GENERIC::makeComponents()
                     // only output a field if non empty and not just "~"
                     if( !f->IsVoid() )
                     {
-                        XNODE*  xfield;
-                        xfields->AddChild( xfield = node( sField, f->GetText() ) );
-                        xfield->AddAttribute( sName, f->GetName() );
+                        aOut.BeginNode( sField );
+                        aOut.AddAttribute( sName, f->GetName() );
+                        aOut.AddText( f->GetText() );
+                        aOut.EndNode();
                     }
                 }
+
+                aOut.EndNode();
             }
 
-            XNODE*  xlibsource;
-            xcomp->AddChild( xlibsource = node( sLibSource ) );
+            aOut.BeginNode( sLibSource );
 
             // "logical" library name, which is in anticipation of a better search
             // algorithm for parts based on "logical_lib.part" and where logical_lib
             // is merely the library name minus path and extension.
             LIB_PART* part = m_libs->FindLibPart( comp->GetLibId() );
             if( part )
-                xlibsource->AddAttribute( sLib, part->GetLib()->GetLogicalName() );
+                aOut.AddAttribute( sLib, part->GetLib()->GetLogicalName() );
 
             // We only want the symbol name, not the full LIB_ID.
-            xlibsource->AddAttribute( sPart, comp->GetLibId().GetLibItemName() );
+            aOut.AddAttribute( sPart, comp->GetLibId().GetLibItemName() );
 
-            XNODE* xsheetpath;
+            aOut.EndNode();
 
-            xcomp->AddChild( xsheetpath = node( sSheetPath ) );
-            xsheetpath->AddAttribute( sNames, sheetList[i].PathHumanReadable() );
-            xsheetpath->AddAttribute( sTStamps, sheetList[i].Path() );
+            aOut.BeginNode( sSheetPath );
+            aOut.AddAttribute( sNames, sheetList[i].PathHumanReadable() );
+            aOut.AddAttribute( sTStamps, sheetList[i].Path() );
+            aOut.EndNode();
 
             timeStamp.Printf( sTSFmt, (unsigned long)comp->GetTimeStamp() );
-            xcomp->AddChild( node( sTStamp, timeStamp ) );
+            node( aOut, sTStamp, timeStamp );
+
+            aOut.EndNode();
         }
     }
 
-    return xcomps;
+    aOut.EndNode();
 }
 
 
-XNODE* NETLIST_EXPORTER_GENERIC::makeDesignHeader()
+void NETLIST_EXPORTER_GENERIC::makeDesignHeader( GENERIC_NETLIST_WRITER& aOut )
 {
     SCH_SCREEN* screen;
-    XNODE*     xdesign = node( wxT( "design" ) );
-    XNODE*     xtitleBlock;
-    XNODE*     xsheet;
-    XNODE*     xcomment;
     wxString   sheetTxt;
     wxFileName sourceFileName;
 
+    aOut.BeginNode( wxT( "design" ) );
+
     // the root sheet is a special sheet, call it source
-    xdesign->AddChild( node( wxT( "source" ), g_RootSheet->GetScreen()->GetFileName() ) );
+    node( aOut, wxT( "source" ), g_RootSheet->GetScreen()->GetFileName() );
 
-    xdesign->AddChild( node( wxT( "date" ), DateAndTime() ) );
+    node( aOut, wxT( "date" ), DateAndTime() );
 
     // which Eeschema tool
-    xdesign->AddChild( node( wxT( "tool" ), wxT( "Eeschema " ) + GetBuildVersion() ) );
+    node( aOut, wxT( "tool" ), wxT( "Eeschema " ) + GetBuildVersion() );
 
     /*
         Export the sheets information
@@ -218,74 +438,82 @@ XNODE* NETLIST_EXPORTER_GENERIC::makeDesignHeader()
     {
         screen = sheetList[i].LastScreen();
 
-        xdesign->AddChild( xsheet = node( wxT( "sheet" ) ) );
+        aOut.BeginNode( wxT( "sheet" ) );
 
         // get the string representation of the sheet index number.
         // Note that sheet->GetIndex() is zero index base and we need to increment the
         // number by one to make it human readable
         sheetTxt.Printf( wxT( "%u" ), i + 1 );
-        xsheet->AddAttribute( wxT( "number" ), sheetTxt );
-        xsheet->AddAttribute( wxT( "name" ), sheetList[i].PathHumanReadable() );
-        xsheet->AddAttribute( wxT( "tstamps" ), sheetList[i].Path() );
+        aOut.AddAttribute( wxT( "number" ), sheetTxt );
+        aOut.AddAttribute( wxT( "name" ), sheetList[i].PathHumanReadable() );
+        aOut.AddAttribute( wxT( "tstamps" ), sheetList[i].Path() );
 
 
         TITLE_BLOCK tb = screen->GetTitleBlock();
 
-        xsheet->AddChild( xtitleBlock = node( wxT( "title_block" ) ) );
+        aOut.BeginNode( wxT( "title_block" ) );
 
-        xtitleBlock->AddChild( node( wxT( "title" ), tb.GetTitle() ) );
-        xtitleBlock->AddChild( node( wxT( "company" ), tb.GetCompany() ) );
-        xtitleBlock->AddChild( node( wxT( "rev" ), tb.GetRevision() ) );
-        xtitleBlock->AddChild( node( wxT( "date" ), tb.GetDate() ) );
+        node( aOut, wxT( "title" ), tb.GetTitle() );
+        node( aOut, wxT( "company" ), tb.GetCompany() );
+        node( aOut, wxT( "rev" ), tb.GetRevision() );
+        node( aOut, wxT( "date" ), tb.GetDate() );
 
         // We are going to remove the fileName directories.
         sourceFileName = wxFileName( screen->GetFileName() );
-        xtitleBlock->AddChild( node( wxT( "source" ), sourceFileName.GetFullName() ) );
-
-        xtitleBlock->AddChild( xcomment = node( wxT( "comment" ) ) );
-        xcomment->AddAttribute( wxT("number"), wxT("1") );
-        xcomment->AddAttribute( wxT( "value" ), tb.GetComment1() );
-
-        xtitleBlock->AddChild( xcomment = node( wxT( "comment" ) ) );
-        xcomment->AddAttribute( wxT("number"), wxT("2") );
-        xcomment->AddAttribute( wxT( "value" ), tb.GetComment2() );
-
-        xtitleBlock->AddChild( xcomment = node( wxT( "comment" ) ) );
-        xcomment->AddAttribute( wxT("number"), wxT("3") );
-        xcomment->AddAttribute( wxT( "value" ), tb.GetComment3() );
-
-        xtitleBlock->AddChild( xcomment = node( wxT( "comment" ) ) );
-        xcomment->AddAttribute( wxT("number"), wxT("4") );
-        xcomment->AddAttribute( wxT( "value" ), tb.GetComment4() );
+        node( aOut, wxT( "source" ), sourceFileName.GetFullName() );
+
+        aOut.BeginNode( wxT( "comment" ) );
+        aOut.AddAttribute( wxT("number"), wxT("1") );
+        aOut.AddAttribute( wxT( "value" ), tb.GetComment1() );
+        aOut.EndNode();
+
+        aOut.BeginNode( wxT( "comment" ) );
+        aOut.AddAttribute( wxT("number"), wxT("2") );
+        aOut.AddAttribute( wxT( "value" ), tb.GetComment2() );
+        aOut.EndNode();
+
+        aOut.BeginNode( wxT( "comment" ) );
+        aOut.AddAttribute( wxT("number"), wxT("3") );
+        aOut.AddAttribute( wxT( "value" ), tb.GetComment3() );
+        aOut.EndNode();
+
+        aOut.BeginNode( wxT( "comment" ) );
+        aOut.AddAttribute( wxT("number"), wxT("4") );
+        aOut.AddAttribute( wxT( "value" ), tb.GetComment4() );
+        aOut.EndNode();
+
+        aOut.EndNode();     // title_block
+        aOut.EndNode();     // sheet
     }
 
-    return xdesign;
+    aOut.EndNode();
 }
 
 
-XNODE* NETLIST_EXPORTER_GENERIC::makeLibraries()
+void NETLIST_EXPORTER_GENERIC::makeLibraries( GENERIC_NETLIST_WRITER& aOut )
 {
-    XNODE*  xlibs = node( wxT( "libraries" ) );     // auto_ptr
+    aOut.BeginNode( wxT( "libraries" ) );
 
     for( std::set<void*>::iterator it = m_Libraries.begin(); it!=m_Libraries.end();  ++it )
     {
         PART_LIB*    lib = (PART_LIB*) *it;
-        XNODE*      xlibrary;
 
-        xlibs->AddChild( xlibrary = node( wxT( "library" ) ) );
-        xlibrary->AddAttribute( wxT( "logical" ), lib->GetLogicalName() );
-        xlibrary->AddChild( node( wxT( "uri" ),  lib->GetFullFileName() ) );
+        aOut.BeginNode( wxT( "library" ) );
+        aOut.AddAttribute( wxT( "logical" ), lib->GetLogicalName() );
+        node( aOut, wxT( "uri" ),  lib->GetFullFileName() );
 
         // @todo: add more fun stuff here
+
+        aOut.EndNode();
     }
 
-    return xlibs;
+    aOut.EndNode();
 }
 
 
-XNODE* NETLIST_EXPORTER_GENERIC::makeLibParts()
+void NETLIST_EXPORTER_GENERIC::makeLibParts( GENERIC_NETLIST_WRITER& aOut )
 {
-    XNODE*      xlibparts = node( wxT( "libparts" ) );   // auto_ptr
+    wxString    sLibparts = wxT( "libparts" );
     wxString    sLibpart  = wxT( "libpart" );
     wxString    sLib      = wxT( "lib" );
     wxString    sPart     = wxT( "part" );
@@ -309,6 +537,8 @@ XNODE* NETLIST_EXPORTER_GENERIC::makeLibParts()
 
     m_Libraries.clear();
 
+    aOut.BeginNode( sLibparts );
+
     for( std::set<LIB_PART*>::iterator it = m_LibParts.begin(); it!=m_LibParts.end();  ++it )
     {
         LIB_PART* lcomp = *it;
@@ -316,61 +546,65 @@ XNODE* NETLIST_EXPORTER_GENERIC::makeLibParts()
 
         m_Libraries.insert( library );  // inserts component's library if unique
 
-        XNODE* xlibpart;
-        xlibparts->AddChild( xlibpart = node( sLibpart ) );
-        xlibpart->AddAttribute( sLib, library->GetLogicalName() );
-        xlibpart->AddAttribute( sPart, lcomp->GetName()  );
+        aOut.BeginNode( sLibpart );
+        aOut.AddAttribute( sLib, library->GetLogicalName() );
+        aOut.AddAttribute( sPart, lcomp->GetName()  );
 
         if( lcomp->GetAliasCount() )
         {
             wxArrayString aliases = lcomp->GetAliasNames( false );
             if( aliases.GetCount() )
             {
-                XNODE* xaliases = node( sAliases );
-                xlibpart->AddChild( xaliases );
+                aOut.BeginNode( sAliases );
+
                 for( unsigned i=0;  i<aliases.GetCount();  ++i )
                 {
-                    xaliases->AddChild( node( sAlias, aliases[i] ) );
+                    node( aOut, sAlias, aliases[i] );
                 }
+
+                aOut.EndNode();
             }
         }
 
         //----- show the important properties -------------------------
         if( !lcomp->GetAlias( 0 )->GetDescription().IsEmpty() )
-            xlibpart->AddChild( node( sDescr, lcomp->GetAlias( 0 )->GetDescription() ) );
+            node( aOut, sDescr, lcomp->GetAlias( 0 )->GetDescription() );
 
         if( !lcomp->GetAlias( 0 )->GetDocFileName().IsEmpty() )
-            xlibpart->AddChild( node( sDocs,  lcomp->GetAlias( 0 )->GetDocFileName() ) );
+            node( aOut, sDocs,  lcomp->GetAlias( 0 )->GetDocFileName() );
 
         // Write the footprint list
         if( lcomp->GetFootPrints().GetCount() )
         {
-            XNODE*  xfootprints;
-            xlibpart->AddChild( xfootprints = node( sFprints ) );
+            aOut.BeginNode( sFprints );
 
             for( unsigned i=0; i<lcomp->GetFootPrints().GetCount(); ++i )
             {
-                xfootprints->AddChild( node( sFp, lcomp->GetFootPrints()[i] ) );
+                node( aOut, sFp, lcomp->GetFootPrints()[i] );
             }
+
+            aOut.EndNode();
         }
 
         //----- show the fields here ----------------------------------
         fieldList.clear();
         lcomp->GetFields( fieldList );
 
-        XNODE*     xfields;
-        xlibpart->AddChild( xfields = node( sFields ) );
+        aOut.BeginNode( sFields );
 
         for( unsigned i=0;  i<fieldList.size();  ++i )
         {
             if( !fieldList[i].GetText().IsEmpty() )
             {
-                XNODE*     xfield;
-                xfields->AddChild( xfield = node( sField, fieldList[i].GetText() ) );
-                xfield->AddAttribute( sName, fieldList[i].GetName(false) );
+                aOut.BeginNode( sField );
+                aOut.AddAttribute( sName, fieldList[i].GetName(false) );
+                aOut.AddText( fieldList[i].GetText() );
+                aOut.EndNode();
             }
         }
 
+        aOut.EndNode();
+
         //----- show the pins here ------------------------------------
         pinList.clear();
         lcomp->GetPins( pinList, 0, 0 );
@@ -395,30 +629,31 @@ XNODE* NETLIST_EXPORTER_GENERIC::makeLibParts()
 
         if( pinList.size() )
         {
-            XNODE*     pins;
+            aOut.BeginNode( sPins );
 
-            xlibpart->AddChild( pins = node( sPins ) );
             for( unsigned i=0; i<pinList.size();  ++i )
             {
-                XNODE*     pin;
-
-                pins->AddChild( pin = node( sPin ) );
-                pin->AddAttribute( sPinNum, pinList[i]->GetNumberString() );
-                pin->AddAttribute( sPinName, pinList[i]->GetName() );
-                pin->AddAttribute( sPinType, pinList[i]->GetCanonicalElectricalTypeName() );
+                aOut.BeginNode( sPin );
+                aOut.AddAttribute( sPinNum, pinList[i]->GetNumberString() );
+                aOut.AddAttribute( sPinName, pinList[i]->GetName() );
+                aOut.AddAttribute( sPinType, pinList[i]->GetCanonicalElectricalTypeName() );
 
                 // caution: construction work site here, drive slowly
+                aOut.EndNode();
             }
+
+            aOut.EndNode();
         }
+
+        aOut.EndNode();
     }
 
-    return xlibparts;
+    aOut.EndNode();
 }
 
 
-XNODE* NETLIST_EXPORTER_GENERIC::makeListOfNets()
+void NETLIST_EXPORTER_GENERIC::makeListOfNets( GENERIC_NETLIST_WRITER& aOut )
 {
-    XNODE*      xnets = node( wxT( "nets" ) );      // auto_ptr if exceptions ever get used.
     wxString    netCodeTxt;
     wxString    netName;
     wxString    ref;
@@ -431,7 +666,7 @@ XNODE* NETLIST_EXPORTER_GENERIC::makeListOfNets()
     wxString    sNode = wxT( "node" );
     wxString    sFmtd = wxT( "%d" );
 
-    XNODE*      xnet = 0;
+    bool        netStarted = false;
     int         netCode;
     int         lastNetCode = -1;
     int         sameNetcodeCount = 0;
@@ -446,6 +681,8 @@ XNODE* NETLIST_EXPORTER_GENERIC::makeListOfNets()
 
     m_LibParts.clear();     // must call this function before using m_LibParts.
 
+    aOut.BeginNode( wxT( "nets" ) );
+
     for( unsigned ii = 0; ii < m_masterList->size(); ii++ )
     {
         NETLIST_OBJECT* nitem = m_masterList->GetItem( ii );
@@ -474,30 +711,35 @@ XNODE* NETLIST_EXPORTER_GENERIC::makeListOfNets()
 
         if( ++sameNetcodeCount == 1 )
         {
-            xnets->AddChild( xnet = node( sNet ) );
+            if( netStarted )
+                aOut.EndNode();
+
+            aOut.BeginNode( sNet );
+            netStarted = true;
             netCodeTxt.Printf( sFmtd, netCode );
-            xnet->AddAttribute( sCode, netCodeTxt );
-            xnet->AddAttribute( sName, netName );
+            aOut.AddAttribute( sCode, netCodeTxt );
+            aOut.AddAttribute( sName, netName );
         }
 
-        XNODE*      xnode;
-        xnet->AddChild( xnode = node( sNode ) );
-        xnode->AddAttribute( sRef, ref );
-        xnode->AddAttribute( sPin,  nitem->GetPinNumText() );
+        aOut.BeginNode( sNode );
+        aOut.AddAttribute( sRef, ref );
+        aOut.AddAttribute( sPin,  nitem->GetPinNumText() );
+        aOut.EndNode();
     }
 
-    return xnets;
+    if( netStarted )
+        aOut.EndNode();
+
+    aOut.EndNode();
 }
 
 
-XNODE* NETLIST_EXPORTER_GENERIC::node( const wxString& aName, const wxString& aTextualContent /* = wxEmptyString*/ )
+void NETLIST_EXPORTER_GENERIC::node( GENERIC_NETLIST_WRITER& aOut, const wxString& aName,
+                                     const wxString& aTextualContent /* = wxEmptyString*/ )
 {
-    XNODE* n = new XNODE( wxXML_ELEMENT_NODE, aName );
-
-    if( aTextualContent.Len() > 0 )     // excludes wxEmptyString, the parameter's default value
-        n->AddChild( new XNODE( wxXML_TEXT_NODE, wxEmptyString, aTextualContent ) );
-
-    return n;
+    aOut.BeginNode( aName );
+    aOut.AddText( aTextualContent );
+    aOut.EndNode();
 }
 
 
@@ -28,13 +28,14 @@
 
 #include <netlist_exporter.h>
 
-#include <xnode.h>      // also nests: <wx/xml/xml.h>
-
 #define GENERIC_INTERMEDIATE_NETLIST_EXT wxT( "xml" )
 
+class GENERIC_NETLIST_WRITER;
+class OUTPUTFORMATTER;
+
 /**
  * Enum GNL
- * is a set of bit which control the totality of the tree built by makeRoot()
+ * is a set of bit which control the totality of the tree written by writeRoot()
  */
 enum GNL_T
 {
@@ -68,61 +69,65 @@ public:
 #define GNL_ALL     ( GNL_LIBRARIES | GNL_COMPONENTS | GNL_PARTS | GNL_HEADER | GNL_NETS )
 
 protected:
-   /**
+    /**
      * Function node
-     * is a convenience function that creates a new XNODE with an optional textual child.
-     * It also provides some insulation from a possible change in XML library.
+     * is a convenience function that outputs a node with an optional textual content
+     * and no attributes.
      *
-     * @param aName is the name to associate with a new node of type wxXML_ELEMENT_NODE.
-     * @param aTextualContent is optional, and if given is the text to include in a child
-     *   of the returned node, and has type wxXML_TEXT_NODE.
+     * @param aOut is the destination of the node.
+     * @param aName is the name of the new node.
+     * @param aTextualContent is optional, and if given is the text to include in the node.
      */
-    XNODE* node( const wxString& aName, const wxString& aTextualContent = wxEmptyString );
+    void node( GENERIC_NETLIST_WRITER& aOut, const wxString& aName,
+               const wxString& aTextualContent = wxEmptyString );
 
     /**
-     * Function makeGenericRoot
-     * builds the entire document tree for the generic export.  This is factored
-     * out here so we can write the tree in either S-expression file format
-     * or in XML if we put the tree built here into a wxXmlDocument.
+     * Function formatRoot
+     * formats the entire document as an S-expression to \a aOut, the same way as
+     * XNODE::Format() would for the equivalent XNODE tree, but without building
+     * the tree: nodes are written as soon as they are found.
+     * @param aOut is the destination of the serialization to text.
      * @param aCtl - a bitset or-ed together from GNL_ENUM values
-     * @return XNODE* - the root nodes
+     * @throw IO_ERROR if any problems.
+     */
+    void formatRoot( OUTPUTFORMATTER* aOut, int aCtl = GNL_ALL );
+
+    /**
+     * Function writeRoot
+     * walks the design and outputs the document nodes selected by \a aCtl to \a aOut.
      */
-    XNODE* makeRoot( int aCtl = GNL_ALL );
+    void writeRoot( GENERIC_NETLIST_WRITER& aOut, int aCtl );
 
     /**
      * Function makeComponents
-     * @return XNODE* - returns a sub-tree holding all the schematic components.
+     * outputs a sub-tree holding all the schematic components.
      */
-    XNODE* makeComponents();
+    void makeComponents( GENERIC_NETLIST_WRITER& aOut );
 
     /**
      * Function makeDesignHeader
-     * fills out a project "design" header into an XML node.
-     * @return XNODE* - the design header
+     * outputs a project "design" header.
      */
-    XNODE* makeDesignHeader();
+    void makeDesignHeader( GENERIC_NETLIST_WRITER& aOut );
 
     /**
      * Function makeLibParts
-     * fills out an XML node with the unique library parts and returns it.
-     * @return XNODE* - the library parts nodes
+     * outputs a node with the unique library parts.
      */
-    XNODE* makeLibParts();
+    void makeLibParts( GENERIC_NETLIST_WRITER& aOut );
 
     /**
      * Function makeListOfNets
-     * fills out an XML node with a list of nets and returns it.
-     * @return XNODE* - the list of nets nodes
+     * outputs a node with a list of nets.
      */
-    XNODE* makeListOfNets();
+    void makeListOfNets( GENERIC_NETLIST_WRITER& aOut );
 
     /**
      * Function makeLibraries
-     * fills out an XML node with a list of used libraries and returns it.
+     * outputs a node with a list of used libraries.
      * Must have called makeGenericLibParts() before this function.
-     * @return XNODE* - the library nodes
      */
-    XNODE* makeLibraries();
+    void makeLibraries( GENERIC_NETLIST_WRITER& aOut );
 };
 
 #endif
@@ -55,7 +55,6 @@ void NETLIST_EXPORTER_KICAD::Format( OUTPUTFORMATTER* aOut, int aCtl )
     for( unsigned ii = 0; ii < m_masterList->size(); ii++ )
         m_masterList->GetItem( ii )->m_Flag = 0;
 
-    std::unique_ptr<XNODE> xroot( makeRoot( aCtl ) );
-
-    xroot->Format( aOut, 0 );
+    // The netlist is written while the design is walked, no XNODE tree is built
+    formatRoot( aOut, aCtl );
 }
@@ -22,6 +22,11 @@
 
 #include <ctype.h>
 #include <algorithm>
+#include <atomic>
+#include <exception>
+#include <map>
+#include <system_error>
+#include <thread>
 
 #include <wx/mstream.h>
 #include <wx/filename.h>
@@ -31,6 +36,7 @@
 #include <kiway.h>
 #include <kicad_string.h>
 #include <richio.h>
+#include <i18n_utility.h>
 #include <core/typeinfo.h>
 #include <properties.h>
 
@@ -62,9 +68,62 @@
 // Must be the first line of part library document (.dcm) files.
 #define DOCFILE_IDENT     "EESchema-DOCLIB  Version 2.0"
 
+/**
+ * Class SCH_LOAD_ERROR
+ * is an error found by the parser.  Schematic files are parsed by worker threads (see
+ * SCH_LEGACY_PLUGIN::loadScreens()), which must not translate messages, so the error keeps
+ * the message marked with _HKI() and the location of the error.  Throw() translates the
+ * message in the main thread and throws the PARSE_ERROR or IO_ERROR reported to the caller.
+ */
+class SCH_LOAD_ERROR
+{
+public:
+    SCH_LOAD_ERROR( const wxString& aMessage ) :
+        m_message( aMessage ), m_isParseError( false ), m_lineNumber( 0 ), m_offset( 0 )
+    {
+    }
+
+    ///> Error with a message containing a single %s, replaced with aArg
+    SCH_LOAD_ERROR( const wxString& aFormat, const wxString& aArg ) :
+        m_message( aFormat ), m_arg( aArg ), m_isParseError( false ), m_lineNumber( 0 ),
+        m_offset( 0 )
+    {
+    }
+
+    SCH_LOAD_ERROR( const wxString& aMessage, const wxString& aSource, const char* aInputLine,
+                    int aLineNumber, int aOffset ) :
+        m_message( aMessage ), m_isParseError( true ), m_source( aSource ),
+        m_inputLine( aInputLine ), m_lineNumber( aLineNumber ), m_offset( aOffset )
+    {
+    }
+
+    void Throw() const
+    {
+        wxString message = wxGetTranslation( m_message );
+
+        if( !m_arg.IsEmpty() )
+            message = wxString::Format( message, m_arg );
+
+        if( m_isParseError )
+            THROW_PARSE_ERROR( message, m_source, m_inputLine.c_str(), m_lineNumber, m_offset );
+
+        THROW_IO_ERROR( message );
+    }
+
+private:
+    wxString    m_message;      ///< Untranslated message
+    wxString    m_arg;
+    bool        m_isParseError;
+    wxString    m_source;
+    std::string m_inputLine;
+    int         m_lineNumber;
+    int         m_offset;
+};
+
+
 #define SCH_PARSE_ERROR( text, reader, pos )                         \
-    THROW_PARSE_ERROR( text, reader.GetSource(), reader.Line(),      \
-                       reader.LineNumber(), pos - reader.Line() )
+    throw SCH_LOAD_ERROR( text, reader.GetSource(), reader.Line(),   \
+                          reader.LineNumber(), (int) ( pos - reader.Line() ) )
 
 
 // Token delimiters.
@@ -142,7 +201,7 @@ static bool strCompare( const char* aString, const char* aLine, const char** aOu
 static int parseInt( FILE_LINE_READER& aReader, const char* aLine, const char** aOutput = NULL )
 {
     if( !*aLine )
-        SCH_PARSE_ERROR( _( "unexpected end of line" ), aReader, aLine );
+        SCH_PARSE_ERROR( _HKI( "unexpected end of line" ), aReader, aLine );
 
     // Clear errno before calling strtol() in case some other crt call set it.
     errno = 0;
@@ -187,7 +246,7 @@ static unsigned long parseHex( FILE_LINE_READER& aReader, const char* aLine,
                                const char** aOutput = NULL )
 {
     if( !*aLine )
-        SCH_PARSE_ERROR( _( "unexpected end of line" ), aReader, aLine );
+        SCH_PARSE_ERROR( _HKI( "unexpected end of line" ), aReader, aLine );
 
     unsigned long retv;
 
@@ -235,7 +294,7 @@ static double parseDouble( FILE_LINE_READER& aReader, const char* aLine,
                            const char** aOutput = NULL )
 {
     if( !*aLine )
-        SCH_PARSE_ERROR( _( "unexpected end of line" ), aReader, aLine );
+        SCH_PARSE_ERROR( _HKI( "unexpected end of line" ), aReader, aLine );
 
     // Clear errno before calling strtod() in case some other crt call set it.
     errno = 0;
@@ -281,10 +340,10 @@ static char parseChar( FILE_LINE_READER& aReader, const char* aCurrentToken,
         aCurrentToken++;
 
     if( !*aCurrentToken )
-        SCH_PARSE_ERROR( _( "unexpected end of line" ), aReader, aCurrentToken );
+        SCH_PARSE_ERROR( _HKI( "unexpected end of line" ), aReader, aCurrentToken );
 
     if( !isspace( *( aCurrentToken + 1 ) ) )
-        SCH_PARSE_ERROR( _( "expected single character token" ), aReader, aCurrentToken );
+        SCH_PARSE_ERROR( _HKI( "expected single character token" ), aReader, aCurrentToken );
 
     if( aNextToken )
     {
@@ -325,7 +384,7 @@ static void parseUnquotedString( wxString& aString, FILE_LINE_READER& aReader,
         if( aCanBeEmpty )
             return;
         else
-            SCH_PARSE_ERROR( _( "unexpected end of line" ), aReader, aCurrentToken );
+            SCH_PARSE_ERROR( _HKI( "unexpected end of line" ), aReader, aCurrentToken );
     }
 
     const char* tmp = aCurrentToken;
@@ -338,7 +397,7 @@ static void parseUnquotedString( wxString& aString, FILE_LINE_READER& aReader,
         if( aCanBeEmpty )
             return;
         else
-            SCH_PARSE_ERROR( _( "unexpected end of line" ), aReader, aCurrentToken );
+            SCH_PARSE_ERROR( _HKI( "unexpected end of line" ), aReader, aCurrentToken );
     }
 
     std::string utf8;
@@ -349,7 +408,7 @@ static void parseUnquotedString( wxString& aString, FILE_LINE_READER& aReader,
     aString = FROM_UTF8( utf8.c_str() );
 
     if( aString.IsEmpty() && !aCanBeEmpty )
-        SCH_PARSE_ERROR( _( "expected unquoted string" ), aReader, aCurrentToken );
+        SCH_PARSE_ERROR( _HKI( "expected unquoted string" ), aReader, aCurrentToken );
 
     if( aNextToken )
     {
@@ -389,7 +448,7 @@ static void parseQuotedString( wxString& aString, FILE_LINE_READER& aReader,
         if( aCanBeEmpty )
             return;
         else
-            SCH_PARSE_ERROR( _( "unexpected end of line" ), aReader, aCurrentToken );
+            SCH_PARSE_ERROR( _HKI( "unexpected end of line" ), aReader, aCurrentToken );
     }
 
     const char* tmp = aCurrentToken;
@@ -402,12 +461,12 @@ static void parseQuotedString( wxString& aString, FILE_LINE_READER& aReader,
         if( aCanBeEmpty )
             return;
         else
-            SCH_PARSE_ERROR( _( "unexpected end of line" ), aReader, aCurrentToken );
+            SCH_PARSE_ERROR( _HKI( "unexpected end of line" ), aReader, aCurrentToken );
     }
 
     // Verify opening quote.
     if( *tmp != '"' )
-        SCH_PARSE_ERROR( _( "expecting opening quote" ), aReader, aCurrentToken );
+        SCH_PARSE_ERROR( _HKI( "expecting opening quote" ), aReader, aCurrentToken );
 
     tmp++;
 
@@ -421,7 +480,7 @@ static void parseQuotedString( wxString& aString, FILE_LINE_READER& aReader,
             tmp++;
 
             if( !*tmp )
-                SCH_PARSE_ERROR( _( "unexpected end of line" ), aReader, aCurrentToken );
+                SCH_PARSE_ERROR( _HKI( "unexpected end of line" ), aReader, aCurrentToken );
 
             // Do not copy the escape byte if it is followed by \ or "
             if( *tmp != '"' && *tmp != '\\' )
@@ -444,10 +503,10 @@ static void parseQuotedString( wxString& aString, FILE_LINE_READER& aReader,
     aString = FROM_UTF8( utf8.c_str() );
 
     if( aString.IsEmpty() && !aCanBeEmpty )
-        SCH_PARSE_ERROR( _( "expected quoted string" ), aReader, aCurrentToken );
+        SCH_PARSE_ERROR( _HKI( "expected quoted string" ), aReader, aCurrentToken );
 
     if( *tmp && *tmp != '"' )
-        SCH_PARSE_ERROR( _( "no closing quote for string found" ), aReader, tmp );
+        SCH_PARSE_ERROR( _HKI( "no closing quote for string found" ), aReader, tmp );
 
     // Move past the closing quote.
     tmp++;
@@ -478,6 +537,7 @@ class SCH_LEGACY_PLUGIN_CACHE
     bool            m_isWritable;
     bool            m_isModified;
     int             m_modHash;      // Keep track of the modification status of the library.
+    static int      s_modHashGeneration;    // Last modification hash of all the caches.
     int             m_versionMajor;
     int             m_versionMinor;
     int             m_libType;      // Is this cache a component or symbol library.
@@ -490,6 +550,7 @@ class SCH_LEGACY_PLUGIN_CACHE
                                      FILE_LINE_READER&            aReader );
     void            loadFootprintFilters( std::unique_ptr< LIB_PART >& aPart,
                                           FILE_LINE_READER&            aReader );
+    void            load();
     void            loadDocs();
     LIB_ARC*        loadArc( std::unique_ptr< LIB_PART >& aPart, FILE_LINE_READER& aReader );
     LIB_CIRCLE*     loadCircle( std::unique_ptr< LIB_PART >& aPart, FILE_LINE_READER& aReader );
@@ -506,6 +567,10 @@ class SCH_LEGACY_PLUGIN_CACHE
 
     void            saveDocFile();
 
+    /// Modification hashes are unique across all the caches, so a reloaded cache can
+    /// be told apart from the cache it replaces.
+    void            incrementModifyHash() { m_modHash = ++s_modHashGeneration; }
+
     friend SCH_LEGACY_PLUGIN;
 
 public:
@@ -610,59 +675,184 @@ SCH_SHEET* SCH_LEGACY_PLUGIN::Load( const wxString& aFileName, KIWAY* aKiway,
 }
 
 
-// Everything below this comment is recursive.  Modify with care.
+/**
+ * Function collectScreens
+ * adds the screens used by the sub-sheets of \a aScreen to \a aScreens, indexed by their
+ * file names in lower case (file names are compared without case by SCH_SHEET).
+ */
+static void collectScreens( SCH_SCREEN* aScreen, std::map<wxString, SCH_SCREEN*>& aScreens )
+{
+    for( EDA_ITEM* item = aScreen->GetDrawItems(); item; item = item->Next() )
+    {
+        if( item->Type() != SCH_SHEET_T )
+            continue;
+
+        SCH_SCREEN* screen = static_cast<SCH_SHEET*>( item )->GetScreen();
+
+        if( screen && aScreens.insert( std::make_pair( screen->GetFileName().Lower(),
+                                                       screen ) ).second )
+            collectScreens( screen, aScreens );
+    }
+}
+
 
 void SCH_LEGACY_PLUGIN::loadHierarchy( SCH_SHEET* aSheet )
 {
-    SCH_SCREEN* screen = NULL;
+    // Screens already loaded, sheets using the same file share the screen
+    std::map<wxString, SCH_SCREEN*> screens;
 
-    if( !aSheet->GetScreen() )
-    {
-        // SCH_SCREEN objects store the full path and file name where the SCH_SHEET object only
-        // stores the file name and extension.  Add the project path to the file name and
-        // extension to compare when calling SCH_SHEET::SearchHierarchy().
-        wxFileName fileName = aSheet->GetFileName();
+    if( m_rootSheet->GetScreen() )
+        collectScreens( m_rootSheet->GetScreen(), screens );
 
-        if( !fileName.IsAbsolute() )
-            fileName.SetPath( m_path );
+    // The hierarchy is loaded level by level. Files of the sheets found in a level do not
+    // depend on each other, so they are parsed concurrently (see loadScreens()), then their
+    // sub-sheets make the next level.
+    std::vector<SCH_SHEET*> sheets( 1, aSheet );
 
-        m_rootSheet->SearchHierarchy( fileName.GetFullPath(), &screen );
+    while( !sheets.empty() )
+    {
+        std::vector<SCH_SCREEN*> newScreens;
+        std::vector<SCH_SHEET*> parents;
 
-        if( screen )
+        for( SCH_SHEET* sheet : sheets )
         {
-            aSheet->SetScreen( screen );
+            if( sheet->GetScreen() )
+                continue;
+
+            // SCH_SCREEN objects store the full path and file name where the SCH_SHEET object
+            // only stores the file name and extension.  Add the project path to the file name
+            // and extension to compare with the loaded screens.
+            wxFileName fileName = sheet->GetFileName();
+
+            if( !fileName.IsAbsolute() )
+                fileName.SetPath( m_path );
+
+            SCH_SCREEN*& screen = screens[fileName.GetFullPath().Lower()];
+
+            if( screen )
+            {
+                // Do not need to load the sub-sheets - this is done for the first sheet
+                // using the screen.
+                sheet->SetScreen( screen );
+                continue;
+            }
 
-            // Do not need to load the sub-sheets - this has already been done.
+            screen = new SCH_SCREEN( m_kiway );
+            screen->SetFileName( fileName.GetFullPath() );
+            sheet->SetScreen( screen );
+
+            newScreens.push_back( screen );
+            parents.push_back( sheet );
         }
-        else
-        {
-            aSheet->SetScreen( new SCH_SCREEN( m_kiway ) );
-            aSheet->GetScreen()->SetFileName( fileName.GetFullPath() );
-            loadFile( fileName.GetFullPath(), aSheet->GetScreen() );
 
-            EDA_ITEM* item = aSheet->GetScreen()->GetDrawItems();
+        loadScreens( newScreens );
+
+        sheets.clear();
 
-            while( item )
+        for( unsigned i = 0; i < newScreens.size(); i++ )
+        {
+            for( EDA_ITEM* item = newScreens[i]->GetDrawItems(); item; item = item->Next() )
             {
-                if( item->Type() == SCH_SHEET_T )
-                {
-                    SCH_SHEET* sheet = (SCH_SHEET*) item;
+                if( item->Type() != SCH_SHEET_T )
+                    continue;
+
+                SCH_SHEET* sheet = (SCH_SHEET*) item;
+
+                // Set the parent to the sheet that loaded the screen.  This effectively
+                // creates a method to find the root sheet from any sheet so a pointer to the
+                // root sheet does not need to be stored globally.  Note: this is not the same
+                // as a hierarchy.  Complex hierarchies can have multiple copies of a sheet.
+                // This only provides a simple tree to find the root sheet.
+                sheet->SetParent( parents[i] );
+                sheets.push_back( sheet );
+            }
+        }
+    }
+}
 
-                    // Set the parent to aSheet.  This effectively creates a method to find
-                    // the root sheet from any sheet so a pointer to the root sheet does not
-                    // need to be stored globally.  Note: this is not the same as a hierarchy.
-                    // Complex hierarchies can have multiple copies of a sheet.  This only
-                    // provides a simple tree to find the root sheet.
-                    sheet->SetParent( aSheet );
 
-                    // Recursion starts here.
-                    loadHierarchy( sheet );
-                }
+void SCH_LEGACY_PLUGIN::loadScreens( const std::vector<SCH_SCREEN*>& aScreens )
+{
+    std::vector<std::exception_ptr> errors( aScreens.size() );
+    std::vector<char> skipped( aScreens.size(), 0 );
+    std::atomic<unsigned> nextScreen( 0 );
+
+    // Each file is parsed by a separate plugin, the parser keeps the version of the file.
+    // The locale is already set by Load() and it is not changed until all files are loaded.
+    auto loader = [&]()
+    {
+        SCH_LEGACY_PLUGIN plugin;
+        plugin.init( m_kiway, m_props );
+        plugin.m_path = m_path;
 
-                item = item->Next();
+        for( unsigned i = nextScreen++; i < aScreens.size(); i = nextScreen++ )
+        {
+            // FILE_LINE_READER reports a translated error, leave it to the main thread
+            if( !wxFileName::IsFileReadable( aScreens[i]->GetFileName() ) )
+            {
+                skipped[i] = 1;
+                continue;
             }
+
+            try
+            {
+                plugin.loadFile( aScreens[i]->GetFileName(), aScreens[i] );
+            }
+            catch( ... )
+            {
+                errors[i] = std::current_exception();
+            }
+        }
+    };
+
+    // Default field names are translated here, the workers use the names cached by
+    // TEMPLATE_FIELDNAME::GetDefaultFieldName()
+    for( int i = 0; i <= MANDATORY_FIELDS; i++ )
+        TEMPLATE_FIELDNAME::GetDefaultFieldName( i );
+
+    unsigned threadCount = std::min<unsigned>( std::thread::hardware_concurrency(),
+                                               aScreens.size() );
+
+    // The current thread parses files as well
+    std::vector<std::thread> threads;
+    threads.reserve( threadCount );
+
+    try
+    {
+        for( unsigned i = 1; i < threadCount; i++ )
+            threads.emplace_back( loader );
+    }
+    catch( const std::system_error& )
+    {
+        // No more threads can be started, the files are parsed by the running ones
+    }
+
+    loader();
+
+    for( std::thread& thread : threads )
+        thread.join();
+
+    // Report the error of the first file, as if the files were loaded one after another.
+    // Screens are already owned by the sheets, they are freed with the hierarchy.
+    SCH_LEGACY_PLUGIN plugin;
+    plugin.init( m_kiway, m_props );
+    plugin.m_path = m_path;
+
+    try
+    {
+        for( unsigned i = 0; i < aScreens.size(); i++ )
+        {
+            if( skipped[i] )
+                plugin.loadFile( aScreens[i]->GetFileName(), aScreens[i] );
+            else if( errors[i] )
+                std::rethrow_exception( errors[i] );
         }
     }
+    catch( const SCH_LOAD_ERROR& error )
+    {
+        // The parser messages are translated here, in the main thread
+        error.Throw();
+    }
 }
 
 
@@ -716,9 +906,8 @@ void SCH_LEGACY_PLUGIN::loadHeader( FILE_LINE_READER& aReader, SCH_SCREEN* aScre
 
     if( !strCompare( "Eeschema Schematic File Version", line, &line ) )
     {
-        m_error.Printf( _( "'%s' does not appear to be an Eeschema file" ),
-                        GetChars( aScreen->GetFileName() ) );
-        THROW_IO_ERROR( m_error );
+        throw SCH_LOAD_ERROR( _HKI( "'%s' does not appear to be an Eeschema file" ),
+                              aScreen->GetFileName() );
     }
 
     // get the file version here.
@@ -744,7 +933,7 @@ void SCH_LEGACY_PLUGIN::loadHeader( FILE_LINE_READER& aReader, SCH_SCREEN* aScre
             return;
     }
 
-    THROW_IO_ERROR( _( "Missing 'EELAYER END'" ) );
+    throw SCH_LOAD_ERROR( _HKI( "Missing 'EELAYER END'" ) );
 }
 
 
@@ -763,7 +952,7 @@ void SCH_LEGACY_PLUGIN::loadPageSettings( FILE_LINE_READER& aReader, SCH_SCREEN*
     parseUnquotedString( buf, aReader, line, &line );
 
     if( !pageInfo.SetType( buf ) )
-        SCH_PARSE_ERROR( _( "invalid page size" ), aReader, line );
+        SCH_PARSE_ERROR( _HKI( "invalid page size" ), aReader, line );
 
     int pagew = parseInt( aReader, line, &line );
     int pageh = parseInt( aReader, line, &line );
@@ -792,7 +981,7 @@ void SCH_LEGACY_PLUGIN::loadPageSettings( FILE_LINE_READER& aReader, SCH_SCREEN*
         buf.clear();
 
         if( !aReader.ReadLine() )
-            SCH_PARSE_ERROR( _( "unexpected end of file" ), aReader, line );
+            SCH_PARSE_ERROR( _HKI( "unexpected end of file" ), aReader, line );
 
         line = aReader.Line();
 
@@ -848,7 +1037,7 @@ void SCH_LEGACY_PLUGIN::loadPageSettings( FILE_LINE_READER& aReader, SCH_SCREEN*
         }
     }
 
-    SCH_PARSE_ERROR( _( "missing 'EndDescr'" ), aReader, line );
+    SCH_PARSE_ERROR( _HKI( "missing 'EndDescr'" ), aReader, line );
 }
 
 
@@ -916,7 +1105,7 @@ SCH_SHEET* SCH_LEGACY_PLUGIN::loadSheet( FILE_LINE_READER& aReader )
                 sheetPin->SetText( text );
 
                 if( line == NULL )
-                    THROW_IO_ERROR( _( "unexpected end of line" ) );
+                    throw SCH_LOAD_ERROR( _HKI( "unexpected end of line" ) );
 
                 switch( parseChar( aReader, line, &line ) )
                 {
@@ -940,7 +1129,7 @@ SCH_SHEET* SCH_LEGACY_PLUGIN::loadSheet( FILE_LINE_READER& aReader )
                     sheetPin->SetShape( NET_UNSPECIFIED );
                     break;
                 default:
-                    SCH_PARSE_ERROR( _( "invalid sheet pin type" ), aReader, line );
+                    SCH_PARSE_ERROR( _HKI( "invalid sheet pin type" ), aReader, line );
                 }
 
                 switch( parseChar( aReader, line, &line ) )
@@ -961,7 +1150,7 @@ SCH_SHEET* SCH_LEGACY_PLUGIN::loadSheet( FILE_LINE_READER& aReader )
                     sheetPin->SetEdge( SCH_SHEET_PIN::SHEET_LEFT_SIDE );
                     break;
                 default:
-                    SCH_PARSE_ERROR( _( "invalid sheet pin side" ), aReader, line );
+                    SCH_PARSE_ERROR( _HKI( "invalid sheet pin side" ), aReader, line );
                 }
 
                 wxPoint position;
@@ -983,7 +1172,7 @@ SCH_SHEET* SCH_LEGACY_PLUGIN::loadSheet( FILE_LINE_READER& aReader )
         line = aReader.ReadLine();
     }
 
-    SCH_PARSE_ERROR( _( "missing '$EndSheet`" ), aReader, line );
+    SCH_PARSE_ERROR( _HKI( "missing '$EndSheet`" ), aReader, line );
 
     return NULL;  // Prevents compiler warning.  Should never get here.
 }
@@ -1021,7 +1210,7 @@ SCH_BITMAP* SCH_LEGACY_PLUGIN::loadBitmap( FILE_LINE_READER& aReader )
             while( line )
             {
                 if( !aReader.ReadLine() )
-                    SCH_PARSE_ERROR( _( "Unexpected end of file" ), aReader, line );
+                    SCH_PARSE_ERROR( _HKI( "Unexpected end of file" ), aReader, line );
 
                 line = aReader.Line();
 
@@ -1054,7 +1243,7 @@ SCH_BITMAP* SCH_LEGACY_PLUGIN::loadBitmap( FILE_LINE_READER& aReader )
             }
 
             if( line == NULL )
-                THROW_IO_ERROR( _( "unexpected end of file" ) );
+                throw SCH_LOAD_ERROR( _HKI( "unexpected end of file" ) );
         }
         else if( strCompare( "$EndBitmap", line ) )
             return bitmap.release();
@@ -1062,7 +1251,7 @@ SCH_BITMAP* SCH_LEGACY_PLUGIN::loadBitmap( FILE_LINE_READER& aReader )
         line = aReader.ReadLine();
     }
 
-    THROW_IO_ERROR( _( "unexpected end of file" ) );
+    throw SCH_LOAD_ERROR( _HKI( "unexpected end of file" ) );
 }
 
 
@@ -1242,7 +1431,7 @@ SCH_TEXT* SCH_LEGACY_PLUGIN::loadText( FILE_LINE_READER& aReader )
         else if( strCompare( SheetLabelType[NET_UNSPECIFIED], line, &line ) )
             text->SetShape( NET_UNSPECIFIED );
         else
-            SCH_PARSE_ERROR( _( "invalid label type" ), aReader, line );
+            SCH_PARSE_ERROR( _HKI( "invalid label type" ), aReader, line );
     }
 
     int thickness = 0;
@@ -1253,7 +1442,7 @@ SCH_TEXT* SCH_LEGACY_PLUGIN::loadText( FILE_LINE_READER& aReader )
         if( strCompare( "Italic", line, &line ) )
             text->SetItalic( true );
         else if( !strCompare( "~", line, &line ) )
-            SCH_PARSE_ERROR( _( "expected 'Italics' or '~'" ), aReader, line );
+            SCH_PARSE_ERROR( _HKI( "expected 'Italics' or '~'" ), aReader, line );
 
         // The thickness token does not exist in older versions of the schematic file format
         // so calling parseInt will be made only if the EOL is not reached.
@@ -1438,7 +1627,7 @@ SCH_COMPONENT* SCH_LEGACY_PLUGIN::loadComponent( FILE_LINE_READER& aReader )
                 else if( hjustify == 'R' )
                     component->GetField( index )->SetHorizJustify( GR_TEXT_HJUSTIFY_RIGHT );
                 else if( hjustify != 'C' )
-                    SCH_PARSE_ERROR( _( "component field text horizontal justification must be "
+                    SCH_PARSE_ERROR( _HKI( "component field text horizontal justification must be "
                                         "L, R, or C" ), aReader, line );
 
                 // We are guaranteed to have a least one character here for older file formats
@@ -1448,26 +1637,29 @@ SCH_COMPONENT* SCH_LEGACY_PLUGIN::loadComponent( FILE_LINE_READER& aReader )
                 else if( textAttrs[0] == 'B' )
                     component->GetField( index )->SetVertJustify( GR_TEXT_VJUSTIFY_BOTTOM );
                 else if( textAttrs[0] != 'C' )
-                    SCH_PARSE_ERROR( _( "component field text vertical justification must be "
+                    SCH_PARSE_ERROR( _HKI( "component field text vertical justification must be "
                                         "B, T, or C" ), aReader, line );
 
                 // Newer file formats include the bold and italics text attribute.
                 if( textAttrs.Length() > 1 )
                 {
                     if( textAttrs.Length() != 3 )
-                        SCH_PARSE_ERROR( _( "component field text attributes must be 3 characters wide" ),
+                        SCH_PARSE_ERROR( _HKI( "component field text attributes must be "
+                                               "3 characters wide" ),
                                          aReader, line );
 
                     if( textAttrs[1] == 'I' )
                         component->GetField( index )->SetItalic( true );
                     else if( textAttrs[1] != 'N' )
-                        SCH_PARSE_ERROR( _( "component field text italics indicator must be I or N" ),
+                        SCH_PARSE_ERROR( _HKI( "component field text italics indicator "
+                                               "must be I or N" ),
                                          aReader, line );
 
                     if( textAttrs[2] == 'B' )
                         component->GetField( index )->SetBold( true );
                     else if( textAttrs[2] != 'N' )
-                        SCH_PARSE_ERROR( _( "component field text bold indicator must be B or N" ),
+                        SCH_PARSE_ERROR( _HKI( "component field text bold indicator "
+                                               "must be B or N" ),
                                          aReader, line );
                 }
             }
@@ -1482,7 +1674,7 @@ SCH_COMPONENT* SCH_LEGACY_PLUGIN::loadComponent( FILE_LINE_READER& aReader )
             else if( orientation == 'V' )
                 component->GetField( index )->SetTextAngle( TEXT_ANGLE_VERT );
             else
-                SCH_PARSE_ERROR( _( "component field orientation must be H or V" ),
+                SCH_PARSE_ERROR( _HKI( "component field orientation must be H or V" ),
                                  aReader, line );
 
             if( name.IsEmpty() )
@@ -1514,22 +1706,22 @@ SCH_COMPONENT* SCH_LEGACY_PLUGIN::loadComponent( FILE_LINE_READER& aReader )
             transform.x1 = parseInt( aReader, line, &line );
 
             if( transform.x1 < -1 || transform.x1 > 1 )
-                SCH_PARSE_ERROR( _( "invalid component X1 transform value" ), aReader, line );
+                SCH_PARSE_ERROR( _HKI( "invalid component X1 transform value" ), aReader, line );
 
             transform.y1 = parseInt( aReader, line, &line );
 
             if( transform.y1 < -1 || transform.y1 > 1 )
-                SCH_PARSE_ERROR( _( "invalid component Y1 transform value" ), aReader, line );
+                SCH_PARSE_ERROR( _HKI( "invalid component Y1 transform value" ), aReader, line );
 
             transform.x2 = parseInt( aReader, line, &line );
 
             if( transform.x2 < -1 || transform.x2 > 1 )
-                SCH_PARSE_ERROR( _( "invalid component X2 transform value" ), aReader, line );
+                SCH_PARSE_ERROR( _HKI( "invalid component X2 transform value" ), aReader, line );
 
             transform.y2 = parseInt( aReader, line, &line );
 
             if( transform.y2 < -1 || transform.y2 > 1 )
-                SCH_PARSE_ERROR( _( "invalid component Y2 transform value" ), aReader, line );
+                SCH_PARSE_ERROR( _HKI( "invalid component Y2 transform value" ), aReader, line );
 
             component->SetTransform( transform );
         }
@@ -2009,11 +2201,14 @@ void SCH_LEGACY_PLUGIN::saveText( SCH_TEXT* aText )
 }
 
 
+int SCH_LEGACY_PLUGIN_CACHE::s_modHashGeneration = 0;
+
+
 SCH_LEGACY_PLUGIN_CACHE::SCH_LEGACY_PLUGIN_CACHE( const wxString& aFullPathAndFileName ) :
     m_libFileName( aFullPathAndFileName ),
     m_isWritable( true ),
     m_isModified( false ),
-    m_modHash( 1 )
+    m_modHash( ++s_modHashGeneration )
 {
     m_versionMajor = -1;
     m_versionMinor = -1;
@@ -2102,7 +2297,7 @@ LIB_ALIAS* SCH_LEGACY_PLUGIN_CACHE::removeAlias( LIB_ALIAS* aAlias )
 
     m_aliases.erase( it );
     m_isModified = true;
-    ++m_modHash;
+    incrementModifyHash();
     return alias;
 }
 
@@ -2128,11 +2323,24 @@ void SCH_LEGACY_PLUGIN_CACHE::AddSymbol( const LIB_PART* aPart )
     }
 
     m_isModified = true;
-    ++m_modHash;
+    incrementModifyHash();
 }
 
 
 void SCH_LEGACY_PLUGIN_CACHE::Load()
+{
+    try
+    {
+        load();
+    }
+    catch( const SCH_LOAD_ERROR& error )
+    {
+        error.Throw();
+    }
+}
+
+
+void SCH_LEGACY_PLUGIN_CACHE::load()
 {
     wxCHECK_RET( m_libFileName.IsAbsolute(),
                  wxString::Format( "Cannot use relative file paths in legacy plugin to "
@@ -2198,7 +2406,7 @@ void SCH_LEGACY_PLUGIN_CACHE::Load()
         }
     }
 
-    ++m_modHash;
+    incrementModifyHash();
 
     // Remember the file modification time of library file when the
     // cache snapshot was made, so that in a networked environment we will
@@ -2521,7 +2729,7 @@ void SCH_LEGACY_PLUGIN_CACHE::loadField( std::unique_ptr< LIB_PART >& aPart,
     int         id;
 
     if( sscanf( line + 1, "%d", &id ) != 1 || id < 0 )
-        SCH_PARSE_ERROR( _( "invalid field ID" ), aReader, line + 1 );
+        SCH_PARSE_ERROR( _HKI( "invalid field ID" ), aReader, line + 1 );
 
     std::unique_ptr< LIB_FIELD > field( new LIB_FIELD( aPart.get(), id ) );
 
@@ -2530,7 +2738,7 @@ void SCH_LEGACY_PLUGIN_CACHE::loadField( std::unique_ptr< LIB_PART >& aPart,
         line++;
 
     if( *line == 0 )
-        SCH_PARSE_ERROR( _( "unexpected end of line" ), aReader, line );
+        SCH_PARSE_ERROR( _HKI( "unexpected end of line" ), aReader, line );
 
     wxString text;
     parseQuotedString( text, aReader, line, &line, true );
@@ -2560,7 +2768,7 @@ void SCH_LEGACY_PLUGIN_CACHE::loadField( std::unique_ptr< LIB_PART >& aPart,
     else if( textOrient == 'V' )
         field->SetTextAngle( TEXT_ANGLE_VERT );
     else
-        SCH_PARSE_ERROR( _( "invalid field text orientation parameter" ), aReader, line );
+        SCH_PARSE_ERROR( _HKI( "invalid field text orientation parameter" ), aReader, line );
 
     char textVisible = parseChar( aReader, line, &line );
 
@@ -2569,7 +2777,7 @@ void SCH_LEGACY_PLUGIN_CACHE::loadField( std::unique_ptr< LIB_PART >& aPart,
     else if ( textVisible == 'I' )
         field->SetVisible( false );
     else
-        SCH_PARSE_ERROR( _( "invalid field text visibility parameter" ), aReader, line );
+        SCH_PARSE_ERROR( _HKI( "invalid field text visibility parameter" ), aReader, line );
 
     // It may be technically correct to use the library version to determine if the field text
     // attributes are present.  If anyone knows if that is valid and what version that would be,
@@ -2586,7 +2794,7 @@ void SCH_LEGACY_PLUGIN_CACHE::loadField( std::unique_ptr< LIB_PART >& aPart,
         else if( textHJustify == 'R' )
             field->SetHorizJustify( GR_TEXT_HJUSTIFY_RIGHT );
         else
-            SCH_PARSE_ERROR( _( "invalid field text horizontal justification parameter" ),
+            SCH_PARSE_ERROR( _HKI( "invalid field text horizontal justification parameter" ),
                              aReader, line );
 
         wxString attributes;
@@ -2594,7 +2802,7 @@ void SCH_LEGACY_PLUGIN_CACHE::loadField( std::unique_ptr< LIB_PART >& aPart,
         parseUnquotedString( attributes, aReader, line, &line );
 
         if( !(attributes.size() == 3 || attributes.size() == 1 ) )
-            SCH_PARSE_ERROR( _( "invalid field text attributes size" ),
+            SCH_PARSE_ERROR( _HKI( "invalid field text attributes size" ),
                              aReader, line );
 
         if( attributes[0] == 'C' )
@@ -2604,7 +2812,7 @@ void SCH_LEGACY_PLUGIN_CACHE::loadField( std::unique_ptr< LIB_PART >& aPart,
         else if( attributes[0] == 'T' )
             field->SetVertJustify( GR_TEXT_VJUSTIFY_TOP );
         else
-            SCH_PARSE_ERROR( _( "invalid field text vertical justification parameter" ),
+            SCH_PARSE_ERROR( _HKI( "invalid field text vertical justification parameter" ),
                              aReader, line );
 
         if( attributes.size() == 3 )
@@ -2612,12 +2820,12 @@ void SCH_LEGACY_PLUGIN_CACHE::loadField( std::unique_ptr< LIB_PART >& aPart,
             if( attributes[1] == 'I' )        // Italic
                 field->SetItalic( true );
             else if( attributes[1] != 'N' )   // No italics is default, check for error.
-                SCH_PARSE_ERROR( _( "invalid field text italic parameter" ), aReader, line );
+                SCH_PARSE_ERROR( _HKI( "invalid field text italic parameter" ), aReader, line );
 
             if ( attributes[2] == 'B' )       // Bold
                 field->SetBold( true );
             else if( attributes[2] != 'N' )   // No bold is default, check for error.
-                SCH_PARSE_ERROR( _( "invalid field text bold parameter" ), aReader, line );
+                SCH_PARSE_ERROR( _HKI( "invalid field text bold parameter" ), aReader, line );
         }
     }
 
@@ -2706,13 +2914,14 @@ void SCH_LEGACY_PLUGIN_CACHE::loadDrawEntries( std::unique_ptr< LIB_PART >& aPar
             break;
 
         default:
-            SCH_PARSE_ERROR( _( "undefined DRAW entry" ), aReader, line );
+            SCH_PARSE_ERROR( _HKI( "undefined DRAW entry" ), aReader, line );
         }
 
         line = aReader.ReadLine();
     }
 
-    SCH_PARSE_ERROR( _( "file ended prematurely loading component draw element" ), aReader, line );
+    SCH_PARSE_ERROR( _HKI( "file ended prematurely loading component draw element" ),
+                     aReader, line );
 }
 
 
@@ -2736,7 +2945,7 @@ FILL_T SCH_LEGACY_PLUGIN_CACHE::parseFillMode( FILE_LINE_READER& aReader, const
         break;
 
     default:
-        SCH_PARSE_ERROR( _( "invalid fill type, expected f, F, or N" ), aReader, aLine );
+        SCH_PARSE_ERROR( _HKI( "invalid fill type, expected f, F, or N" ), aReader, aLine );
     }
 
     return mode;
@@ -2890,7 +3099,7 @@ LIB_TEXT* SCH_LEGACY_PLUGIN_CACHE::loadText( std::unique_ptr< LIB_PART >& aPart,
         if( strCompare( "Italic", line, &line ) )
             text->SetItalic( true );
         else if( !strCompare( "Normal", line, &line ) )
-            SCH_PARSE_ERROR( _( "invalid text stype, expected 'Normal' or 'Italic'" ),
+            SCH_PARSE_ERROR( _HKI( "invalid text stype, expected 'Normal' or 'Italic'" ),
                              aReader, line );
 
         if( parseInt( aReader, line, &line ) > 0 )
@@ -2911,7 +3120,8 @@ LIB_TEXT* SCH_LEGACY_PLUGIN_CACHE::loadText( std::unique_ptr< LIB_PART >& aPart,
             break;
 
         default:
-            SCH_PARSE_ERROR( _( "invalid horizontal text justication parameter, expected L, C, or R" ),
+            SCH_PARSE_ERROR( _HKI( "invalid horizontal text justication parameter, "
+                                   "expected L, C, or R" ),
                              aReader, line );
         }
 
@@ -2930,7 +3140,8 @@ LIB_TEXT* SCH_LEGACY_PLUGIN_CACHE::loadText( std::unique_ptr< LIB_PART >& aPart,
             break;
 
         default:
-            SCH_PARSE_ERROR( _( "invalid vertical text justication parameter, expected T, C, or B" ),
+            SCH_PARSE_ERROR( _HKI( "invalid vertical text justication parameter, "
+                                   "expected T, C, or B" ),
                              aReader, line );
         }
     }
@@ -3054,7 +3265,7 @@ LIB_PIN* SCH_LEGACY_PLUGIN_CACHE::loadPin( std::unique_ptr< LIB_PART >& aPart,
         break;
 
     default:
-        SCH_PARSE_ERROR( _( "unknown pin type" ), aReader, line );
+        SCH_PARSE_ERROR( _HKI( "unknown pin type" ), aReader, line );
     }
 
     if( !attributes.IsEmpty() )       /* Special Symbol defined */
@@ -3107,7 +3318,7 @@ LIB_PIN* SCH_LEGACY_PLUGIN_CACHE::loadPin( std::unique_ptr< LIB_PART >& aPart,
                 break;
 
             default:
-                SCH_PARSE_ERROR( _( "unknown pin attribute" ), aReader, line );
+                SCH_PARSE_ERROR( _HKI( "unknown pin attribute" ), aReader, line );
             }
         }
 
@@ -3150,7 +3361,8 @@ LIB_PIN* SCH_LEGACY_PLUGIN_CACHE::loadPin( std::unique_ptr< LIB_PART >& aPart,
             break;
 
         default:
-            SCH_PARSE_ERROR( _( "pin attributes do not define a valid pin shape" ), aReader, line );
+            SCH_PARSE_ERROR( _HKI( "pin attributes do not define a valid pin shape" ),
+                             aReader, line );
         }
     }
 
@@ -3239,7 +3451,8 @@ void SCH_LEGACY_PLUGIN_CACHE::loadFootprintFilters( std::unique_ptr< LIB_PART >&
         line = aReader.ReadLine();
     }
 
-    SCH_PARSE_ERROR( _( "file ended prematurely while loading footprint filters" ), aReader, line );
+    SCH_PARSE_ERROR( _HKI( "file ended prematurely while loading footprint filters" ),
+                     aReader, line );
 }
 
 
@@ -3317,7 +3530,7 @@ void SCH_LEGACY_PLUGIN_CACHE::DeleteAlias( const wxString& aAliasName )
     }
 
     m_aliases.erase( it );
-    ++m_modHash;
+    incrementModifyHash();
     m_isModified = true;
 }
 
@@ -3417,6 +3630,23 @@ void SCH_LEGACY_PLUGIN::EnumerateSymbolLib( wxArrayString&    aAliasNameList,
 }
 
 
+void SCH_LEGACY_PLUGIN::EnumerateSymbolLib( std::vector<LIB_ALIAS*>& aAliasList,
+                                            const wxString&          aLibraryPath,
+                                            const PROPERTIES*        aProperties )
+{
+    LOCALE_IO   toggle;     // toggles on, then off, the C locale.
+
+    m_props = aProperties;
+
+    cacheLib( aLibraryPath );
+
+    const LIB_ALIAS_MAP& aliases = m_cache->m_aliases;
+
+    for( LIB_ALIAS_MAP::const_iterator it = aliases.begin();  it != aliases.end();  ++it )
+        aAliasList.push_back( it->second );
+}
+
+
 LIB_ALIAS* SCH_LEGACY_PLUGIN::LoadSymbol( const wxString& aLibraryPath, const wxString& aAliasName,
                                           const PROPERTIES* aProperties )
 {
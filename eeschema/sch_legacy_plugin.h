@@ -23,6 +23,8 @@
  * with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <vector>
+
 #include <sch_io_mgr.h>
 
 
@@ -107,6 +109,9 @@ public:
     void EnumerateSymbolLib( wxArrayString&    aAliasNameList,
                              const wxString&   aLibraryPath,
                              const PROPERTIES* aProperties = NULL ) override;
+    void EnumerateSymbolLib( std::vector<LIB_ALIAS*>& aAliasList,
+                             const wxString&          aLibraryPath,
+                             const PROPERTIES*        aProperties = NULL ) override;
     LIB_ALIAS* LoadSymbol( const wxString& aLibraryPath, const wxString& aAliasName,
                            const PROPERTIES* aProperties = NULL ) override;
     void SaveSymbol( const wxString& aLibraryPath, const LIB_PART* aSymbol,
@@ -123,6 +128,14 @@ public:
 
 private:
     void loadHierarchy( SCH_SHEET* aSheet );
+
+    /**
+     * Function loadScreens
+     * parses the files of \a aScreens (their file names have to be set) concurrently.
+     * @throw IO_ERROR (or the exception thrown by the parser) of the first file that could
+     *        not be loaded, after all the files have been parsed.
+     */
+    void loadScreens( const std::vector<SCH_SCREEN*>& aScreens );
     void loadHeader( FILE_LINE_READER& aReader, SCH_SCREEN* aScreen );
     void loadPageSettings( FILE_LINE_READER& aReader, SCH_SCREEN* aScreen );
     void loadFile( const wxString& aFileName, SCH_SCREEN* aScreen );
@@ -151,7 +164,6 @@ private:
 
 protected:
     int               m_version;    ///< Version of file being loaded.
-    wxString          m_error;      ///< For throwing exceptions
     wxString          m_path;       ///< Root project path for loading child sheets.
     const PROPERTIES* m_props;      ///< Passed via Save() or Load(), no ownership, may be NULL.
     KIWAY*            m_kiway;      ///< Required for path to legacy component libraries.
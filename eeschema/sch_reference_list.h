@@ -64,6 +64,8 @@ class SCH_REFERENCE
                                         ///< per package.
     SCH_SHEET_PATH m_SheetPath;         ///< The sheet path for this reference.
     bool           m_IsNew;             ///< True if not yet annotated.
+    bool           m_Changed;           ///< True if SCH_REFERENCE_LIST::Annotate() has changed
+                                        ///< the reference number or the unit.
     int            m_SheetNum;          ///< The sheet number for the reference.
     time_t         m_TimeStamp;         ///< The time stamp for the reference.
     EDA_TEXT*      m_Value;             ///< The component value of the reference.  It is the
@@ -84,6 +86,7 @@ public:
         m_Unit         = 0;
         m_TimeStamp    = 0;
         m_IsNew        = false;
+        m_Changed      = false;
         m_Value        = NULL;
         m_NumRef       = 0;
         m_Flag         = 0;
@@ -270,14 +273,17 @@ public:
      * Updates the reference components for the schematic project (or the current sheet)
      * Note: this function does not calculate the reference numbers stored in m_NumRef
      * So, it must be called after calculation of new reference numbers
+     * @param aChangedOnly = true to update only the components annotated by Annotate(),
+     *                       leaving the references of other components untouched.
      * @see SCH_REFERENCE::Annotate()
      */
-    void UpdateAnnotation()
+    void UpdateAnnotation( bool aChangedOnly = false )
     {
         /* update the reference numbers */
         for( unsigned ii = 0; ii < GetCount(); ii++ )
         {
-            componentFlatList[ii].Annotate();
+            if( !aChangedOnly || componentFlatList[ii].m_Changed )
+                componentFlatList[ii].Annotate();
         }
     }
 
@@ -291,6 +297,12 @@ public:
      *      to SCH_REFERENCE_LISTs. May be an empty map. If not empty, any multi-unit parts
      *      found in this map will be annotated as a group rather than individually.
      * <p>
+     * Only the components not yet annotated get a reference number, the others keep theirs
+     * and are used to find the numbers and units in use.  The list is indexed by reference
+     * prefix, number and part once, so annotation time grows almost linearly with the number
+     * of components.  Call UpdateAnnotation( true ) to apply only the changed references.
+     * </p>
+     * <p>
      * If a the sheet number is 2 and \a aSheetIntervalId is 100, then the first reference
      * designator would be 201 and the last reference designator would be 299 when no overlap
      * occurs with sheet number 3.  If there are 150 items in sheet number 2, then items are
@@ -400,17 +412,6 @@ public:
         sort( componentFlatList.begin(), componentFlatList.end(), sortByReferenceOnly );
     }
 
-    /**
-     * Function GetUnit
-     * searches the sorted list of components for a another component with the same
-     * reference and a given part unit.  Use this method to manage components with
-     * multiple parts per package.
-     * @param aIndex = index in aComponentsList for of given SCH_REFERENCE item to test.
-     * @param aUnit = the given unit number to search
-     * @return index in aComponentsList if found or -1 if not found
-     */
-    int FindUnit( size_t aIndex, int aUnit );
-
     /**
      * Function ResetHiddenReferences
      * clears the annotation for all references that have an invisible reference designator.
@@ -418,27 +419,6 @@ public:
      */
     void ResetHiddenReferences();
 
-    /**
-     * Function GetRefsInUse
-     * adds all the reference designator numbers greater than \a aMinRefId to \a aIdList
-     * skipping the reference at \a aIndex.
-     * @param aIndex = the current component index to use for reference prefix filtering.
-     * @param aIdList = the buffer to fill
-     * @param aMinRefId = the min id value to store. all values < aMinRefId are ignored
-     */
-    void GetRefsInUse( int aIndex, std::vector< int >& aIdList, int aMinRefId );
-
-    /**
-     * Function GetLastReference
-     * returns the last used (greatest) reference number in the reference list
-     * for the prefix reference given by \a aIndex.  The component list must be
-     * sorted.
-     *
-     * @param aIndex The index of the reference item used for the search pattern.
-     * @param aMinValue The minimum value for the current search.
-     */
-    int GetLastReference( int aIndex, int aMinValue );
-
 #if defined(DEBUG)
     void Show( const char* aPrefix = "" )
     {
@@ -471,19 +451,6 @@ private:
     static bool sortByTimeStamp( const SCH_REFERENCE& item1, const SCH_REFERENCE& item2 );
 
     static bool sortByReferenceOnly( const SCH_REFERENCE& item1, const SCH_REFERENCE& item2 );
-
-    /**
-     * Function CreateFirstFreeRefId
-     * searches for the first free reference number in \a aListId of reference numbers in use.
-     * This function just searches for a hole in a list of incremented numbers, this list must
-     * be sorted by increasing values and each value can be stored only once.  The new value
-     * is added to the list.
-     * @see BuildRefIdInUseList to prepare this list
-     * @param aIdList The buffer that contains the reference numbers in use.
-     * @param aFirstValue The first expected free value
-     * @return The first free (not yet used) value.
-     */
-    int CreateFirstFreeRefId( std::vector<int>& aIdList, int aFirstValue );
 };
 
 #endif    // _SCH_REFERENCE_LIST_H_
@@ -43,6 +43,8 @@
 
 #include <netlist.h>
 #include <class_netlist_object.h>
+#include <sch_screen_connectivity.h>
+#include <sch_screen_index.h>
 #include <class_library.h>
 #include <sch_junction.h>
 #include <sch_bus_entry.h>
@@ -54,6 +56,8 @@
 #include <sch_text.h>
 #include <lib_pin.h>
 
+#include <algorithm>
+
 
 #define EESCHEMA_FILE_STAMP   "EESchema"
 
@@ -124,6 +128,73 @@ SCH_SCREEN::~SCH_SCREEN()
 }
 
 
+const NETLIST_OBJECT_LIST& SCH_SCREEN::GetConnectivity( SCH_SHEET_PATH* aSheetPath )
+{
+    if( !m_connectivity )
+        m_connectivity.reset( new SCH_SCREEN_CONNECTIVITY( this ) );
+
+    return m_connectivity->GetItems( aSheetPath );
+}
+
+
+void SCH_SCREEN::SetConnectivityDirty()
+{
+    if( m_connectivity )
+        m_connectivity->SetDirty();
+}
+
+
+void SCH_SCREEN::itemsChanged()
+{
+    SetConnectivityDirty();
+
+    if( m_index )
+        m_index->Clear();
+}
+
+
+/**
+ * Function drawListItem
+ * returns the draw list item containing \a aItem (fields and sheet pins belong to their
+ * parents).
+ */
+static SCH_ITEM* drawListItem( SCH_ITEM* aItem )
+{
+    if( aItem && ( aItem->Type() == SCH_FIELD_T || aItem->Type() == SCH_SHEET_PIN_T ) )
+        return (SCH_ITEM*) aItem->GetParent();
+
+    return aItem;
+}
+
+
+void SCH_SCREEN::SetCurItem( SCH_ITEM* aItem )
+{
+    BASE_SCREEN::SetCurItem( (EDA_ITEM*) aItem );
+
+    // The current item may be moved or edited without notifying the screen
+    if( m_index )
+        m_index->SetVolatileItem( drawListItem( aItem ) );
+}
+
+
+std::vector<SCH_ITEM*> SCH_SCREEN::getItemsAt( const wxPoint& aPosition, int aAccuracy ) const
+{
+    if( !m_index )
+        m_index.reset( new SCH_SCREEN_INDEX );
+
+    if( !m_index->IsValid() )
+    {
+        m_index->Build( m_drawList.begin() );
+        m_index->SetVolatileItem( drawListItem( GetCurItem() ) );
+    }
+
+    std::vector<SCH_ITEM*> items;
+    m_index->Query( aPosition, aAccuracy, items );
+
+    return items;
+}
+
+
 void SCH_SCREEN::IncRefCount()
 {
     m_refCount++;
@@ -152,12 +223,14 @@ void SCH_SCREEN::Clear()
 void SCH_SCREEN::FreeDrawList()
 {
     m_drawList.DeleteAll();
+    itemsChanged();
 }
 
 
 void SCH_SCREEN::Remove( SCH_ITEM* aItem )
 {
     m_drawList.Remove( aItem );
+    itemsChanged();
 }
 
 
@@ -202,7 +275,7 @@ bool SCH_SCREEN::CheckIfOnDrawList( SCH_ITEM* aItem )
 
 SCH_ITEM* SCH_SCREEN::GetItem( const wxPoint& aPosition, int aAccuracy, KICAD_T aType ) const
 {
-    for( SCH_ITEM* item = m_drawList.begin(); item; item = item->Next() )
+    for( SCH_ITEM* item : getItemsAt( aPosition, aAccuracy ) )
     {
         if( item->HitTest( aPosition, aAccuracy ) && (aType == NOT_USED) )
             return item;
@@ -263,6 +336,8 @@ void SCH_SCREEN::ExtractWires( DLIST< SCH_ITEM >& aList, bool aCreateCopy )
             break;
         }
     }
+
+    itemsChanged();
 }
 
 
@@ -289,6 +364,7 @@ void SCH_SCREEN::ReplaceWires( DLIST< SCH_ITEM >& aWireList )
     }
 
     m_drawList.Append( aWireList );
+    itemsChanged();
 }
 
 
@@ -551,6 +627,9 @@ void SCH_SCREEN::CheckComponentsToPartsLinks()
 
             m_modification_sync = mod_hash;     // note the last mod_hash
 
+            // Components might have different pins now
+            itemsChanged();
+
             // guard against unneeded runs through this code path by printing trace
             DBG(printf("%s: resync-ing %s\n", __func__, TO_UTF8( GetFileName() ) );)
         }
@@ -631,11 +710,10 @@ void SCH_SCREEN::ClearDrawingState()
 LIB_PIN* SCH_SCREEN::GetPin( const wxPoint& aPosition, SCH_COMPONENT** aComponent,
                              bool aEndPointOnly ) const
 {
-    SCH_ITEM*       item;
     SCH_COMPONENT*  component = NULL;
     LIB_PIN*        pin = NULL;
 
-    for( item = m_drawList.begin(); item; item = item->Next() )
+    for( SCH_ITEM* item : getItemsAt( aPosition ) )
     {
         if( item->Type() != SCH_COMPONENT_T )
             continue;
@@ -705,7 +783,7 @@ SCH_SHEET_PIN* SCH_SCREEN::GetSheetLabel( const wxPoint& aPosition )
 {
     SCH_SHEET_PIN* sheetPin = NULL;
 
-    for( SCH_ITEM* item = m_drawList.begin(); item; item = item->Next() )
+    for( SCH_ITEM* item : getItemsAt( aPosition ) )
     {
         if( item->Type() != SCH_SHEET_T )
             continue;
@@ -723,10 +801,9 @@ SCH_SHEET_PIN* SCH_SCREEN::GetSheetLabel( const wxPoint& aPosition )
 
 int SCH_SCREEN::CountConnectedItems( const wxPoint& aPos, bool aTestJunctions ) const
 {
-    SCH_ITEM* item;
-    int       count = 0;
+    int count = 0;
 
-    for( item = m_drawList.begin(); item; item = item->Next() )
+    for( SCH_ITEM* item : getItemsAt( aPos ) )
     {
         if( item->Type() == SCH_JUNCTION_T  && !aTestJunctions )
             continue;
@@ -837,11 +914,10 @@ void SCH_SCREEN::SelectBlockItems()
 
 void SCH_SCREEN::addConnectedItemsToBlock( const wxPoint& position )
 {
-    SCH_ITEM* item;
     ITEM_PICKER picker;
     bool addinlist = true;
 
-    for( item = m_drawList.begin(); item; item = item->Next() )
+    for( SCH_ITEM* item : getItemsAt( position ) )
     {
         picker.SetItem( item );
 
@@ -924,9 +1000,74 @@ bool SCH_SCREEN::TestDanglingEnds()
     for( item = m_drawList.begin(); item; item = item->Next() )
         item->GetEndPoints( endPoints );
 
+    // Index the end points, so every item is tested only against the end points located
+    // at its own ends. Wire and bus ends are kept in pairs, because items connected to
+    // the middle of a segment need both ends.
+    RTree<unsigned, int, 2, double> endPointTree;
+
+    for( unsigned ii = 0; ii < endPoints.size(); ii++ )
+    {
+        DANGLING_END_T type = endPoints[ii].GetType();
+        bool isSegment = ( type == WIRE_START_END || type == BUS_START_END )
+                         && ii + 1 < endPoints.size();
+        wxPoint start = endPoints[ii].GetPosition();
+        wxPoint end = isSegment ? endPoints[ii + 1].GetPosition() : start;
+
+        const int min[2] = { std::min( start.x, end.x ), std::min( start.y, end.y ) };
+        const int max[2] = { std::max( start.x, end.x ), std::max( start.y, end.y ) };
+
+        endPointTree.Insert( min, max, ii );
+
+        if( isSegment )
+            ii++;
+    }
+
+    std::vector< DANGLING_END_ITEM > itemEnds;
+    std::vector< DANGLING_END_ITEM > nearEnds;
+    std::vector< unsigned > found;
+
+    auto visitor = [&found]( unsigned aIndex )
+    {
+        found.push_back( aIndex );
+        return true;
+    };
+
     for( item = m_drawList.begin(); item; item = item->Next() )
     {
-        if( item->IsDanglingStateChanged( endPoints ) )
+        itemEnds.clear();
+        nearEnds.clear();
+        found.clear();
+
+        item->GetEndPoints( itemEnds );
+
+        if( !itemEnds.empty() )
+        {
+            EDA_RECT area( itemEnds[0].GetPosition(), wxSize( 0, 0 ) );
+
+            for( const DANGLING_END_ITEM& end : itemEnds )
+                area.Merge( end.GetPosition() );
+
+            const int min[2] = { area.GetX(), area.GetY() };
+            const int max[2] = { area.GetRight(), area.GetBottom() };
+
+            endPointTree.Search( min, max, visitor );
+
+            // Keep the original order, segment ends have to follow their starts
+            std::sort( found.begin(), found.end() );
+
+            for( unsigned ii : found )
+            {
+                nearEnds.push_back( endPoints[ii] );
+
+                DANGLING_END_T type = endPoints[ii].GetType();
+
+                if( ( type == WIRE_START_END || type == BUS_START_END )
+                    && ii + 1 < endPoints.size() )
+                    nearEnds.push_back( endPoints[ii + 1] );
+            }
+        }
+
+        if( item->IsDanglingStateChanged( nearEnds ) )
             hasStateChanged = true;
     }
 
@@ -959,6 +1100,9 @@ bool SCH_SCREEN::BreakSegment( const wxPoint& aPoint )
         brokenSegments = true;
     }
 
+    if( brokenSegments )
+        itemsChanged();
+
     return brokenSegments;
 }
 
@@ -994,7 +1138,7 @@ bool SCH_SCREEN::BreakSegmentsOnJunctions()
 
 int SCH_SCREEN::GetNode( const wxPoint& aPosition, EDA_ITEMS& aList )
 {
-    for( SCH_ITEM* item = m_drawList.begin(); item; item = item->Next() )
+    for( SCH_ITEM* item : getItemsAt( aPosition ) )
     {
         if( item->Type() == SCH_LINE_T && item->HitTest( aPosition )
             && (item->GetLayer() == LAYER_BUS || item->GetLayer() == LAYER_WIRE) )
@@ -1013,7 +1157,7 @@ int SCH_SCREEN::GetNode( const wxPoint& aPosition, EDA_ITEMS& aList )
 
 SCH_LINE* SCH_SCREEN::GetWireOrBus( const wxPoint& aPosition )
 {
-    for( SCH_ITEM* item = m_drawList.begin(); item; item = item->Next() )
+    for( SCH_ITEM* item : getItemsAt( aPosition ) )
     {
         if( (item->Type() == SCH_LINE_T) && item->HitTest( aPosition )
             && (item->GetLayer() == LAYER_BUS || item->GetLayer() == LAYER_WIRE) )
@@ -1029,7 +1173,7 @@ SCH_LINE* SCH_SCREEN::GetWireOrBus( const wxPoint& aPosition )
 SCH_LINE* SCH_SCREEN::GetLine( const wxPoint& aPosition, int aAccuracy, int aLayer,
                                SCH_LINE_TEST_T aSearchType )
 {
-    for( SCH_ITEM* item = m_drawList.begin(); item; item = item->Next() )
+    for( SCH_ITEM* item : getItemsAt( aPosition, aAccuracy ) )
     {
         if( item->Type() != SCH_LINE_T )
             continue;
@@ -1062,7 +1206,7 @@ SCH_LINE* SCH_SCREEN::GetLine( const wxPoint& aPosition, int aAccuracy, int aLay
 
 SCH_TEXT* SCH_SCREEN::GetLabel( const wxPoint& aPosition, int aAccuracy )
 {
-    for( SCH_ITEM* item = m_drawList.begin(); item; item = item->Next() )
+    for( SCH_ITEM* item : getItemsAt( aPosition, aAccuracy ) )
     {
         switch( item->Type() )
         {
@@ -0,0 +1,97 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file sch_screen_connectivity.cpp
+ */
+
+#include <fctsys.h>
+#include <project.h>
+#include <class_sch_screen.h>
+#include <class_library.h>
+#include <class_netlist_object.h>
+#include <sch_component.h>
+#include <sch_screen_connectivity.h>
+
+
+SCH_SCREEN_CONNECTIVITY::SCH_SCREEN_CONNECTIVITY( SCH_SCREEN* aScreen ) :
+    m_screen( aScreen ), m_libHash( 0 )
+{
+}
+
+
+SCH_SCREEN_CONNECTIVITY::~SCH_SCREEN_CONNECTIVITY()
+{
+}
+
+
+const NETLIST_OBJECT_LIST& SCH_SCREEN_CONNECTIVITY::GetItems( SCH_SHEET_PATH* aSheetPath )
+{
+    int libHash = m_screen->Prj().SchLibs()->GetModifyHash();
+
+    if( libHash != m_libHash )
+    {
+        SetDirty();
+        m_libHash = libHash;
+    }
+
+    std::vector<int> units = getUnitSelections( aSheetPath );
+
+    for( const VARIANT& variant : m_variants )
+    {
+        if( variant.m_units == units )
+            return *variant.m_items;
+    }
+
+    VARIANT variant;
+    variant.m_units = units;
+    variant.m_items.reset( new NETLIST_OBJECT_LIST() );
+
+    for( SCH_ITEM* item = m_screen->GetDrawItems(); item; item = item->Next() )
+        item->GetNetListItem( *variant.m_items, aSheetPath );
+
+    variant.m_items->BuildSheetConnections();
+    m_variants.push_back( std::move( variant ) );
+
+    return *m_variants.back().m_items;
+}
+
+
+void SCH_SCREEN_CONNECTIVITY::SetDirty()
+{
+    m_variants.clear();
+}
+
+
+std::vector<int> SCH_SCREEN_CONNECTIVITY::getUnitSelections( SCH_SHEET_PATH* aSheetPath ) const
+{
+    std::vector<int> units;
+
+    for( SCH_ITEM* item = m_screen->GetDrawItems(); item; item = item->Next() )
+    {
+        if( item->Type() == SCH_COMPONENT_T )
+            units.push_back( static_cast<SCH_COMPONENT*>( item )->GetUnitSelection( aSheetPath ) );
+    }
+
+    return units;
+}
@@ -0,0 +1,93 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file sch_screen_connectivity.h
+ * @brief Connections made by the items of a single schematic screen.
+ */
+
+#ifndef SCH_SCREEN_CONNECTIVITY_H
+#define SCH_SCREEN_CONNECTIVITY_H
+
+#include <memory>
+#include <vector>
+
+class NETLIST_OBJECT_LIST;
+class SCH_SCREEN;
+class SCH_SHEET_PATH;
+
+
+/**
+ * Class SCH_SCREEN_CONNECTIVITY
+ * keeps the connected items (wires, buses, junctions, labels, pins and sheet pins) of a screen
+ * with the connections made inside the screen already found, so they are not searched again
+ * for every netlist, ERC or highlight request. The connections between sheets are made when
+ * the items of all the sheet instances are merged (see NETLIST_OBJECT_LIST::BuildNetListInfo()).
+ *
+ * The items are rebuilt after the screen has been modified (see SCH_SCREEN::SetModify()).
+ */
+class SCH_SCREEN_CONNECTIVITY
+{
+public:
+    SCH_SCREEN_CONNECTIVITY( SCH_SCREEN* aScreen );
+
+    ~SCH_SCREEN_CONNECTIVITY();
+
+    /**
+     * Function GetItems
+     * returns the connected items of the screen for a sheet instance. Items connected together
+     * have the same net code (or bus net code), codes are local to the screen.
+     * Item sheet paths are the paths of the instance the items were built for, they have to be
+     * replaced by the actual instance path.
+     * @param aSheetPath is the instance of the screen.
+     */
+    const NETLIST_OBJECT_LIST& GetItems( SCH_SHEET_PATH* aSheetPath );
+
+    /**
+     * Function SetDirty
+     * removes the stored items, so they are rebuilt when requested next time.
+     */
+    void SetDirty();
+
+private:
+    ///> Items built for a set of component unit selections. Components may use different
+    ///> units in every sheet instance, so a single screen might have different pins.
+    struct VARIANT
+    {
+        std::vector<int> m_units;
+        std::unique_ptr<NETLIST_OBJECT_LIST> m_items;
+    };
+
+    ///> Returns the unit selected by each component of the screen for a sheet instance.
+    std::vector<int> getUnitSelections( SCH_SHEET_PATH* aSheetPath ) const;
+
+    ///> Screen containing the items
+    SCH_SCREEN* m_screen;
+
+    ///> Library modification hash, pins have to be rebuilt when libraries change
+    int m_libHash;
+
+    std::vector<VARIANT> m_variants;
+};
+
+#endif /* SCH_SCREEN_CONNECTIVITY_H */
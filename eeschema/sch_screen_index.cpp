@@ -0,0 +1,152 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file sch_screen_index.cpp
+ */
+
+#include <fctsys.h>
+#include <sch_item_struct.h>
+#include <sch_sheet.h>
+#include <sch_screen_index.h>
+
+#include <algorithm>
+
+
+SCH_SCREEN_INDEX::SCH_SCREEN_INDEX() :
+    m_volatileItem( NULL ), m_valid( false )
+{
+}
+
+
+void SCH_SCREEN_INDEX::Build( SCH_ITEM* aFirst )
+{
+    Clear();
+
+    unsigned order = 0;
+
+    for( SCH_ITEM* item = aFirst; item; item = item->Next() )
+    {
+        ENTRY& entry = m_entries[item];
+        entry.m_order = order++;
+        insert( item, entry );
+    }
+
+    m_valid = true;
+}
+
+
+void SCH_SCREEN_INDEX::Clear()
+{
+    m_tree.RemoveAll();
+    m_entries.clear();
+    m_volatileItem = NULL;
+    m_valid = false;
+}
+
+
+void SCH_SCREEN_INDEX::SetVolatileItem( SCH_ITEM* aItem )
+{
+    if( !m_valid || aItem == m_volatileItem )
+        return;
+
+    // The previous item has been placed, it can be found by its new bounding box
+    if( m_volatileItem )
+        insert( m_volatileItem, m_entries[m_volatileItem] );
+
+    m_volatileItem = NULL;
+
+    auto it = aItem ? m_entries.find( aItem ) : m_entries.end();
+
+    // Items that are not indexed are not in the draw list, they cannot be found
+    if( it == m_entries.end() )
+        return;
+
+    m_tree.Remove( it->second.m_min, it->second.m_max, aItem );
+    m_volatileItem = aItem;
+}
+
+
+void SCH_SCREEN_INDEX::Query( const wxPoint& aPosition, int aAccuracy,
+                              std::vector<SCH_ITEM*>& aItems )
+{
+    const int min[2] = { aPosition.x - aAccuracy, aPosition.y - aAccuracy };
+    const int max[2] = { aPosition.x + aAccuracy, aPosition.y + aAccuracy };
+
+    auto visitor = [&aItems]( SCH_ITEM* aItem )
+    {
+        aItems.push_back( aItem );
+        return true;
+    };
+
+    m_tree.Search( min, max, visitor );
+
+    if( m_volatileItem )
+        aItems.push_back( m_volatileItem );
+
+    // Callers expect the same item as found by walking the draw list
+    std::sort( aItems.begin(), aItems.end(),
+            [this]( SCH_ITEM* aFirst, SCH_ITEM* aSecond )
+            {
+                return m_entries[aFirst].m_order < m_entries[aSecond].m_order;
+            } );
+}
+
+
+EDA_RECT SCH_SCREEN_INDEX::GetItemArea( SCH_ITEM* aItem )
+{
+    EDA_RECT area = aItem->GetBoundingBox();
+    area.Normalize();
+
+    // Sheet pins are hit tested with the sheet
+    if( aItem->Type() == SCH_SHEET_T )
+    {
+        for( SCH_SHEET_PIN& pin : static_cast<SCH_SHEET*>( aItem )->GetPins() )
+        {
+            EDA_RECT pinArea = pin.GetBoundingBox();
+            pinArea.Normalize();
+            area.Merge( pinArea );
+        }
+    }
+
+    std::vector<wxPoint> points;
+    aItem->GetConnectionPoints( points );
+
+    for( const wxPoint& point : points )
+        area.Merge( point );
+
+    return area;
+}
+
+
+void SCH_SCREEN_INDEX::insert( SCH_ITEM* aItem, ENTRY& aEntry )
+{
+    EDA_RECT area = GetItemArea( aItem );
+
+    aEntry.m_min[0] = area.GetX();
+    aEntry.m_min[1] = area.GetY();
+    aEntry.m_max[0] = area.GetRight();
+    aEntry.m_max[1] = area.GetBottom();
+
+    m_tree.Insert( aEntry.m_min, aEntry.m_max, aItem );
+}
@@ -0,0 +1,123 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file sch_screen_index.h
+ * @brief Spatial index of the items of a schematic screen.
+ */
+
+#ifndef SCH_SCREEN_INDEX_H
+#define SCH_SCREEN_INDEX_H
+
+#include <unordered_map>
+#include <vector>
+
+#include <wx/gdicmn.h>
+
+#include <geometry/rtree.h>
+
+class EDA_RECT;
+class SCH_ITEM;
+
+
+/**
+ * Class SCH_SCREEN_INDEX
+ * is an R-tree of the items of a screen draw list, used to find the items located at a point
+ * without testing every item of the screen.
+ *
+ * The index is built when it is queried for the first time and has to be cleared whenever
+ * items are added, removed or modified (see SCH_SCREEN::SetModify()). The item being edited
+ * (the current item of the screen) may be moved without notifying the screen, so it is taken
+ * out of the tree and returned by every query until another item becomes the current one.
+ */
+class SCH_SCREEN_INDEX
+{
+public:
+    SCH_SCREEN_INDEX();
+
+    /**
+     * Function IsValid
+     * @return true if the index has been built and not cleared since.
+     */
+    bool IsValid() const { return m_valid; }
+
+    /**
+     * Function Build
+     * indexes items of a draw list.
+     * @param aFirst is the first item of the draw list.
+     */
+    void Build( SCH_ITEM* aFirst );
+
+    /**
+     * Function Clear
+     * removes all items, so the index is rebuilt before the next query.
+     */
+    void Clear();
+
+    /**
+     * Function SetVolatileItem
+     * sets the item that may be modified without notifying the screen. The previous volatile
+     * item is put back in the tree, using its current bounding box.
+     * @param aItem is a draw list item or NULL.
+     */
+    void SetVolatileItem( SCH_ITEM* aItem );
+
+    /**
+     * Function Query
+     * finds the items that might be located at a point.
+     * @param aPosition is the tested point.
+     * @param aAccuracy is the distance from aPosition an item may be found at.
+     * @param aItems is filled with the items, in the draw list order. Items have to be
+     *               hit tested by the caller, the index only compares bounding boxes.
+     */
+    void Query( const wxPoint& aPosition, int aAccuracy, std::vector<SCH_ITEM*>& aItems );
+
+    /**
+     * Function GetItemArea
+     * returns the area an item may be hit or connected in (its bounding box, including
+     * component fields, sheet pins and connection points).
+     */
+    static EDA_RECT GetItemArea( SCH_ITEM* aItem );
+
+private:
+    struct ENTRY
+    {
+        unsigned    m_order;                ///< Position in the draw list
+        int         m_min[2];               ///< Indexed bounding box
+        int         m_max[2];
+    };
+
+    ///> Inserts an item to the tree
+    void insert( SCH_ITEM* aItem, ENTRY& aEntry );
+
+    RTree<SCH_ITEM*, int, 2, double> m_tree;
+
+    std::unordered_map<SCH_ITEM*, ENTRY> m_entries;
+
+    ///> Item taken out of the tree, it is always returned by queries
+    SCH_ITEM* m_volatileItem;
+
+    bool m_valid;
+};
+
+#endif /* SCH_SCREEN_INDEX_H */
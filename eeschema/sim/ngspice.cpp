@@ -273,7 +273,8 @@ void NGSPICE::init()
         return;
 
     LOCALE_IO c_locale;               // ngspice works correctly only with C locale
-    ngSpice_Init( &cbSendChar, &cbSendStat, &cbControlledExit, NULL, NULL, &cbBGThreadRunning, this );
+    ngSpice_Init( &cbSendChar, &cbSendStat, &cbControlledExit, &cbSendData, &cbSendInitData,
+                  &cbBGThreadRunning, this );
 
     // Load a custom spinit file, to fix the problem with loading .cm files
     // Switch to the executable directory, so the relative paths are correct
@@ -420,6 +421,49 @@ int NGSPICE::cbBGThreadRunning( bool is_running, int id, void* user )
 }
 
 
+int NGSPICE::cbSendData( pvecvaluesall aValues, int aCount, int aId, void* aUser )
+{
+    // Called from the simulator thread for every computed point
+    NGSPICE* sim = reinterpret_cast<NGSPICE*>( aUser );
+    int scale = -1;
+
+    sim->m_row.resize( aValues->veccount );
+
+    for( int i = 0; i < aValues->veccount; i++ )
+    {
+        const vecvalues* value = aValues->vecsa[i];
+
+        sim->m_row[i] = COMPLEX( value->creal, value->is_complex ? value->cimag : 0.0 );
+
+        if( value->is_scale )
+            scale = i;
+    }
+
+    sim->m_dataStream.AppendRow( sim->m_row, scale );
+
+    return 0;
+}
+
+
+int NGSPICE::cbSendInitData( pvecinfoall aInfo, int aId, void* aUser )
+{
+    // Called from the simulator thread when a new simulation starts
+    NGSPICE* sim = reinterpret_cast<NGSPICE*>( aUser );
+    std::vector<std::string> names;
+    std::vector<bool> complex;
+
+    for( int i = 0; i < aInfo->veccount; i++ )
+    {
+        names.push_back( aInfo->vecs[i]->vecname );
+        complex.push_back( !aInfo->vecs[i]->is_real );
+    }
+
+    sim->m_dataStream.Reset( names, complex );
+
+    return 0;
+}
+
+
 int NGSPICE::cbControlledExit( int status, bool immediate, bool exit_upon_quit, int id, void* user )
 {
     // Something went wrong, reload the dll
@@ -91,11 +91,16 @@ private:
     static int cbSendStat( char* what, int id, void* user );
     static int cbBGThreadRunning( bool is_running, int id, void* user );
     static int cbControlledExit( int status, bool immediate, bool exit_upon_quit, int id, void* user );
+    static int cbSendData( pvecvaluesall aValues, int aCount, int aId, void* aUser );
+    static int cbSendInitData( pvecinfoall aInfo, int aId, void* aUser );
 
     void dump();
 
     ///> NGspice should be initialized only once
     static bool m_initialized;
+
+    ///> Values of the current simulation step, used by the simulator thread only
+    std::vector<COMPLEX> m_row;
 };
 
 #endif /* NGSPICE_H */
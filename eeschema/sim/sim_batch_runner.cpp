@@ -0,0 +1,524 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 CERN
+ * @author Maciej Suminski <maciej.suminski@cern.ch>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * https://www.gnu.org/licenses/gpl-3.0.html
+ * or you may search the http://www.gnu.org website for the version 3 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+#include "sim_batch_runner.h"
+
+#include <wx/ffile.h>
+#include <wx/filefn.h>
+#include <wx/filename.h>
+#include <wx/process.h>
+#include <wx/textfile.h>
+#include <wx/tokenzr.h>
+#include <wx/utils.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <thread>
+
+
+/**
+ * @brief ngspice process executing a single run. Notifies the runner when it terminates.
+ */
+class SIM_BATCH_PROCESS : public wxProcess
+{
+public:
+    SIM_BATCH_PROCESS( SIM_BATCH_RUNNER* aRunner, int aRun )
+        : m_runner( aRunner ), m_run( aRun ), m_pid( 0 )
+    {
+    }
+
+    void OnTerminate( int aPid, int aStatus ) override
+    {
+        // The runner is reset when the batch is cancelled
+        if( m_runner )
+            m_runner->onRunFinished( this, aStatus );
+
+        delete this;
+    }
+
+    SIM_BATCH_RUNNER* m_runner;
+    int m_run;
+    long m_pid;
+};
+
+
+SIM_BATCH_RUNNER::SIM_BATCH_RUNNER( const wxString& aNetlist,
+        const std::vector<wxString>& aVectors, bool aComplex )
+    : m_netlist( aNetlist ), m_vectors( aVectors ), m_complex( aComplex ),
+      m_executable( "ngspice" ), m_nextRun( 0 ), m_running( 0 ), m_maxProcesses( 1 )
+{
+}
+
+
+SIM_BATCH_RUNNER::~SIM_BATCH_RUNNER()
+{
+    Cancel();
+}
+
+
+std::vector<SIM_BATCH_RUNNER::RUN_VALUES> SIM_BATCH_RUNNER::MakeSweep(
+        const std::vector<VARIATION>& aVariations, int aSteps )
+{
+    std::vector<RUN_VALUES> runs;
+
+    if( aVariations.empty() || aSteps < 1 )
+        return runs;
+
+    // Step index for every variation, incremented like the digits of a number
+    std::vector<int> steps( aVariations.size(), 0 );
+
+    while( true )
+    {
+        RUN_VALUES values;
+
+        for( unsigned int i = 0; i < aVariations.size(); ++i )
+        {
+            const VARIATION& var = aVariations[i];
+            double min = var.m_min.ToDouble();
+            double max = var.m_max.ToDouble();
+            double value = aSteps > 1 ? min + ( max - min ) * steps[i] / ( aSteps - 1 ) : min;
+
+            values.emplace_back( var.m_device, SPICE_VALUE( value ) );
+        }
+
+        runs.push_back( values );
+
+        unsigned int digit = 0;
+
+        while( digit < steps.size() && ++steps[digit] == aSteps )
+            steps[digit++] = 0;
+
+        if( digit == steps.size() )
+            break;
+    }
+
+    return runs;
+}
+
+
+std::vector<SIM_BATCH_RUNNER::RUN_VALUES> SIM_BATCH_RUNNER::MakeMonteCarlo(
+        const std::vector<VARIATION>& aVariations, int aCount, unsigned int aSeed )
+{
+    std::vector<RUN_VALUES> runs;
+    std::mt19937 generator( aSeed );
+
+    for( int run = 0; run < aCount; ++run )
+    {
+        RUN_VALUES values;
+
+        for( const auto& var : aVariations )
+        {
+            double min = std::min( var.m_min.ToDouble(), var.m_max.ToDouble() );
+            double max = std::max( var.m_min.ToDouble(), var.m_max.ToDouble() );
+            std::uniform_real_distribution<double> distribution( min, max );
+
+            values.emplace_back( var.m_device, SPICE_VALUE( distribution( generator ) ) );
+        }
+
+        runs.push_back( values );
+    }
+
+    return runs;
+}
+
+
+bool SIM_BATCH_RUNNER::Start( const std::vector<RUN_VALUES>& aRuns,
+        std::function<void()> aFinished, int aMaxProcesses )
+{
+    if( IsRunning() || aRuns.empty() || m_vectors.empty() )
+        return false;
+
+    m_filePrefix = wxFileName::CreateTempFileName( "kicad_sim" );
+
+    if( m_filePrefix.IsEmpty() )
+        return false;
+
+    RESULT failed;
+    failed.m_ok = false;
+
+    m_runs = aRuns;
+    m_results.assign( m_runs.size(), failed );
+    m_finished = aFinished;
+    m_nextRun = 0;
+    m_maxProcesses = aMaxProcesses > 0 ? aMaxProcesses
+                                       : std::max<int>( 1, std::thread::hardware_concurrency() );
+
+    while( m_running < m_maxProcesses && launchNext() )
+        ;
+
+    // Nothing could be started, most likely the simulator executable is missing
+    if( !IsRunning() )
+    {
+        Cancel();
+        return false;
+    }
+
+    return true;
+}
+
+
+void SIM_BATCH_RUNNER::Cancel()
+{
+    m_nextRun = m_runs.size();
+
+    for( auto process : m_processes )
+    {
+        // The process object deletes itself once the process is terminated
+        process->m_runner = nullptr;
+        wxProcess::Kill( process->m_pid, wxSIGKILL );
+        removeRunFiles( process->m_run );
+    }
+
+    m_processes.clear();
+    m_running = 0;
+
+    if( !m_filePrefix.IsEmpty() )
+    {
+        wxRemoveFile( m_filePrefix );
+        m_filePrefix.Clear();
+    }
+}
+
+
+int SIM_BATCH_RUNNER::GetFailedCount() const
+{
+    return std::count_if( m_results.begin(), m_results.end(),
+                          []( const RESULT& aResult ) { return !aResult.m_ok; } );
+}
+
+
+SIM_BATCH_RUNNER::SUMMARY SIM_BATCH_RUNNER::GetSummary( int aVector, METRIC aMetric ) const
+{
+    SUMMARY summary = { 0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+    std::vector<double> values;
+
+    for( const auto& result : m_results )
+    {
+        if( result.m_ok )
+            values.push_back( result.m_metrics[aVector * METRIC_COUNT + aMetric] );
+    }
+
+    if( values.empty() )
+        return summary;
+
+    std::sort( values.begin(), values.end() );
+
+    // Linear interpolation between the closest ranks
+    auto percentile = [&]( double aFraction ) {
+        double rank = aFraction * ( values.size() - 1 );
+        size_t lower = (size_t) std::floor( rank );
+        size_t upper = std::min( lower + 1, values.size() - 1 );
+
+        return values[lower] + ( values[upper] - values[lower] ) * ( rank - lower );
+    };
+
+    summary.m_count = values.size();
+    summary.m_min = values.front();
+    summary.m_p5 = percentile( 0.05 );
+    summary.m_median = percentile( 0.5 );
+    summary.m_p95 = percentile( 0.95 );
+    summary.m_max = values.back();
+
+    return summary;
+}
+
+
+wxString SIM_BATCH_RUNNER::FormatSummary() const
+{
+    wxString out = wxString::Format( "%lu runs, %d failed\n",
+                                     (unsigned long) m_results.size(), GetFailedCount() );
+
+    out += wxString::Format( "%-24s %-8s %12s %12s %12s %12s %12s\n",
+                             "Vector", "Metric", "Min", "5%", "Median", "95%", "Max" );
+
+    for( unsigned int vec = 0; vec < m_vectors.size(); ++vec )
+    {
+        for( int metric = 0; metric < METRIC_COUNT; ++metric )
+        {
+            SUMMARY s = GetSummary( vec, (METRIC) metric );
+
+            out += wxString::Format( "%-24s %-8s %12g %12g %12g %12g %12g\n",
+                                     m_vectors[vec], GetMetricName( (METRIC) metric ),
+                                     s.m_min, s.m_p5, s.m_median, s.m_p95, s.m_max );
+        }
+    }
+
+    return out;
+}
+
+
+bool SIM_BATCH_RUNNER::WriteCsv( const wxString& aFileName ) const
+{
+    const wxChar SEPARATOR = ';';
+    wxFFile out( aFileName, "wb" );
+
+    if( !out.IsOpened() )
+        return false;
+
+    wxString line = "Run";
+
+    if( !m_runs.empty() )
+    {
+        for( const auto& value : m_runs[0] )
+            line += SEPARATOR + value.first;
+    }
+
+    for( const auto& vector : m_vectors )
+    {
+        for( int metric = 0; metric < METRIC_COUNT; ++metric )
+            line += wxString::Format( "%c%s %s", SEPARATOR, vector,
+                                      GetMetricName( (METRIC) metric ) );
+    }
+
+    out.Write( line + "\r\n" );
+
+    for( unsigned int run = 0; run < m_runs.size(); ++run )
+    {
+        line = wxString::Format( "%u", run + 1 );
+
+        for( const auto& value : m_runs[run] )
+            line += SEPARATOR + value.second.ToSpiceString();
+
+        const RESULT& result = m_results[run];
+
+        if( result.m_ok )
+        {
+            for( double metric : result.m_metrics )
+                line += wxString::Format( "%c%g", SEPARATOR, metric );
+        }
+        else
+        {
+            line += SEPARATOR + wxString( "failed" );
+        }
+
+        out.Write( line + "\r\n" );
+    }
+
+    out.Write( wxString::Format( "\r\nVector%cMetric%cRuns%cMin%c5%%%cMedian%c95%%%cMax\r\n",
+                                 SEPARATOR, SEPARATOR, SEPARATOR, SEPARATOR, SEPARATOR,
+                                 SEPARATOR, SEPARATOR ) );
+
+    for( unsigned int vec = 0; vec < m_vectors.size(); ++vec )
+    {
+        for( int metric = 0; metric < METRIC_COUNT; ++metric )
+        {
+            SUMMARY s = GetSummary( vec, (METRIC) metric );
+
+            out.Write( wxString::Format( "%s%c%s%c%d%c%g%c%g%c%g%c%g%c%g\r\n",
+                       m_vectors[vec], SEPARATOR, GetMetricName( (METRIC) metric ), SEPARATOR,
+                       s.m_count, SEPARATOR, s.m_min, SEPARATOR, s.m_p5, SEPARATOR,
+                       s.m_median, SEPARATOR, s.m_p95, SEPARATOR, s.m_max ) );
+        }
+    }
+
+    return out.Close();
+}
+
+
+const char* SIM_BATCH_RUNNER::GetMetricName( METRIC aMetric )
+{
+    switch( aMetric )
+    {
+    case MINIMUM:   return "min";
+    case MAXIMUM:   return "max";
+    case FINAL:     return "final";
+    default:        return "unknown";
+    }
+}
+
+
+bool SIM_BATCH_RUNNER::launchNext()
+{
+    if( m_nextRun >= (int) m_runs.size() )
+        return false;
+
+    int run = m_nextRun++;
+
+    // A run that cannot be started stays marked as failed
+    wxFFile netlist( runFileName( run, "cir" ), "wb" );
+
+    if( !netlist.IsOpened() || !netlist.Write( makeNetlist( run ) ) || !netlist.Close() )
+    {
+        removeRunFiles( run );
+        return true;
+    }
+
+    wxString command = wxString::Format( "\"%s\" -b -o \"%s\" \"%s\"", m_executable,
+                                         runFileName( run, "log" ), runFileName( run, "cir" ) );
+
+    SIM_BATCH_PROCESS* process = new SIM_BATCH_PROCESS( this, run );
+    long pid = wxExecute( command, wxEXEC_ASYNC, process );
+
+    if( pid <= 0 )
+    {
+        delete process;
+        removeRunFiles( run );
+        return true;
+    }
+
+    process->m_pid = pid;
+    m_processes.push_back( process );
+    ++m_running;
+
+    return true;
+}
+
+
+void SIM_BATCH_RUNNER::onRunFinished( SIM_BATCH_PROCESS* aProcess, int aExitCode )
+{
+    int run = aProcess->m_run;
+
+    m_processes.erase( std::remove( m_processes.begin(), m_processes.end(), aProcess ),
+                       m_processes.end() );
+    --m_running;
+
+    if( aExitCode == 0 )
+        m_results[run].m_ok = readResult( run, m_results[run] );
+
+    removeRunFiles( run );
+
+    while( m_running < m_maxProcesses && launchNext() )
+        ;
+
+    if( !IsRunning() )
+    {
+        wxRemoveFile( m_filePrefix );
+        m_filePrefix.Clear();
+
+        if( m_finished )
+            m_finished();
+    }
+}
+
+
+bool SIM_BATCH_RUNNER::readResult( int aRun, RESULT& aResult ) const
+{
+    wxTextFile file( runFileName( aRun, "dat" ) );
+
+    if( !file.Exists() || !file.Open() )
+        return false;
+
+    const unsigned int vectorCount = m_vectors.size();
+    std::vector<double>& metrics = aResult.m_metrics;
+    int points = 0;
+
+    metrics.assign( vectorCount * METRIC_COUNT, 0.0 );
+
+    // With wr_singlescale set, every line holds the scale value followed by the vector values
+    for( size_t i = 0; i < file.GetLineCount(); ++i )
+    {
+        wxStringTokenizer tokenizer( file[i], " \t" );
+        std::vector<double> row;
+        double value;
+
+        while( tokenizer.HasMoreTokens() && tokenizer.GetNextToken().ToCDouble( &value ) )
+            row.push_back( value );
+
+        // Skip the header (vector names) and empty lines
+        if( row.empty() )
+            continue;
+
+        // The vectors are real, but a complex scale (frequency in AC analysis) is written
+        // as two columns: the real and the imaginary part
+        if( row.size() <= vectorCount || row.size() > vectorCount + ( m_complex ? 2 : 1 ) )
+            return false;
+
+        const size_t first = row.size() - vectorCount;
+
+        for( unsigned int vec = 0; vec < vectorCount; ++vec )
+        {
+            double* vecMetrics = &metrics[vec * METRIC_COUNT];
+            value = row[first + vec];
+
+            vecMetrics[MINIMUM] = points ? std::min( vecMetrics[MINIMUM], value ) : value;
+            vecMetrics[MAXIMUM] = points ? std::max( vecMetrics[MAXIMUM], value ) : value;
+            vecMetrics[FINAL] = value;
+        }
+
+        ++points;
+    }
+
+    return points > 0;
+}
+
+
+wxString SIM_BATCH_RUNNER::makeNetlist( int aRun ) const
+{
+    wxString dataFile = runFileName( aRun, "dat" );
+
+    // ngspice treats backslashes as escape characters
+    dataFile.Replace( "\\", "/" );
+
+    wxString control = ".control\nset wr_singlescale\nset wr_vecnames\n";
+
+    // Phases are reported in degrees, as in the plots
+    if( m_complex )
+        control += "set units=degrees\n";
+
+    for( const auto& value : m_runs[aRun] )
+        control += "alter @" + value.first + "=" + value.second.ToSpiceString() + "\n";
+
+    control += "run\nwrdata \"" + dataFile + "\"";
+
+    for( const auto& vector : m_vectors )
+        control += " " + vector;
+
+    control += "\nquit\n.endc\n";
+
+    // The control block has to be placed before the final .end line
+    wxString netlist = m_netlist;
+    size_t end = netlist.Lower().rfind( ".end" );
+
+    if( end != wxString::npos && ( end == 0 || netlist[end - 1] == '\n' )
+            && netlist.Mid( end + 4 ).Trim().IsEmpty() )
+    {
+        netlist.insert( end, control );
+    }
+    else
+    {
+        netlist += control + ".end\n";
+    }
+
+    return netlist;
+}
+
+
+wxString SIM_BATCH_RUNNER::runFileName( int aRun, const wxString& aExtension ) const
+{
+    return wxString::Format( "%s_%d.%s", m_filePrefix, aRun, aExtension );
+}
+
+
+void SIM_BATCH_RUNNER::removeRunFiles( int aRun ) const
+{
+    for( const char* ext : { "cir", "log", "dat" } )
+    {
+        wxString fileName = runFileName( aRun, ext );
+
+        if( wxFileExists( fileName ) )
+            wxRemoveFile( fileName );
+    }
+}
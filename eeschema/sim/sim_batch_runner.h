@@ -0,0 +1,224 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 CERN
+ * @author Maciej Suminski <maciej.suminski@cern.ch>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * https://www.gnu.org/licenses/gpl-3.0.html
+ * or you may search the http://www.gnu.org website for the version 3 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+#ifndef SIM_BATCH_RUNNER_H
+#define SIM_BATCH_RUNNER_H
+
+#include "spice_value.h"
+
+#include <wx/string.h>
+
+#include <functional>
+#include <utility>
+#include <vector>
+
+class SIM_BATCH_PROCESS;
+
+/**
+ * @brief Runs a netlist many times with different component values (parameter sweeps and
+ * Monte Carlo tolerance analysis) and summarizes the chosen vectors.
+ *
+ * The shared ngspice library keeps a single circuit per process, so every run is executed
+ * by a separate ngspice process in batch mode. Several processes are started at the same time
+ * (one per processor core by default); they are handled in the main thread event loop, so the
+ * user interface stays responsive while a batch is running.
+ */
+class SIM_BATCH_RUNNER
+{
+public:
+    ///> Device values applied in a single run (Spice device name, value)
+    typedef std::vector< std::pair<wxString, SPICE_VALUE> > RUN_VALUES;
+
+    ///> Range of values for a device
+    struct VARIATION
+    {
+        wxString    m_device;       ///< Spice name of the device
+        SPICE_VALUE m_min;
+        SPICE_VALUE m_max;
+    };
+
+    ///> Values computed for every vector in each run
+    enum METRIC
+    {
+        MINIMUM,
+        MAXIMUM,
+        FINAL,          ///< The last point (e.g. the steady state value)
+        METRIC_COUNT
+    };
+
+    ///> Result of a single run
+    struct RESULT
+    {
+        bool m_ok;
+
+        ///> METRIC_COUNT values for every vector
+        std::vector<double> m_metrics;
+    };
+
+    ///> Distribution of a metric over the successful runs
+    struct SUMMARY
+    {
+        int     m_count;
+        double  m_min;
+        double  m_p5;
+        double  m_median;
+        double  m_p95;
+        double  m_max;
+    };
+
+    /**
+     * @param aNetlist is the netlist to be simulated, including the simulation command.
+     * @param aVectors are the real valued Spice vector expressions to be summarized, for
+     * complex results the magnitude or phase has to be selected (e.g. mag(V(out)), ph(V(out))).
+     * @param aComplex tells if the simulation results are complex (AC analysis), in such
+     * case phases are computed in degrees.
+     */
+    SIM_BATCH_RUNNER( const wxString& aNetlist, const std::vector<wxString>& aVectors,
+                      bool aComplex );
+
+    ///> Kills the processes that are still running
+    ~SIM_BATCH_RUNNER();
+
+    /**
+     * @brief Creates runs for a parameter sweep: all combinations of aSteps values evenly
+     * spaced in the range of every variation.
+     */
+    static std::vector<RUN_VALUES> MakeSweep( const std::vector<VARIATION>& aVariations,
+                                              int aSteps );
+
+    /**
+     * @brief Creates runs for a Monte Carlo analysis: values are drawn from a uniform
+     * distribution over the range of every variation.
+     * @param aSeed initializes the random generator, so an analysis may be repeated.
+     */
+    static std::vector<RUN_VALUES> MakeMonteCarlo( const std::vector<VARIATION>& aVariations,
+                                                   int aCount, unsigned int aSeed );
+
+    ///> Sets the ngspice executable, by default it is searched in the system path
+    void SetExecutable( const wxString& aExecutable )
+    {
+        m_executable = aExecutable;
+    }
+
+    /**
+     * @brief Starts executing runs.
+     * @param aRuns are the device values for every run.
+     * @param aFinished is called (in the main thread) once all runs are finished.
+     * @param aMaxProcesses is the number of processes running at the same time, 0 selects
+     * the number of processor cores.
+     * @return False if the runs could not be started.
+     */
+    bool Start( const std::vector<RUN_VALUES>& aRuns, std::function<void()> aFinished,
+                int aMaxProcesses = 0 );
+
+    ///> Kills the running processes and drops the runs that have not been started yet
+    void Cancel();
+
+    bool IsRunning() const
+    {
+        return m_running > 0;
+    }
+
+    const std::vector<wxString>& GetVectors() const
+    {
+        return m_vectors;
+    }
+
+    const std::vector<RUN_VALUES>& GetRuns() const
+    {
+        return m_runs;
+    }
+
+    ///> Returns results of the runs, in the same order as the runs passed to Start()
+    const std::vector<RESULT>& GetResults() const
+    {
+        return m_results;
+    }
+
+    ///> Returns the number of runs that have failed
+    int GetFailedCount() const;
+
+    ///> Computes the distribution of a metric of a vector over the successful runs
+    SUMMARY GetSummary( int aVector, METRIC aMetric ) const;
+
+    ///> Returns the summary of all vectors as a text table
+    wxString FormatSummary() const;
+
+    /**
+     * @brief Saves values and results of every run, followed by the summary, to a CSV file.
+     * @return True in case of success.
+     */
+    bool WriteCsv( const wxString& aFileName ) const;
+
+    static const char* GetMetricName( METRIC aMetric );
+
+private:
+    friend class SIM_BATCH_PROCESS;
+
+    ///> Starts the next run, returns false if there are no more runs to start
+    bool launchNext();
+
+    ///> Called by SIM_BATCH_PROCESS when its run has finished
+    void onRunFinished( SIM_BATCH_PROCESS* aProcess, int aExitCode );
+
+    ///> Reads the data written by a run and computes the metrics
+    bool readResult( int aRun, RESULT& aResult ) const;
+
+    ///> Returns the netlist for a run, with the control block applying the device values
+    wxString makeNetlist( int aRun ) const;
+
+    ///> Returns the name of a temporary file used by a run
+    wxString runFileName( int aRun, const wxString& aExtension ) const;
+
+    ///> Removes the temporary files of a run
+    void removeRunFiles( int aRun ) const;
+
+    const wxString m_netlist;
+    const std::vector<wxString> m_vectors;
+    const bool m_complex;
+
+    wxString m_executable;
+
+    ///> Common prefix of the temporary files
+    wxString m_filePrefix;
+
+    std::vector<RUN_VALUES> m_runs;
+    std::vector<RESULT> m_results;
+
+    ///> Processes that are currently running
+    std::vector<SIM_BATCH_PROCESS*> m_processes;
+
+    ///> Index of the next run to be started
+    int m_nextRun;
+
+    ///> Number of processes that are currently running
+    int m_running;
+
+    int m_maxProcesses;
+
+    std::function<void()> m_finished;
+};
+
+#endif /* SIM_BATCH_RUNNER_H */
@@ -0,0 +1,312 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 CERN
+ * @author Tomasz Wlostowski <tomasz.wlostowski@cern.ch>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * https://www.gnu.org/licenses/gpl-3.0.html
+ * or you may search the http://www.gnu.org website for the version 3 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+#include "sim_data_stream.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+
+
+static std::string toLower( const std::string& aString )
+{
+    std::string lower( aString );
+
+    std::transform( lower.begin(), lower.end(), lower.begin(), ::tolower );
+
+    return lower;
+}
+
+
+SIM_DATA_STREAM::SIM_DATA_STREAM() :
+    m_length( 0 ), m_start( 0 ), m_scale( -1 ), m_runId( 0 )
+{
+}
+
+
+void SIM_DATA_STREAM::SetFilter( const std::vector<std::string>& aNames )
+{
+    std::lock_guard<std::mutex> lock( m_lock );
+
+    m_filter.clear();
+
+    for( const auto& name : aNames )
+    {
+        for( const auto& alias : vectorNames( name ) )
+            m_filter.push_back( alias );
+    }
+}
+
+
+void SIM_DATA_STREAM::Reset( const std::vector<std::string>& aNames,
+                             const std::vector<bool>& aComplex )
+{
+    std::lock_guard<std::mutex> lock( m_lock );
+
+    m_vectors.clear();
+    m_vectors.resize( aNames.size() );
+
+    for( size_t i = 0; i < aNames.size(); ++i )
+    {
+        VECTOR& vector = m_vectors[i];
+
+        vector.m_name = toLower( aNames[i] );
+        vector.m_complex = i < aComplex.size() && aComplex[i];
+        vector.m_stored = false;
+
+        for( const auto& alias : vectorNames( vector.m_name ) )
+        {
+            if( std::find( m_filter.begin(), m_filter.end(), alias ) != m_filter.end() )
+                vector.m_stored = true;
+        }
+    }
+
+    m_length = 0;
+    m_start = 0;
+    m_scale = -1;
+    ++m_runId;
+}
+
+
+void SIM_DATA_STREAM::AppendRow( const std::vector<COMPLEX>& aValues, int aScale )
+{
+    std::lock_guard<std::mutex> lock( m_lock );
+
+    if( aValues.size() != m_vectors.size() )
+        return;
+
+    // The scale vector is known once the first row is received
+    if( aScale >= 0 && m_length == 0 )
+    {
+        m_scale = aScale;
+        m_vectors[aScale].m_stored = true;
+    }
+
+    size_t offset = m_length % BLOCK_SIZE;
+
+    // The reader has fallen behind, the oldest points are dropped
+    if( offset == 0 && m_length - m_start == MAX_BLOCKS * BLOCK_SIZE )
+        releaseFirstBlock();
+
+    size_t block = ( m_length - m_start ) / BLOCK_SIZE;
+
+    for( size_t i = 0; i < m_vectors.size(); ++i )
+    {
+        VECTOR& vector = m_vectors[i];
+
+        if( !vector.m_stored )
+            continue;
+
+        if( offset == 0 )
+        {
+            vector.m_real.push_back( allocBlock() );
+
+            if( vector.m_complex )
+                vector.m_imag.push_back( allocBlock() );
+        }
+
+        vector.m_real[block][offset] = aValues[i].real();
+
+        if( vector.m_complex )
+            vector.m_imag[block][offset] = aValues[i].imag();
+    }
+
+    ++m_length;
+}
+
+
+void SIM_DATA_STREAM::Trim( size_t aFirst )
+{
+    std::lock_guard<std::mutex> lock( m_lock );
+
+    aFirst = std::min( aFirst, m_length );
+
+    while( m_start + BLOCK_SIZE <= aFirst )
+        releaseFirstBlock();
+}
+
+
+void SIM_DATA_STREAM::Clear()
+{
+    std::lock_guard<std::mutex> lock( m_lock );
+
+    for( auto& vector : m_vectors )
+    {
+        vector.m_real.clear();
+        vector.m_imag.clear();
+        vector.m_stored = false;
+    }
+
+    m_spareBlocks.clear();
+    m_start = m_length;
+    m_scale = -1;
+}
+
+
+size_t SIM_DATA_STREAM::GetLength() const
+{
+    std::lock_guard<std::mutex> lock( m_lock );
+
+    return m_length;
+}
+
+
+unsigned int SIM_DATA_STREAM::GetRunId() const
+{
+    std::lock_guard<std::mutex> lock( m_lock );
+
+    return m_runId;
+}
+
+
+bool SIM_DATA_STREAM::GetPoints( const std::string& aName, VALUE_TYPE aType, size_t& aFirst,
+                                 std::vector<double>& aScale, std::vector<double>& aValues ) const
+{
+    std::lock_guard<std::mutex> lock( m_lock );
+
+    int index = findVector( aName );
+
+    if( index < 0 || m_scale < 0 || !m_vectors[index].m_stored )
+        return false;
+
+    aFirst = std::max( aFirst, m_start );
+
+    copyPoints( m_vectors[m_scale], MAGNITUDE, aFirst, aScale );
+    copyPoints( m_vectors[index], aType, aFirst, aValues );
+
+    return true;
+}
+
+
+std::vector<std::string> SIM_DATA_STREAM::vectorNames( const std::string& aName )
+{
+    std::string name = toLower( aName );
+    std::vector<std::string> names = { name };
+
+    auto inside = [&]( const char* aPrefix, const char* aSuffix ) -> std::string {
+        size_t prefixLen = strlen( aPrefix );
+        size_t suffixLen = strlen( aSuffix );
+
+        if( name.size() > prefixLen + suffixLen && name.compare( 0, prefixLen, aPrefix ) == 0
+                && name.compare( name.size() - suffixLen, suffixLen, aSuffix ) == 0 )
+            return name.substr( prefixLen, name.size() - prefixLen - suffixLen );
+
+        return std::string();
+    };
+
+    // Node voltages are named either v(node) or just node
+    std::string node = inside( "v(", ")" );
+
+    if( !node.empty() )
+        names.push_back( node );
+
+    // Currents of voltage sources & inductors are stored as branch vectors
+    std::string device = inside( "i(", ")" );
+
+    if( device.empty() )
+        device = inside( "@", "[i]" );
+
+    if( !device.empty() )
+        names.push_back( device + "#branch" );
+
+    return names;
+}
+
+
+int SIM_DATA_STREAM::findVector( const std::string& aName ) const
+{
+    std::vector<std::string> names = vectorNames( aName );
+
+    for( size_t i = 0; i < m_vectors.size(); ++i )
+    {
+        for( const auto& alias : vectorNames( m_vectors[i].m_name ) )
+        {
+            if( std::find( names.begin(), names.end(), alias ) != names.end() )
+                return (int) i;
+        }
+    }
+
+    return -1;
+}
+
+
+void SIM_DATA_STREAM::copyPoints( const VECTOR& aVector, VALUE_TYPE aType, size_t aFirst,
+                                  std::vector<double>& aOut ) const
+{
+    for( size_t i = aFirst; i < m_length; ++i )
+    {
+        size_t block = ( i - m_start ) / BLOCK_SIZE;
+        size_t offset = i % BLOCK_SIZE;
+        double real = aVector.m_real[block][offset];
+
+        if( !aVector.m_complex )
+        {
+            // The same values as returned by SPICE_SIMULATOR::GetMagPlot()/GetPhasePlot()
+            aOut.push_back( aType == MAGNITUDE ? real : 0.0 );
+            continue;
+        }
+
+        double imag = aVector.m_imag[block][offset];
+
+        if( aType == MAGNITUDE )
+            aOut.push_back( hypot( real, imag ) );
+        else
+            aOut.push_back( atan2( imag, real ) );
+    }
+}
+
+
+void SIM_DATA_STREAM::releaseFirstBlock()
+{
+    for( auto& vector : m_vectors )
+    {
+        if( !vector.m_real.empty() )
+        {
+            m_spareBlocks.push_back( std::move( vector.m_real.front() ) );
+            vector.m_real.erase( vector.m_real.begin() );
+        }
+
+        if( !vector.m_imag.empty() )
+        {
+            m_spareBlocks.push_back( std::move( vector.m_imag.front() ) );
+            vector.m_imag.erase( vector.m_imag.begin() );
+        }
+    }
+
+    m_start += BLOCK_SIZE;
+}
+
+
+SIM_DATA_STREAM::BLOCK SIM_DATA_STREAM::allocBlock()
+{
+    if( m_spareBlocks.empty() )
+        return BLOCK( new double[BLOCK_SIZE] );
+
+    BLOCK block = std::move( m_spareBlocks.back() );
+    m_spareBlocks.pop_back();
+
+    return block;
+}
@@ -0,0 +1,165 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 CERN
+ * @author Tomasz Wlostowski <tomasz.wlostowski@cern.ch>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * https://www.gnu.org/licenses/gpl-3.0.html
+ * or you may search the http://www.gnu.org website for the version 3 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+#ifndef SIM_DATA_STREAM_H
+#define SIM_DATA_STREAM_H
+
+#include <complex>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+typedef std::complex<double> COMPLEX;
+
+/**
+ * @brief Vectors of a simulation, received from the simulator while it is running.
+ *
+ * The simulator thread appends a point to every vector (a row) each time a new step is
+ * computed, while the user interface thread copies the points received since its previous
+ * read. Only the vectors selected with SetFilter() (and the scale vector) are stored.
+ *
+ * Points are stored in a ring of fixed size blocks: blocks that have been read are released
+ * with Trim() and, if the reader falls behind, the oldest blocks are reused once MAX_BLOCKS
+ * blocks are filled, so the memory used does not depend on the simulation length.
+ */
+class SIM_DATA_STREAM
+{
+public:
+    ///> Value returned for the points of a vector
+    enum VALUE_TYPE
+    {
+        MAGNITUDE,      ///< Magnitude of complex values, real values are returned as they are
+        PHASE           ///< Phase of complex values (in radians), 0 for real values
+    };
+
+    SIM_DATA_STREAM();
+
+    /**
+     * @brief Selects the vectors to be stored, starting with the next Reset().
+     * @param aNames are the vector names in Spice convention (e.g. V(3), I(V1), @r1[i]).
+     */
+    void SetFilter( const std::vector<std::string>& aNames );
+
+    /**
+     * @brief Starts a new set of vectors, discarding the current one.
+     * @param aNames are the vector names, in the order of the values passed to AppendRow().
+     * @param aComplex tells which vectors have complex values.
+     */
+    void Reset( const std::vector<std::string>& aNames, const std::vector<bool>& aComplex );
+
+    /**
+     * @brief Appends a point to every vector.
+     * @param aValues are the new values, one for each vector.
+     * @param aScale is the index of the scale vector (the X axis), or -1 if unknown.
+     */
+    void AppendRow( const std::vector<COMPLEX>& aValues, int aScale );
+
+    /**
+     * @brief Releases the points stored before aFirst, once they have been read.
+     */
+    void Trim( size_t aFirst );
+
+    ///> Releases all the stored points, e.g. once the simulation is finished
+    void Clear();
+
+    ///> Returns the number of points received for each vector
+    size_t GetLength() const;
+
+    ///> Returns an identifier of the current set of vectors, it changes on every Reset()
+    unsigned int GetRunId() const;
+
+    /**
+     * @brief Copies the points of a vector and of the scale vector received since aFirst.
+     * @param aName is the vector name in Spice convention, compared case insensitively.
+     * @param aType selects the values returned for the vector (scale values are returned
+     * as magnitudes).
+     * @param aFirst is the index of the first point to be copied. If the points have been
+     * released already, it is moved to the first stored point.
+     * @param aScale receives the scale points.
+     * @param aValues receives the vector points, the same count as aScale.
+     * @return False if there is no such vector (or scale vector) stored in the current set.
+     */
+    bool GetPoints( const std::string& aName, VALUE_TYPE aType, size_t& aFirst,
+                    std::vector<double>& aScale, std::vector<double>& aValues ) const;
+
+    ///> Number of points in a block
+    static const size_t BLOCK_SIZE = 4096;
+
+    ///> Maximum number of blocks stored for a vector
+    static const size_t MAX_BLOCKS = 64;
+
+private:
+    typedef std::unique_ptr<double[]> BLOCK;
+
+    struct VECTOR
+    {
+        std::string         m_name;     ///< Lower case name
+        bool                m_complex;
+        bool                m_stored;   ///< Is the vector selected by the filter?
+        std::vector<BLOCK>  m_real;
+        std::vector<BLOCK>  m_imag;     ///< Empty for real vectors
+    };
+
+    ///> Returns names a vector may have in ngspice (V(x) is x, I(V1) is v1#branch)
+    static std::vector<std::string> vectorNames( const std::string& aName );
+
+    ///> Returns the index of a vector, or -1 if not found
+    int findVector( const std::string& aName ) const;
+
+    ///> Copies points [aFirst, m_length) of a vector
+    void copyPoints( const VECTOR& aVector, VALUE_TYPE aType, size_t aFirst,
+                     std::vector<double>& aOut ) const;
+
+    ///> Moves the first block of every stored vector to the spare blocks
+    void releaseFirstBlock();
+
+    ///> Returns a block, reusing a spare one if possible
+    BLOCK allocBlock();
+
+    ///> Protects all the members, the writer is the simulator thread
+    mutable std::mutex m_lock;
+
+    std::vector<VECTOR> m_vectors;
+
+    ///> Names of the vectors to be stored, as returned by vectorNames()
+    std::vector<std::string> m_filter;
+
+    ///> Released blocks, reused for new points
+    std::vector<BLOCK> m_spareBlocks;
+
+    ///> Number of points received for every vector
+    size_t m_length;
+
+    ///> Index of the first stored point (a multiple of BLOCK_SIZE)
+    size_t m_start;
+
+    ///> Index of the scale vector
+    int m_scale;
+
+    unsigned int m_runId;
+};
+
+#endif /* SIM_DATA_STREAM_H */
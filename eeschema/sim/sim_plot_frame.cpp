@@ -36,11 +36,19 @@
 
 #include "sim_plot_frame.h"
 #include "sim_plot_panel.h"
+#include "sim_batch_runner.h"
 #include "spice_simulator.h"
 #include "spice_reporter.h"
 
 #include <menus_helpers.h>
 
+#include <wx/choicdlg.h>
+#include <wx/numdlg.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
 SIM_PLOT_TYPE operator|( SIM_PLOT_TYPE aFirst, SIM_PLOT_TYPE aSecond )
 {
     int res = (int) aFirst | (int) aSecond;
@@ -105,7 +113,7 @@ TRACE_DESC::TRACE_DESC( const NETLIST_EXPORTER_PSPICE_SIM& aExporter, const wxSt
 wxString SIM_PLOT_FRAME::m_savedWorkbooksPath;
 
 SIM_PLOT_FRAME::SIM_PLOT_FRAME( KIWAY* aKiway, wxWindow* aParent )
-    : SIM_PLOT_FRAME_BASE( aParent ), m_lastSimPlot( nullptr )
+    : SIM_PLOT_FRAME_BASE( aParent ), m_lastSimPlot( nullptr ), m_streamTimer( this )
 {
     SetKiway( this, aKiway );
     m_signalsIconColorList = NULL;
@@ -149,6 +157,7 @@ SIM_PLOT_FRAME::SIM_PLOT_FRAME( KIWAY* aKiway, wxWindow* aParent )
     Connect( EVT_SIM_STARTED, wxCommandEventHandler( SIM_PLOT_FRAME::onSimStarted ), NULL, this );
     Connect( EVT_SIM_FINISHED, wxCommandEventHandler( SIM_PLOT_FRAME::onSimFinished ), NULL, this );
     Connect( EVT_SIM_CURSOR_UPDATE, wxCommandEventHandler( SIM_PLOT_FRAME::onCursorUpdate ), NULL, this );
+    Bind( wxEVT_TIMER, &SIM_PLOT_FRAME::onStreamTimer, this, m_streamTimer.GetId() );
 
     // Toolbar buttons
     m_toolSimulate = m_toolBar->AddTool( ID_SIM_RUN, _( "Run/Stop Simulation" ),
@@ -180,6 +189,11 @@ SIM_PLOT_FRAME::SIM_PLOT_FRAME( KIWAY* aKiway, wxWindow* aParent )
     Bind( wxEVT_COMMAND_MENU_SELECTED, &SIM_PLOT_FRAME::onTune,      this, m_tuneValue->GetId() );
     Bind( wxEVT_COMMAND_MENU_SELECTED, &SIM_PLOT_FRAME::onSettings,  this, m_settings->GetId() );
 
+    // Batch runs are not a part of the generated frame, the entry follows "Run Simulation"
+    m_batchRun = m_simulationMenu->Insert( 1, wxID_ANY, _( "Tolerance Analysis..." ),
+            _( "Run the simulation many times with varied values of the tuned components" ) );
+    Bind( wxEVT_COMMAND_MENU_SELECTED, &SIM_PLOT_FRAME::onBatchRun, this, m_batchRun->GetId() );
+
     m_toolBar->Realize();
     m_plotNotebook->SetPageText( 0, _( "Welcome!" ) );
 
@@ -283,6 +297,20 @@ void SIM_PLOT_FRAME::StartSimulation()
         return;
     }
 
+    // Only the vectors of the displayed traces are received while the simulation is running
+    std::vector<std::string> streamedVectors;
+
+    if( plotPanel )
+    {
+        for( const auto& trace : m_plots[plotPanel].m_traces )
+        {
+            const TRACE_DESC& desc = trace.second;
+            streamedVectors.push_back( (const char*) m_exporter->GetSpiceVector( desc.GetName(),
+                    desc.GetType(), desc.GetParam() ).c_str() );
+        }
+    }
+
+    m_simulator->GetDataStream().SetFilter( streamedVectors );
     m_simulator->LoadNetlist( formatter.GetString() );
     updateTuners();
     applyTuners();
@@ -444,6 +472,7 @@ void SIM_PLOT_FRAME::removePlot( const wxString& aPlotName, bool aErase )
         auto traceIt = traceMap.find( aPlotName );
         wxASSERT( traceIt != traceMap.end() );
         traceMap.erase( traceIt );
+        m_plots[plotPanel].m_streamPositions.erase( aPlotName );
     }
 
     wxASSERT( plotPanel->IsShown( aPlotName ) );
@@ -534,6 +563,86 @@ bool SIM_PLOT_FRAME::updatePlot( const TRACE_DESC& aDescriptor, SIM_PLOT_PANEL*
 }
 
 
+void SIM_PLOT_FRAME::updateStreamedPlots()
+{
+    SIM_TYPE simType = m_exporter->GetSimType();
+    SIM_PLOT_PANEL* plotPanel = CurrentPlot();
+
+    if( !plotPanel || plotPanel->GetType() != simType || !SIM_PLOT_PANEL::IsPlottable( simType ) )
+        return;
+
+    SIM_DATA_STREAM& stream = m_simulator->GetDataStream();
+    PLOT_INFO& plotInfo = m_plots[plotPanel];
+    std::vector<double> data_x, data_y;
+    bool updated = false;
+
+    // The traces still show the previous results, they are replaced with the new ones
+    bool newRun = ( stream.GetRunId() != plotInfo.m_streamRunId );
+
+    if( newRun )
+    {
+        plotInfo.m_streamRunId = stream.GetRunId();
+        plotInfo.m_streamPositions.clear();
+    }
+
+    // Points read by all the traces may be released
+    size_t readPoints = stream.GetLength();
+
+    for( const auto& trace : plotInfo.m_traces )
+    {
+        TRACE* plotTrace = plotPanel->GetTrace( trace.first );
+
+        if( !plotTrace )
+            continue;
+
+        const TRACE_DESC& descriptor = trace.second;
+        wxString spiceVector = m_exporter->GetSpiceVector( descriptor.GetName(),
+                descriptor.GetType(), descriptor.GetParam() );
+
+        // Points dropped by the stream are missing in the trace, so the number of points
+        // of the trace is the read position only for traces added during the run
+        auto position = plotInfo.m_streamPositions.find( trace.first );
+        size_t first = 0;
+
+        if( position != plotInfo.m_streamPositions.end() )
+            first = position->second;
+        else if( !newRun )
+            first = plotTrace->GetDataX().size();
+
+        SIM_DATA_STREAM::VALUE_TYPE valueType = ( descriptor.GetType() & SPT_AC_PHASE ) ?
+                SIM_DATA_STREAM::PHASE : SIM_DATA_STREAM::MAGNITUDE;
+
+        data_x.clear();
+        data_y.clear();
+
+        if( !stream.GetPoints( (const char*) spiceVector.c_str(), valueType, first,
+                               data_x, data_y ) )
+            continue;
+
+        if( newRun )
+        {
+            plotTrace->SetData( std::vector<double>(), std::vector<double>() );
+            updated = true;
+        }
+
+        if( !data_x.empty() )
+        {
+            plotPanel->AppendTracePoints( trace.first, data_x.size(), data_x.data(),
+                                          data_y.data() );
+            updated = true;
+        }
+
+        plotInfo.m_streamPositions[trace.first] = first + data_x.size();
+        readPoints = std::min( readPoints, first + data_x.size() );
+    }
+
+    stream.Trim( readPoints );
+
+    if( updated )
+        plotPanel->UpdateAll();
+}
+
+
 void SIM_PLOT_FRAME::updateSignalList()
 {
     SIM_PLOT_PANEL* plotPanel = CurrentPlot();
@@ -1024,6 +1133,151 @@ void SIM_PLOT_FRAME::onSettings( wxCommandEvent& event )
 }
 
 
+void SIM_PLOT_FRAME::onBatchRun( wxCommandEvent& event )
+{
+    // Upper limit of runs in a single analysis
+    const long MAX_BATCH_RUNS = 10000;
+
+    if( m_batchRunner && m_batchRunner->IsRunning() )
+    {
+        if( IsOK( this, _( "Tolerance analysis is running. Stop it?" ) ) )
+        {
+            m_batchRunner->Cancel();
+            m_simConsole->AppendText( _( "Tolerance analysis stopped\n" ) );
+        }
+
+        return;
+    }
+
+    SIM_PLOT_PANEL* plotPanel = CurrentPlot();
+
+    if( !plotPanel || m_plots[plotPanel].m_traces.empty() )
+    {
+        DisplayInfoMessage( this, _( "Add the signals to be analyzed to the plot first." ) );
+        return;
+    }
+
+    if( m_tuners.empty() )
+    {
+        DisplayInfoMessage( this, _( "Add tuners for the components to be varied first.\n"
+                    "Component values are chosen from the tuner ranges." ) );
+        return;
+    }
+
+    if( !m_settingsDlg )
+        m_settingsDlg = new DIALOG_SIM_SETTINGS( this );
+
+    STRING_FORMATTER formatter;
+
+    updateNetlistExporter();
+    m_exporter->SetSimCommand( m_plots[plotPanel].m_simCommand );
+
+    if( !m_exporter->Format( &formatter, m_settingsDlg->GetNetlistOptions() ) )
+    {
+        DisplayError( this, _( "There were errors during netlist export, aborted." ) );
+        return;
+    }
+
+    const wxString modes[] = { _( "Monte Carlo (random values)" ),
+                               _( "Parameter sweep (all value combinations)" ) };
+    int mode = wxGetSingleChoiceIndex( _( "Select the analysis type:" ),
+                                       _( "Tolerance Analysis" ), 2, modes, this );
+
+    if( mode < 0 )
+        return;
+
+    std::vector<SIM_BATCH_RUNNER::VARIATION> variations;
+
+    for( auto tuner : m_tuners )
+        variations.push_back( { tuner->GetSpiceName(), tuner->GetMin(), tuner->GetMax() } );
+
+    std::vector<SIM_BATCH_RUNNER::RUN_VALUES> runs;
+
+    if( mode == 0 )
+    {
+        long count = wxGetNumberFromUser( _( "Number of runs:" ), wxEmptyString,
+                _( "Monte Carlo Analysis" ), 100, 1, MAX_BATCH_RUNS, this );
+
+        if( count <= 0 )
+            return;
+
+        // Reported, so the same values may be generated again
+        unsigned int seed = std::random_device()();
+        runs = SIM_BATCH_RUNNER::MakeMonteCarlo( variations, count, seed );
+        m_simConsole->AppendText( wxString::Format( _( "Monte Carlo seed: %u\n" ), seed ) );
+    }
+    else
+    {
+        long steps = wxGetNumberFromUser( _( "Number of values for each component:" ),
+                wxEmptyString, _( "Parameter Sweep" ), 5, 2, 100, this );
+
+        if( steps <= 0 )
+            return;
+
+        if( std::pow( steps, variations.size() ) > MAX_BATCH_RUNS )
+        {
+            DisplayError( this, wxString::Format( _( "Too many value combinations, "
+                        "the limit is %ld runs." ), MAX_BATCH_RUNS ) );
+            return;
+        }
+
+        runs = SIM_BATCH_RUNNER::MakeSweep( variations, steps );
+    }
+
+    // AC traces refer to the magnitude or phase of a complex vector
+    std::vector<wxString> vectors;
+
+    for( const auto& trace : m_plots[plotPanel].m_traces )
+    {
+        const TRACE_DESC& desc = trace.second;
+        wxString vector = m_exporter->GetSpiceVector( desc.GetName(), desc.GetType(),
+                                                      desc.GetParam() );
+
+        if( desc.GetType() & SPT_AC_MAG )
+            vector = "mag(" + vector + ")";
+        else if( desc.GetType() & SPT_AC_PHASE )
+            vector = "ph(" + vector + ")";
+
+        if( std::find( vectors.begin(), vectors.end(), vector ) == vectors.end() )
+            vectors.push_back( vector );
+    }
+
+    wxString netlist = wxString::FromUTF8( formatter.GetString().c_str() );
+    m_batchRunner.reset( new SIM_BATCH_RUNNER( netlist, vectors,
+                                               m_exporter->GetSimType() == ST_AC ) );
+
+    // Results are reported after the process termination handler returns
+    if( !m_batchRunner->Start( runs, [this]() { CallAfter( &SIM_PLOT_FRAME::onBatchFinished ); } ) )
+    {
+        DisplayError( this, _( "Could not start the simulation processes.\n"
+                    "Make sure the ngspice executable is installed and may be found in the "
+                    "system path." ) );
+        return;
+    }
+
+    m_simConsole->AppendText( wxString::Format( _( "Tolerance analysis started (%lu runs)\n" ),
+                                                (unsigned long) runs.size() ) );
+}
+
+
+void SIM_PLOT_FRAME::onBatchFinished()
+{
+    if( !m_batchRunner || m_batchRunner->IsRunning() )
+        return;
+
+    m_simConsole->AppendText( m_batchRunner->FormatSummary() );
+
+    wxFileDialog saveDlg( this, _( "Save tolerance analysis results" ), "", "",
+                "CSV file (*.csv)|*.csv", wxFD_SAVE | wxFD_OVERWRITE_PROMPT );
+
+    if( saveDlg.ShowModal() == wxID_CANCEL )
+        return;
+
+    if( !m_batchRunner->WriteCsv( saveDlg.GetPath() ) )
+        DisplayError( this, wxString::Format( _( "Could not write %s" ), saveDlg.GetPath() ) );
+}
+
+
 void SIM_PLOT_FRAME::onAddSignal( wxCommandEvent& event )
 {
     SIM_PLOT_PANEL* plotPanel = CurrentPlot();
@@ -1120,6 +1374,9 @@ void SIM_PLOT_FRAME::onSimStarted( wxCommandEvent& aEvent )
 {
     m_toolBar->SetToolNormalBitmap( ID_SIM_RUN, KiBitmap( sim_stop_xpm ) );
     SetCursor( wxCURSOR_ARROWWAIT );
+
+    // Show the results as they are computed
+    m_streamTimer.Start( 200 );
 }
 
 
@@ -1127,6 +1384,11 @@ void SIM_PLOT_FRAME::onSimFinished( wxCommandEvent& aEvent )
 {
     m_toolBar->SetToolNormalBitmap( ID_SIM_RUN, KiBitmap( sim_run_xpm ) );
     SetCursor( wxCURSOR_ARROW );
+    m_streamTimer.Stop();
+
+    // The complete results are read from the simulator, unless a new run has started already
+    if( !IsSimulationRunning() )
+        m_simulator->GetDataStream().Clear();
 
     SIM_TYPE simType = m_exporter->GetSimType();
 
@@ -1177,6 +1439,12 @@ void SIM_PLOT_FRAME::onSimFinished( wxCommandEvent& aEvent )
 }
 
 
+void SIM_PLOT_FRAME::onStreamTimer( wxTimerEvent& aEvent )
+{
+    updateStreamedPlots();
+}
+
+
 void SIM_PLOT_FRAME::onSimUpdate( wxCommandEvent& aEvent )
 {
     if( IsSimulationRunning() )
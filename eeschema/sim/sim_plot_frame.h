@@ -37,6 +37,7 @@
 #include <dialogs/dialog_sim_settings.h>
 
 #include <wx/event.h>
+#include <wx/timer.h>
 
 #include <list>
 #include <memory>
@@ -49,6 +50,7 @@ class SPICE_SIMULATOR;
 class NETLIST_EXPORTER_PSPICE_SIM;
 class SIM_PLOT_PANEL;
 class SIM_THREAD_REPORTER;
+class SIM_BATCH_RUNNER;
 class TUNER_SLIDER;
 
 ///> Trace descriptor class
@@ -185,6 +187,12 @@ private:
      */
     bool updatePlot( const TRACE_DESC& aDescriptor, SIM_PLOT_PANEL* aPanel );
 
+    /**
+     * @brief Appends the points received from the running simulator to the plots of the
+     * current SIM_PLOT_PANEL, so the results are shown before the simulation finishes.
+     */
+    void updateStreamedPlots();
+
     /**
      * @brief Updates the list of currently plotted signals.
      */
@@ -257,6 +265,10 @@ private:
     void onAddSignal( wxCommandEvent& event );
     void onProbe( wxCommandEvent& event );
     void onTune( wxCommandEvent& event );
+    void onBatchRun( wxCommandEvent& event );
+
+    ///> Reports results of a finished tolerance analysis
+    void onBatchFinished();
 
     void onClose( wxCloseEvent& aEvent );
 
@@ -265,6 +277,7 @@ private:
     void onSimReport( wxCommandEvent& aEvent );
     void onSimStarted( wxCommandEvent& aEvent );
     void onSimFinished( wxCommandEvent& aEvent );
+    void onStreamTimer( wxTimerEvent& aEvent );
 
     // adjust the sash dimension of splitter windows after reading
     // the config settings
@@ -293,6 +306,16 @@ private:
 
         ///> Spice directive used to execute the simulation
         wxString m_simCommand;
+
+        ///> SIM_DATA_STREAM run that provided the points of the traces
+        unsigned int m_streamRunId;
+
+        ///> Stream index of the next point to be read, for each trace
+        std::map<wxString, size_t> m_streamPositions;
+
+        PLOT_INFO() : m_streamRunId( 0 )
+        {
+        }
     };
 
     ///> Map of plot panels and associated data
@@ -330,6 +353,15 @@ private:
     ///> Panel that was used as the most recent one for simulations
     SIM_PLOT_PANEL* m_lastSimPlot;
 
+    ///> Refreshes the plots with the points received while the simulation is running
+    wxTimer m_streamTimer;
+
+    ///> Menu entry starting the tolerance analysis (not a part of the generated frame)
+    wxMenuItem* m_batchRun;
+
+    ///> Runner of the most recent tolerance analysis
+    std::unique_ptr<SIM_BATCH_RUNNER> m_batchRunner;
+
     ///> imagelists uset to add a small coloured icon to signal names
     ///> and cursors name, the same color as the corresponding signal traces
     wxImageList* m_signalsIconColorList;
@@ -361,6 +361,142 @@ void CURSOR::UpdateReference()
 }
 
 
+void TRACE::AppendData( const double* aX, const double* aY, size_t aCount )
+{
+    if( aCount == 0 )
+        return;
+
+    if( m_cursor )
+        m_cursor->Update();
+
+    if( m_xs.empty() )
+    {
+        m_minX = m_maxX = aX[0];
+        m_minY = m_maxY = aY[0];
+    }
+    else if( aX[0] < m_xs.back() )
+    {
+        m_increasingX = false;
+    }
+
+    for( size_t i = 0; i < aCount; i++ )
+    {
+        if( i > 0 && aX[i] < aX[i - 1] )
+            m_increasingX = false;
+
+        m_minX = std::min( m_minX, aX[i] );
+        m_maxX = std::max( m_maxX, aX[i] );
+        m_minY = std::min( m_minY, aY[i] );
+        m_maxY = std::max( m_maxY, aY[i] );
+    }
+
+    m_xs.insert( m_xs.end(), aX, aX + aCount );
+    m_ys.insert( m_ys.end(), aY, aY + aCount );
+}
+
+
+void TRACE::Plot( wxDC& aDC, mpWindow& aWindow )
+{
+    if( !IsVisible() )
+        return;
+
+    m_decimated = m_increasingX && m_scaleX;
+
+    if( m_decimated )
+        decimate( aWindow );
+
+    mpFXYVector::Plot( aDC, aWindow );
+    m_decimated = false;
+}
+
+
+bool TRACE::GetNextXY( double& aX, double& aY )
+{
+    if( !m_decimated )
+        return mpFXYVector::GetNextXY( aX, aY );
+
+    if( m_index >= m_plotXs.size() )
+        return false;
+
+    aX = m_plotXs[m_index];
+    aY = m_plotYs[m_index++];
+
+    return true;
+}
+
+
+void TRACE::decimate( mpWindow& aWindow )
+{
+    m_plotXs.clear();
+    m_plotYs.clear();
+
+    wxCoord startPx = m_drawOutsideMargins ? 0 : aWindow.GetMarginLeft();
+    wxCoord endPx   = m_drawOutsideMargins ? aWindow.GetScrX()
+                                           : aWindow.GetScrX() - aWindow.GetMarginRight();
+
+    // Skip the points outside the view, but keep the ones next to its borders,
+    // so the lines crossing the borders are drawn
+    double minX = s2x( aWindow.p2x( startPx ) );
+    double maxX = s2x( aWindow.p2x( endPx ) );
+
+    if( minX > maxX )
+        std::swap( minX, maxX );
+
+    size_t first = std::lower_bound( m_xs.begin(), m_xs.end(), minX ) - m_xs.begin();
+    size_t last = std::upper_bound( m_xs.begin(), m_xs.end(), maxX ) - m_xs.begin();
+
+    if( first > 0 )
+        --first;
+
+    if( last < m_xs.size() )
+        ++last;
+
+    DecimatePoints( m_xs, m_ys, first, last,
+                    [&]( double aX ) { return (int) aWindow.x2p( x2s( aX ) ); },
+                    m_plotXs, m_plotYs );
+}
+
+
+void TRACE::DecimatePoints( const std::vector<double>& aXs, const std::vector<double>& aYs,
+                            size_t aFirst, size_t aLast,
+                            const std::function<int( double )>& aColumn,
+                            std::vector<double>& aOutXs, std::vector<double>& aOutYs )
+{
+    for( size_t i = aFirst; i < aLast; )
+    {
+        // Find the points drawn in the same pixel column
+        int column = aColumn( aXs[i] );
+        size_t minIdx = i, maxIdx = i;
+        size_t next = i + 1;
+
+        for( ; next < aLast && aColumn( aXs[next] ) == column; ++next )
+        {
+            if( aYs[next] < aYs[minIdx] )
+                minIdx = next;
+
+            if( aYs[next] > aYs[maxIdx] )
+                maxIdx = next;
+        }
+
+        // The first and last points connect the column with its neighbours,
+        // the extremes are kept in the order they appear
+        const size_t points[] = { i, std::min( minIdx, maxIdx ), std::max( minIdx, maxIdx ),
+                                  next - 1 };
+
+        for( size_t k = 0; k < 4; ++k )
+        {
+            if( k > 0 && points[k] == points[k - 1] )
+                continue;
+
+            aOutXs.push_back( aXs[points[k]] );
+            aOutYs.push_back( aYs[points[k]] );
+        }
+
+        i = next;
+    }
+}
+
+
 SIM_PLOT_PANEL::SIM_PLOT_PANEL( SIM_TYPE aType, wxWindow* parent, wxWindowID id, const wxPoint& pos,
                 const wxSize& size, long style, const wxString& name )
     : mpWindow( parent, id, pos, size, style ), m_colorIdx( 0 ),
@@ -511,19 +647,7 @@ bool SIM_PLOT_PANEL::AddTrace( const wxString& aName, int aPoints,
 
     std::vector<double> tmp( aY, aY + aPoints );
 
-    if( m_type == ST_AC )
-    {
-        if( aFlags & SPT_AC_PHASE )
-        {
-            for( int i = 0; i < aPoints; i++ )
-                tmp[i] = tmp[i] * 180.0 / M_PI;                 // convert to degrees
-        }
-        else
-        {
-            for( int i = 0; i < aPoints; i++ )
-                tmp[i] = 20 * log( tmp[i] ) / log( 10.0 );      // convert to dB
-        }
-    }
+    convertValues( tmp, aFlags );
 
     trace->SetData( std::vector<double>( aX, aX + aPoints ), tmp );
 
@@ -540,6 +664,25 @@ bool SIM_PLOT_PANEL::AddTrace( const wxString& aName, int aPoints,
 }
 
 
+bool SIM_PLOT_PANEL::AppendTracePoints( const wxString& aName, int aPoints,
+        const double* aX, const double* aY )
+{
+    TRACE* trace = GetTrace( aName );
+
+    if( !trace )
+        return false;
+
+    std::vector<double> tmp( aY, aY + aPoints );
+
+    convertValues( tmp, trace->GetFlags() );
+
+    trace->AppendData( aX, tmp.data(), aPoints );
+    trace->UpdateScales();
+
+    return true;
+}
+
+
 bool SIM_PLOT_PANEL::DeleteTrace( const wxString& aName )
 {
     auto it = m_traces.find( aName );
@@ -625,6 +768,24 @@ void SIM_PLOT_PANEL::ResetScales()
 }
 
 
+void SIM_PLOT_PANEL::convertValues( std::vector<double>& aY, int aFlags ) const
+{
+    if( m_type != ST_AC )
+        return;
+
+    if( aFlags & SPT_AC_PHASE )
+    {
+        for( double& y : aY )
+            y = y * 180.0 / M_PI;                 // convert to degrees
+    }
+    else
+    {
+        for( double& y : aY )
+            y = 20 * log( y ) / log( 10.0 );      // convert to dB
+    }
+}
+
+
 wxColour SIM_PLOT_PANEL::generateColor()
 {
     /// @todo have a look at:
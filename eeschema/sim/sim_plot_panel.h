@@ -27,6 +27,8 @@
 #define __SIM_PLOT_PANEL_H
 
 #include <widgets/mathplot.h>
+#include <algorithm>
+#include <functional>
 #include <map>
 #include "sim_types.h"
 
@@ -87,7 +89,8 @@ class TRACE : public mpFXYVector
 {
 public:
     TRACE( const wxString& aName ) :
-        mpFXYVector( aName ), m_cursor( nullptr ), m_flags( 0 )
+        mpFXYVector( aName ), m_cursor( nullptr ), m_flags( 0 ),
+        m_increasingX( true ), m_decimated( false )
     {
         SetContinuity( true );
         SetDrawOutsideMargins( false );
@@ -105,8 +108,36 @@ public:
             m_cursor->Update();
 
         mpFXYVector::SetData( aX, aY );
+        m_increasingX = std::is_sorted( m_xs.begin(), m_xs.end() );
     }
 
+    /**
+     * @brief Appends points to the data set, e.g. points received from a running simulation.
+     * @param aX are the X axis values.
+     * @param aY are the Y axis values.
+     * @param aCount is the number of points to append.
+     */
+    void AppendData( const double* aX, const double* aY, size_t aCount );
+
+    /**
+     * @brief Draws the trace. If the X values are increasing, only the first, last, lowest
+     * and highest point of each pixel column are drawn, so the drawing time depends on the
+     * plot width rather than on the number of points.
+     */
+    void Plot( wxDC& aDC, mpWindow& aWindow ) override;
+
+    /**
+     * @brief Decimates points with increasing X values, keeping only the first, last, lowest
+     * and highest point drawn in every pixel column.
+     * @param aFirst and aLast select the range of points [aFirst, aLast) to be decimated.
+     * @param aColumn returns the pixel column for an X value.
+     * @param aOutXs and aOutYs receive the decimated points.
+     */
+    static void DecimatePoints( const std::vector<double>& aXs, const std::vector<double>& aYs,
+                                size_t aFirst, size_t aLast,
+                                const std::function<int( double )>& aColumn,
+                                std::vector<double>& aOutXs, std::vector<double>& aOutYs );
+
     const std::vector<double>& GetDataX() const
     {
         return m_xs;
@@ -153,9 +184,24 @@ public:
     }
 
 protected:
+    ///> Returns the decimated points when plotting
+    bool GetNextXY( double& aX, double& aY ) override;
+
+    ///> Fills m_plotXs & m_plotYs with the decimated points visible in aWindow
+    void decimate( mpWindow& aWindow );
+
     CURSOR* m_cursor;
     int m_flags;
     wxColour m_traceColour;
+
+    ///> X values never decrease, so the data may be decimated
+    bool m_increasingX;
+
+    ///> GetNextXY() enumerates the decimated points
+    bool m_decimated;
+
+    ///> Decimated points
+    std::vector<double> m_plotXs, m_plotYs;
 };
 
 
@@ -192,6 +238,14 @@ public:
     bool AddTrace( const wxString& aName, int aPoints,
             const double* aX, const double* aY, SIM_PLOT_TYPE aFlags );
 
+    /**
+     * @brief Appends points to an existing trace. Values are converted the same way as in
+     * AddTrace(), according to the trace flags.
+     * @return False if there is no trace with the given name.
+     */
+    bool AppendTracePoints( const wxString& aName, int aPoints,
+            const double* aX, const double* aY );
+
     bool DeleteTrace( const wxString& aName );
 
     void DeleteAllTraces();
@@ -251,6 +305,9 @@ private:
     ///> Returns a new color from the palette
     wxColour generateColor();
 
+    ///> Converts Y values of AC simulations to decibels or degrees, depending on aFlags
+    void convertValues( std::vector<double>& aY, int aFlags ) const;
+
     // Color index to get a new color from the palette
     unsigned int m_colorIdx;
 
@@ -26,6 +26,7 @@
 #define SPICE_SIMULATOR_H
 
 #include "sim_types.h"
+#include "sim_data_stream.h"
 
 #include <string>
 #include <vector>
@@ -33,8 +34,6 @@
 
 class SPICE_REPORTER;
 
-typedef std::complex<double> COMPLEX;
-
 class SPICE_SIMULATOR
 {
 public:
@@ -124,9 +123,26 @@ public:
      */
     virtual std::vector<double> GetPhasePlot( const std::string& aName, int aMaxLen = -1 ) = 0;
 
+    /**
+     * @brief Returns the vectors received while the simulation is running. Unlike the Get*Plot()
+     * functions, it may be used before the simulation is finished.
+     */
+    const SIM_DATA_STREAM& GetDataStream() const
+    {
+        return m_dataStream;
+    }
+
+    SIM_DATA_STREAM& GetDataStream()
+    {
+        return m_dataStream;
+    }
+
 protected:
     ///> Reporter object to receive simulation log
     SPICE_REPORTER* m_reporter;
+
+    ///> Vectors of the current simulation, filled by the simulator thread
+    SIM_DATA_STREAM m_dataStream;
 };
 
 #endif /* SPICE_SIMULATOR_H */
@@ -26,34 +26,52 @@
 #include <dsnlexer.h>
 #include <fctsys.h>
 #include <macros.h>
+#include <i18n_utility.h>
+#include <ki_mutex.h>
+
+#include <wx/thread.h>
 
 using namespace TFIELD_T;
 
 const wxString TEMPLATE_FIELDNAME::GetDefaultFieldName( int aFieldNdx )
 {
     // Fixed values for the first few default fields used by EESCHEMA
-    // (mandatory fields)
-    switch( aFieldNdx )
+    // (mandatory fields), the last entry is the prefix of user field names.
+    static const wxChar* const englishNames[MANDATORY_FIELDS + 1] =
     {
-    case  REFERENCE:
-        return _( "Reference" );   // The component reference, R1, C1, etc.
-
-    case  VALUE:
-        return _( "Value" );       // The component value + name
-
-    case  FOOTPRINT:
-        return _( "Footprint" );   // The footprint for use with Pcbnew
-
-    case  DATASHEET:
-        return _( "Datasheet" );   // Link to a datasheet for component
+        _HKI( "Reference" ),    // The component reference, R1, C1, etc.
+        _HKI( "Value" ),        // The component value + name
+        _HKI( "Footprint" ),    // The footprint for use with Pcbnew
+        _HKI( "Datasheet" ),    // Link to a datasheet for component
+        _HKI( "Field" )         // Other fields are use fields, give a default name
+    };
+
+    // wxGetTranslation() is not thread safe, so the names are translated by the main thread
+    // only.  Other threads (the schematic loader, see SCH_LEGACY_PLUGIN::loadScreens()) get
+    // the names translated by the main thread last time.
+    static MUTEX    names_mutex;
+    static wxString names[MANDATORY_FIELDS + 1];
+
+    int      idx = ( aFieldNdx >= 0 && aFieldNdx < MANDATORY_FIELDS ) ? aFieldNdx
+                                                                      : MANDATORY_FIELDS;
+    wxString fieldName;
+
+    if( wxIsMainThread() )
+    {
+        fieldName = wxGetTranslation( englishNames[idx] );
 
-    default:
-        break;
+        MUTLOCK lock( names_mutex );
+        names[idx] = fieldName;
+    }
+    else
+    {
+        MUTLOCK lock( names_mutex );
+        fieldName = names[idx].IsEmpty() ? wxString( englishNames[idx] ) : names[idx];
     }
 
-    // Other fields are use fields, give a default name:
-    wxString fieldName = _( "Field" );
-    fieldName << aFieldNdx;
+    if( idx == MANDATORY_FIELDS )
+        fieldName << aFieldNdx;
+
     return fieldName;
 }
 
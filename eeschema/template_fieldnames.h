@@ -118,6 +118,7 @@ struct TEMPLATE_FIELDNAME
      * Function GetDefaultFieldName
      * returns a default symbol field name for field \a aFieldNdx for all components.
      * These fieldnames are not modifiable, but template fieldnames are.
+     * May be called from worker threads, which get the names translated by the main thread.
      * @param aFieldNdx The field number index, > 0
      */
     static const wxString GetDefaultFieldName( int aFieldNdx );
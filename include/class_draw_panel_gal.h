@@ -196,6 +196,23 @@ public:
      */
     virtual void OnShow() {}
 
+    /**
+     * Function ShowProfilerOverlay()
+     * Enables frame time profiling (see FRAME_PROFILER) and displays the average section times
+     * on the canvas.
+     * @param aShow decides if the profiler and its overlay are enabled.
+     */
+    void ShowProfilerOverlay( bool aShow );
+
+    /**
+     * Function IsProfilerOverlayShown()
+     * Returns true if the frame time statistics are displayed.
+     */
+    bool IsProfilerOverlayShown() const
+    {
+        return m_profilerOverlay;
+    }
+
 protected:
     void onPaint( wxPaintEvent& WXUNUSED( aEvent ) );
     void onSize( wxSizeEvent& aEvent );
@@ -205,8 +222,14 @@ protected:
     void onRefreshTimer( wxTimerEvent& aEvent );
     void onShowTimer( wxTimerEvent& aEvent );
 
+    /// Draws the frame time statistics to the overlay target
+    void drawProfilerOverlay();
+
     static const int MinRefreshPeriod = 17;             ///< 60 FPS.
 
+    /// Number of frames averaged in the profiler overlay
+    static const int PROFILER_AVERAGE_FRAMES = 30;
+
     /// Pointer to the parent window
     wxWindow*                m_parent;
 
@@ -225,6 +248,9 @@ protected:
     /// Flag that determines if VIEW may use GAL for redrawing the screen.
     bool                     m_drawingEnabled;
 
+    /// Are the frame time statistics displayed?
+    bool                     m_profilerOverlay;
+
     /// Timer responsible for preventing too frequent refresh
     wxTimer                  m_refreshTimer;
 
@@ -0,0 +1,217 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file frame_profiler.h
+ * @brief Frame time statistics of the drawing loop, collected on user request.
+ */
+
+#ifndef FRAME_PROFILER_H
+#define FRAME_PROFILER_H
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <vector>
+
+#include <wx/string.h>
+
+/**
+ * Class FRAME_PROFILER
+ * collects the time spent in the drawing loop sections for the most recent frames.
+ *
+ * Sections are timed with FRAME_PROFILER_SCOPE objects placed in the measured functions.
+ * Times of a section are summed until the frame is finished with EndFrame(), so a section
+ * executed by several threads may report more time than the frame took. Timers are always
+ * compiled in, but they only check a flag unless the profiler is enabled.
+ */
+class FRAME_PROFILER
+{
+public:
+    ///> Measured sections of the drawing loop
+    enum SECTION
+    {
+        FRAME,              ///< Whole frame (from BeginFrame() to EndFrame())
+        VIEW_UPDATE,        ///< Updating modified items (VIEW::UpdateItems())
+        VIEW_REDRAW,        ///< Redrawing the view (VIEW::Redraw())
+        VIEW_QUERY,         ///< Searching the view R-trees, without drawing the found items
+        PAINTER,            ///< Drawing items with a PAINTER (summed for all threads)
+        GAL_COMPOSITE,      ///< Compositing & presenting the frame (GAL::EndDrawing())
+        RATSNEST,           ///< Ratsnest update & drawing
+        ROUTER,             ///< Interactive router (since the previous frame)
+        SECTION_COUNT
+    };
+
+    ///> Times measured during a single frame
+    struct RECORD
+    {
+        unsigned long   m_frame;                        ///< Frame number
+        double          m_time[SECTION_COUNT];          ///< Time spent in sections (in ms)
+        unsigned int    m_calls[SECTION_COUNT];         ///< Number of measured calls
+    };
+
+    /**
+     * Function Instance
+     * returns the profiler shared by all the drawing panels.
+     */
+    static FRAME_PROFILER& Instance();
+
+    /**
+     * Function IsEnabled
+     * tells if timers should measure their sections. It is meant to be cheap enough to be
+     * called in the hot paths.
+     */
+    static bool IsEnabled()
+    {
+        return s_enabled.load( std::memory_order_relaxed );
+    }
+
+    /**
+     * Function Enable
+     * starts or stops collecting frame times. The collected history is kept.
+     */
+    void Enable( bool aEnable );
+
+    /**
+     * Function AddSample
+     * adds time spent in a section to the current frame. May be called from any thread.
+     * @param aSection is the section that has been executed.
+     * @param aNanoseconds is the time the section took.
+     */
+    void AddSample( SECTION aSection, long long aNanoseconds );
+
+    /**
+     * Function BeginFrame
+     * marks the beginning of a frame, it is the start point for the FRAME section.
+     */
+    void BeginFrame();
+
+    /**
+     * Function EndFrame
+     * stores the times collected since the previous call as a new frame record.
+     */
+    void EndFrame();
+
+    /**
+     * Function Clear
+     * removes the collected frame records.
+     */
+    void Clear();
+
+    /**
+     * Function GetRecords
+     * returns the stored frame records, ordered from the oldest to the newest one.
+     */
+    std::vector<RECORD> GetRecords() const;
+
+    /**
+     * Function GetAverage
+     * computes average section times over the most recent frames.
+     * @param aAverage is filled with the average times (m_calls holds the total call count).
+     * @param aFrameCount is the maximum number of frames to be averaged.
+     * @return false if there are no frame records yet.
+     */
+    bool GetAverage( RECORD& aAverage, int aFrameCount ) const;
+
+    /**
+     * Function Dump
+     * saves the stored frame records to a CSV file, so it can be attached to bug reports.
+     * @param aFileName is the output file name.
+     * @return true in case of success.
+     */
+    bool Dump( const wxString& aFileName ) const;
+
+    /**
+     * Function GetSectionName
+     * returns the name of a section, as used in the overlay and dumps.
+     */
+    static const char* GetSectionName( SECTION aSection );
+
+    ///> Number of frames kept in the history
+    static const int HISTORY_SIZE = 600;
+
+private:
+    FRAME_PROFILER();
+
+    ///> Flag checked by the timers
+    static std::atomic<bool> s_enabled;
+
+    ///> Times collected for the current frame (in ns)
+    std::atomic<long long> m_current[SECTION_COUNT];
+
+    ///> Number of calls collected for the current frame
+    std::atomic<unsigned int> m_currentCalls[SECTION_COUNT];
+
+    ///> Ring buffer of frame records
+    std::vector<RECORD> m_history;
+
+    ///> Index of the next record to be written
+    int m_next;
+
+    ///> Number of finished frames
+    unsigned long m_frameCounter;
+
+    ///> Start time of the current frame
+    std::chrono::steady_clock::time_point m_frameStart;
+
+    ///> Was BeginFrame() called while the profiler was enabled?
+    bool m_frameStarted;
+
+    ///> Protects the history
+    mutable std::mutex m_lock;
+};
+
+
+/**
+ * Class FRAME_PROFILER_SCOPE
+ * measures the time since its creation until it goes out of scope and adds it to a section
+ * of the current frame. Does nothing when the profiler is disabled.
+ */
+class FRAME_PROFILER_SCOPE
+{
+public:
+    FRAME_PROFILER_SCOPE( FRAME_PROFILER::SECTION aSection ) :
+        m_section( aSection ), m_active( FRAME_PROFILER::IsEnabled() )
+    {
+        if( m_active )
+            m_start = std::chrono::steady_clock::now();
+    }
+
+    ~FRAME_PROFILER_SCOPE()
+    {
+        if( m_active )
+        {
+            auto elapsed = std::chrono::steady_clock::now() - m_start;
+
+            FRAME_PROFILER::Instance().AddSample( m_section,
+                    std::chrono::duration_cast<std::chrono::nanoseconds>( elapsed ).count() );
+        }
+    }
+
+private:
+    FRAME_PROFILER::SECTION m_section;
+    bool m_active;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+#endif /* FRAME_PROFILER_H */
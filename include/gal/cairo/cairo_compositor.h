@@ -32,9 +32,11 @@
 #define CAIRO_COMPOSITOR_H_
 
 #include <gal/compositor.h>
+#include <math/box2.h>
 #include <cairo.h>
 #include <boost/smart_ptr/shared_array.hpp>
 #include <deque>
+#include <vector>
 
 namespace KIGFX
 {
@@ -89,6 +91,47 @@ public:
         cairo_get_matrix( m_mainContext, &m_matrix );
     }
 
+    /**
+     * Function SetTileCount()
+     * Splits the buffers into a grid of tiles that may be rendered concurrently. The actual
+     * number of tiles may be lower, so the tiles are not too small.
+     *
+     * @param aCount is the requested number of tiles, tiling is disabled if it is less than 2.
+     */
+    void SetTileCount( int aCount );
+
+    /// Returns the number of tiles the buffers are split into
+    int GetTileCount() const
+    {
+        return m_tiles.size();
+    }
+
+    /// Returns the area covered by a tile (in pixels)
+    const BOX2I& GetTileArea( int aTile ) const
+    {
+        return m_tiles[aTile];
+    }
+
+    /**
+     * Function GetTileContext()
+     * Returns a context drawing to a tile of the current buffer. Tile surfaces share
+     * the pixel storage with the buffer, so the buffer contains the tile drawings as soon
+     * as the tile context is flushed. The context has the current buffer transformation
+     * applied, shifted to the tile origin.
+     *
+     * @param aTile is the tile index.
+     */
+    cairo_t* GetTileContext( int aTile );
+
+    /**
+     * Function SetClipArea()
+     * Restricts drawing to the current buffer and clearing it to a part of the buffer.
+     *
+     * @param aArea is the area that may be modified (in pixels), an empty area removes
+     * the restriction.
+     */
+    void SetClipArea( const BOX2I& aArea );
+
 protected:
     typedef boost::shared_array<unsigned int> BitmapPtr;
     typedef struct
@@ -96,6 +139,8 @@ protected:
         cairo_t*            context;        ///< Main texture handle
         cairo_surface_t*    surface;        ///< Point to which an image from texture is attached
         BitmapPtr           bitmap;         ///< Pixel storage
+        std::vector<cairo_t*> tileContexts; ///< Contexts drawing to the tiles (created on demand)
+        BOX2I               clipArea;       ///< Area drawing is restricted to (empty if none)
     } CAIRO_BUFFER;
 
     unsigned int            m_current;      ///< Currently used buffer handle
@@ -116,6 +161,18 @@ protected:
     unsigned int m_stride;              ///< Stride to use given the desired format and width
     unsigned int m_bufferSize;          ///< Amount of memory needed to store a buffer
 
+    int m_tileCount;                    ///< Requested number of tiles
+    std::vector<BOX2I> m_tiles;         ///< Tile areas (in pixels)
+
+    ///> Minimal width and height of a tile (in pixels)
+    static const int MIN_TILE_SIZE = 64;
+
+    /**
+     * Function destroyTiles()
+     * destroys the tile contexts of all buffers.
+     */
+    void destroyTiles();
+
     /**
      * Function clean()
      * performs freeing of resources.
@@ -32,10 +32,11 @@
 
 #include <cairo.h>
 
-#include <gal/graphics_abstraction_layer.h>
+#include <gal/cairo/cairo_gal_base.h>
 #include <wx/dcbuffer.h>
 
 #include <memory>
+#include <vector>
 
 #if defined(__WXMSW__)
 #define SCREEN_DEPTH 24
@@ -63,7 +64,7 @@ namespace KIGFX
 {
 class CAIRO_COMPOSITOR;
 
-class CAIRO_GAL : public GAL, public wxWindow
+class CAIRO_GAL : public CAIRO_GAL_BASE, public wxWindow
 {
 public:
     /**
@@ -101,36 +102,6 @@ public:
     /// @copydoc GAL::EndDrawing()
     virtual void EndDrawing() override;
 
-    /// @copydoc GAL::DrawLine()
-    virtual void DrawLine( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint ) override;
-
-    /// @copydoc GAL::DrawSegment()
-    virtual void DrawSegment( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint, double aWidth ) override;
-
-    /// @copydoc GAL::DrawCircle()
-    virtual void DrawCircle( const VECTOR2D& aCenterPoint, double aRadius ) override;
-
-    /// @copydoc GAL::DrawArc()
-    virtual void DrawArc( const VECTOR2D& aCenterPoint, double aRadius,
-                          double aStartAngle, double aEndAngle ) override;
-
-    /// @copydoc GAL::DrawRectangle()
-    virtual void DrawRectangle( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint ) override;
-
-    /// @copydoc GAL::DrawPolyline()
-    virtual void DrawPolyline( const std::deque<VECTOR2D>& aPointList ) override { drawPoly( aPointList ); }
-    virtual void DrawPolyline( const VECTOR2D aPointList[], int aListSize ) override { drawPoly( aPointList, aListSize ); }
-    virtual void DrawPolyline( const SHAPE_LINE_CHAIN& aLineChain ) override { drawPoly( aLineChain ); }
-
-    /// @copydoc GAL::DrawPolygon()
-    virtual void DrawPolygon( const std::deque<VECTOR2D>& aPointList ) override { drawPoly( aPointList ); }
-    virtual void DrawPolygon( const VECTOR2D aPointList[], int aListSize ) override { drawPoly( aPointList, aListSize ); }
-    virtual void DrawPolygon( const SHAPE_POLY_SET& aPolySet ) override;
-
-    /// @copydoc GAL::DrawCurve()
-    virtual void DrawCurve( const VECTOR2D& startPoint, const VECTOR2D& controlPointA,
-                            const VECTOR2D& controlPointB, const VECTOR2D& endPoint ) override;
-
     // --------------
     // Screen methods
     // --------------
@@ -141,81 +112,6 @@ public:
     /// @brief Shows/hides the GAL canvas
     virtual bool Show( bool aShow ) override;
 
-    /// @copydoc GAL::Flush()
-    virtual void Flush() override;
-
-    /// @copydoc GAL::ClearScreen()
-    virtual void ClearScreen( const COLOR4D& aColor ) override;
-
-    // -----------------
-    // Attribute setting
-    // -----------------
-
-    /// @copydoc GAL::SetIsFill()
-    virtual void SetIsFill( bool aIsFillEnabled ) override;
-
-    /// @copydoc GAL::SetIsStroke()
-    virtual void SetIsStroke( bool aIsStrokeEnabled ) override;
-
-    /// @copydoc GAL::SetStrokeColor()
-    virtual void SetStrokeColor( const COLOR4D& aColor ) override;
-
-    /// @copydoc GAL::SetFillColor()
-    virtual void SetFillColor( const COLOR4D& aColor ) override;
-
-    /// @copydoc GAL::SetLineWidth()
-    virtual void SetLineWidth( double aLineWidth ) override;
-
-    /// @copydoc GAL::SetLayerDepth()
-    virtual void SetLayerDepth( double aLayerDepth ) override;
-
-    // --------------
-    // Transformation
-    // --------------
-
-    /// @copydoc GAL::Transform()
-    virtual void Transform( const MATRIX3x3D& aTransformation ) override;
-
-    /// @copydoc GAL::Rotate()
-    virtual void Rotate( double aAngle ) override;
-
-    /// @copydoc GAL::Translate()
-    virtual void Translate( const VECTOR2D& aTranslation ) override;
-
-    /// @copydoc GAL::Scale()
-    virtual void Scale( const VECTOR2D& aScale ) override;
-
-    /// @copydoc GAL::Save()
-    virtual void Save() override;
-
-    /// @copydoc GAL::Restore()
-    virtual void Restore() override;
-
-    // --------------------------------------------
-    // Group methods
-    // ---------------------------------------------
-
-    /// @copydoc GAL::BeginGroup()
-    virtual int BeginGroup() override;
-
-    /// @copydoc GAL::EndGroup()
-    virtual void EndGroup() override;
-
-    /// @copydoc GAL::DrawGroup()
-    virtual void DrawGroup( int aGroupNumber ) override;
-
-    /// @copydoc GAL::ChangeGroupColor()
-    virtual void ChangeGroupColor( int aGroupNumber, const COLOR4D& aNewColor ) override;
-
-    /// @copydoc GAL::ChangeGroupDepth()
-    virtual void ChangeGroupDepth( int aGroupNumber, int aDepth ) override;
-
-    /// @copydoc GAL::DeleteGroup()
-    virtual void DeleteGroup( int aGroupNumber ) override;
-
-    /// @copydoc GAL::ClearCache()
-    virtual void ClearCache() override;
-
     // --------------------------------------------------------
     // Handling the world <-> screen transformation
     // --------------------------------------------------------
@@ -226,15 +122,6 @@ public:
     /// @copydoc GAL::RestoreScreen()
     virtual void RestoreScreen() override;
 
-    /// @copydoc GAL::SetTarget()
-    virtual void SetTarget( RENDER_TARGET aTarget ) override;
-
-    /// @copydoc GAL::GetTarget()
-    virtual RENDER_TARGET GetTarget() const override;
-
-    /// @copydoc GAL::ClearTarget()
-    virtual void ClearTarget( RENDER_TARGET aTarget ) override;
-
     // -------
     // Cursor
     // -------
@@ -269,20 +156,7 @@ public:
         paintListener = aPaintListener;
     }
 
-protected:
-    virtual void drawGridLine( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint ) override;
-
 private:
-    /// Super class definition
-    typedef GAL super;
-
-    // Compositing variables
-    std::shared_ptr<CAIRO_COMPOSITOR> compositor;   ///< Object for layers compositing
-    unsigned int            mainBuffer;             ///< Handle to the main buffer
-    unsigned int            overlayBuffer;          ///< Handle to the overlay buffer
-    RENDER_TARGET           currentTarget;          ///< Current rendering target
-    bool                    validCompositor;        ///< Compositor initialization flag
-
     // Variables related to wxWidgets
     wxWindow*               parentWindow;           ///< Parent window
     wxEvtHandler*           mouseListener;          ///< Mouse listener
@@ -297,65 +171,16 @@ private:
     wxBitmap*               cursorPixels;           ///< Cursor pixels
     wxBitmap*               cursorPixelsSaved;      ///< Saved cursor pixels
 
-    /// Maximum number of arguments for one command
-    static const int MAX_CAIRO_ARGUMENTS = 4;
-
-    /// Definitions for the command recorder
-    enum GRAPHICS_COMMAND
-    {
-        CMD_SET_FILL,                               ///< Enable/disable filling
-        CMD_SET_STROKE,                             ///< Enable/disable stroking
-        CMD_SET_FILLCOLOR,                          ///< Set the fill color
-        CMD_SET_STROKECOLOR,                        ///< Set the stroke color
-        CMD_SET_LINE_WIDTH,                         ///< Set the line width
-        CMD_STROKE_PATH,                            ///< Set the stroke path
-        CMD_FILL_PATH,                              ///< Set the fill path
-        //CMD_TRANSFORM,                              ///< Transform the actual context
-        CMD_ROTATE,                                 ///< Rotate the context
-        CMD_TRANSLATE,                              ///< Translate the context
-        CMD_SCALE,                                  ///< Scale the context
-        CMD_SAVE,                                   ///< Save the transformation matrix
-        CMD_RESTORE,                                ///< Restore the transformation matrix
-        CMD_CALL_GROUP                              ///< Call a group
-    };
-
-    /// Type definition for an graphics group element
-    typedef struct
-    {
-        GRAPHICS_COMMAND command;                   ///< Command to execute
-        union {
-            double dblArg[MAX_CAIRO_ARGUMENTS];     ///< Arguments for Cairo commands
-            bool boolArg;                           ///< A bool argument
-            int intArg;                             ///< An int argument
-        } argument;
-        cairo_path_t* cairoPath;                    ///< Pointer to a Cairo path
-    } GROUP_ELEMENT;
-
-    // Variables for the grouping function
-    bool                        isGrouping;         ///< Is grouping enabled ?
-    bool                        isElementAdded;     ///< Was an graphic element added ?
-    typedef std::deque<GROUP_ELEMENT> GROUP;        ///< A graphic group type definition
-    std::map<int, GROUP>        groups;             ///< List of graphic groups
-    unsigned int                groupCounter;       ///< Counter used for generating keys for groups
-    GROUP*                      currentGroup;       ///< Currently used group
-
     // Variables related to Cairo <-> wxWidgets
     cairo_matrix_t      cairoWorldScreenMatrix; ///< Cairo world to screen transformation matrix
-    cairo_t*            currentContext;         ///< Currently used Cairo context for drawing
     cairo_t*            context;                ///< Cairo image
     cairo_surface_t*    surface;                ///< Cairo surface
     unsigned int*       bitmapBuffer;           ///< Storage of the cairo image
     unsigned int*       bitmapBufferBackup;     ///< Backup storage of the cairo image
     int                 stride;                 ///< Stride value for Cairo
-    bool                isInitialized;          ///< Are Cairo image & surface ready to use
-    COLOR4D             backgroundColor;        ///< Background color
 
     int wxBufferWidth;
 
-    void flushPath();
-    // Methods
-    void storePath();                           ///< Store the actual path
-
     // Event handlers
     /**
      * @brief Paint event handler.
@@ -382,10 +207,10 @@ private:
     virtual void blitCursor( wxMemoryDC& clientDC );
 
     /// Prepare Cairo surfaces for drawing
-    void initSurface();
+    virtual void initSurface() override;
 
     /// Destroy Cairo surfaces when are not needed anymore
-    void deinitSurface();
+    virtual void deinitSurface() override;
 
     /// Allocate the bitmaps for drawing
     void allocateBitmaps();
@@ -393,21 +218,6 @@ private:
     /// Allocate the bitmaps for drawing
     void deleteBitmaps();
 
-    /// Prepare the compositor
-    void setCompositor();
-
-    /// Drawing polygons & polylines is the same in cairo, so here is the common code
-    void drawPoly( const std::deque<VECTOR2D>& aPointList );
-    void drawPoly( const VECTOR2D aPointList[], int aListSize );
-    void drawPoly( const SHAPE_LINE_CHAIN& aLineChain );
-
-    /**
-     * @brief Returns a valid key that can be used as a new group number.
-     *
-     * @return An unique group number that is not used by any other group.
-     */
-    unsigned int getNewGroupNumber();
-
     /// Format used to store pixels
     static const cairo_format_t GAL_FORMAT = CAIRO_FORMAT_RGB24;
 
@@ -0,0 +1,311 @@
+/*
+ * This program source code file is part of KICAD, a free EDA CAD application.
+ *
+ * Copyright (C) 2012 Torsten Hueter, torstenhtr <at> gmx.de
+ * Copyright (C) 2012-2017 Kicad Developers, see change_log.txt for contributors.
+ * Copyright (C) 2017 CERN
+ * @author Maciej Suminski <maciej.suminski@cern.ch>
+ *
+ * Drawing part of the Cairo Graphics Abstraction Layer
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef CAIRO_GAL_BASE_H_
+#define CAIRO_GAL_BASE_H_
+
+#include <map>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include <cairo.h>
+
+#include <gal/graphics_abstraction_layer.h>
+
+namespace KIGFX
+{
+class CAIRO_COMPOSITOR;
+
+/**
+ * @brief Class CAIRO_GAL_BASE draws the primitives using a Cairo context.
+ *
+ * It contains the part of CAIRO_GAL that does not depend on wxWidgets. Standalone instances
+ * draw to a context provided with SetContext() and do not share any state with other GALs,
+ * so they may be used by worker threads to render parts of the screen (see CAIRO_GAL::GetTile()).
+ */
+class CAIRO_GAL_BASE : public GAL
+{
+public:
+    CAIRO_GAL_BASE();
+
+    virtual ~CAIRO_GAL_BASE();
+
+    // ---------------
+    // Drawing methods
+    // ---------------
+
+    /// @copydoc GAL::DrawLine()
+    virtual void DrawLine( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint ) override;
+
+    /// @copydoc GAL::DrawSegment()
+    virtual void DrawSegment( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint, double aWidth ) override;
+
+    /// @copydoc GAL::DrawCircle()
+    virtual void DrawCircle( const VECTOR2D& aCenterPoint, double aRadius ) override;
+
+    /// @copydoc GAL::DrawArc()
+    virtual void DrawArc( const VECTOR2D& aCenterPoint, double aRadius,
+                          double aStartAngle, double aEndAngle ) override;
+
+    /// @copydoc GAL::DrawRectangle()
+    virtual void DrawRectangle( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint ) override;
+
+    /// @copydoc GAL::DrawPolyline()
+    virtual void DrawPolyline( const std::deque<VECTOR2D>& aPointList ) override { drawPoly( aPointList ); }
+    virtual void DrawPolyline( const VECTOR2D aPointList[], int aListSize ) override { drawPoly( aPointList, aListSize ); }
+    virtual void DrawPolyline( const SHAPE_LINE_CHAIN& aLineChain ) override { drawPoly( aLineChain ); }
+
+    /// @copydoc GAL::DrawPolylines()
+    virtual void DrawPolylines( const VECTOR2D aPoints[], const int aPolylineSizes[],
+                                int aPolylineCount ) override;
+
+    /// @copydoc GAL::DrawPolygon()
+    virtual void DrawPolygon( const std::deque<VECTOR2D>& aPointList ) override { drawPoly( aPointList ); }
+    virtual void DrawPolygon( const VECTOR2D aPointList[], int aListSize ) override { drawPoly( aPointList, aListSize ); }
+    virtual void DrawPolygon( const SHAPE_POLY_SET& aPolySet ) override;
+
+    /// @copydoc GAL::DrawCurve()
+    virtual void DrawCurve( const VECTOR2D& startPoint, const VECTOR2D& controlPointA,
+                            const VECTOR2D& controlPointB, const VECTOR2D& endPoint ) override;
+
+    // --------------
+    // Screen methods
+    // --------------
+
+    /// @copydoc GAL::Flush()
+    virtual void Flush() override;
+
+    /// @copydoc GAL::ClearScreen()
+    virtual void ClearScreen( const COLOR4D& aColor ) override;
+
+    // -----------------
+    // Attribute setting
+    // -----------------
+
+    /// @copydoc GAL::SetIsFill()
+    virtual void SetIsFill( bool aIsFillEnabled ) override;
+
+    /// @copydoc GAL::SetIsStroke()
+    virtual void SetIsStroke( bool aIsStrokeEnabled ) override;
+
+    /// @copydoc GAL::SetStrokeColor()
+    virtual void SetStrokeColor( const COLOR4D& aColor ) override;
+
+    /// @copydoc GAL::SetFillColor()
+    virtual void SetFillColor( const COLOR4D& aColor ) override;
+
+    /// @copydoc GAL::SetLineWidth()
+    virtual void SetLineWidth( double aLineWidth ) override;
+
+    /// @copydoc GAL::SetLayerDepth()
+    virtual void SetLayerDepth( double aLayerDepth ) override;
+
+    // --------------
+    // Transformation
+    // --------------
+
+    /// @copydoc GAL::Transform()
+    virtual void Transform( const MATRIX3x3D& aTransformation ) override;
+
+    /// @copydoc GAL::Rotate()
+    virtual void Rotate( double aAngle ) override;
+
+    /// @copydoc GAL::Translate()
+    virtual void Translate( const VECTOR2D& aTranslation ) override;
+
+    /// @copydoc GAL::Scale()
+    virtual void Scale( const VECTOR2D& aScale ) override;
+
+    /// @copydoc GAL::Save()
+    virtual void Save() override;
+
+    /// @copydoc GAL::Restore()
+    virtual void Restore() override;
+
+    // --------------------------------------------
+    // Group methods
+    // ---------------------------------------------
+
+    /// @copydoc GAL::BeginGroup()
+    virtual int BeginGroup() override;
+
+    /// @copydoc GAL::EndGroup()
+    virtual void EndGroup() override;
+
+    /// @copydoc GAL::DrawGroup()
+    virtual void DrawGroup( int aGroupNumber ) override;
+
+    /// @copydoc GAL::ChangeGroupColor()
+    virtual void ChangeGroupColor( int aGroupNumber, const COLOR4D& aNewColor ) override;
+
+    /// @copydoc GAL::ChangeGroupDepth()
+    virtual void ChangeGroupDepth( int aGroupNumber, int aDepth ) override;
+
+    /// @copydoc GAL::DeleteGroup()
+    virtual void DeleteGroup( int aGroupNumber ) override;
+
+    /// @copydoc GAL::ClearCache()
+    virtual void ClearCache() override;
+
+    /// @copydoc GAL::SetTarget()
+    virtual void SetTarget( RENDER_TARGET aTarget ) override;
+
+    /// @copydoc GAL::GetTarget()
+    virtual RENDER_TARGET GetTarget() const override;
+
+    /// @copydoc GAL::ClearTarget()
+    virtual void ClearTarget( RENDER_TARGET aTarget ) override;
+
+    // ---------------
+    // Tiled rendering
+    // ---------------
+
+    /// @copydoc GAL::GetTileCount()
+    virtual int GetTileCount() const override;
+
+    /// @copydoc GAL::GetTile()
+    virtual GAL* GetTile( int aIndex, BOX2I& aArea ) override;
+
+    /// @copydoc GAL::SetClipArea()
+    virtual bool SetClipArea( const BOX2I& aArea ) override;
+
+    /**
+     * @brief Sets the Cairo context used for drawing. The context is not owned by the GAL
+     * and has to have the world to screen transformation already applied.
+     *
+     * @param aContext is the new context.
+     */
+    void SetContext( cairo_t* aContext );
+
+protected:
+    /**
+     * @brief Copies the settings that affect the world <-> screen transformation
+     * to another instance.
+     */
+    void copyViewSettings( CAIRO_GAL_BASE& aTarget ) const;
+
+    virtual void drawGridLine( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint ) override;
+
+    /// Prepare Cairo surfaces for drawing (standalone instances draw to a provided context)
+    virtual void initSurface() {}
+
+    /// Destroy Cairo surfaces when are not needed anymore
+    virtual void deinitSurface() {}
+
+    void flushPath();
+    void storePath();                           ///< Store the actual path
+
+    /// Drawing polygons & polylines is the same in cairo, so here is the common code
+    void drawPoly( const std::deque<VECTOR2D>& aPointList );
+    void drawPoly( const VECTOR2D aPointList[], int aListSize );
+    void drawPoly( const SHAPE_LINE_CHAIN& aLineChain );
+
+    /// Prepare the compositor, drawing to the buffers created for the current context
+    void setCompositor();
+
+    /**
+     * @brief Finishes the frame for the compositor buffers: removes the clip area set with
+     * SetClipArea() and marks the buffers as holding a complete frame.
+     */
+    void finishBuffers();
+
+    /**
+     * @brief Returns a valid key that can be used as a new group number.
+     *
+     * @return An unique group number that is not used by any other group.
+     */
+    unsigned int getNewGroupNumber();
+
+    /// Maximum number of arguments for one command
+    static const int MAX_CAIRO_ARGUMENTS = 4;
+
+    /// Definitions for the command recorder
+    enum GRAPHICS_COMMAND
+    {
+        CMD_SET_FILL,                               ///< Enable/disable filling
+        CMD_SET_STROKE,                             ///< Enable/disable stroking
+        CMD_SET_FILLCOLOR,                          ///< Set the fill color
+        CMD_SET_STROKECOLOR,                        ///< Set the stroke color
+        CMD_SET_LINE_WIDTH,                         ///< Set the line width
+        CMD_STROKE_PATH,                            ///< Set the stroke path
+        CMD_FILL_PATH,                              ///< Set the fill path
+        //CMD_TRANSFORM,                              ///< Transform the actual context
+        CMD_ROTATE,                                 ///< Rotate the context
+        CMD_TRANSLATE,                              ///< Translate the context
+        CMD_SCALE,                                  ///< Scale the context
+        CMD_SAVE,                                   ///< Save the transformation matrix
+        CMD_RESTORE,                                ///< Restore the transformation matrix
+        CMD_CALL_GROUP                              ///< Call a group
+    };
+
+    /// Type definition for an graphics group element
+    typedef struct
+    {
+        GRAPHICS_COMMAND command;                   ///< Command to execute
+        union {
+            double dblArg[MAX_CAIRO_ARGUMENTS];     ///< Arguments for Cairo commands
+            bool boolArg;                           ///< A bool argument
+            int intArg;                             ///< An int argument
+        } argument;
+        cairo_path_t* cairoPath;                    ///< Pointer to a Cairo path
+    } GROUP_ELEMENT;
+
+    // Variables for the grouping function
+    bool                        isGrouping;         ///< Is grouping enabled ?
+    bool                        isElementAdded;     ///< Was an graphic element added ?
+    typedef std::deque<GROUP_ELEMENT> GROUP;        ///< A graphic group type definition
+    std::map<int, GROUP>        groups;             ///< List of graphic groups
+    unsigned int                groupCounter;       ///< Counter used for generating keys for groups
+    GROUP*                      currentGroup;       ///< Currently used group
+
+    // Compositing variables
+    std::shared_ptr<CAIRO_COMPOSITOR> compositor;   ///< Object for layers compositing
+    unsigned int            mainBuffer;             ///< Handle to the main buffer
+    unsigned int            overlayBuffer;          ///< Handle to the overlay buffer
+    RENDER_TARGET           currentTarget;          ///< Current rendering target
+    bool                    validCompositor;        ///< Compositor initialization flag
+    bool                    buffersPreserved;       ///< Do buffers hold the previous frame?
+    bool                    isClipped;              ///< Is the main buffer clipped?
+
+    ///> GALs drawing to the tiles of the current render target
+    std::vector< std::unique_ptr<CAIRO_GAL_BASE> > tiles;
+
+    cairo_t*            currentContext;         ///< Currently used Cairo context for drawing
+    bool                isInitialized;          ///< Are Cairo image & surface ready to use
+    COLOR4D             backgroundColor;        ///< Background color
+
+    ///> Number of tiles the screen is split into for each rendering thread
+    static const int TILES_PER_THREAD = 2;
+
+private:
+    /// Super class definition
+    typedef GAL super;
+};
+} // namespace KIGFX
+
+#endif  // CAIRO_GAL_BASE_H_
@@ -0,0 +1,103 @@
+/*
+ * This program source code file is part of KICAD, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 CERN
+ * Copyright (C) 2017 Kicad Developers, see change_log.txt for contributors.
+ *
+ * Offscreen Cairo Graphics Abstraction Layer
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef CAIRO_IMAGE_GAL_H_
+#define CAIRO_IMAGE_GAL_H_
+
+#include <gal/cairo/cairo_gal_base.h>
+
+#include <string>
+#include <vector>
+
+namespace KIGFX
+{
+/**
+ * @brief Class CAIRO_IMAGE_GAL renders to an image kept in the main memory.
+ *
+ * It does not need a window nor a display connection, so it may be used to render boards
+ * from command line tools (e.g. to compare drawing results and measure rendering performance).
+ * Layers are composited and the screen is split into tiles the same way as in CAIRO_GAL.
+ */
+class CAIRO_IMAGE_GAL : public CAIRO_GAL_BASE
+{
+public:
+    /**
+     * @brief Constructor CAIRO_IMAGE_GAL
+     *
+     * @param aWidth is the width of the image (in pixels).
+     * @param aHeight is the height of the image (in pixels).
+     */
+    CAIRO_IMAGE_GAL( int aWidth, int aHeight );
+
+    virtual ~CAIRO_IMAGE_GAL();
+
+    /// @copydoc GAL::BeginDrawing()
+    virtual void BeginDrawing() override;
+
+    /// @copydoc GAL::EndDrawing()
+    virtual void EndDrawing() override;
+
+    /// @copydoc GAL::ResizeScreen()
+    virtual void ResizeScreen( int aWidth, int aHeight ) override;
+
+    /**
+     * @brief Sets the number of tiles the image is split into when drawing.
+     *
+     * @param aCount is the requested number of tiles, 0 disables tiling and a negative value
+     * selects the number of tiles depending on the number of threads (the default).
+     */
+    void SetTileCount( int aCount );
+
+    /**
+     * @brief Saves the last rendered image to a PNG file.
+     *
+     * @param aFileName is the name of the output file.
+     * @return True in case of success.
+     */
+    bool SaveImage( const std::string& aFileName ) const;
+
+private:
+    cairo_matrix_t      cairoWorldScreenMatrix; ///< Cairo world to screen transformation matrix
+    cairo_t*            context;                ///< Cairo image
+    cairo_surface_t*    surface;                ///< Cairo surface
+    std::vector<unsigned int> bitmapBuffer;     ///< Storage of the cairo image
+    int                 stride;                 ///< Stride value for Cairo
+    int                 tileCount;              ///< Requested number of tiles
+
+    /// Prepare Cairo surfaces for drawing
+    virtual void initSurface() override;
+
+    /// Destroy Cairo surfaces when are not needed anymore
+    virtual void deinitSurface() override;
+
+    /// Allocate the bitmap for drawing
+    void allocateBitmap();
+
+    /// Format used to store pixels
+    static const cairo_format_t GAL_FORMAT = CAIRO_FORMAT_RGB24;
+};
+} // namespace KIGFX
+
+#endif  // CAIRO_IMAGE_GAL_H_
@@ -122,6 +122,24 @@ public:
     virtual void DrawPolyline( const VECTOR2D aPointList[], int aListSize ) {};
     virtual void DrawPolyline( const SHAPE_LINE_CHAIN& aLineChain ) {};
 
+    /**
+     * @brief Draw a set of polylines sharing the current stroke settings. The points of
+     * all polylines are stored one after another.
+     *
+     * @param aPoints is the array of points of all polylines.
+     * @param aPolylineSizes is the array containing the number of points of each polyline.
+     * @param aPolylineCount is the number of polylines.
+     */
+    virtual void DrawPolylines( const VECTOR2D aPoints[], const int aPolylineSizes[],
+                                int aPolylineCount )
+    {
+        for( int i = 0; i < aPolylineCount; ++i )
+        {
+            DrawPolyline( aPoints, aPolylineSizes[i] );
+            aPoints += aPolylineSizes[i];
+        }
+    }
+
     /**
      * @brief Draw a circle using world coordinates.
      *
@@ -523,6 +541,22 @@ public:
      */
     virtual void DrawGroup( int aGroupNumber ) {};
 
+    /**
+     * @brief Draw a translated copy of the stored group. It allows drawing repeated geometry
+     * (e.g. identical vias) using a single group. The group should be created with
+     * coordinates relative to its origin.
+     *
+     * @param aGroupNumber is the group number.
+     * @param aOffset is the translation applied to the group.
+     */
+    virtual void DrawGroupInstance( int aGroupNumber, const VECTOR2D& aOffset ) {};
+
+    /**
+     * @brief Returns true if the GAL is able to draw translated copies of groups.
+     * @see DrawGroupInstance()
+     */
+    virtual bool IsInstancingSupported() const { return false; }
+
     /**
      * @brief Changes the color used to draw the group.
      *
@@ -551,6 +585,66 @@ public:
      */
     virtual void ClearCache() {};
 
+    /**
+     * @brief Returns a GAL instance that creates groups in the main memory, independently of
+     * this GAL, so it may be used by a worker thread. The instance is owned by this GAL and has
+     * its current world scale and flipping settings applied. Groups created with it are moved
+     * to the cache of this GAL with ImportGroup().
+     *
+     * @param aIndex is the tessellator index, every thread has to use a different one.
+     * @return the tessellator or NULL if the GAL does not support offline tessellation.
+     */
+    virtual GAL* GetTessellator( int aIndex ) { return NULL; };
+
+    /**
+     * @brief Creates a new group containing a copy of a group created by a tessellator.
+     *
+     * @param aTessellator is the tessellator returned by GetTessellator().
+     * @param aGroupNumber is the group number in the tessellator.
+     * @return the number of the new group.
+     */
+    virtual int ImportGroup( GAL* aTessellator, int aGroupNumber ) { return -1; };
+
+    // --------------------------------------------------------
+    // Tiled rendering
+    // --------------------------------------------------------
+
+    /**
+     * @brief Returns the number of tiles the screen is split into, so its parts may be
+     * rendered concurrently.
+     *
+     * @return the number of tiles or 0 if the GAL does not support tiled rendering.
+     */
+    virtual int GetTileCount() const { return 0; };
+
+    /**
+     * @brief Returns a GAL instance drawing to a part of the current render target. Every
+     * tile may be used by a different thread and its drawings become a part of the render
+     * target as soon as they are flushed. The instance is owned by this GAL and has its current
+     * view settings applied. Tiles draw only in the immediate mode.
+     *
+     * @param aIndex is the tile index, from 0 to GetTileCount() - 1.
+     * @param aArea is set to the screen area covered by the tile (in pixels).
+     * @return the tile or NULL if the GAL does not support tiled rendering.
+     */
+    virtual GAL* GetTile( int aIndex, BOX2I& aArea ) { return NULL; };
+
+    // --------------------------------------------------------
+    // Partial redraw
+    // --------------------------------------------------------
+
+    /**
+     * @brief Restricts drawing to the cached and noncached targets (including clearing them)
+     * to a part of the screen until the end of the current frame, so only the part has to be
+     * redrawn. It has to be called between BeginDrawing() and EndDrawing().
+     *
+     * @param aArea is the area to be redrawn (in pixels), it may be empty if nothing is going
+     * to be redrawn.
+     * @return false if the GAL cannot redraw a part of the targets (e.g. it does not keep
+     * the target contents between frames), the targets have to be redrawn as a whole then.
+     */
+    virtual bool SetClipArea( const BOX2I& aArea ) { return false; };
+
     // --------------------------------------------------------
     // Handling the world <-> screen transformation
     // --------------------------------------------------------
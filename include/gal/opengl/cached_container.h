@@ -33,8 +33,7 @@
 #define CACHED_CONTAINER_H_
 
 #include <gal/opengl/vertex_container.h>
-#include <map>
-#include <set>
+#include <gal/opengl/chunk_allocator.h>
 
 namespace KIGFX
 {
@@ -86,24 +85,33 @@ public:
     ///> @copydoc VERTEX_CONTAINER::Unmap()
     void Unmap() override;
 
-protected:
-    ///> Maps size of free memory chunks to their offsets
-    typedef std::pair<unsigned int, unsigned int> CHUNK;
-    typedef std::multimap<unsigned int, unsigned int> FREE_CHUNK_MAP;
+    ///> @copydoc VERTEX_CONTAINER::Compact()
+    void Compact() override;
 
-    /// List of all the stored items
-    typedef std::set<VERTEX_ITEM*> ITEMS;
+    ///> Memory management statistics, useful for profiling
+    struct STATS : public CHUNK_ALLOCATOR::STATS
+    {
+        unsigned int    m_largestFreeChunk;     ///< Size of the largest free chunk
+        unsigned int    m_containerResizes;     ///< Number of times the buffer was enlarged
+        unsigned long   m_relocatedVertices;    ///< Vertices copied to grow an item
+        unsigned long   m_compactedVertices;    ///< Vertices moved by compaction
+    };
 
-    ///> Stores size & offset of free chunks.
-    FREE_CHUNK_MAP      m_freeChunks;
+    /**
+     * Function GetStats()
+     * returns the current memory management statistics.
+     */
+    STATS GetStats() const;
 
-    ///> Stored VERTEX_ITEMs
-    ITEMS               m_items;
+protected:
+    ///> Manages the vertex buffer space, each stored item owns a chunk
+    CHUNK_ALLOCATOR     m_allocator;
 
     ///> Currently modified item
     VERTEX_ITEM*        m_item;
 
     ///> Properties of currently modified chunk & item
+    int                 m_chunk;
     unsigned int        m_chunkSize;
     unsigned int        m_chunkOffset;
 
@@ -119,6 +127,14 @@ protected:
     ///> Flag saying whether it is safe to use glCopyBufferSubData
     bool m_useCopyBuffer;
 
+    ///> Counters that are not tracked by the allocator
+    unsigned int m_containerResizes;
+    unsigned long m_relocatedVertices;
+    unsigned long m_compactedVertices;
+
+    ///> Maximal number of vertices moved by a single compaction step
+    static const unsigned int COMPACTION_BUDGET = 65536;
+
     /**
      * Function init()
      * performs the GL vertex buffer initialization. It can be invoked only when an OpenGL context
@@ -138,22 +154,23 @@ protected:
     bool reallocate( unsigned int aSize );
 
     /**
-     * Function defragmentResize()
-     * removes empty spaces between chunks and optionally resizes the container.
-     * After the operation there is continous space for storing vertices at the end of the container.
+     * Function resize()
+     * enlarges the container. Items keep their offsets, the new space is appended at the end.
      *
      * @param aNewSize is the new size of container, expressed in number of vertices
      * @return false in case of failure (e.g. memory shortage)
      */
-    bool defragmentResize( unsigned int aNewSize );
-    bool defragmentResizeMemcpy( unsigned int aNewSize );
+    bool resize( unsigned int aNewSize );
 
     /**
-     * Function mergeFreeChunks()
-     * looks for consecutive free memory chunks and merges them, decreasing fragmentation of
-     * memory.
+     * Function compact()
+     * moves the items stored at the end of the buffer to free chunks with lower offsets,
+     * so the free space is gathered at the end. The work is bounded, so it can be done
+     * incrementally after each update, instead of defragmenting the whole buffer at once.
+     *
+     * @param aMaxVertices is the maximal number of vertices to be moved.
      */
-    void mergeFreeChunks();
+    void compact( unsigned int aMaxVertices );
 
     /**
      * Function getPowerOf2()
@@ -164,34 +181,6 @@ protected:
     unsigned int getPowerOf2( unsigned int aNumber ) const;
 
 private:
-    /**
-     * Function getChunkSize()
-     * returns size of the given chunk.
-     *
-     * @param aChunk is the chunk.
-     */
-    inline int getChunkSize( const CHUNK& aChunk ) const
-    {
-        return aChunk.first;
-    }
-
-    /**
-     * Function getChunkOffset()
-     * returns offset of the chunk.
-     *
-     * @param aChunk is the chunk.
-     */
-    inline unsigned int getChunkOffset( const CHUNK& aChunk ) const
-    {
-        return aChunk.second;
-    }
-
-    /**
-     * Function addFreeChunk
-     * Adds a chunk marked as free.
-     */
-    void addFreeChunk( unsigned int aOffset, unsigned int aSize );
-
     /// Debug & test functions
     void showFreeChunks();
     void showUsedChunks();
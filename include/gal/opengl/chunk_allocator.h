@@ -0,0 +1,243 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 CERN
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file chunk_allocator.h
+ * @brief Segregated fit allocator managing chunks of a linear address space (e.g. a vertex
+ * buffer). It does not touch the managed memory, so it does not require an OpenGL context.
+ */
+
+#ifndef CHUNK_ALLOCATOR_H_
+#define CHUNK_ALLOCATOR_H_
+
+#include <vector>
+#include <cstdint>
+
+namespace KIGFX
+{
+/**
+ * Class CHUNK_ALLOCATOR
+ *
+ * Manages chunks of the [0, size) range. Free chunks are kept in segregated lists, indexed
+ * by a two level bitmap (a power of 2 size class, subdivided into SL_COUNT linear classes),
+ * so a chunk that fits is found in constant time. Physically adjacent chunks are linked,
+ * hence released chunks are immediately coalesced with their free neighbours, also in
+ * constant time.
+ *
+ * Chunks are identified by handles, which stay valid until the chunk is released.
+ * Sizes and offsets are expressed in abstract units (vertices for CACHED_CONTAINER).
+ */
+class CHUNK_ALLOCATOR
+{
+public:
+    ///> Invalid chunk handle
+    static const int NONE = -1;
+
+    ///> Allocator statistics, useful for profiling
+    struct STATS
+    {
+        unsigned int    m_size;             ///< Managed space
+        unsigned int    m_freeSpace;        ///< Sum of free chunk sizes
+        unsigned int    m_freeChunks;       ///< Number of free chunks
+        unsigned int    m_usedChunks;       ///< Number of allocated chunks
+        unsigned long   m_allocations;      ///< Number of Allocate() calls that succeeded
+        unsigned long   m_releases;         ///< Number of Free() calls
+        unsigned long   m_resizes;          ///< Number of chunks resized in place
+        unsigned long   m_failures;         ///< Number of requests that could not be satisfied
+    };
+
+    CHUNK_ALLOCATOR( unsigned int aSize = 0 );
+
+    /**
+     * Function Reset()
+     * releases all the chunks and sets the size of the managed space.
+     */
+    void Reset( unsigned int aSize );
+
+    /**
+     * Function Grow()
+     * extends the managed space. The chunks keep their offsets, the new space is appended
+     * at the end as free space.
+     *
+     * @param aNewSize is the new size, it cannot be smaller than the current one.
+     */
+    void Grow( unsigned int aNewSize );
+
+    /**
+     * Function Allocate()
+     * reserves a chunk of the requested size. The chunk is taken from the beginning of the
+     * best fitting free chunk, the rest remains free.
+     *
+     * @param aSize is the requested size (greater than 0).
+     * @return Handle of the allocated chunk or NONE if there is no free chunk large enough.
+     */
+    int Allocate( unsigned int aSize );
+
+    /**
+     * Function Free()
+     * releases a chunk and merges it with adjacent free chunks.
+     *
+     * @param aChunk is the handle of the chunk, it becomes invalid after the call.
+     */
+    void Free( int aChunk );
+
+    /**
+     * Function Resize()
+     * changes size of a chunk without moving it. Shrinking always succeeds, the released space
+     * becomes free. Growing succeeds only if the chunk is followed by enough free space.
+     *
+     * @param aChunk is the handle of the chunk.
+     * @param aSize is the new size (greater than 0).
+     * @return true in case of success.
+     */
+    bool Resize( int aChunk, unsigned int aSize );
+
+    inline unsigned int GetOffset( int aChunk ) const
+    {
+        return m_chunks[aChunk].m_offset;
+    }
+
+    inline unsigned int GetSize( int aChunk ) const
+    {
+        return m_chunks[aChunk].m_size;
+    }
+
+    inline bool IsFree( int aChunk ) const
+    {
+        return m_chunks[aChunk].m_free;
+    }
+
+    /**
+     * Function SetData()
+     * associates user data with an allocated chunk (CACHED_CONTAINER stores the owning item).
+     */
+    inline void SetData( int aChunk, void* aData )
+    {
+        m_chunks[aChunk].m_data = aData;
+    }
+
+    inline void* GetData( int aChunk ) const
+    {
+        return m_chunks[aChunk].m_data;
+    }
+
+    ///> Functions to iterate over all chunks (both used and free) in the order of offsets.
+    inline int FirstChunk() const
+    {
+        return m_first;
+    }
+
+    inline int LastChunk() const
+    {
+        return m_last;
+    }
+
+    inline int NextChunk( int aChunk ) const
+    {
+        return m_chunks[aChunk].m_next;
+    }
+
+    inline int PrevChunk( int aChunk ) const
+    {
+        return m_chunks[aChunk].m_prev;
+    }
+
+    inline unsigned int GetFreeSpace() const
+    {
+        return m_stats.m_freeSpace;
+    }
+
+    /**
+     * Function GetLargestFree()
+     * returns size of the largest free chunk.
+     */
+    unsigned int GetLargestFree() const;
+
+    inline const STATS& GetStats() const
+    {
+        return m_stats;
+    }
+
+    /**
+     * Function Check()
+     * verifies consistency of the internal structures.
+     * @return true if no problems were found.
+     */
+    bool Check() const;
+
+private:
+    struct CHUNK
+    {
+        unsigned int    m_offset;
+        unsigned int    m_size;
+        int             m_prev;             ///< Physically preceding chunk
+        int             m_next;             ///< Physically following chunk
+        int             m_prevFree;         ///< Free list links (free chunks only)
+        int             m_nextFree;
+        bool            m_free;
+        void*           m_data;
+    };
+
+    ///> Number of linear subdivisions of a size class (log2)
+    static const int SL_BITS = 3;
+    static const int SL_COUNT = 1 << SL_BITS;
+
+    ///> Number of size classes; sizes below SL_COUNT are mapped to the first one.
+    static const int FL_COUNT = 32 - SL_BITS + 1;
+
+    ///> Computes the size class for a chunk of given size
+    static void mapping( unsigned int aSize, int& aFl, int& aSl );
+
+    ///> Returns a free chunk of at least the given size, without removing it from its list
+    int findFree( unsigned int aSize ) const;
+
+    void insertFree( int aChunk );
+    void removeFree( int aChunk );
+
+    ///> Creates a chunk physically following another one (or the first one for NONE)
+    int createChunk( unsigned int aOffset, unsigned int aSize, int aPrev );
+
+    ///> Unlinks a chunk and returns its handle to the pool
+    void destroyChunk( int aChunk );
+
+    std::vector<CHUNK>  m_chunks;
+    std::vector<int>    m_unusedHandles;
+
+    int                 m_first;
+    int                 m_last;
+
+    ///> Bitmap of non-empty size classes
+    uint32_t            m_flBitmap;
+
+    ///> Bitmaps of non-empty subclasses
+    uint32_t            m_slBitmap[FL_COUNT];
+
+    ///> Heads of the free lists
+    int                 m_heads[FL_COUNT][SL_COUNT];
+
+    STATS               m_stats;
+};
+} // namespace KIGFX
+
+#endif /* CHUNK_ALLOCATOR_H_ */
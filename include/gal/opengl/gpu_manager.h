@@ -31,7 +31,10 @@
 #define GPU_MANAGER_H_
 
 #include <gal/opengl/vertex_common.h>
+#include <math/vector2d.h>
 #include <boost/scoped_array.hpp>
+#include <map>
+#include <vector>
 
 namespace KIGFX
 {
@@ -61,6 +64,16 @@ public:
      */
     virtual void DrawIndices( unsigned int aOffset, unsigned int aSize ) = 0;
 
+    /**
+     * Function DrawInstance()
+     * Makes the GPU draw a translated copy of given range of vertices.
+     * @param aOffset is the beginning of the range.
+     * @param aSize is the number of vertices to be drawn.
+     * @param aTranslation is the translation applied to the vertices.
+     */
+    virtual void DrawInstance( unsigned int aOffset, unsigned int aSize,
+                               const VECTOR2D& aTranslation ) = 0;
+
     /**
      * Function DrawIndices()
      * Makes the GPU draw all the vertices stored in the container.
@@ -94,6 +107,9 @@ protected:
 
     ///> Location of shader attributes (for glVertexAttribPointer)
     int m_shaderAttrib;
+
+    ///> Location of the instance translation shader attribute
+    int m_instanceAttrib;
 };
 
 
@@ -109,6 +125,10 @@ public:
     ///> @copydoc GPU_MANAGER::DrawIndices()
     virtual void DrawIndices( unsigned int aOffset, unsigned int aSize ) override;
 
+    ///> @copydoc GPU_MANAGER::DrawInstance()
+    virtual void DrawInstance( unsigned int aOffset, unsigned int aSize,
+                               const VECTOR2D& aTranslation ) override;
+
     ///> @copydoc GPU_MANAGER::DrawAll()
     virtual void DrawAll() override;
 
@@ -142,6 +162,23 @@ protected:
 
     ///> Current indices buffer size
     unsigned int m_indicesCapacity;
+
+    ///> Draws the instanced ranges of vertices, requires the vertex buffer to be bound
+    void drawInstances();
+
+    ///> Translations (x, y pairs) of instanced ranges of vertices, the key is (offset, size)
+    typedef std::map< std::pair<unsigned int, unsigned int>, std::vector<GLfloat> > INSTANCES;
+    INSTANCES m_instances;
+
+    ///> Number of instances to be drawn in EndDrawing()
+    unsigned int m_instancesSize;
+
+    ///> Handle to the buffer storing instance translations
+    GLuint  m_instanceBuffer;
+
+    ///> Flag saying whether instanced arrays are supported (otherwise instances are drawn
+    ///> one by one)
+    bool m_useInstancedArrays;
 };
 
 
@@ -156,6 +193,10 @@ public:
     ///> @copydoc GPU_MANAGER::DrawIndices()
     virtual void DrawIndices( unsigned int aOffset, unsigned int aSize ) override;
 
+    ///> @copydoc GPU_MANAGER::DrawInstance()
+    virtual void DrawInstance( unsigned int aOffset, unsigned int aSize,
+                               const VECTOR2D& aTranslation ) override;
+
     ///> @copydoc GPU_MANAGER::DrawAll()
     virtual void DrawAll() override;
 
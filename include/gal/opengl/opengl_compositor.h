@@ -34,6 +34,7 @@
 #include <gal/compositor.h>
 #include <gal/opengl/antialiasing.h>
 #include <gal/gal_display_options.h>
+#include <math/box2.h>
 #include <GL/glew.h>
 #include <deque>
 
@@ -88,6 +89,16 @@ public:
     void     DrawBuffer( unsigned int aSourceHandle, unsigned int aDestHandle );
     unsigned int CreateBuffer( VECTOR2U aDimensions );
 
+    /**
+     * Function SetClipArea()
+     * Restricts drawing to the current buffer and clearing it to a part of the screen. It stays
+     * active until it is removed, also when another buffer is selected.
+     *
+     * @param aArea is the area that may be modified (in screen pixels), an empty area removes
+     * the restriction.
+     */
+    void SetClipArea( const BOX2I& aArea );
+
     void SetAntialiasingMode( OPENGL_ANTIALIASING_MODE aMode ); // clears all buffers
     OPENGL_ANTIALIASING_MODE GetAntialiasingMode() const;
 
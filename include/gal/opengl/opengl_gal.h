@@ -33,6 +33,7 @@
 #include <gal/graphics_abstraction_layer.h>
 #include <gal/gal_display_options.h>
 #include <gal/opengl/shader.h>
+#include <gal/opengl/vertex_gal.h>
 #include <gal/opengl/vertex_manager.h>
 #include <gal/opengl/vertex_item.h>
 #include <gal/opengl/cached_container.h>
@@ -42,12 +43,8 @@
 #include <wx/glcanvas.h>
 
 #include <map>
-#include <boost/smart_ptr/shared_array.hpp>
 #include <memory>
-
-#ifndef CALLBACK
-#define CALLBACK
-#endif
+#include <vector>
 
 struct bitmap_glyph;
 
@@ -62,7 +59,7 @@ class SHADER;
  * and quads. The purpose is to provide a fast graphics interface, that takes advantage of modern
  * graphics card GPUs. All methods here benefit thus from the hardware acceleration.
  */
-class OPENGL_GAL : public GAL, public wxGLCanvas, GAL_DISPLAY_OPTIONS_OBSERVER
+class OPENGL_GAL : public VERTEX_GAL, public wxGLCanvas, GAL_DISPLAY_OPTIONS_OBSERVER
 {
 public:
     /**
@@ -117,41 +114,6 @@ public:
     /// @copydoc GAL::EndUpdate()
     virtual void EndUpdate() override;
 
-    /// @copydoc GAL::DrawLine()
-    virtual void DrawLine( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint ) override;
-
-    /// @copydoc GAL::DrawSegment()
-    virtual void DrawSegment( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint,
-                              double aWidth ) override;
-
-    /// @copydoc GAL::DrawCircle()
-    virtual void DrawCircle( const VECTOR2D& aCenterPoint, double aRadius ) override;
-
-    /// @copydoc GAL::DrawArc()
-    virtual void DrawArc( const VECTOR2D& aCenterPoint, double aRadius,
-                          double aStartAngle, double aEndAngle ) override;
-
-    /// @copydoc GAL::DrawRectangle()
-    virtual void DrawRectangle( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint ) override;
-
-    /// @copydoc GAL::DrawPolyline()
-    virtual void DrawPolyline( const std::deque<VECTOR2D>& aPointList ) override;
-    virtual void DrawPolyline( const VECTOR2D aPointList[], int aListSize ) override;
-    virtual void DrawPolyline( const SHAPE_LINE_CHAIN& aLineChain ) override;
-
-    /// @copydoc GAL::DrawPolygon()
-    virtual void DrawPolygon( const std::deque<VECTOR2D>& aPointList ) override;
-    virtual void DrawPolygon( const VECTOR2D aPointList[], int aListSize ) override;
-    virtual void DrawPolygon( const SHAPE_POLY_SET& aPolySet ) override;
-
-    /// @copydoc GAL::DrawCurve()
-    virtual void DrawCurve( const VECTOR2D& startPoint, const VECTOR2D& controlPointA,
-                            const VECTOR2D& controlPointB, const VECTOR2D& endPoint ) override;
-
-    /// @copydoc GAL::BitmapText()
-    virtual void BitmapText( const wxString& aText, const VECTOR2D& aPosition,
-                             double aRotationAngle ) override;
-
     /// @copydoc GAL::DrawGrid()
     virtual void DrawGrid() override;
 
@@ -178,21 +140,6 @@ public:
     /// @copydoc GAL::Transform()
     virtual void Transform( const MATRIX3x3D& aTransformation ) override;
 
-    /// @copydoc GAL::Rotate()
-    virtual void Rotate( double aAngle ) override;
-
-    /// @copydoc GAL::Translate()
-    virtual void Translate( const VECTOR2D& aTranslation ) override;
-
-    /// @copydoc GAL::Scale()
-    virtual void Scale( const VECTOR2D& aScale ) override;
-
-    /// @copydoc GAL::Save()
-    virtual void Save() override;
-
-    /// @copydoc GAL::Restore()
-    virtual void Restore() override;
-
     // --------------------------------------------
     // Group methods
     // ---------------------------------------------
@@ -206,6 +153,15 @@ public:
     /// @copydoc GAL::DrawGroup()
     virtual void DrawGroup( int aGroupNumber ) override;
 
+    /// @copydoc GAL::DrawGroupInstance()
+    virtual void DrawGroupInstance( int aGroupNumber, const VECTOR2D& aOffset ) override;
+
+    /// @copydoc GAL::IsInstancingSupported()
+    virtual bool IsInstancingSupported() const override
+    {
+        return true;
+    }
+
     /// @copydoc GAL::ChangeGroupColor()
     virtual void ChangeGroupColor( int aGroupNumber, const COLOR4D& aNewColor ) override;
 
@@ -218,6 +174,12 @@ public:
     /// @copydoc GAL::ClearCache()
     virtual void ClearCache() override;
 
+    /// @copydoc GAL::GetTessellator()
+    virtual GAL* GetTessellator( int aIndex ) override;
+
+    /// @copydoc GAL::ImportGroup()
+    virtual int ImportGroup( GAL* aTessellator, int aGroupNumber ) override;
+
     // --------------------------------------------------------
     // Handling the world <-> screen transformation
     // --------------------------------------------------------
@@ -237,6 +199,9 @@ public:
     /// @copydoc GAL::ClearTarget()
     virtual void ClearTarget( RENDER_TARGET aTarget ) override;
 
+    /// @copydoc GAL::SetClipArea()
+    virtual bool SetClipArea( const BOX2I& aArea ) override;
+
     // -------
     // Cursor
     // -------
@@ -268,26 +233,13 @@ public:
         paintListener = aPaintListener;
     }
 
-    ///< Parameters passed to the GLU tesselator
-    typedef struct
-    {
-        /// Manager used for storing new vertices
-        VERTEX_MANAGER* vboManager;
-
-        /// Intersect points, that have to be freed after tessellation
-        std::deque< boost::shared_array<GLdouble> >& intersectPoints;
-    } TessParams;
-
 private:
     /// Super class definition
-    typedef GAL super;
+    typedef VERTEX_GAL super;
 
     GAL_DISPLAY_OPTIONS&    options;
     UTIL::LINK              observerLink;
 
-    static const int    CIRCLE_POINTS   = 64;   ///< The number of points for circle approximation
-    static const int    CURVE_POINTS    = 32;   ///< The number of points for curve approximation
-
     static wxGLContext*     glMainContext;      ///< Parent OpenGL context
     wxGLContext*            glPrivContext;      ///< Canvas-specific OpenGL context
     static int              instanceCounter;    ///< GL GAL instance counter
@@ -300,7 +252,6 @@ private:
     typedef std::map< unsigned int, std::shared_ptr<VERTEX_ITEM> > GROUPS_MAP;
     GROUPS_MAP              groups;                 ///< Stores informations about VBO objects (groups)
     unsigned int            groupCounter;           ///< Counter used for generating keys for groups
-    VERTEX_MANAGER*         currentManager;         ///< Currently used VERTEX_MANAGER (for storing VERTEX_ITEMs)
     VERTEX_MANAGER*         cachedManager;          ///< Container for storing cached VERTEX_ITEMs
     VERTEX_MANAGER*         nonCachedManager;       ///< Container for storing non-cached VERTEX_ITEMs
     VERTEX_MANAGER*         overlayManager;         ///< Container for storing overlaid VERTEX_ITEMs
@@ -310,106 +261,24 @@ private:
     unsigned int            mainBuffer;             ///< Main rendering target
     unsigned int            overlayBuffer;          ///< Auxiliary rendering target (for menus etc.)
     RENDER_TARGET           currentTarget;          ///< Current rendering target
+    BOX2I                   clipArea;               ///< Part of the main buffer to be redrawn
+                                                    ///< in the current frame (empty if all)
 
     // Shader
     static SHADER*          shader;                 ///< There is only one shader used for different objects
 
     // Internal flags
     bool                    isFramebufferInitialized;   ///< Are the framebuffers initialized?
+    bool                    isFramebufferPreserved;     ///< Do the framebuffers hold the previous
+                                                        ///< frame?
     static bool             isBitmapFontLoaded;         ///< Is the bitmap font texture loaded?
     bool                    isBitmapFontInitialized;    ///< Is the shader set to use bitmap fonts?
     bool                    isInitialized;              ///< Basic initialization flag, has to be done
                                                         ///< when the window is visible
     bool                    isGrouping;                 ///< Was a group started?
 
-    // Polygon tesselation
-    /// The tessellator
-    GLUtesselator*          tesselator;
-    /// Storage for intersecting points
-    std::deque< boost::shared_array<GLdouble> > tessIntersects;
-
-    /**
-     * @brief Draw a quad for the line.
-     *
-     * @param aStartPoint is the start point of the line.
-     * @param aEndPoint is the end point of the line.
-     */
-    void drawLineQuad( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint );
-
-    /**
-     * @brief Draw a semicircle. Depending on settings (isStrokeEnabled & isFilledEnabled) it runs
-     * the proper function (drawStrokedSemiCircle or drawFilledSemiCircle).
-     *
-     * @param aCenterPoint is the center point.
-     * @param aRadius is the radius of the semicircle.
-     * @param aAngle is the angle of the semicircle.
-     *
-     */
-    void drawSemiCircle( const VECTOR2D& aCenterPoint, double aRadius, double aAngle );
-
-    /**
-     * @brief Draw a filled semicircle.
-     *
-     * @param aCenterPoint is the center point.
-     * @param aRadius is the radius of the semicircle.
-     * @param aAngle is the angle of the semicircle.
-     *
-     */
-    void drawFilledSemiCircle( const VECTOR2D& aCenterPoint, double aRadius, double aAngle );
-
-    /**
-     * @brief Draw a stroked semicircle.
-     *
-     * @param aCenterPoint is the center point.
-     * @param aRadius is the radius of the semicircle.
-     * @param aAngle is the angle of the semicircle.
-     *
-     */
-    void drawStrokedSemiCircle( const VECTOR2D& aCenterPoint, double aRadius, double aAngle );
-
-    /**
-     * @param Generic way of drawing a polyline stored in different containers.
-     * @param aPointGetter is a function to obtain coordinates of n-th vertex.
-     * @param aPointCount is the number of points to be drawn.
-     */
-    void drawPolyline( std::function<VECTOR2D (int)> aPointGetter, int aPointCount );
-
-    /**
-     * @brief Draws a filled polygon. It does not need the last point to have the same coordinates
-     * as the first one.
-     * @param aPoints is the vertices data (3 coordinates: x, y, z).
-     * @param aPointCount is the number of points.
-     */
-    void drawPolygon( GLdouble* aPoints, int aPointCount );
-
-    /**
-     * @brief Draws a single character using bitmap font.
-     * Its main purpose is to be used in BitmapText() function.
-     *
-     * @param aCharacter is the character to be drawn.
-     * @return Width of the drawn glyph.
-     */
-    int drawBitmapChar( unsigned long aChar );
-
-    /**
-     * @brief Draws an overbar over the currently drawn text.
-     * Its main purpose is to be used in BitmapText() function.
-     * This method requires appropriate scaling to be applied (as is done in BitmapText() function).
-     * The current X coordinate will be the overbar ending.
-     *
-     * @param aLength is the width of the overbar.
-     * @param aHeight is the height for the overbar.
-     */
-    void drawBitmapOverbar( double aLength, double aHeight );
-
-    /**
-     * @brief Computes a size of text drawn using bitmap font with current text setting applied.
-     *
-     * @param aText is the text to be drawn.
-     * @return Pair containing text bounding box and common Y axis offset. The values are expressed
-     * as a number of pixels on the bitmap font texture and need to be scaled before drawing.
-     */
-    std::pair<VECTOR2D, float> computeBitmapTextSize( const wxString& aText ) const;
+    ///< Standalone instances used to tessellate groups in worker threads
+    std::vector< std::unique_ptr<VERTEX_GAL> > tessellators;
 
     // Event handling
     /**
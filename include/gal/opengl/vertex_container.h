@@ -43,8 +43,10 @@ public:
     /**
      * Function MakeContainer()
      * Returns a pointer to a new container of an appropriate type.
+     * @param aInitialSize is the initial container size (expressed in vertices), 0 stands for
+     * the default size.
      */
-    static VERTEX_CONTAINER* MakeContainer( bool aCached );
+    static VERTEX_CONTAINER* MakeContainer( bool aCached, unsigned int aInitialSize = 0 );
 
     virtual ~VERTEX_CONTAINER();
 
@@ -61,6 +63,14 @@ public:
     virtual void Unmap()
     {}
 
+    /**
+     * Function Compact()
+     * reduces fragmentation of the stored data, if applicable. It can be invoked only between
+     * Map() and Unmap() calls, and never while drawing, as item offsets may change.
+     */
+    virtual void Compact()
+    {}
+
     /**
      * Function SetItem()
      * sets the item in order to modify or finishes its current modifications.
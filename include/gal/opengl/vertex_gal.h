@@ -0,0 +1,278 @@
+/*
+ * This program source code file is part of KICAD, a free EDA CAD application.
+ *
+ * Copyright (C) 2012 Torsten Hueter, torstenhtr <at> gmx.de
+ * Copyright (C) 2012-2017 Kicad Developers, see change_log.txt for contributors.
+ * Copyright (C) 2013-2017 CERN
+ * @author Maciej Suminski <maciej.suminski@cern.ch>
+ *
+ * Tessellation part of the OpenGL Graphics Abstraction Layer
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef VERTEX_GAL_H_
+#define VERTEX_GAL_H_
+
+#include <gal/graphics_abstraction_layer.h>
+#include <gal/opengl/vertex_manager.h>
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+#include <boost/smart_ptr/shared_array.hpp>
+
+#ifndef CALLBACK
+#define CALLBACK
+#endif
+
+namespace KIGFX
+{
+/**
+ * @brief Class VERTEX_GAL converts the drawing primitives to triangles stored in a VERTEX_MANAGER.
+ *
+ * It contains the part of OPENGL_GAL that does not depend on an OpenGL context, so it
+ * may be also used as a standalone GAL tessellating groups to the main memory. Standalone
+ * instances do not share any state with other GALs, therefore they may be used by worker
+ * threads. The vertices of a group are then copied to the cache of an OPENGL_GAL using
+ * OPENGL_GAL::ImportGroup().
+ */
+class VERTEX_GAL : public GAL
+{
+public:
+    /**
+     * @brief Constructor VERTEX_GAL
+     * creates a standalone instance, storing the vertices in a local buffer.
+     */
+    VERTEX_GAL();
+
+    virtual ~VERTEX_GAL();
+
+    // ---------------
+    // Drawing methods
+    // ---------------
+
+    /// @copydoc GAL::DrawLine()
+    virtual void DrawLine( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint ) override;
+
+    /// @copydoc GAL::DrawSegment()
+    virtual void DrawSegment( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint,
+                              double aWidth ) override;
+
+    /// @copydoc GAL::DrawCircle()
+    virtual void DrawCircle( const VECTOR2D& aCenterPoint, double aRadius ) override;
+
+    /// @copydoc GAL::DrawArc()
+    virtual void DrawArc( const VECTOR2D& aCenterPoint, double aRadius,
+                          double aStartAngle, double aEndAngle ) override;
+
+    /// @copydoc GAL::DrawRectangle()
+    virtual void DrawRectangle( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint ) override;
+
+    /// @copydoc GAL::DrawPolyline()
+    virtual void DrawPolyline( const std::deque<VECTOR2D>& aPointList ) override;
+    virtual void DrawPolyline( const VECTOR2D aPointList[], int aListSize ) override;
+    virtual void DrawPolyline( const SHAPE_LINE_CHAIN& aLineChain ) override;
+
+    /// @copydoc GAL::DrawPolygon()
+    virtual void DrawPolygon( const std::deque<VECTOR2D>& aPointList ) override;
+    virtual void DrawPolygon( const VECTOR2D aPointList[], int aListSize ) override;
+    virtual void DrawPolygon( const SHAPE_POLY_SET& aPolySet ) override;
+
+    /// @copydoc GAL::DrawCurve()
+    virtual void DrawCurve( const VECTOR2D& startPoint, const VECTOR2D& controlPointA,
+                            const VECTOR2D& controlPointB, const VECTOR2D& endPoint ) override;
+
+    /// @copydoc GAL::BitmapText()
+    virtual void BitmapText( const wxString& aText, const VECTOR2D& aPosition,
+                             double aRotationAngle ) override;
+
+    // --------------
+    // Transformation
+    // --------------
+
+    /// @copydoc GAL::Rotate()
+    virtual void Rotate( double aAngle ) override;
+
+    /// @copydoc GAL::Translate()
+    virtual void Translate( const VECTOR2D& aTranslation ) override;
+
+    /// @copydoc GAL::Scale()
+    virtual void Scale( const VECTOR2D& aScale ) override;
+
+    /// @copydoc GAL::Save()
+    virtual void Save() override;
+
+    /// @copydoc GAL::Restore()
+    virtual void Restore() override;
+
+    // --------------------------------------------
+    // Group methods
+    // ---------------------------------------------
+
+    /// @copydoc GAL::BeginGroup()
+    virtual int BeginGroup() override;
+
+    /// @copydoc GAL::EndGroup()
+    virtual void EndGroup() override;
+
+    /// @copydoc GAL::ClearCache()
+    virtual void ClearCache() override;
+
+    /**
+     * @brief Returns the vertices of a group stored in the local buffer.
+     *
+     * @param aGroupNumber is the group number returned by BeginGroup().
+     * @param aSize is set to the number of vertices in the group.
+     * @return Pointer to the first vertex of the group (valid until the cache is cleared).
+     */
+    const VERTEX* GetGroupVertices( int aGroupNumber, unsigned int& aSize ) const;
+
+    ///< Parameters passed to the GLU tesselator
+    typedef struct
+    {
+        /// Manager used for storing new vertices
+        VERTEX_MANAGER* vboManager;
+
+        /// Intersect points, that have to be freed after tessellation
+        std::deque< boost::shared_array<GLdouble> >& intersectPoints;
+    } TessParams;
+
+protected:
+    /**
+     * @brief Constructor for the derived classes.
+     *
+     * @param aUseBuffer decides if a local vertex buffer is created. Derived classes that provide
+     * their own vertex managers (see currentManager) do not need it.
+     */
+    VERTEX_GAL( bool aUseBuffer );
+
+    /**
+     * @brief Copies the settings that affect the tessellation (world scale, flipping and
+     * depth range) to another instance.
+     */
+    void copyViewSettings( VERTEX_GAL& aTarget ) const;
+
+    static const int    CIRCLE_POINTS   = 64;   ///< The number of points for circle approximation
+    static const int    CURVE_POINTS    = 32;   ///< The number of points for curve approximation
+
+    VERTEX_MANAGER*         currentManager;         ///< Currently used VERTEX_MANAGER (for storing VERTEX_ITEMs)
+
+    // Polygon tesselation
+    /// The tessellator
+    GLUtesselator*          tesselator;
+    /// Storage for intersecting points
+    std::deque< boost::shared_array<GLdouble> > tessIntersects;
+
+    /**
+     * @brief Draw a quad for the line.
+     *
+     * @param aStartPoint is the start point of the line.
+     * @param aEndPoint is the end point of the line.
+     */
+    void drawLineQuad( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint );
+
+    /**
+     * @brief Draw a semicircle. Depending on settings (isStrokeEnabled & isFilledEnabled) it runs
+     * the proper function (drawStrokedSemiCircle or drawFilledSemiCircle).
+     *
+     * @param aCenterPoint is the center point.
+     * @param aRadius is the radius of the semicircle.
+     * @param aAngle is the angle of the semicircle.
+     *
+     */
+    void drawSemiCircle( const VECTOR2D& aCenterPoint, double aRadius, double aAngle );
+
+    /**
+     * @brief Draw a filled semicircle.
+     *
+     * @param aCenterPoint is the center point.
+     * @param aRadius is the radius of the semicircle.
+     * @param aAngle is the angle of the semicircle.
+     *
+     */
+    void drawFilledSemiCircle( const VECTOR2D& aCenterPoint, double aRadius, double aAngle );
+
+    /**
+     * @brief Draw a stroked semicircle.
+     *
+     * @param aCenterPoint is the center point.
+     * @param aRadius is the radius of the semicircle.
+     * @param aAngle is the angle of the semicircle.
+     *
+     */
+    void drawStrokedSemiCircle( const VECTOR2D& aCenterPoint, double aRadius, double aAngle );
+
+    /**
+     * @param Generic way of drawing a polyline stored in different containers.
+     * @param aPointGetter is a function to obtain coordinates of n-th vertex.
+     * @param aPointCount is the number of points to be drawn.
+     */
+    void drawPolyline( std::function<VECTOR2D (int)> aPointGetter, int aPointCount );
+
+    /**
+     * @brief Draws a filled polygon. It does not need the last point to have the same coordinates
+     * as the first one.
+     * @param aPoints is the vertices data (3 coordinates: x, y, z).
+     * @param aPointCount is the number of points.
+     */
+    void drawPolygon( GLdouble* aPoints, int aPointCount );
+
+    /**
+     * @brief Draws a single character using bitmap font.
+     * Its main purpose is to be used in BitmapText() function.
+     *
+     * @param aCharacter is the character to be drawn.
+     * @return Width of the drawn glyph.
+     */
+    int drawBitmapChar( unsigned long aChar );
+
+    /**
+     * @brief Draws an overbar over the currently drawn text.
+     * Its main purpose is to be used in BitmapText() function.
+     * This method requires appropriate scaling to be applied (as is done in BitmapText() function).
+     * The current X coordinate will be the overbar ending.
+     *
+     * @param aLength is the width of the overbar.
+     * @param aHeight is the height for the overbar.
+     */
+    void drawBitmapOverbar( double aLength, double aHeight );
+
+    /**
+     * @brief Computes a size of text drawn using bitmap font with current text setting applied.
+     *
+     * @param aText is the text to be drawn.
+     * @return Pair containing text bounding box and common Y axis offset. The values are expressed
+     * as a number of pixels on the bitmap font texture and need to be scaled before drawing.
+     */
+    std::pair<VECTOR2D, float> computeBitmapTextSize( const wxString& aText ) const;
+
+private:
+    ///< Local vertex buffer (standalone instances only)
+    std::unique_ptr<VERTEX_MANAGER> vertexBuffer;
+
+    ///< Groups stored in the local buffer, as pairs of (offset, size)
+    std::vector< std::pair<unsigned int, unsigned int> > bufferGroups;
+
+    ///< Initial size of the local buffer (expressed in vertices)
+    static const unsigned int BUFFER_INIT_SIZE = 65536;
+};
+} // namespace KIGFX
+
+#endif  // VERTEX_GAL_H_
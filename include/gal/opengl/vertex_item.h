@@ -78,6 +78,9 @@ private:
     unsigned int            m_offset;
     unsigned int            m_size;
 
+    ///> Handle of the chunk allocated for the item (used by CACHED_CONTAINER)
+    int                     m_chunk;
+
     /**
      * Function SetOffset()
      * Sets data offset in the container.
@@ -97,6 +100,16 @@ private:
     {
         m_size = aSize;
     }
+
+    /**
+     * Function setChunk()
+     * Sets the handle of the memory chunk allocated for the item.
+     * @param aChunk is the chunk handle or a negative number if there is no chunk.
+     */
+    inline void setChunk( int aChunk )
+    {
+        m_chunk = aChunk;
+    }
 };
 } // namespace KIGFX
 
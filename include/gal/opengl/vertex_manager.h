@@ -36,6 +36,7 @@
 #include <glm/glm.hpp>
 #include <gal/opengl/vertex_common.h>
 #include <gal/color4d.h>
+#include <math/vector2d.h>
 #include <stack>
 #include <memory>
 #include <wx/log.h>
@@ -55,8 +56,10 @@ public:
      *
      * @param aCached says if vertices should be cached in GPU or system memory. For data that
      * does not change every frame, it is better to store vertices in GPU memory.
+     * @param aInitialSize is the initial size of the container (expressed in vertices),
+     * 0 stands for the default size.
      */
-    VERTEX_MANAGER( bool aCached );
+    VERTEX_MANAGER( bool aCached, unsigned int aInitialSize = 0 );
 
     /**
      * Function Map()
@@ -120,6 +123,18 @@ public:
      */
     bool Vertices( const VERTEX aVertices[], unsigned int aSize );
 
+    /**
+     * Function CopyVertices()
+     * adds vertices to the currently set item without any processing. Contrary to Vertices(),
+     * the color, shader parameters and coordinates are stored as they are, so it is meant for
+     * vertices that have been already processed by another VERTEX_MANAGER.
+     *
+     * @param aVertices contains vertices to be added
+     * @param aSize is the number of vertices to be added.
+     * @return True if successful, false otherwise.
+     */
+    bool CopyVertices( const VERTEX aVertices[], unsigned int aSize );
+
     /**
      * Function Color()
      * changes currently used color that will be applied to newly added vertices.
@@ -297,6 +312,21 @@ public:
      */
     VERTEX* GetVertices( const VERTEX_ITEM& aItem ) const;
 
+    /**
+     * Function GetVertices()
+     * returns a pointer to the vertices stored at a given offset in the container.
+     *
+     * @param aOffset is the offset expressed as a number of vertices.
+     */
+    VERTEX* GetVertices( unsigned int aOffset ) const;
+
+    /**
+     * Function GetSize()
+     * returns the size of the container. For noncached containers it is the number of
+     * vertices stored since the last Clear() call.
+     */
+    unsigned int GetSize() const;
+
     const glm::mat4& GetTransformation() const
     {
         return m_transform;
@@ -329,6 +359,15 @@ public:
      */
     void DrawItem( const VERTEX_ITEM& aItem ) const;
 
+    /**
+     * Function DrawItemInstance()
+     * draws a translated copy of an item to the buffer.
+     *
+     * @param aItem is the item to be drawn.
+     * @param aOffset is the translation applied to the item.
+     */
+    void DrawItemInstance( const VERTEX_ITEM& aItem, const VECTOR2D& aOffset ) const;
+
     /**
      * Function EndDrawing()
      * finishes drawing operations.
@@ -30,6 +30,9 @@
 #define STROKE_FONT_H_
 
 #include <deque>
+#include <map>
+#include <string>
+#include <vector>
 #include <utf8.h>
 
 #include <eda_text.h>
@@ -123,9 +126,42 @@ public:
 
 
 private:
-    GAL*                m_gal;                  ///< Pointer to the GAL
-    GLYPH_LIST          m_glyphs;               ///< Glyph list
-    std::vector<BOX2D>  m_glyphBoundingBoxes;   ///< Bounding boxes of the glyphs
+    ///> Location of a glyph in the contiguous stroke arrays
+    struct GLYPH_SPAN
+    {
+        int m_firstPoint;       ///< Index of the first point in m_glyphPoints
+        int m_firstStroke;      ///< Index of the first stroke in m_glyphStrokeSizes
+        int m_strokeCount;      ///< Number of strokes
+    };
+
+    ///> Settings that affect the shape of a tessellated line of text
+    struct TEXT_LINE_KEY
+    {
+        std::string m_text;
+        VECTOR2D    m_glyphSize;
+        double      m_lineWidth;
+        bool        m_italic;
+        bool        m_mirrored;
+
+        bool operator<( const TEXT_LINE_KEY& aOther ) const;
+    };
+
+    ///> A line of text converted to polylines, ready to be drawn with GAL::DrawPolylines()
+    struct TEXT_LINE_SHAPE
+    {
+        std::vector<VECTOR2D>   m_points;       ///< Points of all strokes, one after another
+        std::vector<int>        m_strokeSizes;  ///< Number of points in each stroke
+        VECTOR2D                m_size;         ///< Size of the text line
+    };
+
+    GAL*                    m_gal;                  ///< Pointer to the GAL
+    std::vector<VECTOR2D>   m_glyphPoints;          ///< Points of all glyph strokes
+    std::vector<int>        m_glyphStrokeSizes;     ///< Number of points in each glyph stroke
+    std::vector<GLYPH_SPAN> m_glyphs;               ///< Glyph list
+    std::vector<BOX2D>      m_glyphBoundingBoxes;   ///< Bounding boxes of the glyphs
+
+    ///> Recently drawn lines of text
+    std::map<TEXT_LINE_KEY, TEXT_LINE_SHAPE> m_textCache;
 
     /**
      * @brief Compute the X and Y size of a given text. The text is expected to be
@@ -167,6 +203,36 @@ private:
      */
     void drawSingleLineText( const UTF8& aText );
 
+    /**
+     * @brief Returns a single line of text converted to polylines using the current settings.
+     * The result is cached, so the following calls for the same text are cheap.
+     *
+     * @param aText is the text to be converted (one line).
+     * @return Reference to the cached shape, valid until the next call.
+     */
+    const TEXT_LINE_SHAPE& getTextLineShape( const UTF8& aText );
+
+    /**
+     * @brief Converts a single line of text to polylines.
+     *
+     * @param aText is the text to be converted (one line).
+     * @param aShape is the output shape.
+     */
+    void tessellateTextLine( const UTF8& aText, TEXT_LINE_SHAPE& aShape ) const;
+
+    /**
+     * @brief Returns the glyph index for a character, substituting unknown characters.
+     */
+    inline int glyphIndex( int aChar ) const
+    {
+        int dd = aChar - ' ';
+
+        if( dd >= (int) m_glyphBoundingBoxes.size() || dd < 0 )
+            dd = '?' - ' ';
+
+        return dd;
+    }
+
     /**
      * @brief Returns number of lines for a given text.
      *
@@ -197,6 +263,9 @@ private:
 
     ///> Factor that determines the pitch between 2 lines.
     static const double INTERLINE_PITCH_RATIO;
+
+    ///> Maximum number of text lines kept in the cache.
+    static const unsigned int TEXT_CACHE_SIZE;
 };
 } // namespace KIGFX
 
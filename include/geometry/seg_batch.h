@@ -0,0 +1,87 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef __SEG_BATCH_H
+#define __SEG_BATCH_H
+
+#include <cstdint>
+
+#include <math/vector2d.h>
+#include <geometry/seg.h>
+
+/**
+ * Batch segment kernels.
+ *
+ * The functions below test a single reference segment (or box) against a run of
+ * consecutive polyline segments at once. They compare integer bounding boxes on
+ * packed coordinates using AVX2 (8 segments per step) or SSE2 (4 segments per step)
+ * when the compiler targets these instruction sets, and fall back to plain scalar
+ * code otherwise. The bounding box test is exact, so the callers can run the regular
+ * SEG predicates only on the returned candidates and get the same results as when
+ * testing every segment pair one at a time.
+ */
+
+///> Maximum number of segments processed by a single SegBatchFilter() call.
+static const int SEG_BATCH_SIZE = 32;
+
+/**
+ * Function SegBatchFilter()
+ *
+ * Finds segments whose bounding boxes are not further than aClearance (in both axes)
+ * from the bounding box of aRef. The n-th segment spans aPoints[n] and aPoints[n + 1].
+ * @param aPoints points of the polyline, at least aCount + 1 of them
+ * @param aCount number of segments to test, no more than SEG_BATCH_SIZE
+ * @param aRef reference segment (only its bounding box is used)
+ * @param aClearance bounding box inflation, must not be negative
+ * @return bit mask of candidate segments (bit n set for the n-th segment)
+ */
+uint32_t SegBatchFilter( const VECTOR2I* aPoints, int aCount, const SEG& aRef, int aClearance );
+
+/**
+ * Function SegBatchPop()
+ *
+ * Returns the index of the lowest bit set in aMask and clears it. aMask must not be zero.
+ */
+inline int SegBatchPop( uint32_t& aMask )
+{
+#if defined( __GNUC__ )
+    int n = __builtin_ctz( aMask );
+#else
+    int n = 0;
+
+    while( !( aMask & ( 1u << n ) ) )
+        n++;
+#endif
+
+    aMask &= aMask - 1;
+    return n;
+}
+
+/**
+ * Function SegBatchDescribe()
+ *
+ * Returns the name of the kernel selected at compile time ("avx2", "sse2" or "scalar").
+ */
+const char* SegBatchDescribe();
+
+#endif // __SEG_BATCH_H
@@ -25,6 +25,8 @@
 #ifndef __SHAPE_LINE_CHAIN
 #define __SHAPE_LINE_CHAIN
 
+#include <algorithm>
+#include <cstdlib>
 #include <vector>
 #include <sstream>
 
@@ -33,6 +35,7 @@
 #include <math/vector2d.h>
 #include <geometry/shape.h>
 #include <geometry/seg.h>
+#include <geometry/seg_batch.h>
 
 /**
  * Class SHAPE_LINE_CHAIN
@@ -586,6 +589,48 @@ public:
 
     const VECTOR2I PointAlong( int aPathLength ) const;
 
+    /**
+     * Function VisitSegmentsNear()
+     *
+     * Calls aVisitor( index ) for every segment whose bounding box is not further than
+     * aClearance from the bounding box of aRef, in ascending index order. The bounding
+     * boxes are compared in batches (see SegBatchFilter()), so the visitor sees a superset
+     * of the segments that can be closer than aClearance to aRef and should run the exact
+     * test on its own.
+     * @param aRef the reference segment
+     * @param aClearance maximum bounding box distance
+     * @param aVisitor functor taking the segment index, returning true to stop the search
+     * @return true if the search has been stopped by the visitor
+     */
+    template <class Visitor>
+    bool VisitSegmentsNear( const SEG& aRef, int aClearance, Visitor aVisitor ) const
+    {
+        const int openCount = std::max( 0, (int) m_points.size() - 1 );
+        const int clearance = std::abs( aClearance );
+
+        for( int base = 0; base < openCount; base += SEG_BATCH_SIZE )
+        {
+            int count = std::min( SEG_BATCH_SIZE, openCount - base );
+            uint32_t mask = SegBatchFilter( &m_points[base], count, aRef, clearance );
+
+            while( mask )
+            {
+                if( aVisitor( base + SegBatchPop( mask ) ) )
+                    return true;
+            }
+        }
+
+        if( m_closed && !m_points.empty() )
+        {
+            const VECTOR2I closing[2] = { m_points.back(), m_points.front() };
+
+            if( SegBatchFilter( closing, 1, aRef, clearance ) && aVisitor( openCount ) )
+                return true;
+        }
+
+        return false;
+    }
+
 private:
     /// array of vertices
     std::vector<VECTOR2I> m_points;
@@ -31,6 +31,8 @@
 #include <set>
 
 #include <gal/color4d.h>
+#include <math/vector2d.h>
+#include <view/instance_key.h>
 #include <colors.h>
 #include <worksheet_shape_builder.h>
 #include <memory>
@@ -301,6 +303,34 @@ public:
      */
     virtual bool Draw( const VIEW_ITEM* aItem, int aLayer ) = 0;
 
+    /**
+     * Function Clone
+     * Creates a copy of the painter with the same settings. The copy may be attached to another
+     * GAL (see SetGAL()) and used to draw items concurrently with the original painter.
+     * @return The new painter or NULL if the painter cannot be used by multiple threads.
+     */
+    virtual PAINTER* Clone() const
+    {
+        return NULL;
+    }
+
+    /**
+     * Function GetInstanceKey
+     * Tells whether an item may be drawn as a translated copy of another item that looks
+     * the same. Such items are drawn once to a shared group, placed with its origin at (0, 0)
+     * and then instanced at every position.
+     * @param aItem is the item to be checked.
+     * @param aLayer is the layer the item is going to be drawn on.
+     * @param aKey is filled with the description of the item look.
+     * @param aOrigin is set to the point where the group origin is placed for the item.
+     * @return True if the item may be instanced.
+     */
+    virtual bool GetInstanceKey( const VIEW_ITEM* aItem, int aLayer, INSTANCE_KEY& aKey,
+                                 VECTOR2D& aOrigin ) const
+    {
+        return false;
+    }
+
 protected:
     /// Instance of graphic abstraction layer that gives an interface to call
     /// commands used to draw (eg. DrawLine, DrawCircle, etc.)
@@ -204,6 +204,12 @@ public:
         m_layers.reset();   // mark as needs updating
     }
 
+    /// Returns the board items that share this node
+    inline const std::unordered_set<const BOARD_CONNECTED_ITEM*>& GetParents() const
+    {
+        return m_parents;
+    }
+
     inline void RemoveParent( const BOARD_CONNECTED_ITEM* aParent )
     {
         auto it = m_parents.find( aParent );
@@ -0,0 +1,96 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file instance_key.h
+ * @brief INSTANCE_KEY class definition.
+ */
+
+#ifndef __INSTANCE_KEY_H
+#define __INSTANCE_KEY_H
+
+#include <algorithm>
+#include <gal/color4d.h>
+
+namespace KIGFX
+{
+/**
+ * Struct INSTANCE_KEY
+ * Describes everything that affects the look of an item drawn by a PAINTER, except its position.
+ * Items that have equal keys are drawn as translated copies of a single cached group.
+ */
+struct INSTANCE_KEY
+{
+    INSTANCE_KEY() : m_size( 0 )
+    {
+    }
+
+    /// Appends a value to the key, values over the key capacity are ignored and the key
+    /// becomes invalid.
+    void Add( int aValue )
+    {
+        if( m_size < MAX_SIZE )
+            m_data[m_size] = aValue;
+
+        ++m_size;
+    }
+
+    void Add( const COLOR4D& aColor )
+    {
+        unsigned int rgba = (unsigned int) ( aColor.r * 255 ) << 24
+                          | (unsigned int) ( aColor.g * 255 ) << 16
+                          | (unsigned int) ( aColor.b * 255 ) << 8
+                          | (unsigned int) ( aColor.a * 255 );
+        Add( (int) rgba );
+    }
+
+    bool IsValid() const
+    {
+        return m_size > 0 && m_size <= MAX_SIZE;
+    }
+
+    bool operator<( const INSTANCE_KEY& aOther ) const
+    {
+        if( m_size != aOther.m_size )
+            return m_size < aOther.m_size;
+
+        int size = std::min<int>( m_size, MAX_SIZE );
+
+        return std::lexicographical_compare( m_data, m_data + size,
+                                             aOther.m_data, aOther.m_data + size );
+    }
+
+    bool operator==( const INSTANCE_KEY& aOther ) const
+    {
+        return m_size == aOther.m_size
+            && std::equal( m_data, m_data + std::min<int>( m_size, MAX_SIZE ), aOther.m_data );
+    }
+
+    enum { MAX_SIZE = 24 };
+
+    int m_data[MAX_SIZE];
+    int m_size;
+};
+} // namespace KIGFX
+
+#endif /* __INSTANCE_KEY_H */
@@ -27,10 +27,13 @@
 
 #include <vector>
 #include <set>
+#include <map>
+#include <memory>
 #include <unordered_map>
 
 #include <math/box2.h>
 #include <gal/definitions.h>
+#include <view/instance_key.h>
 
 namespace KIGFX
 {
@@ -516,7 +519,8 @@ public:
 
     /**
      * Function Redraw()
-     * Immediately redraws the whole view.
+     * Immediately redraws the whole view. If ClearTargets() has limited the redraw to the dirty
+     * area of the view, only the items in that area are drawn.
      */
     void Redraw();
 
@@ -526,6 +530,20 @@ public:
      */
     void RecacheAllItems();
 
+    /**
+     * Function SetInstancing()
+     * Enables drawing of items that look the same (see PAINTER::GetInstanceKey()) as translated
+     * copies of a single cached group. It is used only if the GAL supports instancing.
+     * @param aEnabled says whether instancing should be enabled.
+     */
+    void SetInstancing( bool aEnabled );
+
+    /**
+     * Function IsInstancing()
+     * Returns true if items are drawn as instances of shared groups.
+     */
+    bool IsInstancing() const;
+
     /**
      * Function IsDynamic()
      * Tells if the VIEW is dynamic (ie. can be changed, for example displaying PCBs in a window)
@@ -562,7 +580,7 @@ public:
     {
         wxASSERT( aTarget < TARGETS_NUMBER );
 
-        return m_dirtyTargets[aTarget];
+        return m_dirtyTargets[aTarget] || ( m_isDirtyArea && aTarget != TARGET_OVERLAY );
     }
 
     /**
@@ -577,6 +595,15 @@ public:
         m_dirtyTargets[aTarget] = true;
     }
 
+    /**
+     * Function MarkTargetDirty()
+     * Marks a part of a target as dirty. Targets with only small dirty areas are redrawn
+     * partially, TARGET_OVERLAY is always redrawn as a whole.
+     * @param aTarget is the target to set.
+     * @param aArea is the area to be redrawn (in world coordinates).
+     */
+    void MarkTargetDirty( int aTarget, const BOX2I& aArea );
+
     /// Returns true if the layer is cached
     inline bool IsCached( int aLayer ) const
     {
@@ -637,10 +664,39 @@ private:
     typedef std::vector<VIEW_LAYER*>                LAYER_ORDER;
     typedef std::vector<VIEW_LAYER*>::iterator      LAYER_ORDER_ITER;
 
+    ///> Shared group drawn for all items that have the same INSTANCE_KEY
+    struct INSTANCE_TEMPLATE
+    {
+        int             group;      ///< group number, the origin of the item is at (0, 0)
+        int             layer;      ///< layer the group was drawn for
+        unsigned int    lastUsed;   ///< number of the frame the group was drawn in lately
+    };
+
+    typedef std::map<INSTANCE_KEY, INSTANCE_TEMPLATE> INSTANCE_TEMPLATES;
+
+    ///> Geometry update of an item on a single layer, queued by UpdateItems()
+    struct CACHE_JOB
+    {
+        VIEW_ITEM*  item;
+        int         layer;
+        int         group;      ///< group number in the tessellator that has processed the job
+        bool        painted;    ///< false if the painter has not been able to draw the item
+    };
+
+    ///> Part of the screen rendered by a worker thread
+    struct TILE
+    {
+        GAL*                        gal;
+        std::unique_ptr<PAINTER>    painter;
+        BOX2I                       area;       ///< tile area in world coordinates
+        std::vector<VIEW_ITEM*>     fallback;   ///< items the painter has not been able to draw
+    };
+
     // Function objects that need to access VIEW/VIEW_ITEM private/protected members
     struct clearLayerCache;
     struct recacheItem;
     struct drawItem;
+    struct drawTileItem;
     struct unlinkItem;
     struct updateItemsColor;
     struct changeItemsDepth;
@@ -650,13 +706,37 @@ private:
     ///* Redraws contents within rect aRect
     void redrawRect( const BOX2I& aRect );
 
+    /**
+     * Function redrawTiles()
+     * Draws a layer by rendering the GAL tiles concurrently. Items that the tile painters
+     * cannot draw are drawn afterwards by the main GAL.
+     *
+     * @param aLayer is the layer to be drawn.
+     * @param aRect is the area to be drawn (in world coordinates).
+     * @param aTiles contains the tile painters.
+     */
+    void redrawTiles( VIEW_LAYER& aLayer, const BOX2I& aRect, std::vector<TILE>& aTiles );
+
     inline void markTargetClean( int aTarget )
     {
         wxASSERT( aTarget < TARGETS_NUMBER );
 
         m_dirtyTargets[aTarget] = false;
+
+        // Dirty area is shared by the cached and noncached targets, they are redrawn together
+        if( aTarget != TARGET_OVERLAY )
+            m_isDirtyArea = false;
     }
 
+    /**
+     * Function getPartialRedrawArea()
+     * Computes the part of the screen covered by the dirty area, if it is small enough to be
+     * redrawn alone.
+     * @param aScreenArea is set to the area to be redrawn (in pixels).
+     * @return false if the whole screen should be redrawn.
+     */
+    bool getPartialRedrawArea( BOX2I& aScreenArea ) const;
+
     /**
      * Function draw()
      * Draws an item, but on a specified layers. It has to be marked that some of drawing settings
@@ -669,6 +749,31 @@ private:
      */
     void draw( VIEW_ITEM* aItem, int aLayer, bool aImmediate = false );
 
+    /**
+     * Function drawInstance()
+     * Draws an item as an instance of a shared group, the group is created if it does not
+     * exist yet.
+     *
+     * @param aItem is the item to be drawn.
+     * @param aLayer is the layer which should be drawn.
+     * @return False if the item cannot be instanced.
+     */
+    bool drawInstance( VIEW_ITEM* aItem, int aLayer );
+
+    /// Returns true if an item is drawn as an instance on a given layer
+    bool isInstanced( const VIEW_ITEM* aItem, int aLayer ) const;
+
+    /**
+     * Function clearInstanceTemplates()
+     * Removes the shared groups used for drawing instances.
+     * @param aDeleteGroups says whether the groups should be deleted from the GAL too (it is not
+     * necessary if the GAL cache has been already cleared).
+     */
+    void clearInstanceTemplates( bool aDeleteGroups = true );
+
+    /// Removes the shared groups that have not been drawn recently
+    void purgeInstanceTemplates();
+
     /**
      * Function draw()
      * Draws an item on all layers that the item uses.
@@ -701,8 +806,11 @@ private:
      * Manages dirty flags & redraw queueing when updating an item.
      * @param aItem is the item to be updated.
      * @param aUpdateFlags determines the way an item is refreshed.
+     * @param aGeometryJobs if not NULL, geometry updates are queued there instead of being
+     * done immediately (see updateItemsGeometry()).
      */
-    void invalidateItem( VIEW_ITEM* aItem, int aUpdateFlags );
+    void invalidateItem( VIEW_ITEM* aItem, int aUpdateFlags,
+                         std::vector<CACHE_JOB>* aGeometryJobs = NULL );
 
     /// Updates colors that are used for an item to be drawn
     void updateItemColor( VIEW_ITEM* aItem, int aLayer );
@@ -710,6 +818,14 @@ private:
     /// Updates all informations needed to draw an item
     void updateItemGeometry( VIEW_ITEM* aItem, int aLayer );
 
+    /**
+     * Function updateItemsGeometry()
+     * Processes queued geometry updates. If both the GAL and the PAINTER support it, items
+     * are tessellated by worker threads and then the results are uploaded to the GAL cache
+     * in the queue order. Otherwise the updates are done one by one with updateItemGeometry().
+     */
+    void updateItemsGeometry( std::vector<CACHE_JOB>& aJobs );
+
     /// Updates bounding box of an item
     void updateBbox( VIEW_ITEM* aItem );
 
@@ -771,11 +887,47 @@ private:
     /// Flags to mark targets as dirty, so they have to be redrawn on the next refresh event
     bool m_dirtyTargets[TARGETS_NUMBER];
 
+    /// Area of TARGET_CACHED and TARGET_NONCACHED modified since the last redraw
+    /// (in world coordinates)
+    BOX2I m_dirtyArea;
+
+    /// Is m_dirtyArea set?
+    bool m_isDirtyArea;
+
+    /// Area drawn by the next Redraw() call (in world coordinates), set by ClearTargets()
+    /// when only a part of the screen is redrawn
+    BOX2I m_redrawArea;
+
+    /// Is only m_redrawArea going to be redrawn?
+    bool m_partialRedraw;
+
+    /// Largest part of the screen that is redrawn partially, larger dirty areas cause
+    /// a full redraw
+    static const double MAX_PARTIAL_REDRAW_AREA;
+
     /// Rendering order modifier for layers that are marked as top layers
     static const int TOP_LAYER_MODIFIER;
 
+    /// Minimal number of geometry updates that are worth tessellating in worker threads
+    static const int MIN_PARALLEL_CACHE_JOBS;
+
+    /// Number of geometry updates tessellated before uploading them to the GAL cache
+    static const int CACHE_BATCH_SIZE;
+
     /// Flat list of all items
     std::vector<VIEW_ITEM*> m_allItems;
+
+    /// Whether items may be drawn as instances of shared groups
+    bool m_useInstancing;
+
+    /// Shared groups used for drawing instances
+    INSTANCE_TEMPLATES m_instanceTemplates;
+
+    /// Number of frames drawn so far, used to find unused instance templates
+    unsigned int m_frameCounter;
+
+    /// Number of frames after which an unused instance template is removed
+    static const unsigned int INSTANCE_TEMPLATE_LIFETIME;
 };
 } // namespace KIGFX
 
@@ -25,51 +25,54 @@
 #ifndef __VIEW_RTREE_H
 #define __VIEW_RTREE_H
 
+#include <vector>
+#include <unordered_map>
+
 #include <math/box2.h>
 
 #include <geometry/rtree.h>
 
 namespace KIGFX
 {
+class VIEW_ITEM;
+
 typedef RTree<VIEW_ITEM*, int, 2, float> VIEW_RTREE_BASE;
 
 /**
  * Class VIEW_RTREE -
  * Implements an R-tree for fast spatial indexing of VIEW items.
  * Non-owning.
+ *
+ * Most of the items are stored in a packed tree, built at once using Sort-Tile-Recursive
+ * bulk loading and kept in two contiguous arrays (nodes and leaf entries). Insertions are
+ * buffered until the next query: a large batch (e.g. a board being loaded) rebuilds the packed
+ * tree, while a few items go to a regular dynamic R-tree. Removed entries are only marked
+ * as such, the packed tree is rebuilt when the dynamic part or the number of removed entries
+ * become too large.
  */
-class VIEW_RTREE : public VIEW_RTREE_BASE
+class VIEW_RTREE
 {
 public:
+    VIEW_RTREE();
 
     /**
      * Function Insert()
      * Inserts an item into the tree. Item's bounding box is taken via its ViewBBox() method.
      */
-    void Insert( VIEW_ITEM* aItem )
-    {
-        const BOX2I&    bbox    = aItem->ViewBBox();
-        const int       mmin[2] = { bbox.GetX(), bbox.GetY() };
-        const int       mmax[2] = { bbox.GetRight(), bbox.GetBottom() };
-
-        VIEW_RTREE_BASE::Insert( mmin, mmax, aItem );
-    }
+    void Insert( VIEW_ITEM* aItem );
 
     /**
      * Function Remove()
      * Removes an item from the tree. Removal is done by comparing pointers, attepmting to remove a copy
      * of the item will fail.
      */
-    void Remove( VIEW_ITEM* aItem )
-    {
-        // const BOX2I&    bbox    = aItem->ViewBBox();
-
-        // FIXME: use cached bbox or ptr_map to speed up pointer <-> node lookups.
-        const int       mmin[2] = { INT_MIN, INT_MIN };
-        const int       mmax[2] = { INT_MAX, INT_MAX };
+    void Remove( VIEW_ITEM* aItem );
 
-        VIEW_RTREE_BASE::Remove( mmin, mmax, aItem );
-    }
+    /**
+     * Function RemoveAll()
+     * Removes all items from the tree.
+     */
+    void RemoveAll();
 
     /**
      * Function Query()
@@ -82,10 +85,170 @@ public:
         const int   mmin[2] = { aBounds.GetX(), aBounds.GetY() };
         const int   mmax[2] = { aBounds.GetRight(), aBounds.GetBottom() };
 
-        VIEW_RTREE_BASE::Search( mmin, mmax, aVisitor );
+        // Do not restructure the tree while it is being traversed by an outer query
+        if( m_queryDepth == 0 )
+            flush();
+
+        ++m_queryDepth;
+
+        if( queryPacked( mmin, mmax, aVisitor ) )
+            m_dynamic.Search( mmin, mmax, aVisitor );
+
+        --m_queryDepth;
+    }
+
+    /**
+     * Function Flush()
+     * Applies the buffered insertions and removals, so the tree may be searched with
+     * QueryConcurrent().
+     */
+    void Flush()
+    {
+        if( m_queryDepth == 0 )
+            flush();
+    }
+
+    /**
+     * Function QueryConcurrent()
+     * Same as Query(), but does not modify the tree, so it may be called by several threads
+     * at once. The tree has to be flushed beforehand and must not be modified until all
+     * the concurrent queries are finished.
+     */
+    template <class Visitor>
+    void QueryConcurrent( const BOX2I& aBounds, Visitor& aVisitor )
+    {
+        const int   mmin[2] = { aBounds.GetX(), aBounds.GetY() };
+        const int   mmax[2] = { aBounds.GetRight(), aBounds.GetBottom() };
+
+        if( queryPacked( mmin, mmax, aVisitor ) )
+            m_dynamic.Search( mmin, mmax, aVisitor );
     }
 
 private:
+    ///> Leaf entry of the packed tree
+    struct ENTRY
+    {
+        int         m_min[2];
+        int         m_max[2];
+        VIEW_ITEM*  m_item;         ///< NULL if the item has been removed
+    };
+
+    ///> Node of the packed tree, its children are stored in a contiguous range
+    struct NODE
+    {
+        int         m_min[2];
+        int         m_max[2];
+        int         m_first;        ///< index of the first child (entry for the leaf nodes)
+        int         m_count;        ///< number of children
+    };
+
+    template <class T>
+    static bool overlaps( const T& aBox, const int aMin[2], const int aMax[2] )
+    {
+        return aBox.m_min[0] <= aMax[0] && aBox.m_max[0] >= aMin[0]
+            && aBox.m_min[1] <= aMax[1] && aBox.m_max[1] >= aMin[1];
+    }
+
+    template <class Visitor>
+    bool visitEntries( int aFirst, int aLast, const int aMin[2], const int aMax[2],
+                       Visitor& aVisitor )
+    {
+        for( int i = aFirst; i < aLast; ++i )
+        {
+            // The visitor may insert items, so do not keep references to the entries
+            VIEW_ITEM* item = m_entries[i].m_item;
+
+            if( item && overlaps( m_entries[i], aMin, aMax ) && !aVisitor( item ) )
+                return false;
+        }
+
+        return true;
+    }
+
+    template <class Visitor>
+    bool queryPacked( const int aMin[2], const int aMax[2], Visitor& aVisitor )
+    {
+        // Items inserted by an outer query visitor have not been moved to the trees yet
+        if( !visitEntries( m_packedCount, m_entries.size(), aMin, aMax, aVisitor ) )
+            return false;
+
+        if( m_nodes.empty() || !overlaps( m_nodes.back(), aMin, aMax ) )
+            return true;
+
+        // Depth-first traversal, each level adds at most NODE_CAPACITY - 1 nodes to the stack
+        int stack[STACK_SIZE];
+        int top = 0;
+
+        stack[top++] = m_nodes.size() - 1;     // root
+
+        while( top > 0 )
+        {
+            int idx = stack[--top];
+            const NODE& node = m_nodes[idx];
+            const int last = node.m_first + node.m_count;
+
+            if( idx < m_leafNodeCount )
+            {
+                if( !visitEntries( node.m_first, last, aMin, aMax, aVisitor ) )
+                    return false;
+            }
+            else
+            {
+                for( int i = node.m_first; i < last; ++i )
+                {
+                    if( overlaps( m_nodes[i], aMin, aMax ) )
+                        stack[top++] = i;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    ///> Moves the buffered items to the dynamic tree, or rebuilds the packed tree if needed
+    void flush();
+
+    ///> Builds the packed tree from all stored items
+    void rebuild();
+
+    ///> Marks an entry as removed, returns false if the item is not stored in m_entries
+    bool removeEntry( VIEW_ITEM* aItem );
+
+    ///> Sorts boxes in the Sort-Tile-Recursive order
+    template <class T>
+    static void sortTiles( std::vector<T>& aBoxes );
+
+    ///> Number of children of a packed tree node
+    static const int NODE_CAPACITY = 16;
+
+    ///> Traversal stack size, enough for trees of NODE_CAPACITY^16 items
+    static const int STACK_SIZE = 16 * NODE_CAPACITY;
+
+    ///> Dynamic part size (or number of removed entries) that is always accepted without
+    ///> rebuilding the packed tree
+    static const int MIN_REBUILD_SIZE = 256;
+
+    ///> Packed tree nodes, leaves come first and the root is the last one
+    std::vector<NODE> m_nodes;
+    int m_leafNodeCount;
+
+    ///> Packed tree leaf entries, followed by the items inserted since the last query
+    std::vector<ENTRY> m_entries;
+    int m_packedCount;
+    int m_removedEntries;
+
+    ///> Position of items in m_entries, built on the first removal after a rebuild
+    std::unordered_map<VIEW_ITEM*, int> m_entryIndex;
+
+    ///> Items inserted after the packed tree has been built
+    VIEW_RTREE_BASE m_dynamic;
+    int m_dynamicCount;
+
+    ///> Set when there are too many removed entries in the packed tree
+    bool m_needsRebuild;
+
+    ///> Number of queries in progress
+    int m_queryDepth;
 };
 } // namespace KIGFX
 
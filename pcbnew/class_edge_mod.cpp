@@ -50,6 +50,7 @@
 #include <class_edge_mod.h>
 
 #include <stdio.h>
+#include <limits>
 
 EDGE_MODULE::EDGE_MODULE( MODULE* parent, STROKE_T aShape ) :
     DRAWSEGMENT( parent, PCB_MODULE_EDGE_T )
@@ -264,6 +265,18 @@ EDA_ITEM* EDGE_MODULE::Clone() const
 }
 
 
+unsigned int EDGE_MODULE::ViewGetLOD( int aLayer, KIGFX::VIEW* aView ) const
+{
+    // Hide the details of footprints that are too small on the screen
+    const MODULE* module = dyn_cast<const MODULE*>( GetParent() );
+
+    if( module && module->ViewIsCoarse( aView ) )
+        return std::numeric_limits<unsigned int>::max();
+
+    return 0;
+}
+
+
 void EDGE_MODULE::Flip( const wxPoint& aCentre )
 {
     wxPoint pt;
@@ -49,6 +49,7 @@
 #include <class_module.h>
 
 #include <view/view.h>
+#include <gal/graphics_abstraction_layer.h>
 
 MODULE::MODULE( BOARD* parent ) :
     BOARD_ITEM_CONTAINER( (BOARD_ITEM*) parent, PCB_MODULE_T ),
@@ -850,14 +851,41 @@ void MODULE::ViewGetLayers( int aLayers[], int& aCount ) const
 
 unsigned int MODULE::ViewGetLOD( int aLayer, KIGFX::VIEW* aView ) const
 {
+    const unsigned int MAX = std::numeric_limits<unsigned int>::max();
+
+    // Simplified footprint shape, only when the details are not displayed
+    if( aLayer == ITEM_GAL_LAYER( MOD_FR_VISIBLE ) || aLayer == ITEM_GAL_LAYER( MOD_BK_VISIBLE ) )
+        return ViewIsCoarse( aView ) ? 0 : MAX;
+
     int layer = ( m_Layer == F_Cu ) ? MOD_FR_VISIBLE :
                 ( m_Layer == B_Cu ) ? MOD_BK_VISIBLE : ANCHOR_VISIBLE;
 
-    // Currently it is only for anchor layer
+    // Anchor layer
     if( aView->IsLayerVisible( ITEM_GAL_LAYER( layer ) ) )
         return 30;
 
-    return std::numeric_limits<unsigned int>::max();
+    return MAX;
+}
+
+
+bool MODULE::ViewIsCoarse( const KIGFX::VIEW* aView ) const
+{
+    if( !aView )
+        return false;
+
+    // The details may be hidden only if the simplified shape is displayed instead
+    if( m_Layer != F_Cu && m_Layer != B_Cu )
+        return false;
+
+    int coarseLayer = ( m_Layer == F_Cu ) ? MOD_FR_VISIBLE : MOD_BK_VISIBLE;
+
+    if( !aView->IsLayerVisible( ITEM_GAL_LAYER( coarseLayer ) ) )
+        return false;
+
+    // Use the bounding box cached by CalculateBoundingBox(), only its size matters here
+    int size = std::max( m_BoundaryBox.GetWidth(), m_BoundaryBox.GetHeight() );
+
+    return size * aView->GetGAL()->GetWorldScale() < LOD_PIXELS;
 }
 
 
@@ -568,6 +568,19 @@ public:
     /// @copydoc VIEW_ITEM::ViewGetLOD()
     virtual unsigned int ViewGetLOD( int aLayer, KIGFX::VIEW* aView ) const override;
 
+    /**
+     * Function ViewIsCoarse
+     * Tells whether the footprint is too small on the screen to show any details. In such
+     * case the pads, graphic items and texts are hidden and the footprint is drawn
+     * as a box on its MOD_FR_VISIBLE/MOD_BK_VISIBLE layer. The details are never hidden
+     * when that layer is not visible, so the footprint does not vanish.
+     * @param aView is the view that displays the footprint.
+     */
+    bool ViewIsCoarse( const KIGFX::VIEW* aView ) const;
+
+    ///> Footprint size (in pixels) below which it is drawn as a box
+    static const int LOD_PIXELS = 8;
+
     /// @copydoc VIEW_ITEM::ViewBBox()
     virtual const BOX2I ViewBBox() const override;
 
@@ -982,6 +982,12 @@ unsigned int D_PAD::ViewGetLOD( int aLayer, KIGFX::VIEW* aView ) const
         return ( Millimeter2iu( 100 ) / divisor );
     }
 
+    // Hide the details of footprints that are too small on the screen
+    const MODULE* module = GetParent();
+
+    if( module && module->ViewIsCoarse( aView ) )
+        return UINT_MAX;
+
     // Other layers are shown without any conditions
     return 0;
 }
@@ -459,6 +459,11 @@ unsigned int TEXTE_MODULE::ViewGetLOD( int aLayer, KIGFX::VIEW* aView ) const
                                     !aView->IsLayerVisible( ITEM_GAL_LAYER( MOD_BK_VISIBLE ) ) ) )
         return MAX;
 
+    const MODULE* module = dyn_cast<const MODULE*>( GetParent() );
+
+    if( module && module->ViewIsCoarse( aView ) )
+        return MAX;
+
     return 0;
 }
 
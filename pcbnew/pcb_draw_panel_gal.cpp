@@ -56,6 +56,7 @@ const LAYER_NUM GAL_LAYER_ORDER[] =
 
     NETNAMES_GAL_LAYER( PAD_FR_NETNAMES_VISIBLE ), ITEM_GAL_LAYER( PAD_FR_VISIBLE ),
     NETNAMES_GAL_LAYER( F_Cu ), F_Cu, F_Mask, F_SilkS, F_Paste, F_Adhes,
+    ITEM_GAL_LAYER( MOD_FR_VISIBLE ),
 
     NETNAMES_GAL_LAYER( In1_Cu ),   In1_Cu,
     NETNAMES_GAL_LAYER( In2_Cu ),   In2_Cu,
@@ -90,6 +91,7 @@ const LAYER_NUM GAL_LAYER_ORDER[] =
 
     NETNAMES_GAL_LAYER( PAD_BK_NETNAMES_VISIBLE ), ITEM_GAL_LAYER( PAD_BK_VISIBLE ),
     NETNAMES_GAL_LAYER( B_Cu ), B_Cu, B_Mask, B_Adhes, B_Paste, B_SilkS,
+    ITEM_GAL_LAYER( MOD_BK_VISIBLE ),
 
     ITEM_GAL_LAYER( MOD_TEXT_BK_VISIBLE ),
     ITEM_GAL_LAYER( WORKSHEET )
@@ -107,6 +109,9 @@ EDA_DRAW_PANEL_GAL( aParentWindow, aWindowId, aPosition, aSize, aOptions, aGalTy
     setDefaultLayerOrder();
     setDefaultLayerDeps();
 
+    // Pads and vias are usually repeated many times with the same shape
+    m_view->SetInstancing( true );
+
     // Load display options (such as filled/outline display of items).
     // Can be made only if the parent window is an EDA_DRAW_FRAME (or a derived class)
     // which is not always the case (namely when it is used from a wxDialog like the pad editor)
@@ -131,41 +136,59 @@ void PCB_DRAW_PANEL_GAL::DisplayBoard( const BOARD* aBoard )
 {
     m_view->Clear();
 
+    AddBoardItems( m_view, aBoard );
+
+    // Ratsnest
+    if( m_ratsnest )
+    {
+        m_view->Remove( m_ratsnest );
+        delete m_ratsnest;
+    }
+
+    m_ratsnest = new KIGFX::RATSNEST_VIEWITEM( aBoard->GetRatsnest() );
+    m_view->Add( m_ratsnest );
+
+    // The dynamic ratsnest is computed in a worker thread, redraw it when it is ready
+    m_ratsnest->SetUpdateCallback( [this]() {
+        CallAfter( &PCB_DRAW_PANEL_GAL::onRatsnestUpdated );
+    } );
+
+    // Display settings
+    UseColorScheme( aBoard->GetColorsSettings() );
+}
+
+
+void PCB_DRAW_PANEL_GAL::onRatsnestUpdated()
+{
+    m_view->MarkTargetDirty( KIGFX::TARGET_OVERLAY );
+    Refresh();
+}
+
+
+void PCB_DRAW_PANEL_GAL::AddBoardItems( KIGFX::VIEW* aView, const BOARD* aBoard )
+{
     // Load zones
     for( int i = 0; i < aBoard->GetAreaCount(); ++i )
-        m_view->Add( (KIGFX::VIEW_ITEM*) ( aBoard->GetArea( i ) ) );
+        aView->Add( (KIGFX::VIEW_ITEM*) ( aBoard->GetArea( i ) ) );
 
     // Load drawings
     for( BOARD_ITEM* drawing = aBoard->m_Drawings; drawing; drawing = drawing->Next() )
-        m_view->Add( drawing );
+        aView->Add( drawing );
 
     // Load tracks
     for( TRACK* track = aBoard->m_Track; track; track = track->Next() )
-        m_view->Add( track );
+        aView->Add( track );
 
     // Load modules and its additional elements
     for( MODULE* module = aBoard->m_Modules; module; module = module->Next() )
     {
-        module->RunOnChildren( std::bind( &KIGFX::VIEW::Add, m_view, _1 ) );
-        m_view->Add( module );
+        module->RunOnChildren( std::bind( &KIGFX::VIEW::Add, aView, _1 ) );
+        aView->Add( module );
     }
 
     // Segzones (equivalent of ZONE_CONTAINER for legacy boards)
     for( SEGZONE* zone = aBoard->m_Zone; zone; zone = zone->Next() )
-        m_view->Add( zone );
-
-    // Ratsnest
-    if( m_ratsnest )
-    {
-        m_view->Remove( m_ratsnest );
-        delete m_ratsnest;
-    }
-
-    m_ratsnest = new KIGFX::RATSNEST_VIEWITEM( aBoard->GetRatsnest() );
-    m_view->Add( m_ratsnest );
-
-    // Display settings
-    UseColorScheme( aBoard->GetColorsSettings() );
+        aView->Add( zone );
 }
 
 
@@ -369,13 +392,19 @@ void PCB_DRAW_PANEL_GAL::OnShow()
 
 
 void PCB_DRAW_PANEL_GAL::setDefaultLayerOrder()
+{
+    SetDefaultLayerOrder( m_view );
+}
+
+
+void PCB_DRAW_PANEL_GAL::SetDefaultLayerOrder( KIGFX::VIEW* aView )
 {
     for( LAYER_NUM i = 0; (unsigned) i < sizeof( GAL_LAYER_ORDER ) / sizeof( LAYER_NUM ); ++i )
     {
         LAYER_NUM layer = GAL_LAYER_ORDER[i];
         wxASSERT( layer < KIGFX::VIEW::VIEW_MAX_LAYERS );
 
-        m_view->SetLayerOrder( layer, i );
+        aView->SetLayerOrder( layer, i );
     }
 }
 
@@ -389,6 +418,12 @@ bool PCB_DRAW_PANEL_GAL::SwitchBackend( GAL_TYPE aGalType )
 
 
 void PCB_DRAW_PANEL_GAL::setDefaultLayerDeps()
+{
+    SetDefaultLayerDeps( m_view, m_backend == GAL_TYPE_OPENGL );
+}
+
+
+void PCB_DRAW_PANEL_GAL::SetDefaultLayerDeps( KIGFX::VIEW* aView, bool aCached )
 {
     for( LAYER_NUM i = 0; (unsigned) i < sizeof( GAL_LAYER_ORDER ) / sizeof( LAYER_NUM ); ++i )
     {
@@ -398,59 +433,59 @@ void PCB_DRAW_PANEL_GAL::setDefaultLayerDeps()
         // Set layer display dependencies & targets
         if( IsCopperLayer( layer ) )
         {
-            m_view->SetRequired( GetNetnameLayer( layer ), layer );
-            m_view->SetLayerTarget( layer, KIGFX::TARGET_CACHED );
+            aView->SetRequired( GetNetnameLayer( layer ), layer );
+            aView->SetLayerTarget( layer, KIGFX::TARGET_CACHED );
         }
         else if( IsNetnameLayer( layer ) )
         {
-            m_view->SetLayerDisplayOnly( layer );
-            m_view->SetLayerTarget( layer, KIGFX::TARGET_CACHED );
+            aView->SetLayerDisplayOnly( layer );
+            aView->SetLayerTarget( layer, KIGFX::TARGET_CACHED );
         }
     }
 
     // caching makes no sense for Cairo and other software renderers
-    if ( m_backend != GAL_TYPE_OPENGL )
+    if( !aCached )
     {
         for( int i = 0; i < KIGFX::VIEW::VIEW_MAX_LAYERS; i++ )
-           m_view->SetLayerTarget( i, KIGFX::TARGET_NONCACHED );
+           aView->SetLayerTarget( i, KIGFX::TARGET_NONCACHED );
     }
 
-    m_view->SetLayerTarget( ITEM_GAL_LAYER( ANCHOR_VISIBLE ), KIGFX::TARGET_NONCACHED );
-    m_view->SetLayerDisplayOnly( ITEM_GAL_LAYER( ANCHOR_VISIBLE ) );
+    aView->SetLayerTarget( ITEM_GAL_LAYER( ANCHOR_VISIBLE ), KIGFX::TARGET_NONCACHED );
+    aView->SetLayerDisplayOnly( ITEM_GAL_LAYER( ANCHOR_VISIBLE ) );
 
     // Some more required layers settings
-    m_view->SetRequired( ITEM_GAL_LAYER( VIAS_HOLES_VISIBLE ), ITEM_GAL_LAYER( VIA_THROUGH_VISIBLE ) );
-    m_view->SetRequired( ITEM_GAL_LAYER( PADS_HOLES_VISIBLE ), ITEM_GAL_LAYER( PADS_VISIBLE ) );
-    m_view->SetRequired( NETNAMES_GAL_LAYER( PADS_NETNAMES_VISIBLE ), ITEM_GAL_LAYER( PADS_VISIBLE ) );
+    aView->SetRequired( ITEM_GAL_LAYER( VIAS_HOLES_VISIBLE ), ITEM_GAL_LAYER( VIA_THROUGH_VISIBLE ) );
+    aView->SetRequired( ITEM_GAL_LAYER( PADS_HOLES_VISIBLE ), ITEM_GAL_LAYER( PADS_VISIBLE ) );
+    aView->SetRequired( NETNAMES_GAL_LAYER( PADS_NETNAMES_VISIBLE ), ITEM_GAL_LAYER( PADS_VISIBLE ) );
 
     // Front modules
-    m_view->SetRequired( ITEM_GAL_LAYER( PAD_FR_VISIBLE ), ITEM_GAL_LAYER( MOD_FR_VISIBLE ) );
-    m_view->SetRequired( ITEM_GAL_LAYER( MOD_TEXT_FR_VISIBLE ), ITEM_GAL_LAYER( MOD_FR_VISIBLE ) );
-    m_view->SetRequired( NETNAMES_GAL_LAYER( PAD_FR_NETNAMES_VISIBLE ), ITEM_GAL_LAYER( PAD_FR_VISIBLE ) );
-    m_view->SetRequired( F_Adhes, ITEM_GAL_LAYER( PAD_FR_VISIBLE ) );
-    m_view->SetRequired( F_Paste, ITEM_GAL_LAYER( PAD_FR_VISIBLE ) );
-    m_view->SetRequired( F_Mask, ITEM_GAL_LAYER( PAD_FR_VISIBLE ) );
-    m_view->SetRequired( F_CrtYd, ITEM_GAL_LAYER( MOD_FR_VISIBLE ) );
-    m_view->SetRequired( F_Fab, ITEM_GAL_LAYER( MOD_FR_VISIBLE ) );
-    m_view->SetRequired( F_SilkS, ITEM_GAL_LAYER( MOD_FR_VISIBLE ) );
+    aView->SetRequired( ITEM_GAL_LAYER( PAD_FR_VISIBLE ), ITEM_GAL_LAYER( MOD_FR_VISIBLE ) );
+    aView->SetRequired( ITEM_GAL_LAYER( MOD_TEXT_FR_VISIBLE ), ITEM_GAL_LAYER( MOD_FR_VISIBLE ) );
+    aView->SetRequired( NETNAMES_GAL_LAYER( PAD_FR_NETNAMES_VISIBLE ), ITEM_GAL_LAYER( PAD_FR_VISIBLE ) );
+    aView->SetRequired( F_Adhes, ITEM_GAL_LAYER( PAD_FR_VISIBLE ) );
+    aView->SetRequired( F_Paste, ITEM_GAL_LAYER( PAD_FR_VISIBLE ) );
+    aView->SetRequired( F_Mask, ITEM_GAL_LAYER( PAD_FR_VISIBLE ) );
+    aView->SetRequired( F_CrtYd, ITEM_GAL_LAYER( MOD_FR_VISIBLE ) );
+    aView->SetRequired( F_Fab, ITEM_GAL_LAYER( MOD_FR_VISIBLE ) );
+    aView->SetRequired( F_SilkS, ITEM_GAL_LAYER( MOD_FR_VISIBLE ) );
 
     // Back modules
-    m_view->SetRequired( ITEM_GAL_LAYER( PAD_BK_VISIBLE ), ITEM_GAL_LAYER( MOD_BK_VISIBLE ) );
-    m_view->SetRequired( ITEM_GAL_LAYER( MOD_TEXT_BK_VISIBLE ), ITEM_GAL_LAYER( MOD_BK_VISIBLE ) );
-    m_view->SetRequired( NETNAMES_GAL_LAYER( PAD_BK_NETNAMES_VISIBLE ), ITEM_GAL_LAYER( PAD_BK_VISIBLE ) );
-    m_view->SetRequired( B_Adhes, ITEM_GAL_LAYER( PAD_BK_VISIBLE ) );
-    m_view->SetRequired( B_Paste, ITEM_GAL_LAYER( PAD_BK_VISIBLE ) );
-    m_view->SetRequired( B_Mask, ITEM_GAL_LAYER( PAD_BK_VISIBLE ) );
-    m_view->SetRequired( B_CrtYd, ITEM_GAL_LAYER( MOD_BK_VISIBLE ) );
-    m_view->SetRequired( B_Fab, ITEM_GAL_LAYER( MOD_BK_VISIBLE ) );
-    m_view->SetRequired( B_SilkS, ITEM_GAL_LAYER( MOD_BK_VISIBLE ) );
-
-    m_view->SetLayerTarget( ITEM_GAL_LAYER( GP_OVERLAY ), KIGFX::TARGET_OVERLAY );
-    m_view->SetLayerDisplayOnly( ITEM_GAL_LAYER( GP_OVERLAY ) );
-    m_view->SetLayerTarget( ITEM_GAL_LAYER( RATSNEST_VISIBLE ), KIGFX::TARGET_OVERLAY );
-    m_view->SetLayerDisplayOnly( ITEM_GAL_LAYER( RATSNEST_VISIBLE ) );
-
-    m_view->SetLayerDisplayOnly( ITEM_GAL_LAYER( WORKSHEET ) );
-    m_view->SetLayerDisplayOnly( ITEM_GAL_LAYER( GRID_VISIBLE ) );
-    m_view->SetLayerDisplayOnly( ITEM_GAL_LAYER( DRC_VISIBLE ) );
+    aView->SetRequired( ITEM_GAL_LAYER( PAD_BK_VISIBLE ), ITEM_GAL_LAYER( MOD_BK_VISIBLE ) );
+    aView->SetRequired( ITEM_GAL_LAYER( MOD_TEXT_BK_VISIBLE ), ITEM_GAL_LAYER( MOD_BK_VISIBLE ) );
+    aView->SetRequired( NETNAMES_GAL_LAYER( PAD_BK_NETNAMES_VISIBLE ), ITEM_GAL_LAYER( PAD_BK_VISIBLE ) );
+    aView->SetRequired( B_Adhes, ITEM_GAL_LAYER( PAD_BK_VISIBLE ) );
+    aView->SetRequired( B_Paste, ITEM_GAL_LAYER( PAD_BK_VISIBLE ) );
+    aView->SetRequired( B_Mask, ITEM_GAL_LAYER( PAD_BK_VISIBLE ) );
+    aView->SetRequired( B_CrtYd, ITEM_GAL_LAYER( MOD_BK_VISIBLE ) );
+    aView->SetRequired( B_Fab, ITEM_GAL_LAYER( MOD_BK_VISIBLE ) );
+    aView->SetRequired( B_SilkS, ITEM_GAL_LAYER( MOD_BK_VISIBLE ) );
+
+    aView->SetLayerTarget( ITEM_GAL_LAYER( GP_OVERLAY ), KIGFX::TARGET_OVERLAY );
+    aView->SetLayerDisplayOnly( ITEM_GAL_LAYER( GP_OVERLAY ) );
+    aView->SetLayerTarget( ITEM_GAL_LAYER( RATSNEST_VISIBLE ), KIGFX::TARGET_OVERLAY );
+    aView->SetLayerDisplayOnly( ITEM_GAL_LAYER( RATSNEST_VISIBLE ) );
+
+    aView->SetLayerDisplayOnly( ITEM_GAL_LAYER( WORKSHEET ) );
+    aView->SetLayerDisplayOnly( ITEM_GAL_LAYER( GRID_VISIBLE ) );
+    aView->SetLayerDisplayOnly( ITEM_GAL_LAYER( DRC_VISIBLE ) );
 }
@@ -50,6 +50,29 @@ public:
      */
     void DisplayBoard( const BOARD* aBoard );
 
+    /**
+     * Function AddBoardItems
+     * adds all items from a board to a VIEW (without the ratsnest and the worksheet).
+     * @param aView is the VIEW that receives the items.
+     * @param aBoard is the PCB to be loaded.
+     */
+    static void AddBoardItems( KIGFX::VIEW* aView, const BOARD* aBoard );
+
+    /**
+     * Function SetDefaultLayerOrder
+     * assigns the layer order used by the board editor to a VIEW.
+     * @param aView is the VIEW to be configured.
+     */
+    static void SetDefaultLayerOrder( KIGFX::VIEW* aView );
+
+    /**
+     * Function SetDefaultLayerDeps
+     * sets rendering targets & dependencies used by the board editor for the layers of a VIEW.
+     * @param aView is the VIEW to be configured.
+     * @param aCached decides if the items should be cached (it is worth only with OpenGL).
+     */
+    static void SetDefaultLayerDeps( KIGFX::VIEW* aView, bool aCached );
+
     /**
      * Function SetWorksheet
      * Sets (or updates) worksheet used by the draw panel.
@@ -93,6 +116,9 @@ protected:
     ///> Sets rendering targets & dependencies for layers.
     void setDefaultLayerDeps();
 
+    ///> Redraws the ratsnest after its dynamic part has been computed in background.
+    void onRatsnestUpdated();
+
     ///> Currently used worksheet
     KIGFX::WORKSHEET_VIEWITEM* m_worksheet;
 
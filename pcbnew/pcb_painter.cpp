@@ -39,6 +39,7 @@
 #include <pcb_painter.h>
 #include <gal/graphics_abstraction_layer.h>
 #include <convert_basic_shapes_to_polygon.h>
+#include <frame_profiler.h>
 
 using namespace KIGFX;
 
@@ -259,6 +260,7 @@ int PCB_PAINTER::getLineThickness( int aActualThickness ) const
 
 bool PCB_PAINTER::Draw( const VIEW_ITEM* aItem, int aLayer )
 {
+    FRAME_PROFILER_SCOPE profilerScope( FRAME_PROFILER::PAINTER );
     const EDA_ITEM* item = static_cast<const EDA_ITEM*>( aItem );
 
     // the "cast" applied in here clarifies which overloaded draw() is called
@@ -319,6 +321,100 @@ bool PCB_PAINTER::Draw( const VIEW_ITEM* aItem, int aLayer )
 }
 
 
+bool PCB_PAINTER::GetInstanceKey( const VIEW_ITEM* aItem, int aLayer, INSTANCE_KEY& aKey,
+                                  VECTOR2D& aOrigin ) const
+{
+    const EDA_ITEM* item = static_cast<const EDA_ITEM*>( aItem );
+
+    // Net names are different for every item, so there is nothing to share
+    if( IsNetnameLayer( aLayer ) )
+        return false;
+
+    switch( item->Type() )
+    {
+    case PCB_VIA_T:
+        aOrigin = VECTOR2D( static_cast<const VIA*>( item )->GetStart() );
+        return getInstanceKey( static_cast<const VIA*>( item ), aLayer, aKey );
+
+    case PCB_PAD_T:
+        aOrigin = VECTOR2D( static_cast<const D_PAD*>( item )->GetPosition() );
+        return getInstanceKey( static_cast<const D_PAD*>( item ), aLayer, aKey );
+
+    default:
+        return false;
+    }
+}
+
+
+bool PCB_PAINTER::getInstanceKey( const VIA* aVia, int aLayer, INSTANCE_KEY& aKey ) const
+{
+    LAYER_ID layerTop, layerBottom;
+    aVia->LayerPair( &layerTop, &layerBottom );
+
+    BOARD* brd = aVia->GetBoard();
+    constexpr int clearanceFlags = PCB_RENDER_SETTINGS::CL_EXISTING | PCB_RENDER_SETTINGS::CL_VIAS;
+    bool clearance = ( m_pcbSettings.m_clearance & clearanceFlags ) == clearanceFlags;
+
+    aKey.Add( PCB_VIA_T );
+    aKey.Add( aLayer );
+    aKey.Add( aVia->GetViaType() );
+    aKey.Add( aVia->GetWidth() );
+    aKey.Add( aVia->GetDrillValue() );
+    aKey.Add( layerTop );
+    aKey.Add( layerBottom );
+    aKey.Add( brd && ( brd->GetVisibleLayers() & aVia->GetLayerSet() ).any() );
+    aKey.Add( m_pcbSettings.GetColor( aVia, aLayer ) );
+    aKey.Add( m_pcbSettings.m_sketchMode[ITEM_GAL_LAYER( VIA_THROUGH_VISIBLE )] );
+    aKey.Add( m_pcbSettings.m_sketchMode[ITEM_GAL_LAYER( VIA_BBLIND_VISIBLE )] );
+    aKey.Add( m_pcbSettings.m_sketchMode[ITEM_GAL_LAYER( VIA_MICROVIA_VISIBLE )] );
+    aKey.Add( KiROUND( m_pcbSettings.m_outlineWidth ) );
+    aKey.Add( clearance ? aVia->GetClearance() : -1 );
+
+    return aKey.IsValid();
+}
+
+
+bool PCB_PAINTER::getInstanceKey( const D_PAD* aPad, int aLayer, INSTANCE_KEY& aKey ) const
+{
+    constexpr int clearanceFlags = PCB_RENDER_SETTINGS::CL_PADS;
+    bool clearance = ( m_pcbSettings.m_clearance & clearanceFlags ) == clearanceFlags;
+
+    aKey.Add( PCB_PAD_T );
+    aKey.Add( aLayer );
+    aKey.Add( aPad->GetShape() );
+    aKey.Add( aPad->GetSize().x );
+    aKey.Add( aPad->GetSize().y );
+    aKey.Add( aPad->GetDrillShape() );
+    aKey.Add( aPad->GetDrillSize().x );
+    aKey.Add( aPad->GetDrillSize().y );
+    aKey.Add( KiROUND( aPad->GetOrientation() ) );
+    aKey.Add( aPad->GetOffset().x );
+    aKey.Add( aPad->GetOffset().y );
+    aKey.Add( aPad->GetDelta().x );
+    aKey.Add( aPad->GetDelta().y );
+    aKey.Add( aPad->GetShape() == PAD_SHAPE_ROUNDRECT
+              ? aPad->GetRoundRectCornerRadius() : 0 );
+
+    if( aLayer == F_Mask || aLayer == B_Mask )
+    {
+        aKey.Add( aPad->GetSolderMaskMargin() );
+    }
+    else if( aLayer == F_Paste || aLayer == B_Paste )
+    {
+        wxSize solderpasteMargin = aPad->GetSolderPasteMargin();
+        aKey.Add( solderpasteMargin.x );
+        aKey.Add( solderpasteMargin.y );
+    }
+
+    aKey.Add( m_pcbSettings.GetColor( aPad, aLayer ) );
+    aKey.Add( m_pcbSettings.m_sketchMode[ITEM_GAL_LAYER( PADS_VISIBLE )] );
+    aKey.Add( KiROUND( m_pcbSettings.m_outlineWidth ) );
+    aKey.Add( clearance ? aPad->GetClearance() : -1 );
+
+    return aKey.IsValid();
+}
+
+
 void PCB_PAINTER::draw( const TRACK* aTrack, int aLayer )
 {
     VECTOR2D start( aTrack->GetStart() );
@@ -953,6 +1049,19 @@ void PCB_PAINTER::draw( const MODULE* aModule, int aLayer )
         m_gal->DrawLine( center - VECTOR2D( anchorSize, 0 ), center + VECTOR2D( anchorSize, 0 ) );
         m_gal->DrawLine( center - VECTOR2D( 0, anchorSize ), center + VECTOR2D( 0, anchorSize ) );
     }
+    else if( aLayer == ITEM_GAL_LAYER( MOD_FR_VISIBLE )
+            || aLayer == ITEM_GAL_LAYER( MOD_BK_VISIBLE ) )
+    {
+        // Footprints that are too small to show any detail are drawn as a box (see
+        // MODULE::ViewGetLOD())
+        const COLOR4D& color = m_pcbSettings.GetColor( aModule, aLayer );
+        const EDA_RECT& bbox = aModule->GetBoundingBox();
+
+        m_gal->SetIsFill( true );
+        m_gal->SetIsStroke( false );
+        m_gal->SetFillColor( color );
+        m_gal->DrawRectangle( VECTOR2D( bbox.GetOrigin() ), VECTOR2D( bbox.GetEnd() ) );
+    }
 }
 
 
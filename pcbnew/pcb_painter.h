@@ -213,6 +213,16 @@ public:
     /// @copydoc PAINTER::Draw()
     virtual bool Draw( const VIEW_ITEM* aItem, int aLayer ) override;
 
+    /// @copydoc PAINTER::Clone()
+    virtual PCB_PAINTER* Clone() const override
+    {
+        return new PCB_PAINTER( *this );
+    }
+
+    /// @copydoc PAINTER::GetInstanceKey()
+    virtual bool GetInstanceKey( const VIEW_ITEM* aItem, int aLayer, INSTANCE_KEY& aKey,
+                                 VECTOR2D& aOrigin ) const override;
+
 protected:
     PCB_RENDER_SETTINGS m_pcbSettings;
 
@@ -229,6 +239,10 @@ protected:
     void draw( const PCB_TARGET* aTarget );
     void draw( const MARKER_PCB* aMarker );
 
+    // Instance keys for items that are often repeated on a board (see GetInstanceKey())
+    bool getInstanceKey( const VIA* aVia, int aLayer, INSTANCE_KEY& aKey ) const;
+    bool getInstanceKey( const D_PAD* aPad, int aLayer, INSTANCE_KEY& aKey ) const;
+
     /**
      * Function getLineThickness()
      * Get the thickness to draw for a line (e.g. 0 thickness lines
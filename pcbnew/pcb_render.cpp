@@ -0,0 +1,329 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/*
+ * Offscreen board renderer. Loads a board, draws it with VIEW and PCB_PAINTER to an image
+ * (CAIRO_IMAGE_GAL, no window is needed), saves the result as PNG files and reports the time
+ * spent on every rendering phase, as measured by FRAME_PROFILER:
+ *  - redraw:    VIEW::Redraw(), looking up the visible items and drawing them,
+ *  - query:     searching the view R-trees, without drawing the found items,
+ *  - paint:     PCB_PAINTER::Draw() calls,
+ *  - composite: merging the layer buffers into the final image.
+ * Query and paint times are summed for all the tile threads.
+ *
+ * Usage: pcb_render [options] board.kicad_pcb
+ *  -s WIDTHxHEIGHT     image size in pixels (default 1600x1200)
+ *  -z ZOOM[,ZOOM...]   zoom levels, 1 shows the whole board (default 1,4,16)
+ *  -c X,Y              view center in mm (default: the board center)
+ *  -l LAYER[,LAYER...] board layers to be shown, e.g. F.Cu,B.Cu (default: all enabled layers)
+ *  -r REPEATS          number of frames rendered for each zoom level (default 5)
+ *  -t TILES            number of tiles, 0 renders in a single thread (default: automatic)
+ *  -o PREFIX           output files prefix, no images are saved if empty (default: "render")
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <wx/init.h>
+#include <wx/tokenzr.h>
+
+#include <profile.h>
+#include <frame_profiler.h>
+#include <convert_to_biu.h>
+#include <ki_exception.h>
+#include <io_mgr.h>
+#include <class_board.h>
+#include <pcb_painter.h>
+#include <pcb_draw_panel_gal.h>
+#include <view/view.h>
+#include <gal/cairo/cairo_image_gal.h>
+
+using namespace KIGFX;
+
+
+struct PHASE_TIMES
+{
+    PHASE_TIMES() : redraw( 0.0 ), query( 0.0 ), paint( 0.0 ), composite( 0.0 ), items( 0 )
+    {
+    }
+
+    double redraw;
+    double query;
+    double paint;
+    double composite;
+    unsigned int items;     ///< number of items drawn by the painter
+};
+
+
+static void usage()
+{
+    fprintf( stderr, "Usage: pcb_render [-s WIDTHxHEIGHT] [-z ZOOM,...] [-c X,Y] [-l LAYER,...]\n"
+                     "                  [-r REPEATS] [-t TILES] [-o PREFIX] board.kicad_pcb\n" );
+}
+
+
+static PHASE_TIMES renderFrame( VIEW& aView, CAIRO_IMAGE_GAL& aGal, const COLOR4D& aBackground )
+{
+    FRAME_PROFILER& profiler = FRAME_PROFILER::Instance();
+    PHASE_TIMES times;
+
+    aView.MarkDirty();
+
+    profiler.BeginFrame();
+    aGal.BeginDrawing();
+    aGal.ClearScreen( aBackground );
+    aView.ClearTargets();
+    aView.Redraw();
+    aGal.EndDrawing();
+    profiler.EndFrame();
+
+    FRAME_PROFILER::RECORD record;
+
+    if( profiler.GetAverage( record, 1 ) )
+    {
+        times.redraw = record.m_time[FRAME_PROFILER::VIEW_REDRAW];
+        times.query = record.m_time[FRAME_PROFILER::VIEW_QUERY];
+        times.paint = record.m_time[FRAME_PROFILER::PAINTER];
+        times.composite = record.m_time[FRAME_PROFILER::GAL_COMPOSITE];
+        times.items = record.m_calls[FRAME_PROFILER::PAINTER];
+    }
+
+    return times;
+}
+
+
+int main( int argc, char** argv )
+{
+    wxInitializer initializer;
+
+    if( !initializer )
+    {
+        fprintf( stderr, "Could not initialize wxWidgets\n" );
+        return 1;
+    }
+
+    int width = 1600, height = 1200;
+    int repeats = 5;
+    int tiles = -1;
+    bool customCenter = false;
+    VECTOR2D center;
+    std::vector<double> zooms;
+    wxString layers;
+    std::string prefix = "render";
+    const char* boardFile = NULL;
+
+    for( int i = 1; i < argc; ++i )
+    {
+        const char* arg = argv[i];
+        const char* value = ( i + 1 < argc ) ? argv[i + 1] : NULL;
+
+        if( arg[0] != '-' )
+        {
+            boardFile = arg;
+            continue;
+        }
+
+        if( !value || strlen( arg ) != 2 )
+        {
+            usage();
+            return 1;
+        }
+
+        switch( arg[1] )
+        {
+        case 's':
+            if( sscanf( value, "%dx%d", &width, &height ) != 2 || width <= 0 || height <= 0 )
+            {
+                usage();
+                return 1;
+            }
+            break;
+
+        case 'z':
+        {
+            wxStringTokenizer tokenizer( value, "," );
+
+            while( tokenizer.HasMoreTokens() )
+                zooms.push_back( atof( tokenizer.GetNextToken().c_str() ) );
+
+            break;
+        }
+
+        case 'c':
+            if( sscanf( value, "%lf,%lf", &center.x, &center.y ) != 2 )
+            {
+                usage();
+                return 1;
+            }
+
+            center = center * IU_PER_MM;
+            customCenter = true;
+            break;
+
+        case 'l': layers = value;                           break;
+        case 'r': repeats = std::max( 1, atoi( value ) );   break;
+        case 't': tiles = atoi( value );                    break;
+        case 'o': prefix = value;                           break;
+
+        default:
+            usage();
+            return 1;
+        }
+
+        ++i;
+    }
+
+    if( !boardFile )
+    {
+        usage();
+        return 1;
+    }
+
+    if( zooms.empty() )
+        zooms = { 1.0, 4.0, 16.0 };
+
+    std::unique_ptr<BOARD> board;
+    PROF_COUNTER loadTime;
+
+    try
+    {
+        board.reset( IO_MGR::Load( IO_MGR::KICAD, wxString::FromUTF8( boardFile ) ) );
+    }
+    catch( const IO_ERROR& ioe )
+    {
+        fprintf( stderr, "Error loading board: %s\n", (const char*) ioe.What().mb_str() );
+        return 1;
+    }
+
+    loadTime.Stop();
+
+    CAIRO_IMAGE_GAL gal( width, height );
+    PCB_PAINTER painter( &gal );
+    VIEW view;
+
+    gal.SetTileCount( tiles );
+    view.SetGAL( &gal );
+    view.SetPainter( &painter );
+    PCB_DRAW_PANEL_GAL::SetDefaultLayerOrder( &view );
+    PCB_DRAW_PANEL_GAL::SetDefaultLayerDeps( &view, false );
+    painter.GetSettings()->ImportLegacyColors( board->GetColorsSettings() );
+
+    // Board layers are shown if they were requested or, by default, if they are enabled
+    LSET visibleLayers = board->GetEnabledLayers();
+
+    if( !layers.IsEmpty() )
+    {
+        wxStringTokenizer tokenizer( layers, "," );
+        visibleLayers.reset();
+
+        while( tokenizer.HasMoreTokens() )
+        {
+            wxString name = tokenizer.GetNextToken();
+            LAYER_ID layer = board->GetLayerID( name );
+
+            if( layer == UNDEFINED_LAYER )
+            {
+                fprintf( stderr, "Unknown layer: %s\n", (const char*) name.mb_str() );
+                return 1;
+            }
+
+            visibleLayers.set( layer );
+        }
+    }
+
+    for( LAYER_NUM layer = 0; layer < LAYER_ID_COUNT; ++layer )
+        view.SetLayerVisible( layer, visibleLayers[layer] );
+
+    PROF_COUNTER viewTime;
+    PCB_DRAW_PANEL_GAL::AddBoardItems( &view, board.get() );
+    view.UpdateItems();
+    viewTime.Stop();
+
+    printf( "%s: board loaded in %.1f ms, view filled in %.1f ms\n",
+            boardFile, loadTime.msecs(), viewTime.msecs() );
+
+    // Zoom 1 fits the board in the image
+    EDA_RECT bbox = board->ComputeBoundingBox();
+    view.SetViewport( BOX2D( bbox.GetOrigin(), bbox.GetSize() ) );
+    double fitScale = view.GetScale();
+
+    if( !customCenter )
+        center = view.GetCenter();
+
+    const COLOR4D& background = painter.GetSettings()->GetBackgroundColor();
+
+    FRAME_PROFILER::Instance().Enable( true );
+
+    for( unsigned int i = 0; i < zooms.size(); ++i )
+    {
+        view.SetScale( fitScale * zooms[i] );
+        view.SetCenter( center );
+
+        // The first frame warms up the caches, it is not measured
+        renderFrame( view, gal, background );
+
+        PHASE_TIMES total, best;
+        best.redraw = best.query = best.paint = best.composite =
+                std::numeric_limits<double>::max();
+
+        for( int r = 0; r < repeats; ++r )
+        {
+            PHASE_TIMES frame = renderFrame( view, gal, background );
+
+            total.redraw += frame.redraw;
+            total.query += frame.query;
+            total.paint += frame.paint;
+            total.composite += frame.composite;
+            total.items = frame.items;
+            best.redraw = std::min( best.redraw, frame.redraw );
+            best.query = std::min( best.query, frame.query );
+            best.paint = std::min( best.paint, frame.paint );
+            best.composite = std::min( best.composite, frame.composite );
+        }
+
+        printf( "zoom %g: %u items, redraw %.2f ms (min %.2f), query %.2f ms (min %.2f), "
+                "paint %.2f ms (min %.2f), composite %.2f ms (min %.2f)\n", zooms[i],
+                total.items, total.redraw / repeats, best.redraw, total.query / repeats,
+                best.query, total.paint / repeats, best.paint, total.composite / repeats,
+                best.composite );
+
+        if( !prefix.empty() )
+        {
+            char fileName[64];
+            snprintf( fileName, sizeof( fileName ), "_zoom%g.png", zooms[i] );
+
+            if( !gal.SaveImage( prefix + fileName ) )
+                fprintf( stderr, "Could not save %s%s\n", prefix.c_str(), fileName );
+        }
+    }
+
+    view.Clear();
+
+    return 0;
+}
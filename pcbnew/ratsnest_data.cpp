@@ -49,6 +49,8 @@ using namespace std::placeholders;
 #include <algorithm>
 #include <limits>
 
+#include <frame_profiler.h>
+
 #ifdef PROFILE
 #include <profile.h>
 #endif
@@ -859,6 +861,8 @@ void RN_NET::GetConnectedItems( const BOARD_CONNECTED_ITEM* aItem,
 
 void RN_DATA::AddSimple( const BOARD_ITEM* aItem )
 {
+    ++m_revision;
+
     if( aItem->IsConnected() )
     {
         const BOARD_CONNECTED_ITEM* item = static_cast<const BOARD_CONNECTED_ITEM*>( aItem );
@@ -882,6 +886,8 @@ void RN_DATA::AddSimple( const BOARD_ITEM* aItem )
 
 void RN_DATA::AddBlocked( const BOARD_ITEM* aItem )
 {
+    ++m_revision;
+
     if( aItem->IsConnected() )
     {
         const BOARD_CONNECTED_ITEM* item = static_cast<const BOARD_CONNECTED_ITEM*>( aItem );
@@ -1061,6 +1067,7 @@ void RN_NET::processPads()
 bool RN_DATA::Add( const BOARD_ITEM* aItem )
 {
     int net = NETINFO_LIST::ORPHANED;
+    ++m_revision;
 
     if( aItem->IsConnected() )
     {
@@ -1133,6 +1140,7 @@ bool RN_DATA::Add( const BOARD_ITEM* aItem )
 bool RN_DATA::Remove( const BOARD_ITEM* aItem )
 {
     int net = NETINFO_LIST::ORPHANED;
+    ++m_revision;
 
     if( aItem->IsConnected() )
     {
@@ -1213,6 +1221,7 @@ bool RN_DATA::Update( const BOARD_ITEM* aItem )
 void RN_DATA::ProcessBoard()
 {
     int netCount = m_board->GetNetCount();
+    ++m_revision;
     m_nets.clear();
     m_nets.resize( netCount );
     int netCode;
@@ -1264,7 +1273,9 @@ void RN_DATA::ProcessBoard()
 
 void RN_DATA::Recalculate( int aNet )
 {
+    FRAME_PROFILER_SCOPE profilerScope( FRAME_PROFILER::RATSNEST );
     unsigned int netCount = m_board->GetNetCount();
+    ++m_revision;
 
     if( aNet <= 0 && netCount > 1 )              // Recompute everything
     {
@@ -466,6 +466,16 @@ public:
      */
     std::list<RN_NODE_PTR> GetNodes( const BOARD_CONNECTED_ITEM* aItem ) const;
 
+    /**
+     * Function GetAllNodes()
+     * Returns all nodes of the net.
+     * @return Set of nodes that belong to the net.
+     */
+    const RN_LINKS::RN_NODE_SET& GetAllNodes() const
+    {
+        return m_links.GetNodes();
+    }
+
     /**
      * Function GetAllItems()
      * Adds all stored items to a list.
@@ -655,7 +665,7 @@ public:
      * Default constructor
      * @param aBoard is the board to be processed in order to look for unconnected items.
      */
-    RN_DATA( const BOARD* aBoard ) : m_board( aBoard ) {}
+    RN_DATA( const BOARD* aBoard ) : m_board( aBoard ), m_revision( 0 ) {}
 
     /**
      * Function Add()
@@ -706,6 +716,8 @@ public:
     {
         for( RN_NET& net : m_nets )
             net.ClearSimple();
+
+        ++m_revision;
     }
 
     /**
@@ -782,6 +794,17 @@ public:
      */
     int GetUnconnectedCount() const;
 
+    /**
+     * Function GetRevision()
+     * Returns a number that changes every time the ratsnest data is modified, so the ratsnest
+     * display may be refreshed only when it is necessary.
+     * @return Revision number of the ratsnest data.
+     */
+    unsigned int GetRevision() const
+    {
+        return m_revision;
+    }
+
 protected:
     /**
      * Function updateNet()
@@ -795,6 +818,9 @@ protected:
 
     ///> Stores information about ratsnest grouped by net numbers.
     std::vector<RN_NET> m_nets;
+
+    ///> Modification counter, see GetRevision().
+    unsigned int m_revision;
 };
 
 #endif /* RATSNEST_DATA_H */
@@ -34,12 +34,26 @@
 #include <layers_id_colors_and_visibility.h>
 
 #include <view/view.h>
+#include <frame_profiler.h>
+
+#include <chrono>
+#include <limits>
+#include <memory>
 
 namespace KIGFX {
 
 RATSNEST_VIEWITEM::RATSNEST_VIEWITEM( RN_DATA* aData ) :
-        EDA_ITEM( NOT_USED ), m_data( aData )
+        EDA_ITEM( NOT_USED ), m_data( aData ), m_valid( false ), m_revision( 0 ),
+        m_dynamicPending( false ), m_dynamicGeneration( 0 ), m_jobGeneration( 0 )
+{
+}
+
+
+RATSNEST_VIEWITEM::~RATSNEST_VIEWITEM()
 {
+    // The job does not access ratsnest data, but it has to finish before the callback is gone
+    if( m_dynamicThread.joinable() )
+        m_dynamicThread.join();
 }
 
 
@@ -55,6 +69,17 @@ const BOX2I RATSNEST_VIEWITEM::ViewBBox() const
 
 void RATSNEST_VIEWITEM::ViewDraw( int aLayer, KIGFX::VIEW* aView ) const
 {
+    FRAME_PROFILER_SCOPE profilerScope( FRAME_PROFILER::RATSNEST );
+
+    if( !m_valid || m_revision != m_data->GetRevision() )
+    {
+        m_revision = m_data->GetRevision();
+        m_valid = true;
+        update();
+    }
+
+    collectDynamicJob();
+
     auto gal = aView->GetGAL();
     gal->SetIsStroke( true );
     gal->SetIsFill( false );
@@ -62,62 +87,207 @@ void RATSNEST_VIEWITEM::ViewDraw( int aLayer, KIGFX::VIEW* aView ) const
     auto rs = aView->GetPainter()->GetSettings();
     auto color = rs->GetColor( NULL, ITEM_GAL_LAYER( RATSNEST_VISIBLE ) );
     int highlightedNet = rs->GetHighlightNetCode();
+    int netCount = m_data->GetNetCount();
+
+    // Draw the "dynamic" ratsnest (i.e. for objects that may be currently being moved),
+    // using brighter color for the temporary ratsnest
+    gal->SetStrokeColor( color.Brightened( 0.8 ) );
+
+    for( size_t i = 0; i < m_dynamicLines.m_nets.size(); ++i )
+    {
+        int netCode = m_dynamicLines.m_nets[i].first;
+
+        // The lines might have been computed before the nets were modified
+        if( netCode < netCount && m_data->GetNet( netCode ).IsVisible() )
+            drawLines( gal, m_dynamicLines, i );
+    }
+
+    // Draw the "static" ratsnest
+    for( size_t i = 0; i < m_staticLines.m_nets.size(); ++i )
+    {
+        int netCode = m_staticLines.m_nets[i].first;
+
+        if( !m_data->GetNet( netCode ).IsVisible() )
+            continue;
+
+        // Using the default ratsnest color for not highlighted nets
+        gal->SetStrokeColor( netCode == highlightedNet ? color.Brightened( 0.8 ) : color );
+        drawLines( gal, m_staticLines, i );
+    }
+}
+
+
+void RATSNEST_VIEWITEM::ViewGetLayers( int aLayers[], int& aCount ) const
+{
+    aCount = 1;
+    aLayers[0] = ITEM_GAL_LAYER( RATSNEST_VISIBLE );
+}
+
+
+void RATSNEST_VIEWITEM::update() const
+{
+    m_staticLines.m_points.clear();
+    m_staticLines.m_nets.clear();
+    m_dynamicInput.clear();
 
-    // Dynamic ratsnest (for e.g. dragged items)
     for( int i = 1; i < m_data->GetNetCount(); ++i )
     {
         RN_NET& net = m_data->GetNet( i );
+        const std::vector<RN_EDGE_MST_PTR>* edges = net.GetUnconnected();
 
-        if( !net.IsVisible() )
-            continue;
+        if( edges && !edges->empty() )
+        {
+            m_staticLines.m_nets.push_back( std::make_pair( i, m_staticLines.m_points.size() ) );
+
+            for( const RN_EDGE_MST_PTR& edge : *edges )
+            {
+                const RN_NODE_PTR& sourceNode = edge->GetSourceNode();
+                const RN_NODE_PTR& targetNode = edge->GetTargetNode();
+
+                m_staticLines.m_points.push_back( VECTOR2D( sourceNode->GetX(),
+                                                            sourceNode->GetY() ) );
+                m_staticLines.m_points.push_back( VECTOR2D( targetNode->GetX(),
+                                                            targetNode->GetY() ) );
+            }
+        }
 
-        // Set brighter color for the temporary ratsnest
-        gal->SetStrokeColor( color.Brightened( 0.8 ) );
+        // Copy the nodes needed to compute the dynamic ratsnest, so it can be done in background
+        DYNAMIC_NET dynamicNet;
+        dynamicNet.m_netCode = i;
 
-        // Draw the "dynamic" ratsnest (i.e. for objects that may be currently being moved)
         for( const RN_NODE_PTR& node : net.GetSimpleNodes() )
         {
             // Skipping nodes with higher reference count avoids displaying redundant lines
-            if( node->GetRefCount() > 1 )
-                continue;
+            if( node->GetRefCount() <= 1 )
+                dynamicNet.m_sources.push_back( VECTOR2I( node->GetX(), node->GetY() ) );
+        }
+
+        if( dynamicNet.m_sources.empty() )
+            continue;
+
+        for( const RN_NODE_PTR& node : net.GetAllNodes() )
+        {
+            if( LINE_TARGET()( node ) )
+                dynamicNet.m_targets.push_back( VECTOR2I( node->GetX(), node->GetY() ) );
+        }
+
+        m_dynamicInput.push_back( dynamicNet );
+    }
+
+    if( m_dynamicInput.empty() )
+    {
+        // Nothing is moved, so the results of a job that is still running are not needed
+        m_dynamicLines.m_points.clear();
+        m_dynamicLines.m_nets.clear();
+        m_dynamicPending = false;
+        ++m_dynamicGeneration;
+    }
+    else
+    {
+        m_dynamicPending = true;
+        startDynamicJob();
+    }
+}
 
-            RN_NODE_PTR dest = net.GetClosestNode( node, LINE_TARGET() );
 
-            if( dest )
+void RATSNEST_VIEWITEM::startDynamicJob() const
+{
+    // If there is a job running, the new one is started when it is finished.
+    // Only the most recent input is kept, the intermediate states are not interesting.
+    if( !m_dynamicPending || m_dynamicThread.joinable() )
+        return;
+
+    auto input = std::make_shared<std::vector<DYNAMIC_NET> >();
+    input->swap( m_dynamicInput );
+
+    std::packaged_task<LINES()> task( [input]() { return computeDynamicLines( *input ); } );
+    std::function<void()> callback = m_updateCallback;
+
+    m_dynamicJob = task.get_future();
+    m_jobGeneration = m_dynamicGeneration;
+    m_dynamicPending = false;
+
+    m_dynamicThread = std::thread( [callback]( std::packaged_task<LINES()> aTask )
             {
-                VECTOR2D origin( node->GetX(), node->GetY() );
-                VECTOR2D end( dest->GetX(), dest->GetY() );
+                aTask();
 
-                gal->DrawLine( origin, end );
-            }
-        }
+                if( callback )
+                    callback();
+            }, std::move( task ) );
+}
 
-        // Draw the "static" ratsnest
-        if( i != highlightedNet )
-            gal->SetStrokeColor( color );  // using the default ratsnest color for not highlighted
 
-        const std::vector<RN_EDGE_MST_PTR>* edges = net.GetUnconnected();
+void RATSNEST_VIEWITEM::collectDynamicJob() const
+{
+    if( !m_dynamicJob.valid()
+            || m_dynamicJob.wait_for( std::chrono::seconds( 0 ) ) != std::future_status::ready )
+        return;
 
-        if( edges == NULL )
-            continue;
+    LINES lines = m_dynamicJob.get();
+    m_dynamicThread.join();
 
-        for( const RN_EDGE_MST_PTR& edge : *edges )
+    if( m_jobGeneration == m_dynamicGeneration )
+        m_dynamicLines = std::move( lines );
+
+    startDynamicJob();
+}
+
+
+RATSNEST_VIEWITEM::LINES RATSNEST_VIEWITEM::computeDynamicLines(
+        const std::vector<DYNAMIC_NET>& aNets )
+{
+    LINES lines;
+
+    for( const DYNAMIC_NET& net : aNets )
+    {
+        size_t first = lines.m_points.size();
+
+        for( const VECTOR2I& source : net.m_sources )
         {
-            const RN_NODE_PTR& sourceNode = edge->GetSourceNode();
-            const RN_NODE_PTR& targetNode = edge->GetTargetNode();
-            VECTOR2D source( sourceNode->GetX(), sourceNode->GetY() );
-            VECTOR2D target( targetNode->GetX(), targetNode->GetY() );
+            // The same metric as in RN_NET::GetClosestNode(), so the chosen nodes do not change
+            unsigned int minDistance = std::numeric_limits<unsigned int>::max();
+            const VECTOR2I* closest = NULL;
+
+            for( const VECTOR2I& target : net.m_targets )
+            {
+                if( target == source )
+                    continue;
+
+                // Drop the least significant bits to avoid overflow
+                int64_t x = ( target.x - source.x ) >> 16;
+                int64_t y = ( target.y - source.y ) >> 16;
+                unsigned int distance = x * x + y * y;
 
-            gal->DrawLine( source, target );
+                if( distance < minDistance )
+                {
+                    minDistance = distance;
+                    closest = &target;
+                }
+            }
+
+            if( closest )
+            {
+                lines.m_points.push_back( VECTOR2D( source ) );
+                lines.m_points.push_back( VECTOR2D( *closest ) );
+            }
         }
+
+        if( lines.m_points.size() > first )
+            lines.m_nets.push_back( std::make_pair( net.m_netCode, first ) );
     }
+
+    return lines;
 }
 
 
-void RATSNEST_VIEWITEM::ViewGetLayers( int aLayers[], int& aCount ) const
+void RATSNEST_VIEWITEM::drawLines( GAL* aGal, const LINES& aLines, size_t aIndex )
 {
-    aCount = 1;
-    aLayers[0] = ITEM_GAL_LAYER( RATSNEST_VISIBLE );
+    size_t begin = aLines.m_nets[aIndex].second;
+    size_t end = ( aIndex + 1 < aLines.m_nets.size() ) ? aLines.m_nets[aIndex + 1].second
+                                                       : aLines.m_points.size();
+
+    for( size_t i = begin; i + 1 < end; i += 2 )
+        aGal->DrawLine( aLines.m_points[i], aLines.m_points[i + 1] );
 }
 
 }
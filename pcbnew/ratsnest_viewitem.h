@@ -33,16 +33,44 @@
 #include <base_struct.h>
 #include <math/vector2d.h>
 
-class GAL;
+#include <functional>
+#include <future>
+#include <thread>
+#include <utility>
+#include <vector>
+
 class RN_DATA;
 
 namespace KIGFX
 {
+class GAL;
+
+/**
+ * Class RATSNEST_VIEWITEM
+ * draws the ratsnest (missing connections) of a board.
+ *
+ * Lines are not recomputed for every frame, they are cached and rebuilt only when the
+ * ratsnest data revision changes. The dynamic ratsnest (lines going from items that are being
+ * moved to the closest nodes) is computed in a background thread and swapped in once it is
+ * ready, so dragging items does not wait for it.
+ */
 class RATSNEST_VIEWITEM : public EDA_ITEM
 {
 public:
     RATSNEST_VIEWITEM( RN_DATA* aData );
 
+    ~RATSNEST_VIEWITEM();
+
+    /**
+     * Function SetUpdateCallback()
+     * Sets a function to be called when the dynamic ratsnest computed in the background is
+     * ready to be displayed. The function is called from the worker thread.
+     */
+    void SetUpdateCallback( std::function<void()> aCallback )
+    {
+        m_updateCallback = aCallback;
+    }
+
     /// @copydoc VIEW_ITEM::ViewBBox()
     const BOX2I ViewBBox() const override;
 
@@ -68,8 +96,79 @@ public:
     }
 
 protected:
+    ///> Precomputed ratsnest lines, grouped by nets.
+    struct LINES
+    {
+        ///> Line end points, every two consecutive points make a line.
+        std::vector<VECTOR2D> m_points;
+
+        ///> Net codes and indices of their first points, ordered by indices.
+        std::vector<std::pair<int, size_t> > m_nets;
+    };
+
+    ///> Dynamic ratsnest input for a single net, copied so it may be processed in background.
+    struct DYNAMIC_NET
+    {
+        int m_netCode;
+
+        ///> Nodes of the moved items.
+        std::vector<VECTOR2I> m_sources;
+
+        ///> Nodes that may be connected with the moved items.
+        std::vector<VECTOR2I> m_targets;
+    };
+
+    ///> Rebuilds the cached lines after the ratsnest data has changed.
+    void update() const;
+
+    ///> Starts computing the dynamic ratsnest in background, unless there is a job running.
+    void startDynamicJob() const;
+
+    ///> Takes the dynamic ratsnest computed in background, if there is any ready.
+    void collectDynamicJob() const;
+
+    ///> Finds the closest target for every source node.
+    static LINES computeDynamicLines( const std::vector<DYNAMIC_NET>& aNets );
+
+    ///> Draws cached lines of a net.
+    static void drawLines( GAL* aGal, const LINES& aLines, size_t aIndex );
+
     ///> Object containing ratsnest data.
     RN_DATA* m_data;
+
+    ///> Are the cached lines valid for m_revision?
+    mutable bool m_valid;
+
+    ///> Ratsnest data revision the cached lines were built for.
+    mutable unsigned int m_revision;
+
+    ///> Lines connecting disjoint parts of nets.
+    mutable LINES m_staticLines;
+
+    ///> Lines going from moved items to the closest nodes.
+    mutable LINES m_dynamicLines;
+
+    ///> Input for the next dynamic ratsnest job.
+    mutable std::vector<DYNAMIC_NET> m_dynamicInput;
+
+    ///> Is m_dynamicInput waiting for a job to be started?
+    mutable bool m_dynamicPending;
+
+    ///> Incremented when the dynamic ratsnest is not needed anymore, so the results of a job
+    ///> started earlier are dropped.
+    mutable unsigned int m_dynamicGeneration;
+
+    ///> Value of m_dynamicGeneration when the current job was started.
+    mutable unsigned int m_jobGeneration;
+
+    ///> Dynamic ratsnest being computed in background.
+    mutable std::future<LINES> m_dynamicJob;
+
+    ///> Thread computing the dynamic ratsnest.
+    mutable std::thread m_dynamicThread;
+
+    ///> Function called when a background job is finished.
+    std::function<void()> m_updateCallback;
 };
 
 }   // namespace KIGFX
@@ -0,0 +1,225 @@
+/*
+ * KiRouter - a push-and-(sometimes-)shove PCB router
+ *
+ * Copyright (C) 2017 CERN
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifdef USE_OPENMP
+#include <omp.h>
+#endif /* USE_OPENMP */
+
+#include <algorithm>
+#include <set>
+
+#include "pns_batch_optimizer.h"
+#include "pns_router.h"
+#include "pns_node.h"
+#include "pns_segment.h"
+#include "pns_optimizer.h"
+
+namespace PNS {
+
+BATCH_OPTIMIZER::BATCH_OPTIMIZER( ROUTER* aRouter ) :
+    ALGO_BASE( aRouter )
+{
+    SetDebugDecorator( NULL );
+
+    m_effortLevel = OPTIMIZER::MERGE_SEGMENTS | OPTIMIZER::MERGE_OBTUSE;
+    m_stats = STATS();
+}
+
+
+BATCH_OPTIMIZER::~BATCH_OPTIMIZER()
+{
+}
+
+
+void BATCH_OPTIMIZER::AddNet( int aNet )
+{
+    m_nets.push_back( aNet );
+}
+
+
+int BATCH_OPTIMIZER::cornerCount( const LINE& aLine )
+{
+    return std::max( 0, aLine.CLine().PointCount() - 2 );
+}
+
+
+void BATCH_OPTIMIZER::assembleLines( NODE* aWorld, JOB& aJob )
+{
+    std::set<ITEM*> netItems;
+    std::vector<SEGMENT*> segs;
+
+    aWorld->AllItemsInNet( aJob.m_net, netItems );
+
+    for( ITEM* item : netItems )
+    {
+        if( item->OfKind( ITEM::SEGMENT_T ) )
+            segs.push_back( static_cast<SEGMENT*>( item ) );
+    }
+
+    // Process the segments in a stable order, so that the results do not depend
+    // on memory layout
+    std::sort( segs.begin(), segs.end(), []( const SEGMENT* a, const SEGMENT* b ) {
+        const SEG& sa = a->Seg();
+        const SEG& sb = b->Seg();
+
+        if( sa.A != sb.A )
+            return sa.A.x < sb.A.x || ( sa.A.x == sb.A.x && sa.A.y < sb.A.y );
+
+        if( sa.B != sb.B )
+            return sa.B.x < sb.B.x || ( sa.B.x == sb.B.x && sa.B.y < sb.B.y );
+
+        return a->Layer() < b->Layer();
+    } );
+
+    std::set<SEGMENT*> visited;
+
+    for( SEGMENT* seg : segs )
+    {
+        if( visited.count( seg ) )
+            continue;
+
+        LINE line = aWorld->AssembleLine( seg );
+        bool locked = false;
+
+        for( SEGMENT* s : line.LinkedSegments() )
+        {
+            visited.insert( s );
+            locked |= s->IsLocked();
+        }
+
+        if( !locked && line.SegmentCount() > 0 )
+            aJob.m_lines.push_back( line );
+    }
+}
+
+
+void BATCH_OPTIMIZER::optimizeJob( NODE* aWorld, JOB& aJob ) const
+{
+    OPTIMIZER optimizer( aWorld );
+
+    optimizer.SetEffortLevel( m_effortLevel );
+    optimizer.SetCollisionMask( -1 );
+
+    for( const LINE& orig : aJob.m_lines )
+    {
+        LINE opt( orig );
+        bool improved = false;
+
+        if( optimizer.Optimize( &opt ) )
+        {
+            const SHAPE_LINE_CHAIN& a = orig.CLine();
+            const SHAPE_LINE_CHAIN& b = opt.CLine();
+
+            int lenA = a.Length(), lenB = b.Length();
+            int cornersA = cornerCount( orig ), cornersB = cornerCount( opt );
+
+            // The optimizer keeps the ends of the line, but better safe than sorry:
+            // a moved end would disconnect the track.
+            improved = a.CPoint( 0 ) == b.CPoint( 0 ) && a.CPoint( -1 ) == b.CPoint( -1 )
+                    && lenB <= lenA && cornersB <= cornersA
+                    && ( lenB < lenA || cornersB < cornersA );
+        }
+
+        aJob.m_results.push_back( opt );
+        aJob.m_improved.push_back( improved );
+    }
+}
+
+
+int BATCH_OPTIMIZER::Run()
+{
+    NODE* world = Router()->GetWorld();
+
+    m_stats = STATS();
+    m_jobs.clear();
+
+    world->KillChildren();
+
+    for( int net : m_nets )
+    {
+        JOB job;
+        job.m_net = net;
+
+        assembleLines( world, job );
+
+        if( !job.m_lines.empty() )
+            m_jobs.push_back( job );
+    }
+
+    int jobCount = m_jobs.size();
+    int i;
+
+    // The world is not modified until all nets are done, so the optimizers
+    // can query it concurrently.
+#ifdef USE_OPENMP
+    #pragma omp parallel for schedule(dynamic, 1) private(i)
+#endif /* USE_OPENMP */
+    for( i = 0; i < jobCount; i++ )
+        optimizeJob( world, m_jobs[i] );
+
+    NODE* commitNode = world->Branch();
+    int modified = 0;
+
+    for( JOB& job : m_jobs )
+    {
+        for( int j = 0; j < (int) job.m_lines.size(); j++ )
+        {
+            LINE& orig = job.m_lines[j];
+            const LINE* result = &orig;
+
+            m_stats.m_lineCount++;
+            m_stats.m_lengthBefore += orig.CLine().Length();
+            m_stats.m_cornersBefore += cornerCount( orig );
+
+            if( job.m_improved[j] )
+            {
+                LINE newLine( orig, job.m_results[j].CLine() );
+
+                // Lines of other nets optimized at the same time are not in the snapshot
+                if( commitNode->CheckColliding( &newLine ) )
+                {
+                    m_stats.m_conflictCount++;
+                }
+                else
+                {
+                    commitNode->Remove( orig );
+                    commitNode->Add( newLine );
+                    result = &job.m_results[j];
+
+                    m_stats.m_optimizedCount++;
+                    modified++;
+                }
+            }
+
+            m_stats.m_lengthAfter += result->CLine().Length();
+            m_stats.m_cornersAfter += cornerCount( *result );
+        }
+    }
+
+    if( modified )
+        Router()->CommitRouting( commitNode );
+    else
+        world->KillChildren();
+
+    return modified;
+}
+
+}
@@ -0,0 +1,122 @@
+/*
+ * KiRouter - a push-and-(sometimes-)shove PCB router
+ *
+ * Copyright (C) 2017 CERN
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef __PNS_BATCH_OPTIMIZER_H
+#define __PNS_BATCH_OPTIMIZER_H
+
+#include <cstdint>
+#include <vector>
+
+#include "pns_algo_base.h"
+#include "pns_line.h"
+
+namespace PNS {
+
+class ROUTER;
+class NODE;
+
+/**
+ * Class BATCH_OPTIMIZER
+ *
+ * Runs the OPTIMIZER over every track of a set of nets. The tracks are assembled into
+ * LINEs and optimized net by net in parallel, against a snapshot of the world that is
+ * not modified until all nets are done. The results are then checked against each other
+ * (two nets optimized concurrently might have moved into each other) and committed
+ * in a single step.
+ */
+class BATCH_OPTIMIZER : public ALGO_BASE
+{
+public:
+    struct STATS
+    {
+        ///> number of lines found in the processed nets
+        int m_lineCount;
+
+        ///> number of lines that have been improved and committed
+        int m_optimizedCount;
+
+        ///> number of improved lines discarded due to a collision with another improved line
+        int m_conflictCount;
+
+        ///> total length and corner count of the processed lines, before and after
+        int64_t m_lengthBefore;
+        int64_t m_lengthAfter;
+        int m_cornersBefore;
+        int m_cornersAfter;
+    };
+
+    BATCH_OPTIMIZER( ROUTER* aRouter );
+    ~BATCH_OPTIMIZER();
+
+    /**
+     * Function AddNet()
+     *
+     * Queues all tracks of the net aNet for optimization.
+     */
+    void AddNet( int aNet );
+
+    /**
+     * Function SetEffortLevel()
+     *
+     * Sets the OPTIMIZER effort flags (OPTIMIZER::OptimizationEffort) used for every line.
+     */
+    void SetEffortLevel( int aEffort )
+    {
+        m_effortLevel = aEffort;
+    }
+
+    /**
+     * Function Run()
+     *
+     * Optimizes the queued nets and commits the improved lines through the router.
+     * @return the number of lines that have been modified.
+     */
+    int Run();
+
+    const STATS& Stats() const
+    {
+        return m_stats;
+    }
+
+private:
+    ///> The lines of a single net and their optimized versions
+    struct JOB
+    {
+        int m_net;
+        std::vector<LINE> m_lines;
+        std::vector<LINE> m_results;
+        std::vector<bool> m_improved;
+    };
+
+    void assembleLines( NODE* aWorld, JOB& aJob );
+    void optimizeJob( NODE* aWorld, JOB& aJob ) const;
+
+    static int cornerCount( const LINE& aLine );
+
+    std::vector<int> m_nets;
+    std::vector<JOB> m_jobs;
+    int m_effortLevel;
+    STATS m_stats;
+};
+
+}
+
+#endif
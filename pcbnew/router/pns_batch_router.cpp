@@ -0,0 +1,333 @@
+/*
+ * KiRouter - a push-and-(sometimes-)shove PCB router
+ *
+ * Copyright (C) 2017 CERN
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef USE_OPENMP
+#include <omp.h>
+#endif /* USE_OPENMP */
+
+#include <algorithm>
+#include <map>
+
+#include <wx/intl.h>
+
+#include "pns_batch_router.h"
+#include "pns_router.h"
+#include "pns_node.h"
+#include "pns_line.h"
+#include "pns_segment.h"
+#include "pns_walkaround.h"
+#include "pns_optimizer.h"
+#include "pns_utils.h"
+
+namespace PNS {
+
+BATCH_ROUTER::BATCH_ROUTER( ROUTER* aRouter ) :
+    ALGO_BASE( aRouter )
+{
+    SetDebugDecorator( NULL );
+}
+
+
+BATCH_ROUTER::~BATCH_ROUTER()
+{
+}
+
+
+void BATCH_ROUTER::AddConnection( ITEM* aStartItem, const VECTOR2I& aStart,
+                                  ITEM* aEndItem, const VECTOR2I& aEnd, int aWidth )
+{
+    CONNECTION conn;
+
+    conn.m_start = aStart;
+    conn.m_end = aEnd;
+    conn.m_startItem = aStartItem;
+    conn.m_endItem = aEndItem;
+    conn.m_net = aStartItem ? aStartItem->Net() : -1;
+    conn.m_width = aWidth;
+    conn.m_routed = false;
+    conn.m_layer = -1;
+
+    m_connections.push_back( conn );
+}
+
+
+void BATCH_ROUTER::buildJobs()
+{
+    std::map<int, int> netToJob;
+
+    m_jobs.clear();
+
+    for( int i = 0; i < (int) m_connections.size(); i++ )
+    {
+        const CONNECTION& conn = m_connections[i];
+        auto j = netToJob.find( conn.m_net );
+
+        if( j == netToJob.end() )
+        {
+            JOB job;
+            job.m_net = conn.m_net;
+            job.m_bbox = BOX2I( conn.m_start, VECTOR2I( 0, 0 ) );
+            job.m_node = NULL;
+
+            j = netToJob.insert( std::make_pair( conn.m_net, (int) m_jobs.size() ) ).first;
+            m_jobs.push_back( job );
+        }
+
+        JOB& job = m_jobs[j->second];
+
+        job.m_connections.push_back( i );
+        job.m_bbox.Merge( conn.m_start );
+        job.m_bbox.Merge( conn.m_end );
+    }
+
+    // The walkaround may leave the straight-line bounding box of a connection. Reserve
+    // some room around it, so that nets routed concurrently are unlikely to interfere
+    // (conflicts are still caught when committing the results).
+    for( JOB& job : m_jobs )
+    {
+        int margin = std::max( job.m_bbox.GetWidth(), job.m_bbox.GetHeight() ) / 2;
+
+        for( int idx : job.m_connections )
+            margin = std::max( margin, 4 * m_connections[idx].m_width );
+
+        job.m_bbox.Inflate( margin );
+    }
+}
+
+
+void BATCH_ROUTER::scheduleWaves( std::vector< std::vector<int> >& aWaves ) const
+{
+    std::vector<int> order( m_jobs.size() );
+
+    for( int i = 0; i < (int) m_jobs.size(); i++ )
+        order[i] = i;
+
+    // Place the largest nets first, they are the most likely to conflict with others
+    std::sort( order.begin(), order.end(), [this]( int a, int b ) {
+        return m_jobs[a].m_bbox.GetArea() > m_jobs[b].m_bbox.GetArea();
+    } );
+
+    aWaves.clear();
+
+    for( int jobIdx : order )
+    {
+        const BOX2I& bbox = m_jobs[jobIdx].m_bbox;
+        bool placed = false;
+
+        for( std::vector<int>& wave : aWaves )
+        {
+            bool overlaps = false;
+
+            for( int other : wave )
+            {
+                if( m_jobs[other].m_bbox.Intersects( bbox ) )
+                {
+                    overlaps = true;
+                    break;
+                }
+            }
+
+            if( !overlaps )
+            {
+                wave.push_back( jobIdx );
+                placed = true;
+                break;
+            }
+        }
+
+        if( !placed )
+            aWaves.push_back( std::vector<int>( 1, jobIdx ) );
+    }
+}
+
+
+bool BATCH_ROUTER::routeOnLayer( NODE* aNode, CONNECTION& aConn, int aLayer,
+                                 bool aStartDiagonal )
+{
+    LINE initTrack;
+
+    initTrack.SetNet( aConn.m_net );
+    initTrack.SetWidth( aConn.m_width );
+    initTrack.SetLayer( aLayer );
+    initTrack.SetShape( DIRECTION_45().BuildInitialTrace( aConn.m_start, aConn.m_end,
+                                                          aStartDiagonal ) );
+
+    LINE walkFull;
+    WALKAROUND walkaround( aNode, Router() );
+
+    walkaround.SetSolidsOnly( false );
+    walkaround.SetIterationLimit( Settings().WalkaroundIterationLimit() );
+
+    if( walkaround.Route( initTrack, walkFull, false ) != WALKAROUND::DONE )
+        return false;
+
+    int effort = OPTIMIZER::MERGE_SEGMENTS;
+
+    if( Settings().SmartPads() )
+        effort |= OPTIMIZER::SMART_PADS;
+
+    OPTIMIZER::Optimize( &walkFull, effort, aNode );
+
+    if( walkFull.CPoint( 0 ) != aConn.m_start || walkFull.CPoint( -1 ) != aConn.m_end )
+        return false;
+
+    if( !walkFull.Is45Degree() || aNode->CheckColliding( &walkFull ) )
+        return false;
+
+    aConn.m_path = walkFull.CLine();
+    aConn.m_layer = aLayer;
+
+    return true;
+}
+
+
+bool BATCH_ROUTER::routeConnection( NODE* aNode, CONNECTION& aConn )
+{
+    if( !aConn.m_startItem || !aConn.m_endItem )
+    {
+        aConn.m_failureReason = _( "Missing start or end item" );
+        return false;
+    }
+
+    const LAYER_RANGE& ls = aConn.m_startItem->Layers();
+    const LAYER_RANGE& le = aConn.m_endItem->Layers();
+
+    if( !ls.Overlaps( le ) )
+    {
+        aConn.m_failureReason = _( "No common copper layer (vias are not placed in batch mode)" );
+        return false;
+    }
+
+    int first = std::max( ls.Start(), le.Start() );
+    int last = std::min( ls.End(), le.End() );
+
+    // Try every common layer with both postures of the initial trace
+    for( int layer = first; layer <= last; layer++ )
+    {
+        if( routeOnLayer( aNode, aConn, layer, false ) || routeOnLayer( aNode, aConn, layer, true ) )
+        {
+            // Make the trace visible to the following connections of the same net
+            commitConnection( aNode, aConn );
+            return true;
+        }
+    }
+
+    aConn.m_failureReason = _( "Walkaround failed" );
+    return false;
+}
+
+
+bool BATCH_ROUTER::commitConnection( NODE* aNode, CONNECTION& aConn )
+{
+    LINE l;
+
+    l.SetNet( aConn.m_net );
+    l.SetWidth( aConn.m_width );
+    l.SetLayer( aConn.m_layer );
+    l.SetShape( aConn.m_path );
+
+    if( aNode->CheckColliding( &l ) )
+        return false;
+
+    for( int i = 0; i < l.SegmentCount(); i++ )
+    {
+        std::unique_ptr< SEGMENT > seg( new SEGMENT( l.CSegment( i ), aConn.m_net ) );
+        seg->SetWidth( aConn.m_width );
+        seg->SetLayer( aConn.m_layer );
+        aNode->Add( std::move( seg ) );
+    }
+
+    return true;
+}
+
+
+int BATCH_ROUTER::Run()
+{
+    NODE* world = Router()->GetWorld();
+    std::vector< std::vector<int> > waves;
+    int routed = 0;
+
+    buildJobs();
+    scheduleWaves( waves );
+
+    world->KillChildren();
+    NODE* commitNode = world->Branch();
+
+    for( const std::vector<int>& wave : waves )
+    {
+        // Branching modifies the parent node, so it has to be done before going parallel.
+        for( int jobIdx : wave )
+            m_jobs[jobIdx].m_node = commitNode->Branch();
+
+        int waveSize = wave.size();
+        int i;
+
+#ifdef USE_OPENMP
+        #pragma omp parallel for schedule(dynamic, 1) private(i)
+#endif /* USE_OPENMP */
+        for( i = 0; i < waveSize; i++ )
+        {
+            JOB& job = m_jobs[wave[i]];
+
+            for( int connIdx : job.m_connections )
+                routeConnection( job.m_node, m_connections[connIdx] );
+        }
+
+        for( int jobIdx : wave )
+        {
+            delete m_jobs[jobIdx].m_node;
+            m_jobs[jobIdx].m_node = NULL;
+        }
+
+        // Merge the results. The nets in a wave were routed independently, so check every
+        // trace against the already merged ones and reroute it in place in case of a conflict.
+        for( int jobIdx : wave )
+        {
+            for( int connIdx : m_jobs[jobIdx].m_connections )
+            {
+                CONNECTION& conn = m_connections[connIdx];
+
+                if( conn.m_layer < 0 )
+                    continue;
+
+                if( commitConnection( commitNode, conn ) || routeConnection( commitNode, conn ) )
+                {
+                    conn.m_routed = true;
+                    routed++;
+                }
+                else
+                {
+                    conn.m_layer = -1;
+                    conn.m_path.Clear();
+                    conn.m_failureReason = _( "Conflicts with another routed net" );
+                }
+            }
+        }
+    }
+
+    if( routed )
+        Router()->CommitRouting( commitNode );
+    else
+        world->KillChildren();
+
+    return routed;
+}
+
+}
@@ -0,0 +1,122 @@
+/*
+ * KiRouter - a push-and-(sometimes-)shove PCB router
+ *
+ * Copyright (C) 2017 CERN
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __PNS_BATCH_ROUTER_H
+#define __PNS_BATCH_ROUTER_H
+
+#include <vector>
+
+#include <math/box2.h>
+#include <geometry/shape_line_chain.h>
+
+#include "pns_algo_base.h"
+#include "pns_layerset.h"
+
+namespace PNS {
+
+class ROUTER;
+class NODE;
+class ITEM;
+
+/**
+ * Class BATCH_ROUTER
+ *
+ * Routes a list of pad-to-pad connections (typically unconnected ratsnest edges) without
+ * user interaction, using the same walkaround + optimizer machinery as the interactive
+ * LINE_PLACER in walkaround mode. Connections are grouped by net, and nets whose
+ * bounding boxes do not overlap are routed concurrently, each in a private branch
+ * of the world. The results are then validated against each other and committed
+ * in a single step.
+ */
+class BATCH_ROUTER : public ALGO_BASE
+{
+public:
+    struct CONNECTION
+    {
+        VECTOR2I m_start;
+        VECTOR2I m_end;
+        ITEM* m_startItem;
+        ITEM* m_endItem;
+        int m_net;
+        int m_width;
+
+        ///> True if the connection has been routed and committed.
+        bool m_routed;
+
+        ///> Resulting trace and the layer it was routed on.
+        SHAPE_LINE_CHAIN m_path;
+        int m_layer;
+
+        ///> Reason of the failure, if the connection could not be routed.
+        wxString m_failureReason;
+    };
+
+    BATCH_ROUTER( ROUTER* aRouter );
+    ~BATCH_ROUTER();
+
+    /**
+     * Function AddConnection()
+     *
+     * Queues a connection between two items belonging to the router's world.
+     * @param aStartItem is the item the trace begins at (usually a SOLID)
+     * @param aStart is the starting point (anchor of aStartItem)
+     * @param aEndItem is the item the trace ends at
+     * @param aEnd is the ending point
+     * @param aWidth is the width of the track to be routed
+     */
+    void AddConnection( ITEM* aStartItem, const VECTOR2I& aStart,
+                        ITEM* aEndItem, const VECTOR2I& aEnd, int aWidth );
+
+    /**
+     * Function Run()
+     *
+     * Routes all queued connections and commits the successful ones through the router.
+     * @return the number of connections that have been routed.
+     */
+    int Run();
+
+    const std::vector<CONNECTION>& Connections() const
+    {
+        return m_connections;
+    }
+
+private:
+    ///> A set of connections belonging to a single net, routed in a private branch.
+    struct JOB
+    {
+        int m_net;
+        BOX2I m_bbox;
+        std::vector<int> m_connections;
+        NODE* m_node;
+    };
+
+    void buildJobs();
+    void scheduleWaves( std::vector< std::vector<int> >& aWaves ) const;
+    bool routeConnection( NODE* aNode, CONNECTION& aConn );
+    bool routeOnLayer( NODE* aNode, CONNECTION& aConn, int aLayer, bool aStartDiagonal );
+    bool commitConnection( NODE* aNode, CONNECTION& aConn );
+
+    std::vector<CONNECTION> m_connections;
+    std::vector<JOB> m_jobs;
+};
+
+}
+
+#endif
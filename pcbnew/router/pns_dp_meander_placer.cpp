@@ -123,23 +123,7 @@ void DP_MEANDER_PLACER::release()
 
 int DP_MEANDER_PLACER::origPathLength() const
 {
-    int totalP = 0;
-    int totalN = 0;
-
-    for( const ITEM* item : m_tunedPathP.CItems() )
-    {
-        if( const LINE* l = dyn_cast<const LINE*>( item ) )
-            totalP += l->CLine().Length();
-
-    }
-
-    for( const ITEM* item : m_tunedPathN.CItems() )
-    {
-        if( const LINE* l = dyn_cast<const LINE*>( item ) )
-            totalN += l->CLine().Length();
-    }
-
-    return std::max( totalP, totalN );
+    return std::max( netLength( m_originPair.NetP() ), netLength( m_originPair.NetN() ) );
 }
 
 
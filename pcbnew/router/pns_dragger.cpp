@@ -19,6 +19,10 @@
  * with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+
+#include <profile.h>
+
 #include "pns_dragger.h"
 #include "pns_shove.h"
 #include "pns_router.h"
@@ -37,6 +41,8 @@ DRAGGER::DRAGGER( ROUTER* aRouter ) :
     m_dragStatus = false;
     m_currentMode = RM_MarkObstacles;
     m_initialVia = NULL;
+    m_incrementalRange = 0;
+    m_stats = DRAG_STATS();
 }
 
 
@@ -57,6 +63,8 @@ bool DRAGGER::startDragSegment( const VECTOR2D& aP, SEGMENT* aSeg )
 {
     int w2 = aSeg->Width() / 2;
 
+    m_incrementalRange = 4 * aSeg->Width();
+
     m_draggedLine = m_world->AssembleLine( aSeg, &m_draggedSegmentIndex );
     m_shove->SetInitialLine( m_draggedLine );
     m_lastValidDraggedLine = m_draggedLine;
@@ -80,6 +88,7 @@ bool DRAGGER::startDragVia( const VECTOR2D& aP, VIA* aVia )
     m_draggedVia = aVia;
     m_initialVia = aVia;
     m_mode = DRAG_VIA;
+    m_incrementalRange = 4 * aVia->Diameter();
 
     VECTOR2I p0( aVia->Pos() );
     JOINT* jt = m_world->FindJoint( p0, aVia->Layers().Start(), aVia->Net() );
@@ -112,6 +121,8 @@ bool DRAGGER::Start( const VECTOR2I& aP, ITEM* aStartItem )
     m_lastNode = NULL;
     m_draggedItems.Clear();
     m_currentMode = Settings().Mode();
+    m_lastShovePos = OPT_VECTOR2I();
+    m_stats = DRAG_STATS();
 
     aStartItem->Unmark( MK_LOCKED );
 
@@ -217,15 +228,19 @@ void DRAGGER::dumbDragVia( VIA* aVia, NODE* aNode, const VECTOR2I& aP )
 }
 
 
-bool DRAGGER::dragShove( const VECTOR2I& aP )
+void DRAGGER::resetShove()
 {
-    bool ok = false;
+    m_shove->ClearSpringback();
 
-    if( m_lastNode )
-    {
-        delete m_lastNode;
-        m_lastNode = NULL;
-    }
+    // the via being dragged belonged to one of the discarded states
+    if( m_mode == DRAG_VIA )
+        m_draggedVia = m_initialVia;
+}
+
+
+bool DRAGGER::shoveTo( const VECTOR2I& aP )
+{
+    bool ok = false;
 
     switch( m_mode )
     {
@@ -250,17 +265,9 @@ bool DRAGGER::dragShove( const VECTOR2I& aP )
             ok = true;
         }
 
-        m_lastNode = m_shove->CurrentNode()->Branch();
-
         if( ok )
             m_lastValidDraggedLine = dragged;
 
-        m_lastValidDraggedLine.ClearSegmentLinks();
-        m_lastValidDraggedLine.Unmark();
-        m_lastNode->Add( m_lastValidDraggedLine );
-        m_draggedItems.Clear();
-        m_draggedItems.Add( m_lastValidDraggedLine );
-
         break;
     }
 
@@ -272,18 +279,85 @@ bool DRAGGER::dragShove( const VECTOR2I& aP )
         if( st == SHOVE::SH_OK || st == SHOVE::SH_HEAD_MODIFIED )
             ok = true;
 
-        m_lastNode = m_shove->CurrentNode()->Branch();
+        if( ok && newVia )
+            m_draggedVia = newVia;
+
+        break;
+    }
+    }
+
+    return ok;
+}
+
+
+bool DRAGGER::dragShove( const VECTOR2I& aP )
+{
+    // Limits the number of shove states chained on top of each other when dragging
+    // incrementally. Each state is a branch of the previous one, so a long chain
+    // makes branching and collision queries slower.
+    const int maxIncrementalDepth = 16;
+
+    if( m_lastNode )
+    {
+        delete m_lastNode;
+        m_lastNode = NULL;
+    }
+
+    // Shove starting from the result of the previous event if the cursor has not moved
+    // much since then, otherwise recompute everything from the initial state.
+    bool incremental = m_lastShovePos
+                       && ( aP - *m_lastShovePos ).EuclideanNorm() <= m_incrementalRange
+                       && m_shove->SpringbackDepth() < maxIncrementalDepth;
+
+    if( incremental )
+    {
+        m_stats.m_incrementalShoves++;
+    }
+    else
+    {
+        resetShove();
+        m_stats.m_fullShoves++;
+    }
+
+    bool ok = shoveTo( aP );
+
+    if( !ok && incremental )
+    {
+        // the previous result might have been a dead end, try again from scratch
+        m_stats.m_fallbacks++;
+        resetShove();
+        ok = shoveTo( aP );
+    }
+
+    if( ok )
+        m_lastShovePos = aP;
+    else if( m_lastShovePos )
+    {
+        // The stored states have been discarded, rebuild the last valid one
+        // so that the displayed result stays consistent.
+        resetShove();
+        shoveTo( *m_lastShovePos );
+    }
+
+    m_lastNode = m_shove->CurrentNode()->Branch();
+
+    switch( m_mode )
+    {
+    case DRAG_SEGMENT:
+    case DRAG_CORNER:
+        m_lastValidDraggedLine.ClearSegmentLinks();
+        m_lastValidDraggedLine.Unmark();
+        m_lastNode->Add( m_lastValidDraggedLine );
+        m_draggedItems.Clear();
+        m_draggedItems.Add( m_lastValidDraggedLine );
+        break;
 
+    case DRAG_VIA:
         if( ok )
-        {
-            if( newVia )
-                m_draggedVia = newVia;
             m_draggedItems.Clear();
-        }
 
         break;
     }
-    }
 
     m_dragStatus = ok;
 
@@ -305,19 +379,38 @@ bool DRAGGER::FixRoute()
 
 bool DRAGGER::Drag( const VECTOR2I& aP )
 {
+    PROF_COUNTER timer( "drag" );
+    bool rv = false;
+
     switch( m_currentMode )
     {
     case RM_MarkObstacles:
-        return dragMarkObstacles( aP );
+        rv = dragMarkObstacles( aP );
+        break;
 
     case RM_Shove:
     case RM_Walkaround:
     case RM_Smart:
-        return dragShove( aP );
+        rv = dragShove( aP );
+        break;
 
     default:
-        return false;
+        break;
     }
+
+    double elapsed = timer.msecs();
+
+    m_stats.m_events++;
+    m_stats.m_lastTime = elapsed;
+    m_stats.m_totalTime += elapsed;
+    m_stats.m_maxTime = std::max( m_stats.m_maxTime, elapsed );
+
+    wxLogTrace( "PNS", "Drag: %.3f ms (avg %.3f ms, max %.3f ms, "
+                "%d incremental / %d full shoves, %d fallbacks)",
+                elapsed, m_stats.m_totalTime / m_stats.m_events, m_stats.m_maxTime,
+                m_stats.m_incrementalShoves, m_stats.m_fullShoves, m_stats.m_fallbacks );
+
+    return rv;
 }
 
 
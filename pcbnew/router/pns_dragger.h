@@ -44,6 +44,27 @@ class OPTIMIZER;
 class DRAGGER : public ALGO_BASE
 {
 public:
+    ///> Timing statistics of the current dragging operation
+    struct DRAG_STATS
+    {
+        ///> number of Drag() calls
+        int m_events;
+
+        ///> shoves continued from the previous result
+        int m_incrementalShoves;
+
+        ///> shoves started from the initial world state
+        int m_fullShoves;
+
+        ///> incremental shoves that failed and have been recomputed from scratch
+        int m_fallbacks;
+
+        ///> time spent in Drag(), in milliseconds
+        double m_totalTime;
+        double m_lastTime;
+        double m_maxTime;
+    };
+
      DRAGGER( ROUTER* aRouter );
     ~DRAGGER();
 
@@ -97,6 +118,16 @@ public:
     /// @copydoc ALGO_BASE::Logger()
     virtual LOGGER* Logger() override;
 
+    /**
+     * Function Stats()
+     *
+     * Returns the timing statistics of the current dragging operation.
+     */
+    const DRAG_STATS& Stats() const
+    {
+        return m_stats;
+    }
+
 private:
     enum DragMode {
         DRAG_CORNER = 0,
@@ -106,6 +137,8 @@ private:
 
     bool dragMarkObstacles( const VECTOR2I& aP );
     bool dragShove(const VECTOR2I& aP );
+    bool shoveTo( const VECTOR2I& aP );
+    void resetShove();
     bool startDragSegment( const VECTOR2D& aP, SEGMENT* aSeg );
     bool startDragVia( const VECTOR2D& aP, VIA* aVia );
     void dumbDragVia( VIA* aVia, NODE* aNode, const VECTOR2I& aP );
@@ -123,6 +156,14 @@ private:
     ITEM_SET m_origViaConnections;
     VIA*     m_initialVia;
     ITEM_SET m_draggedItems;
+
+    ///> cursor position of the last successful shove
+    OPT_VECTOR2I m_lastShovePos;
+
+    ///> maximum cursor displacement for which the last shove result is reused
+    int      m_incrementalRange;
+
+    DRAG_STATS m_stats;
 };
 
 }
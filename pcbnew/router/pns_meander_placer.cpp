@@ -91,16 +91,7 @@ bool MEANDER_PLACER::Start( const VECTOR2I& aP, ITEM* aStartItem )
 
 int MEANDER_PLACER::origPathLength() const
 {
-    int total = 0;
-    for( const ITEM* item : m_tunedPath.CItems() )
-    {
-        if( const LINE* l = dyn_cast<const LINE*>( item ) )
-        {
-            total += l->CLine().Length();
-        }
-    }
-
-    return total;
+    return netLength( m_originLine.Net() );
 }
 
 
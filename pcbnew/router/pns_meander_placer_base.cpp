@@ -19,6 +19,8 @@
  * with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <limits>
+
 #include "pns_router.h"
 #include "pns_meander.h"
 #include "pns_meander_placer_base.h"
@@ -189,4 +191,12 @@ int MEANDER_PLACER_BASE::compareWithTolerance( int aValue, int aExpected, int aT
         return 0;
 }
 
+
+int MEANDER_PLACER_BASE::netLength( int aNet ) const
+{
+    int64_t length = Router()->GetWorld()->NetLength( aNet );
+
+    return (int) std::min<int64_t>( length, std::numeric_limits<int>::max() );
+}
+
 }
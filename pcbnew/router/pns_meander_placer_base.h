@@ -156,6 +156,14 @@ protected:
      */
     int compareWithTolerance ( int aValue, int aExpected, int aTolerance = 0 ) const;
 
+    /**
+     * Function netLength()
+     *
+     * Returns the total track length of net aNet in the router world, as cached
+     * by NODE::NetLength(), clamped to the range of the tuned lengths.
+     */
+    int netLength( int aNet ) const;
+
     ///> width of the meandered trace(s)
     int m_currentWidth;
     ///> meandering settings
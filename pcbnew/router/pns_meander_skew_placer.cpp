@@ -34,8 +34,6 @@ namespace PNS {
 MEANDER_SKEW_PLACER::MEANDER_SKEW_PLACER ( ROUTER* aRouter ) :
     MEANDER_PLACER ( aRouter )
 {
-    // Init temporary variables (do not leave uninitialized members)
-    m_coupledLength = 0;
 }
 
 
@@ -90,39 +88,22 @@ bool MEANDER_SKEW_PLACER::Start( const VECTOR2I& aP, ITEM* aStartItem )
     m_currentWidth = m_originLine.Width();
     m_currentEnd = VECTOR2I( 0, 0 );
 
-    if ( m_originPair.PLine().Net() == m_originLine.Net() )
-        m_coupledLength = itemsetLength( m_tunedPathN );
-    else
-        m_coupledLength = itemsetLength( m_tunedPathP );
-
     return true;
 }
 
 
-int MEANDER_SKEW_PLACER::origPathLength( ) const
-{
-    return itemsetLength ( m_tunedPath );
-}
-
-
-int MEANDER_SKEW_PLACER::itemsetLength( const ITEM_SET& aSet ) const
+int MEANDER_SKEW_PLACER::coupledLength() const
 {
-    int total = 0;
-    for( const ITEM* item : aSet.CItems() )
-    {
-        if( const LINE* l = dyn_cast<const LINE*>( item ) )
-        {
-            total += l->CLine().Length();
-        }
-    }
-
-    return total;
+    if( m_originPair.NetP() == m_originLine.Net() )
+        return netLength( m_originPair.NetN() );
+    else
+        return netLength( m_originPair.NetP() );
 }
 
 
 int MEANDER_SKEW_PLACER::currentSkew() const
 {
-    return m_lastLength - m_coupledLength;
+    return m_lastLength - coupledLength();
 }
 
 
@@ -140,7 +121,7 @@ bool MEANDER_SKEW_PLACER::Move( const VECTOR2I& aP, ITEM* aEndItem )
             Dbg()->AddLine( l->CLine(), 4, 10000 );
     }
 
-    return doMove( aP, aEndItem, m_coupledLength + m_settings.m_targetSkew );
+    return doMove( aP, aEndItem, coupledLength() + m_settings.m_targetSkew );
 }
 
 
@@ -163,7 +144,7 @@ const wxString MEANDER_SKEW_PLACER::TuningInfo() const
         return _( "?" );
     }
 
-    status += LengthDoubleToString( (double) m_lastLength - m_coupledLength, false );
+    status += LengthDoubleToString( (double) currentSkew(), false );
     status += "/";
     status += LengthDoubleToString( (double) m_settings.m_targetSkew, false );
 
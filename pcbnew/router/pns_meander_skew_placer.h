@@ -53,15 +53,12 @@ public:
 
 private:
 
+    ///> length of the other net of the pair, read from the world net length cache
+    int coupledLength() const;
     int currentSkew( ) const;
-    int itemsetLength( const ITEM_SET& aSet ) const;
-
-    int origPathLength () const override;
 
     DIFF_PAIR m_originPair;
     ITEM_SET  m_tunedPath, m_tunedPathP, m_tunedPathN;
-
-    int m_coupledLength;
 };
 
 }
@@ -131,6 +131,7 @@ NODE* NODE::Branch()
 
         child->m_joints = m_joints;
         child->m_override = m_override;
+        child->m_netLengths = m_netLengths;
     }
 
     wxLogTrace( "PNS", "%d items, %d joints, %d overrides",
@@ -591,6 +592,7 @@ void NODE::addSegment( SEGMENT* aSeg )
     linkJoint( aSeg->Seg().B, aSeg->Layers(), aSeg->Net(), aSeg );
 
     m_index->Add( aSeg );
+    updateNetLength( aSeg, 1 );
 }
 
 void NODE::Add( std::unique_ptr< SEGMENT > aSegment, bool aAllowRedundant )
@@ -639,12 +641,20 @@ void NODE::doRemove( ITEM* aItem )
     // case 1: removing an item that is stored in the root node from any branch:
     // mark it as overridden, but do not remove
     if( aItem->BelongsTo( m_root ) && !isRoot() )
-        m_override.insert( aItem );
+    {
+        if( m_override.insert( aItem ).second )
+            updateNetLength( aItem, -1 );
+    }
 
     // case 2: the item belongs to this branch or a parent, non-root branch,
     // or the root itself and we are the root: remove from the index
     else if( !aItem->BelongsTo( m_root ) || isRoot() )
+    {
+        if( m_index->Contains( aItem ) )
+            updateNetLength( aItem, -1 );
+
         m_index->Remove( aItem );
+    }
 
     // the item belongs to this particular branch: un-reference it
     if( aItem->BelongsTo( this ) )
@@ -655,6 +665,37 @@ void NODE::doRemove( ITEM* aItem )
 }
 
 
+void NODE::updateNetLength( const ITEM* aItem, int aSign )
+{
+    if( aItem->Kind() != ITEM::SEGMENT_T || aItem->Net() < 0 )
+        return;
+
+    const SEGMENT* seg = static_cast<const SEGMENT*>( aItem );
+
+    m_netLengths[seg->Net()] += aSign * (int64_t) seg->Seg().Length();
+}
+
+
+int64_t NODE::NetLength( int aNet ) const
+{
+    int64_t length = 0;
+    NET_LENGTH_MAP::const_iterator i = m_netLengths.find( aNet );
+
+    if( i != m_netLengths.end() )
+        length = i->second;
+
+    if( !isRoot() )
+    {
+        i = m_root->m_netLengths.find( aNet );
+
+        if( i != m_root->m_netLengths.end() )
+            length += i->second;
+    }
+
+    return length;
+}
+
+
 void NODE::removeSegmentIndex( SEGMENT* aSeg )
 {
     unlinkJoint( aSeg->Seg().A, aSeg->Layers(), aSeg->Net(), aSeg );
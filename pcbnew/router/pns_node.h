@@ -412,6 +412,17 @@ public:
         return !m_children.empty();
     }
 
+    /**
+     * Function NetLength()
+     *
+     * Returns the total length of the track segments belonging to net aNet, as seen
+     * from this branch. The per-net totals are updated whenever a segment is added
+     * or removed, so the query costs O(1) regardless of the size of the net.
+     * @param aNet net code to query
+     * @return total segment length (0 if the net has no segments)
+     */
+    int64_t NetLength( int aNet ) const;
+
     ///> checks if this branch contains an updated version of the m_item
     ///> from the root branch.
     bool Overrides( ITEM* aItem ) const
@@ -423,6 +434,7 @@ private:
     struct DEFAULT_OBSTACLE_VISITOR;
     typedef boost::unordered_multimap<JOINT::HASH_TAG, JOINT> JOINT_MAP;
     typedef JOINT_MAP::value_type TagJointPair;
+    typedef boost::unordered_map<int, int64_t> NET_LENGTH_MAP;
 
     /// nodes are not copyable
     NODE( const NODE& aB );
@@ -450,6 +462,7 @@ private:
     void removeViaIndex( VIA* aVia );
 
     void doRemove( ITEM* aItem );
+    void updateNetLength( const ITEM* aItem, int aSign );
     void unlinkParent();
     void releaseChildren();
     void releaseGarbage();
@@ -502,6 +515,10 @@ private:
     int m_depth;
 
     boost::unordered_set<ITEM*> m_garbageItems;
+
+    ///> per-net segment length. The root stores the totals of its own items,
+    ///> the branches store the difference with respect to the root.
+    NET_LENGTH_MAP m_netLengths;
 };
 
 }
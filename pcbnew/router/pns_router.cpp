@@ -58,6 +58,7 @@
 #include <ratsnest_data.h>
 #include <layers_id_colors_and_visibility.h>
 #include <geometry/convex_hull.h>
+#include <frame_profiler.h>
 
 namespace PNS {
 
@@ -155,6 +156,8 @@ bool ROUTER::StartDragging( const VECTOR2I& aP, ITEM* aStartItem )
 
 bool ROUTER::StartRouting( const VECTOR2I& aP, ITEM* aStartItem, int aLayer )
 {
+    FRAME_PROFILER_SCOPE profilerScope( FRAME_PROFILER::ROUTER );
+
     switch( m_mode )
     {
         case PNS_MODE_ROUTE_SINGLE:
@@ -201,6 +204,8 @@ void ROUTER::DisplayItems( const ITEM_SET& aItems )
 
 void ROUTER::Move( const VECTOR2I& aP, ITEM* endItem )
 {
+    FRAME_PROFILER_SCOPE profilerScope( FRAME_PROFILER::ROUTER );
+
     m_currentEnd = aP;
 
     switch( m_state )
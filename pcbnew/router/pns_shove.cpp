@@ -1404,6 +1404,19 @@ const LINE SHOVE::NewHead() const
 }
 
 
+void SHOVE::ClearSpringback()
+{
+    // Each state is branched from the previous one, so free them starting from the last
+    while( !m_nodeStack.empty() )
+    {
+        delete m_nodeStack.back().m_node;
+        m_nodeStack.pop_back();
+    }
+
+    m_currentNode = m_root;
+}
+
+
 void SHOVE::SetInitialLine( LINE& aInitial )
 {
     m_root = m_root->Branch();
@@ -85,6 +85,21 @@ public:
 
     void SetInitialLine( LINE& aInitial );
 
+    /**
+     * Function ClearSpringback()
+     *
+     * Discards all the stored shove states, so that the next shove operation starts
+     * from the initial world state. Nodes branched from the discarded states must
+     * be deleted beforehand.
+     */
+    void ClearSpringback();
+
+    ///> Returns the number of stored shove states
+    int SpringbackDepth() const
+    {
+        return m_nodeStack.size();
+    }
+
 private:
     typedef std::vector<SHAPE_LINE_CHAIN> HULL_SET;
     typedef boost::optional<LINE> OPT_LINE;
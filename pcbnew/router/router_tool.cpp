@@ -41,6 +41,7 @@ using namespace std::placeholders;
 #include <base_units.h>
 #include <hotkeys.h>
 #include <confirm.h>
+#include <html_messagebox.h>
 
 #include <tool/context_menu.h>
 #include <tool/tool_manager.h>
@@ -53,10 +54,15 @@ using namespace std::placeholders;
 #include <tools/zoom_menu.h>
 
 #include <ratsnest_data.h>
+#include <class_module.h>
+#include <class_pad.h>
 
 #include "router_tool.h"
 #include "pns_segment.h"
 #include "pns_router.h"
+#include "pns_batch_router.h"
+#include "pns_batch_optimizer.h"
+#include "pns_optimizer.h"
 
 using namespace KIGFX;
 using boost::optional;
@@ -273,6 +279,9 @@ bool ROUTER_TOOL::Init()
     CONDITIONAL_MENU& menu = selectionTool->GetToolMenu().GetMenu();
     menu.AddItem( COMMON_ACTIONS::routerInlineDrag, SELECTION_CONDITIONS::Count( 1 )
             && SELECTION_CONDITIONS::OnlyTypes( { PCB_TRACE_T, PCB_VIA_T, EOT } ) );
+    menu.AddItem( COMMON_ACTIONS::routerRouteSelected, SELECTION_CONDITIONS::MoreThan( 0 )
+            && SELECTION_CONDITIONS::OnlyTypes( { PCB_MODULE_T, PCB_PAD_T, EOT } ) );
+    menu.AddItem( COMMON_ACTIONS::routerOptimizeAll, SELECTION_CONDITIONS::Count( 0 ) );
 
     m_savedSettings.Load( GetSettings() );
     return true;
@@ -643,6 +652,8 @@ void ROUTER_TOOL::SetTransitions()
     Go( &ROUTER_TOOL::DpDimensionsDialog, COMMON_ACTIONS::routerActivateDpDimensionsDialog.MakeEvent() );
     Go( &ROUTER_TOOL::SettingsDialog, COMMON_ACTIONS::routerActivateSettingsDialog.MakeEvent() );
     Go( &ROUTER_TOOL::InlineDrag, COMMON_ACTIONS::routerInlineDrag.MakeEvent() );
+    Go( &ROUTER_TOOL::RouteSelected, COMMON_ACTIONS::routerRouteSelected.MakeEvent() );
+    Go( &ROUTER_TOOL::OptimizeAll, COMMON_ACTIONS::routerOptimizeAll.MakeEvent() );
 
     Go( &ROUTER_TOOL::onViaCommand, ACT_PlaceThroughVia.MakeEvent() );
     Go( &ROUTER_TOOL::onViaCommand, ACT_PlaceBlindVia.MakeEvent() );
@@ -864,6 +875,189 @@ int ROUTER_TOOL::InlineDrag( const TOOL_EVENT& aEvent )
 }
 
 
+/**
+ * Returns the router item corresponding to one of the board items sharing a ratsnest node.
+ */
+static PNS::ITEM* findRatsnestNodeItem( PNS::NODE* aWorld, const RN_NODE_PTR& aNode )
+{
+    for( const BOARD_CONNECTED_ITEM* parent : aNode->GetParents() )
+    {
+        PNS::ITEM* item = aWorld->FindItemByParent( parent );
+
+        if( item )
+            return item;
+    }
+
+    return NULL;
+}
+
+
+static bool isRatsnestNodeSelected( const RN_NODE_PTR& aNode,
+                                    const std::set<const BOARD_CONNECTED_ITEM*>& aSelected )
+{
+    for( const BOARD_CONNECTED_ITEM* parent : aNode->GetParents() )
+    {
+        if( aSelected.count( parent ) )
+            return true;
+    }
+
+    return false;
+}
+
+
+int ROUTER_TOOL::RouteSelected( const TOOL_EVENT& aEvent )
+{
+    const SELECTION& selection = m_toolMgr->GetTool<SELECTION_TOOL>()->GetSelection();
+    std::set<const BOARD_CONNECTED_ITEM*> selectedPads;
+    std::set<int> nets;
+
+    for( BOARD_ITEM* item : selection )
+    {
+        if( item->Type() == PCB_MODULE_T )
+        {
+            for( D_PAD* pad = static_cast<MODULE*>( item )->Pads(); pad; pad = pad->Next() )
+                selectedPads.insert( pad );
+        }
+        else if( item->Type() == PCB_PAD_T )
+        {
+            selectedPads.insert( static_cast<D_PAD*>( item ) );
+        }
+    }
+
+    for( const BOARD_CONNECTED_ITEM* pad : selectedPads )
+    {
+        if( pad->GetNetCode() > 0 )
+            nets.insert( pad->GetNetCode() );
+    }
+
+    if( nets.empty() )
+        return 0;
+
+    Activate();
+
+    m_router->SyncWorld();
+
+    RN_DATA* ratsnest = m_board->GetRatsnest();
+    ratsnest->Recalculate();
+
+    PNS::BATCH_ROUTER batch( m_router );
+    PNS::NODE* world = m_router->GetWorld();
+    int total = 0;
+
+    for( int net : nets )
+    {
+        const std::vector<RN_EDGE_MST_PTR>* edges = ratsnest->GetNet( net ).GetUnconnected();
+
+        if( !edges )
+            continue;
+
+        for( const RN_EDGE_MST_PTR& edge : *edges )
+        {
+            const RN_NODE_PTR& src = edge->GetSourceNode();
+            const RN_NODE_PTR& dst = edge->GetTargetNode();
+
+            if( !isRatsnestNodeSelected( src, selectedPads )
+                    && !isRatsnestNodeSelected( dst, selectedPads ) )
+                continue;
+
+            PNS::ITEM* srcItem = findRatsnestNodeItem( world, src );
+            PNS::ITEM* dstItem = findRatsnestNodeItem( world, dst );
+
+            PNS::SIZES_SETTINGS sizes( m_router->Sizes() );
+            sizes.Init( m_board, srcItem, net );
+
+            batch.AddConnection( srcItem, VECTOR2I( src->GetX(), src->GetY() ),
+                                 dstItem, VECTOR2I( dst->GetX(), dst->GetY() ),
+                                 sizes.TrackWidth() );
+            total++;
+        }
+    }
+
+    if( !total )
+    {
+        DisplayInfoMessage( m_frame, _( "The selected items have no unconnected ratsnest lines." ) );
+        return 0;
+    }
+
+    m_frame->UndoRedoBlock( true );
+    int routed = batch.Run();
+    m_frame->UndoRedoBlock( false );
+
+    wxArrayString failures;
+
+    for( const PNS::BATCH_ROUTER::CONNECTION& conn : batch.Connections() )
+    {
+        if( conn.m_routed )
+            continue;
+
+        NETINFO_ITEM* ni = m_board->FindNet( conn.m_net );
+
+        failures.Add( wxString::Format( wxT( "%s (%s, %s): %s" ),
+                      ni ? GetChars( ni->GetNetname() ) : wxT( "?" ),
+                      GetChars( CoordinateToString( conn.m_start.x ) ),
+                      GetChars( CoordinateToString( conn.m_start.y ) ),
+                      GetChars( conn.m_failureReason ) ) );
+    }
+
+    HTML_MESSAGE_BOX report( m_frame, _( "Route Selected Ratsnest" ) );
+    report.MessageSet( wxString::Format( _( "Routed %d of %d connections." ), routed, total ) );
+
+    if( !failures.IsEmpty() )
+        report.ListSet( failures );
+
+    report.ShowModal();
+
+    return 0;
+}
+
+
+int ROUTER_TOOL::OptimizeAll( const TOOL_EVENT& aEvent )
+{
+    Activate();
+
+    m_router->SyncWorld();
+
+    PNS::BATCH_OPTIMIZER batch( m_router );
+    int effort = PNS::OPTIMIZER::MERGE_SEGMENTS | PNS::OPTIMIZER::MERGE_OBTUSE;
+
+    if( m_router->Settings().SmartPads() )
+        effort |= PNS::OPTIMIZER::SMART_PADS;
+
+    batch.SetEffortLevel( effort );
+
+    for( unsigned net = 1; net < m_board->GetNetCount(); net++ )
+        batch.AddNet( net );
+
+    wxBusyCursor busy;
+
+    m_frame->UndoRedoBlock( true );
+    int modified = batch.Run();
+    m_frame->UndoRedoBlock( false );
+
+    const PNS::BATCH_OPTIMIZER::STATS& stats = batch.Stats();
+    wxArrayString details;
+
+    details.Add( wxString::Format( _( "Total length: %s -> %s" ),
+                 GetChars( LengthDoubleToString( (double) stats.m_lengthBefore, false ) ),
+                 GetChars( LengthDoubleToString( (double) stats.m_lengthAfter, false ) ) ) );
+    details.Add( wxString::Format( _( "Corners: %d -> %d" ),
+                 stats.m_cornersBefore, stats.m_cornersAfter ) );
+
+    if( stats.m_conflictCount )
+        details.Add( wxString::Format( _( "%d traces left unchanged due to conflicts "
+                                          "with other optimized traces" ),
+                                       stats.m_conflictCount ) );
+
+    HTML_MESSAGE_BOX report( m_frame, _( "Optimize All Traces" ) );
+    report.MessageSet( wxString::Format( _( "Optimized %d of %d traces." ),
+                                         modified, stats.m_lineCount ) );
+    report.ListSet( details );
+    report.ShowModal();
+
+    return 0;
+}
+
+
 int ROUTER_TOOL::CustomTrackWidthDialog( const TOOL_EVENT& aEvent )
 {
     BOARD_DESIGN_SETTINGS& bds = m_board->GetDesignSettings();
@@ -37,6 +37,8 @@ public:
     int RouteSingleTrace( const TOOL_EVENT& aEvent );
     int RouteDiffPair( const TOOL_EVENT& aEvent );
     int InlineDrag( const TOOL_EVENT& aEvent );
+    int RouteSelected( const TOOL_EVENT& aEvent );
+    int OptimizeAll( const TOOL_EVENT& aEvent );
 
     // TODO make this private?
     int DpDimensionsDialog( const TOOL_EVENT& aEvent );
@@ -584,6 +584,14 @@ TOOL_ACTION COMMON_ACTIONS::toBeDone( "pcbnew.Control.toBeDone",
         AS_GLOBAL, 0,           // dialog saying it is not implemented yet
         "", "" );               // so users are aware of that
 
+TOOL_ACTION COMMON_ACTIONS::toggleFrameProfiler( "pcbnew.Control.toggleFrameProfiler",
+        AS_GLOBAL, MD_CTRL + WXK_F12,
+        _( "Show Frame Times" ), _( "Measure and display the drawing time of each frame" ) );
+
+TOOL_ACTION COMMON_ACTIONS::dumpFrameProfile( "pcbnew.Control.dumpFrameProfile",
+        AS_GLOBAL, MD_CTRL + MD_SHIFT + WXK_F12,
+        _( "Save Frame Times" ), _( "Save the measured frame times to a file" ) );
+
 
 TOOL_ACTION COMMON_ACTIONS::routerActivateSingle( "pcbnew.InteractiveRouter.SingleTrack",
         AS_GLOBAL, TOOL_ACTION::LegacyHotKey( HK_ADD_NEW_TRACK ),
@@ -622,6 +630,18 @@ TOOL_ACTION COMMON_ACTIONS::routerInlineDrag( "pcbnew.InteractiveRouter.InlineDr
         _( "Drag Track/Via" ), _( "Drags tracks and vias without breaking connections" ),
         drag_track_segment_xpm );
 
+TOOL_ACTION COMMON_ACTIONS::routerRouteSelected( "pcbnew.InteractiveRouter.RouteSelected",
+        AS_GLOBAL, 0,
+        _( "Route Selected Ratsnest" ),
+        _( "Routes unconnected ratsnest lines of the selected footprints and pads" ),
+        ps_router_xpm );
+
+TOOL_ACTION COMMON_ACTIONS::routerOptimizeAll( "pcbnew.InteractiveRouter.OptimizeAll",
+        AS_GLOBAL, 0,
+        _( "Optimize All Traces" ),
+        _( "Merges segments and removes unnecessary corners of all unlocked tracks" ),
+        ps_router_xpm );
+
 // Point editor
 TOOL_ACTION COMMON_ACTIONS::pointEditorAddCorner( "pcbnew.PointEditor.addCorner",
         AS_GLOBAL, 0,
@@ -180,6 +180,12 @@ public:
     /// Activation of the Push and Shove router (inline dragging mode)
     static TOOL_ACTION routerInlineDrag;
 
+    /// Routes the unconnected ratsnest lines of the selected items without user interaction
+    static TOOL_ACTION routerRouteSelected;
+
+    /// Runs the trace optimizer over all tracks of the board
+    static TOOL_ACTION routerOptimizeAll;
+
     // Point Editor
     /// Break outline (insert additional points to an edge)
     static TOOL_ACTION pointEditorAddCorner;
@@ -343,6 +349,10 @@ public:
     static TOOL_ACTION showHelp;
     static TOOL_ACTION toBeDone;
 
+    // Frame time profiling
+    static TOOL_ACTION toggleFrameProfiler;
+    static TOOL_ACTION dumpFrameProfile;
+
     /// Find an item
     static TOOL_ACTION find;
 
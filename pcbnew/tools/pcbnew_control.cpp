@@ -51,8 +51,10 @@
 #include <pcb_painter.h>
 #include <origin_viewitem.h>
 #include <board_commit.h>
+#include <frame_profiler.h>
 
 #include <functional>
+#include <wx/filedlg.h>
 using namespace std::placeholders;
 
 
@@ -912,6 +914,38 @@ int PCBNEW_CONTROL::ToBeDone( const TOOL_EVENT& aEvent )
 }
 
 
+int PCBNEW_CONTROL::ToggleFrameProfiler( const TOOL_EVENT& aEvent )
+{
+    EDA_DRAW_PANEL_GAL* canvas = m_frame->GetGalCanvas();
+    canvas->ShowProfilerOverlay( !canvas->IsProfilerOverlayShown() );
+
+    return 0;
+}
+
+
+int PCBNEW_CONTROL::DumpFrameProfile( const TOOL_EVENT& aEvent )
+{
+    if( FRAME_PROFILER::Instance().GetRecords().empty() )
+    {
+        DisplayInfoMessage( m_frame, _( "No frame times have been measured yet. "
+                                        "Enable the frame profiler first." ) );
+        return 0;
+    }
+
+    wxFileDialog dlg( m_frame, _( "Save Frame Times" ), wxEmptyString, "frame_profile.csv",
+                      _( "CSV files (*.csv)|*.csv" ), wxFD_SAVE | wxFD_OVERWRITE_PROMPT );
+
+    if( dlg.ShowModal() == wxID_CANCEL )
+        return 0;
+
+    if( !FRAME_PROFILER::Instance().Dump( dlg.GetPath() ) )
+        DisplayError( m_frame, wxString::Format( _( "Unable to create file <%s>" ),
+                                                 GetChars( dlg.GetPath() ) ) );
+
+    return 0;
+}
+
+
 void PCBNEW_CONTROL::SetTransitions()
 {
     // View controls
@@ -984,6 +1018,8 @@ void PCBNEW_CONTROL::SetTransitions()
     Go( &PCBNEW_CONTROL::AppendBoard,        COMMON_ACTIONS::appendBoard.MakeEvent() );
     Go( &PCBNEW_CONTROL::ShowHelp,           COMMON_ACTIONS::showHelp.MakeEvent() );
     Go( &PCBNEW_CONTROL::ToBeDone,           COMMON_ACTIONS::toBeDone.MakeEvent() );
+    Go( &PCBNEW_CONTROL::ToggleFrameProfiler, COMMON_ACTIONS::toggleFrameProfiler.MakeEvent() );
+    Go( &PCBNEW_CONTROL::DumpFrameProfile,   COMMON_ACTIONS::dumpFrameProfile.MakeEvent() );
 }
 
 
@@ -91,6 +91,8 @@ public:
     int AppendBoard( const TOOL_EVENT& aEvent );
     int ShowHelp( const TOOL_EVENT& aEvent );
     int ToBeDone( const TOOL_EVENT& aEvent );
+    int ToggleFrameProfiler( const TOOL_EVENT& aEvent );
+    int DumpFrameProfile( const TOOL_EVENT& aEvent );
 
     ///> Sets up handlers for various events.
     void SetTransitions() override;
@@ -0,0 +1,259 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/*
+ * Test of CHUNK_ALLOCATOR, the vertex buffer allocator used by CACHED_CONTAINER. It does not
+ * need an OpenGL context. A few fixed scenarios are followed by random Allocate(), Free(),
+ * Resize() and Grow() calls; after every call the allocator has to pass Check() and the
+ * allocated chunks are compared with a model: they must keep their offsets and sizes and
+ * must not overlap. The program exits with a non-zero status if any check fails.
+ *
+ * Usage: chunk_allocator_test [operation_count] [seed]
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <map>
+#include <random>
+#include <vector>
+
+#include <gal/opengl/chunk_allocator.h>
+
+using namespace KIGFX;
+
+
+static int failures = 0;
+
+#define CHECK( cond ) \
+    do { \
+        if( !( cond ) ) \
+        { \
+            fprintf( stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond ); \
+            ++failures; \
+        } \
+    } while( 0 )
+
+
+///> Offset & size of the allocated chunks, indexed by their handles
+typedef std::map<int, std::pair<unsigned int, unsigned int>> MODEL;
+
+
+static void verify( const CHUNK_ALLOCATOR& aAlloc, const MODEL& aModel, unsigned int aSize )
+{
+    CHECK( aAlloc.Check() );
+
+    std::vector<std::pair<unsigned int, unsigned int>> blocks;
+    unsigned int used = 0;
+
+    for( const auto& entry : aModel )
+    {
+        int chunk = entry.first;
+
+        CHECK( !aAlloc.IsFree( chunk ) );
+        CHECK( aAlloc.GetOffset( chunk ) == entry.second.first );
+        CHECK( aAlloc.GetSize( chunk ) == entry.second.second );
+
+        blocks.push_back( entry.second );
+        used += entry.second.second;
+    }
+
+    std::sort( blocks.begin(), blocks.end() );
+
+    for( size_t i = 0; i < blocks.size(); ++i )
+    {
+        CHECK( blocks[i].first + blocks[i].second <= aSize );
+
+        if( i > 0 )
+            CHECK( blocks[i - 1].first + blocks[i - 1].second <= blocks[i].first );
+    }
+
+    CHECK( aAlloc.GetFreeSpace() == aSize - used );
+    CHECK( aAlloc.GetStats().m_usedChunks == aModel.size() );
+}
+
+
+static void testScenarios()
+{
+    CHUNK_ALLOCATOR alloc( 100 );
+    MODEL model;
+
+    // Exact fit and failure when full
+    int a = alloc.Allocate( 40 );
+    int b = alloc.Allocate( 60 );
+    CHECK( a != CHUNK_ALLOCATOR::NONE && b != CHUNK_ALLOCATOR::NONE );
+    CHECK( alloc.GetOffset( a ) == 0 && alloc.GetOffset( b ) == 40 );
+    CHECK( alloc.Allocate( 1 ) == CHUNK_ALLOCATOR::NONE );
+    CHECK( alloc.GetStats().m_failures == 1 );
+    CHECK( alloc.GetLargestFree() == 0 );
+    model[a] = { 0, 40 };
+    model[b] = { 40, 60 };
+    verify( alloc, model, 100 );
+
+    // Released neighbours are coalesced
+    alloc.Free( a );
+    model.erase( a );
+    alloc.Free( b );
+    model.erase( b );
+    verify( alloc, model, 100 );
+    CHECK( alloc.GetStats().m_freeChunks == 1 && alloc.GetLargestFree() == 100 );
+
+    // Resizing in place
+    a = alloc.Allocate( 10 );
+    b = alloc.Allocate( 10 );
+    CHECK( !alloc.Resize( a, 11 ) );            // followed by a used chunk
+    CHECK( alloc.Resize( b, 50 ) );             // followed by free space
+    CHECK( alloc.Resize( a, 5 ) );              // shrinking always succeeds
+    CHECK( alloc.Resize( a, 10 ) );             // the released tail is free again
+    CHECK( !alloc.Resize( b, 91 ) );
+    model[a] = { 0, 10 };
+    model[b] = { 10, 50 };
+    verify( alloc, model, 100 );
+
+    // Growing extends the trailing free chunk or appends a new one
+    alloc.Grow( 150 );
+    verify( alloc, model, 150 );
+    CHECK( alloc.GetStats().m_freeChunks == 1 && alloc.GetLargestFree() == 90 );
+
+    int c = alloc.Allocate( 90 );
+    CHECK( c != CHUNK_ALLOCATOR::NONE && alloc.GetOffset( c ) == 60 );
+    model[c] = { 60, 90 };
+    alloc.Grow( 200 );
+    verify( alloc, model, 200 );
+    CHECK( alloc.GetLargestFree() == 50 );
+
+    // User data
+    alloc.SetData( c, &model );
+    CHECK( alloc.GetData( c ) == &model );
+
+    // Reset releases everything
+    alloc.Reset( 1000 );
+    model.clear();
+    verify( alloc, model, 1000 );
+
+    // Sizes in the upper size classes
+    CHUNK_ALLOCATOR large( 0xF0000000u );
+    int big = large.Allocate( 0x80000001u );
+    CHECK( big != CHUNK_ALLOCATOR::NONE );
+    CHECK( large.Allocate( 0x70000000u ) == CHUNK_ALLOCATOR::NONE );
+    CHECK( large.Allocate( 0x6FFFFFFFu ) != CHUNK_ALLOCATOR::NONE );
+    CHECK( large.Check() );
+}
+
+
+static void testRandom( int aOperations, unsigned int aSeed )
+{
+    // Every operation is followed by a full check, so the number of chunks is kept moderate
+    const unsigned int MAX_SIZE = 40000;
+    std::mt19937 rng( aSeed );
+    unsigned int size = 10000;
+    CHUNK_ALLOCATOR alloc( size );
+    MODEL model;
+    std::vector<int> handles;
+
+    for( int op = 0; op < aOperations; ++op )
+    {
+        int action = rng() % 100;
+
+        // Mostly small chunks, with occasional large ones, as the GAL items
+        unsigned int request = ( rng() % 10 ) ? 1 + rng() % 64 : 1 + rng() % 2000;
+
+        if( action < 45 || handles.empty() )
+        {
+            int chunk = alloc.Allocate( request );
+
+            if( chunk != CHUNK_ALLOCATOR::NONE )
+            {
+                CHECK( model.count( chunk ) == 0 );
+                CHECK( alloc.GetSize( chunk ) == request );
+                model[chunk] = { alloc.GetOffset( chunk ), request };
+                handles.push_back( chunk );
+            }
+            else
+            {
+                CHECK( alloc.GetLargestFree() < request );
+            }
+        }
+        else if( action < 85 )
+        {
+            size_t idx = rng() % handles.size();
+            int chunk = handles[idx];
+
+            alloc.Free( chunk );
+            model.erase( chunk );
+            handles[idx] = handles.back();
+            handles.pop_back();
+        }
+        else if( action < 98 )
+        {
+            int chunk = handles[rng() % handles.size()];
+            unsigned int oldSize = model[chunk].second;
+
+            if( alloc.Resize( chunk, request ) )
+                model[chunk].second = request;
+            else
+                CHECK( request > oldSize );
+        }
+        else if( size < MAX_SIZE )
+        {
+            size += 1 + rng() % 1000;
+            alloc.Grow( size );
+        }
+
+        verify( alloc, model, size );
+
+        if( failures )
+        {
+            fprintf( stderr, "failed at operation %d (seed %u)\n", op, aSeed );
+            return;
+        }
+    }
+
+    const CHUNK_ALLOCATOR::STATS& stats = alloc.GetStats();
+
+    printf( "%d operations: %lu allocations, %lu releases, %lu resizes, %lu failures, "
+            "%u used chunks, %u free chunks\n", aOperations, stats.m_allocations,
+            stats.m_releases, stats.m_resizes, stats.m_failures, stats.m_usedChunks,
+            stats.m_freeChunks );
+}
+
+
+int main( int argc, char** argv )
+{
+    int operations = argc > 1 ? atoi( argv[1] ) : 20000;
+    unsigned int seed = argc > 2 ? strtoul( argv[2], NULL, 10 ) : 1;
+
+    testScenarios();
+
+    if( !failures )
+        testRandom( operations, seed );
+
+    if( failures )
+    {
+        fprintf( stderr, "%d checks failed\n", failures );
+        return 1;
+    }
+
+    printf( "all checks passed\n" );
+    return 0;
+}
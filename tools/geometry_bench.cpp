@@ -0,0 +1,209 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/*
+ * Benchmark and consistency check of the batched segment kernels used by
+ * SHAPE_LINE_CHAIN::Collide() / Intersect(). Every query is also run with the plain
+ * per-segment loops, and the results are compared. Exits with a non-zero status
+ * if they ever differ.
+ *
+ * Usage: geometry_bench [point_count] [query_count]
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+#include <profile.h>
+#include <geometry/seg_batch.h>
+#include <geometry/shape_line_chain.h>
+
+
+static SHAPE_LINE_CHAIN randomChain( std::mt19937& aRng, int aPoints, int aRange, int aStep )
+{
+    std::uniform_int_distribution<int> start( -aRange, aRange );
+    std::uniform_int_distribution<int> step( -aStep, aStep );
+    SHAPE_LINE_CHAIN chain;
+    VECTOR2I p( start( aRng ), start( aRng ) );
+
+    for( int i = 0; i < aPoints; i++ )
+    {
+        chain.Append( p, true );
+        p += VECTOR2I( step( aRng ), step( aRng ) );
+    }
+
+    return chain;
+}
+
+
+// Reference implementations: the per-segment loops the batched code replaces
+static bool naiveCollide( const SHAPE_LINE_CHAIN& aChain, const SEG& aSeg, int aClearance )
+{
+    BOX2I box_a( aSeg.A, aSeg.B - aSeg.A );
+    BOX2I::ecoord_type dist_sq = (BOX2I::ecoord_type) aClearance * aClearance;
+
+    for( int i = 0; i < aChain.SegmentCount(); i++ )
+    {
+        const SEG& s = aChain.CSegment( i );
+        BOX2I box_b( s.A, s.B - s.A );
+
+        if( box_a.SquaredDistance( box_b ) < dist_sq && s.Collide( aSeg, aClearance ) )
+            return true;
+    }
+
+    return false;
+}
+
+
+static int naiveIntersect( const SHAPE_LINE_CHAIN& aChain, const SEG& aSeg,
+                           SHAPE_LINE_CHAIN::INTERSECTIONS& aIp )
+{
+    for( int s = 0; s < aChain.SegmentCount(); s++ )
+    {
+        OPT_VECTOR2I p = aChain.CSegment( s ).Intersect( aSeg );
+
+        if( p )
+        {
+            SHAPE_LINE_CHAIN::INTERSECTION is;
+            is.our = aChain.CSegment( s );
+            is.their = aSeg;
+            is.p = *p;
+            aIp.push_back( is );
+        }
+    }
+
+    return aIp.size();
+}
+
+
+int main( int argc, char** argv )
+{
+    int pointCount = argc > 1 ? atoi( argv[1] ) : 10000;
+    int queryCount = argc > 2 ? atoi( argv[2] ) : 20000;
+
+    std::mt19937 rng( 12345 );
+    std::uniform_int_distribution<int> coord( -1000000, 1000000 );
+    std::uniform_int_distribution<int> len( -50000, 50000 );
+    std::uniform_int_distribution<int> clearance( 0, 20000 );
+
+    SHAPE_LINE_CHAIN chain = randomChain( rng, pointCount, 1000000, 30000 );
+    std::vector<SEG> queries;
+    std::vector<int> clearances;
+
+    for( int i = 0; i < queryCount; i++ )
+    {
+        VECTOR2I a( coord( rng ), coord( rng ) );
+        queries.push_back( SEG( a, a + VECTOR2I( len( rng ), len( rng ) ) ) );
+        clearances.push_back( clearance( rng ) );
+    }
+
+    printf( "kernel: %s, %d points, %d queries\n", SegBatchDescribe(), pointCount, queryCount );
+
+    int mismatches = 0;
+    int hitsBatch = 0, hitsNaive = 0;
+
+    PROF_COUNTER collideBatch( "Collide (batched)" );
+
+    for( int i = 0; i < queryCount; i++ )
+        hitsBatch += chain.Collide( queries[i], clearances[i] );
+
+    double tCollideBatch = collideBatch.msecs();
+
+    PROF_COUNTER collideNaive( "Collide (naive)" );
+
+    for( int i = 0; i < queryCount; i++ )
+        hitsNaive += naiveCollide( chain, queries[i], clearances[i] );
+
+    double tCollideNaive = collideNaive.msecs();
+
+    for( int i = 0; i < queryCount; i++ )
+    {
+        if( chain.Collide( queries[i], clearances[i] )
+                != naiveCollide( chain, queries[i], clearances[i] ) )
+            mismatches++;
+    }
+
+    int isBatch = 0, isNaive = 0;
+
+    PROF_COUNTER intersectBatch( "Intersect (batched)" );
+
+    for( int i = 0; i < queryCount; i++ )
+    {
+        SHAPE_LINE_CHAIN::INTERSECTIONS ip;
+        isBatch += chain.Intersect( queries[i], ip );
+    }
+
+    double tIntersectBatch = intersectBatch.msecs();
+
+    PROF_COUNTER intersectNaive( "Intersect (naive)" );
+
+    for( int i = 0; i < queryCount; i++ )
+    {
+        SHAPE_LINE_CHAIN::INTERSECTIONS ip;
+        isNaive += naiveIntersect( chain, queries[i], ip );
+    }
+
+    double tIntersectNaive = intersectNaive.msecs();
+
+    for( int i = 0; i < queryCount; i++ )
+    {
+        SHAPE_LINE_CHAIN::INTERSECTIONS a, b;
+        chain.Intersect( queries[i], a );
+        naiveIntersect( chain, queries[i], b );
+
+        if( a.size() != b.size() )
+        {
+            mismatches++;
+            continue;
+        }
+
+        // Intersect() sorts the points by their distance from the query origin
+        for( const SHAPE_LINE_CHAIN::INTERSECTION& is : a )
+        {
+            bool found = false;
+
+            for( const SHAPE_LINE_CHAIN::INTERSECTION& ref : b )
+                found |= ( ref.p == is.p && ref.our.Index() == is.our.Index() );
+
+            if( !found )
+            {
+                mismatches++;
+                break;
+            }
+        }
+    }
+
+    printf( "Collide:   %d hits, batched %.2f ms, naive %.2f ms\n",
+            hitsBatch, tCollideBatch, tCollideNaive );
+    printf( "Intersect: %d points, batched %.2f ms, naive %.2f ms\n",
+            isBatch, tIntersectBatch, tIntersectNaive );
+
+    if( hitsBatch != hitsNaive || isBatch != isNaive || mismatches )
+    {
+        printf( "FAILED: %d mismatching queries\n", mismatches );
+        return 1;
+    }
+
+    printf( "OK\n" );
+    return 0;
+}
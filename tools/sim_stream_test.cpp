@@ -0,0 +1,314 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 CERN
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * https://www.gnu.org/licenses/gpl-3.0.html
+ * or you may search the http://www.gnu.org website for the version 3 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/*
+ * Test of the simulation results streaming. Checks:
+ *  - SIM_DATA_STREAM: vector filtering and names (V(x), I(V1), @v1[i]), trimming of the read
+ *    points and the bound on the stored points,
+ *  - a reader that keeps its stream index reads every point once, also after the stream
+ *    dropped the points it did not read in time,
+ *  - TRACE::DecimatePoints(): the first, last, lowest and highest points of every pixel
+ *    column are kept,
+ *  - a short transient analysis run with the ngspice shared library: the streamed points
+ *    have to match the vectors read from ngspice once the simulation is finished.
+ * The program exits with a non-zero status if any check fails.
+ *
+ * Usage: sim_stream_test [-n]
+ *  -n  skips the ngspice run
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <wx/init.h>
+#include <wx/utils.h>
+
+#include <sim/sim_data_stream.h>
+#include <sim/sim_plot_panel.h>
+#include <sim/ngspice.h>
+
+
+static int failures = 0;
+
+#define CHECK( cond ) \
+    do { \
+        if( !( cond ) ) \
+        { \
+            fprintf( stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond ); \
+            ++failures; \
+        } \
+    } while( 0 )
+
+
+static void appendRows( SIM_DATA_STREAM& aStream, size_t aFirst, size_t aCount )
+{
+    std::vector<COMPLEX> row( 4 );
+
+    for( size_t i = aFirst; i < aFirst + aCount; ++i )
+    {
+        row[0] = COMPLEX( i, 0.0 );         // time
+        row[1] = COMPLEX( 2.0 * i, 0.0 );   // out
+        row[2] = COMPLEX( 3.0 * i, 0.0 );   // in
+        row[3] = COMPLEX( 4.0 * i, 0.0 );   // v1#branch
+        aStream.AppendRow( row, 0 );
+    }
+}
+
+
+static void testStream()
+{
+    const size_t BLOCK = SIM_DATA_STREAM::BLOCK_SIZE;
+    SIM_DATA_STREAM stream;
+    std::vector<double> xs, ys;
+    size_t first;
+
+    stream.SetFilter( { "V(out)", "I(V1)" } );
+    stream.Reset( { "time", "out", "in", "v1#branch" }, { false, false, false, false } );
+    appendRows( stream, 0, 3 * BLOCK + 10 );
+
+    CHECK( stream.GetLength() == 3 * BLOCK + 10 );
+
+    // Vectors that are not selected by the filter are not stored
+    first = 0;
+    CHECK( !stream.GetPoints( "V(in)", SIM_DATA_STREAM::MAGNITUDE, first, xs, ys ) );
+
+    first = 0;
+    CHECK( stream.GetPoints( "v(OUT)", SIM_DATA_STREAM::MAGNITUDE, first, xs, ys ) );
+    CHECK( first == 0 && xs.size() == 3 * BLOCK + 10 && ys.size() == xs.size() );
+    CHECK( xs.back() == 3 * BLOCK + 9 && ys.back() == 2.0 * xs.back() );
+
+    // Branch currents may be requested in both notations
+    for( const char* name : { "I(V1)", "@v1[i]" } )
+    {
+        xs.clear();
+        ys.clear();
+        first = BLOCK;
+        CHECK( stream.GetPoints( name, SIM_DATA_STREAM::MAGNITUDE, first, xs, ys ) );
+        CHECK( first == BLOCK && xs.size() == 2 * BLOCK + 10 );
+        CHECK( !ys.empty() && ys.front() == 4.0 * BLOCK );
+    }
+
+    // Points that have been read are released, the readers continue from the stored ones
+    stream.Trim( 2 * BLOCK + 5 );
+    xs.clear();
+    ys.clear();
+    first = 0;
+    CHECK( stream.GetPoints( "V(out)", SIM_DATA_STREAM::MAGNITUDE, first, xs, ys ) );
+    CHECK( first == 2 * BLOCK && xs.size() == BLOCK + 10 );
+    CHECK( !xs.empty() && xs.front() == 2 * BLOCK && ys.front() == 4.0 * BLOCK );
+
+    // Without a reader, the number of stored points is bounded
+    size_t total = ( SIM_DATA_STREAM::MAX_BLOCKS + 2 ) * BLOCK;
+    stream.Reset( { "time", "out", "in", "v1#branch" }, { false, false, false, false } );
+    appendRows( stream, 0, total );
+    xs.clear();
+    ys.clear();
+    first = 0;
+    CHECK( stream.GetPoints( "V(out)", SIM_DATA_STREAM::MAGNITUDE, first, xs, ys ) );
+    CHECK( xs.size() <= SIM_DATA_STREAM::MAX_BLOCKS * BLOCK );
+    CHECK( first + xs.size() == total );
+    CHECK( !xs.empty() && xs.front() == first && ys.back() == 2.0 * ( total - 1 ) );
+
+    stream.Clear();
+    first = 0;
+    CHECK( !stream.GetPoints( "V(out)", SIM_DATA_STREAM::MAGNITUDE, first, xs, ys ) );
+}
+
+
+static void testDroppedBlocks()
+{
+    const size_t BLOCK = SIM_DATA_STREAM::BLOCK_SIZE;
+    SIM_DATA_STREAM stream;
+    std::vector<double> plotXs, xs, ys;
+    size_t position = 0;
+
+    // A reader that keeps the stream index of its next point, as the plot frame does
+    auto read = [&]() -> bool {
+        size_t first = position;
+        xs.clear();
+        ys.clear();
+
+        if( !stream.GetPoints( "V(out)", SIM_DATA_STREAM::MAGNITUDE, first, xs, ys ) )
+            return false;
+
+        plotXs.insert( plotXs.end(), xs.begin(), xs.end() );
+        position = first + xs.size();
+        return true;
+    };
+
+    stream.SetFilter( { "V(out)" } );
+    stream.Reset( { "time", "out", "in", "v1#branch" }, { false, false, false, false } );
+    appendRows( stream, 0, BLOCK + 10 );
+    CHECK( read() );
+    CHECK( position == BLOCK + 10 && plotXs.size() == position );
+
+    // The reader falls behind (e.g. another plot is shown), the oldest blocks are dropped
+    size_t total = ( SIM_DATA_STREAM::MAX_BLOCKS + 3 ) * BLOCK;
+    appendRows( stream, BLOCK + 10, total - BLOCK - 10 );
+    CHECK( read() );
+    CHECK( position == total );
+    CHECK( plotXs.size() < position );
+
+    // Further reads continue where the previous one stopped, without repeated points
+    appendRows( stream, total, 100 );
+    CHECK( read() );
+    CHECK( position == total + 100 && xs.size() == 100 );
+    CHECK( !xs.empty() && xs.front() == total );
+    CHECK( std::adjacent_find( plotXs.begin(), plotXs.end(),
+                               std::greater_equal<double>() ) == plotXs.end() );
+
+    // Nothing new, nothing read
+    CHECK( read() );
+    CHECK( xs.empty() && position == total + 100 );
+}
+
+
+static void testDecimation()
+{
+    const int POINTS = 100000;
+    const int COLUMNS = 500;
+    std::vector<double> xs, ys, outXs, outYs;
+
+    for( int i = 0; i < POINTS; ++i )
+    {
+        xs.push_back( i * 1e-6 );
+        ys.push_back( sin( i * 0.01 ) + ( ( i * 7919 ) % 101 ) * 1e-3 );
+    }
+
+    auto column = [&]( double aX ) {
+        return (int) ( aX / xs.back() * ( COLUMNS - 1 ) );
+    };
+
+    TRACE::DecimatePoints( xs, ys, 0, xs.size(), column, outXs, outYs );
+
+    CHECK( outXs.size() == outYs.size() );
+    CHECK( outXs.size() <= 4 * COLUMNS );
+    CHECK( std::is_sorted( outXs.begin(), outXs.end() ) );
+    CHECK( !outXs.empty() && outXs.front() == xs.front() && outXs.back() == xs.back() );
+
+    // Every column keeps its extremes
+    std::vector<double> minY( COLUMNS, HUGE_VAL ), maxY( COLUMNS, -HUGE_VAL );
+    std::vector<double> outMinY( COLUMNS, HUGE_VAL ), outMaxY( COLUMNS, -HUGE_VAL );
+
+    for( int i = 0; i < POINTS; ++i )
+    {
+        minY[column( xs[i] )] = std::min( minY[column( xs[i] )], ys[i] );
+        maxY[column( xs[i] )] = std::max( maxY[column( xs[i] )], ys[i] );
+    }
+
+    for( size_t i = 0; i < outXs.size(); ++i )
+    {
+        outMinY[column( outXs[i] )] = std::min( outMinY[column( outXs[i] )], outYs[i] );
+        outMaxY[column( outXs[i] )] = std::max( outMaxY[column( outXs[i] )], outYs[i] );
+    }
+
+    CHECK( minY == outMinY && maxY == outMaxY );
+
+    printf( "decimation: %d points -> %lu points\n", POINTS, (unsigned long) outXs.size() );
+}
+
+
+static void testNgspice()
+{
+    const char* netlist =
+        "RC test\n"
+        "V1 in 0 PULSE(0 1 0 1u 1u 1m 2m)\n"
+        "R1 in out 1k\n"
+        "C1 out 0 1u\n"
+        ".tran 1u 5m\n"
+        ".end\n";
+
+    NGSPICE sim;
+    sim.Init();
+    sim.GetDataStream().SetFilter( { "V(out)", "I(V1)" } );
+    sim.LoadNetlist( netlist );
+    sim.Run();
+
+    // bg_run starts the simulation thread asynchronously
+    wxMilliSleep( 100 );
+
+    while( sim.IsRunning() )
+        wxMilliSleep( 10 );
+
+    const SIM_DATA_STREAM& stream = sim.GetDataStream();
+
+    for( const char* name : { "V(out)", "v1#branch" } )
+    {
+        std::vector<double> xs, ys;
+        std::vector<double> reference = sim.GetMagPlot( name );
+        size_t first = 0;
+
+        CHECK( stream.GetPoints( name, SIM_DATA_STREAM::MAGNITUDE, first, xs, ys ) );
+        CHECK( first == 0 );
+        CHECK( !reference.empty() && ys.size() == reference.size() );
+
+        bool equal = ys.size() == reference.size();
+
+        for( size_t i = 0; equal && i < ys.size(); ++i )
+            equal = std::fabs( ys[i] - reference[i] ) <= 1e-9 * ( 1.0 + std::fabs( reference[i] ) );
+
+        CHECK( equal );
+
+        printf( "ngspice: %s streamed %lu points, simulator vector has %lu points\n", name,
+                (unsigned long) ys.size(), (unsigned long) reference.size() );
+    }
+
+    std::vector<double> xs, ys;
+    size_t first = 0;
+    CHECK( !stream.GetPoints( "V(in)", SIM_DATA_STREAM::MAGNITUDE, first, xs, ys ) );
+}
+
+
+int main( int argc, char** argv )
+{
+    wxInitializer initializer;
+
+    if( !initializer )
+    {
+        fprintf( stderr, "Could not initialize wxWidgets\n" );
+        return 1;
+    }
+
+    bool runNgspice = !( argc > 1 && strcmp( argv[1], "-n" ) == 0 );
+
+    testStream();
+    testDroppedBlocks();
+    testDecimation();
+
+    if( runNgspice )
+        testNgspice();
+
+    if( failures )
+    {
+        fprintf( stderr, "%d checks failed\n", failures );
+        return 1;
+    }
+
+    printf( "all checks passed\n" );
+    return 0;
+}
@@ -0,0 +1,239 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/*
+ * Benchmark of VIEW_RTREE (bulk loaded, packed) against the dynamic R-tree that used to
+ * index VIEW layers (VIEW_RTREE_BASE, filled one item at a time). Items imitate a board:
+ * footprints with clusters of pads and tracks between them. The query results are compared
+ * and the program exits with a non-zero status if they differ.
+ *
+ * Usage: view_rtree_bench [item_count] [query_count]
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include <profile.h>
+#include <view/view_item.h>
+#include <view/view_rtree.h>
+
+using namespace KIGFX;
+
+
+class BENCH_ITEM : public VIEW_ITEM
+{
+public:
+    BENCH_ITEM( const BOX2I& aBox ) : m_box( aBox )
+    {
+    }
+
+    const BOX2I ViewBBox() const override
+    {
+        return m_box;
+    }
+
+    void ViewGetLayers( int aLayers[], int& aCount ) const override
+    {
+        aLayers[0] = 0;
+        aCount = 1;
+    }
+
+    BOX2I m_box;
+};
+
+
+struct COLLECTOR
+{
+    COLLECTOR() : m_count( 0 ), m_sum( 0 )
+    {
+    }
+
+    bool operator()( VIEW_ITEM* aItem )
+    {
+        // Order independent checksum of the visited items
+        m_count++;
+        m_sum += static_cast<BENCH_ITEM*>( aItem )->m_box.GetX();
+        return true;
+    }
+
+    int m_count;
+    long long m_sum;
+};
+
+
+static void makeBoard( std::mt19937& aRng, int aCount, std::vector<BENCH_ITEM*>& aItems )
+{
+    const int boardSize = 200000000;    // 200 mm
+    std::uniform_int_distribution<int> pos( 0, boardSize );
+    std::uniform_int_distribution<int> padOffset( -5000000, 5000000 );
+    std::uniform_int_distribution<int> padSize( 300000, 2000000 );
+    std::uniform_int_distribution<int> trackLen( 0, 20000000 );
+
+    while( (int) aItems.size() < aCount )
+    {
+        VECTOR2I fp( pos( aRng ), pos( aRng ) );
+
+        // Footprint pads
+        for( int i = 0; i < 16; i++ )
+        {
+            VECTOR2I p = fp + VECTOR2I( padOffset( aRng ), padOffset( aRng ) );
+            int s = padSize( aRng );
+            aItems.push_back( new BENCH_ITEM( BOX2I( p, VECTOR2I( s, s ) ) ) );
+        }
+
+        // Tracks leaving the footprint
+        for( int i = 0; i < 16; i++ )
+        {
+            VECTOR2I p = fp + VECTOR2I( padOffset( aRng ), padOffset( aRng ) );
+            BOX2I track( p, VECTOR2I( trackLen( aRng ), trackLen( aRng ) / 8 ) );
+
+            if( i % 2 )
+                track = BOX2I( p, VECTOR2I( track.GetHeight(), track.GetWidth() ) );
+
+            aItems.push_back( new BENCH_ITEM( track ) );
+        }
+    }
+}
+
+
+int main( int argc, char** argv )
+{
+    int itemCount = argc > 1 ? atoi( argv[1] ) : 200000;
+    int queryCount = argc > 2 ? atoi( argv[2] ) : 2000;
+
+    std::mt19937 rng( 12345 );
+    std::vector<BENCH_ITEM*> items;
+
+    makeBoard( rng, itemCount, items );
+    itemCount = items.size();
+
+    // Viewports: zoomed out (the whole board) and zoomed in
+    std::uniform_int_distribution<int> pos( 0, 200000000 );
+    std::vector<BOX2I> viewports;
+
+    for( int i = 0; i < queryCount; i++ )
+    {
+        int size = ( i % 4 == 0 ) ? 250000000 : ( 1000000 << ( i % 5 ) );
+        VECTOR2I corner = ( i % 4 == 0 ) ? VECTOR2I( -10000000, -10000000 )
+                                         : VECTOR2I( pos( rng ), pos( rng ) );
+        viewports.push_back( BOX2I( corner, VECTOR2I( size, size * 3 / 4 ) ) );
+    }
+
+    printf( "%d items, %d queries\n", itemCount, queryCount );
+
+    // Build
+    PROF_COUNTER buildOld( "build (dynamic)" );
+    VIEW_RTREE_BASE oldTree;
+
+    for( BENCH_ITEM* item : items )
+    {
+        const BOX2I& bbox = item->ViewBBox();
+        const int mmin[2] = { bbox.GetX(), bbox.GetY() };
+        const int mmax[2] = { bbox.GetRight(), bbox.GetBottom() };
+        oldTree.Insert( mmin, mmax, item );
+    }
+
+    double tBuildOld = buildOld.msecs();
+
+    PROF_COUNTER buildNew( "build (packed)" );
+    VIEW_RTREE newTree;
+
+    for( BENCH_ITEM* item : items )
+        newTree.Insert( item );
+
+    // The packed tree is built on the first query
+    COLLECTOR warmup;
+    newTree.Query( BOX2I( VECTOR2I( 0, 0 ), VECTOR2I( 0, 0 ) ), warmup );
+
+    double tBuildNew = buildNew.msecs();
+
+    // Queries
+    std::vector<COLLECTOR> resultsOld( queryCount ), resultsNew( queryCount );
+
+    PROF_COUNTER queryOld( "query (dynamic)" );
+
+    for( int i = 0; i < queryCount; i++ )
+    {
+        const int mmin[2] = { viewports[i].GetX(), viewports[i].GetY() };
+        const int mmax[2] = { viewports[i].GetRight(), viewports[i].GetBottom() };
+        oldTree.Search( mmin, mmax, resultsOld[i] );
+    }
+
+    double tQueryOld = queryOld.msecs();
+
+    PROF_COUNTER queryNew( "query (packed)" );
+
+    for( int i = 0; i < queryCount; i++ )
+        newTree.Query( viewports[i], resultsNew[i] );
+
+    double tQueryNew = queryNew.msecs();
+
+    int mismatches = 0;
+    long long visited = 0;
+
+    for( int i = 0; i < queryCount; i++ )
+    {
+        visited += resultsNew[i].m_count;
+
+        if( resultsOld[i].m_count != resultsNew[i].m_count
+                || resultsOld[i].m_sum != resultsNew[i].m_sum )
+            mismatches++;
+    }
+
+    // Editing: move 1% of the items, then query again (the moved items go to the dynamic part)
+    std::uniform_int_distribution<int> pick( 0, itemCount - 1 );
+    std::uniform_int_distribution<int> shift( -1000000, 1000000 );
+
+    PROF_COUNTER editNew( "edit (packed)" );
+
+    for( int i = 0; i < itemCount / 100; i++ )
+    {
+        BENCH_ITEM* item = items[pick( rng )];
+        newTree.Remove( item );
+        item->m_box.Move( VECTOR2I( shift( rng ), shift( rng ) ) );
+        newTree.Insert( item );
+    }
+
+    COLLECTOR afterEdit;
+    BOX2I everything;
+    everything.SetMaximum();
+    newTree.Query( everything, afterEdit );
+
+    double tEditNew = editNew.msecs();
+
+    if( afterEdit.m_count != itemCount )
+        mismatches++;
+
+    printf( "build:  dynamic %.2f ms, packed %.2f ms\n", tBuildOld, tBuildNew );
+    printf( "query:  dynamic %.2f ms, packed %.2f ms (%lld items visited)\n",
+            tQueryOld, tQueryNew, visited );
+    printf( "edit:   packed %.2f ms (%d items moved)\n", tEditNew, itemCount / 100 );
+    printf( "%d mismatches\n", mismatches );
+
+    for( BENCH_ITEM* item : items )
+        delete item;
+
+    return mismatches ? 1 : 0;
+}